@@ -0,0 +1,130 @@
+#include "AvailList.h"
+
+void AvailList::clear()
+{
+    m_head = RecordId();
+    m_tail = RecordId();
+    m_nodes.clear();
+    m_byCapacity.clear();
+    m_freeBytes = 0;
+}
+
+void AvailList::append(RecordId rid, quint16 capacity)
+{
+    if (!rid.isValid() || m_nodes.contains(rid))
+        return;
+
+    Node node;
+    node.prev = m_tail;
+    node.capacity = capacity;
+    if (m_tail.isValid())
+        m_nodes[m_tail].next = rid;
+    else
+        m_head = rid;
+    m_tail = rid;
+
+    m_nodes.insert(rid, node);
+    m_byCapacity.insert(capacity, rid);
+    m_freeBytes += capacity;
+}
+
+void AvailList::push(RecordId rid, quint16 capacity)
+{
+    if (!rid.isValid() || m_nodes.contains(rid))
+        return;
+
+    Node node;
+    node.next = m_head;
+    node.capacity = capacity;
+    if (m_head.isValid())
+        m_nodes[m_head].prev = rid;
+    else
+        m_tail = rid;
+    m_head = rid;
+
+    m_nodes.insert(rid, node);
+    m_byCapacity.insert(capacity, rid);
+    m_freeBytes += capacity;
+}
+
+std::optional<AvailList::Taken> AvailList::take(quint16 size)
+{
+    // Ninguna ranura alcanza: no hace falta recorrer la lista (con registros
+    // de largo variable es el caso de casi toda inserción al final)
+    if (m_byCapacity.isEmpty() || m_byCapacity.lastKey() < size)
+        return std::nullopt;
+
+    RecordId chosen;
+    switch (m_policy) {
+    case FirstFit:
+        // En orden de la lista: con tamaño fijo la cabeza siempre alcanza
+        for (RecordId rid = m_head; rid.isValid(); rid = m_nodes.value(rid).next) {
+            if (m_nodes.value(rid).capacity >= size) {
+                chosen = rid;
+                break;
+            }
+        }
+        break;
+    case BestFit: {
+        auto it = m_byCapacity.lowerBound(size);
+        if (it != m_byCapacity.end())
+            chosen = it.value();
+        break;
+    }
+    case WorstFit: {
+        auto it = m_byCapacity.end();
+        --it;
+        chosen = it.value();
+        break;
+    }
+    }
+
+    if (!chosen.isValid())
+        return std::nullopt;
+    return unlink(chosen);
+}
+
+std::optional<AvailList::Taken> AvailList::takeSlot(RecordId rid)
+{
+    if (!m_nodes.contains(rid))
+        return std::nullopt;
+    return unlink(rid);
+}
+
+AvailList::Taken AvailList::unlink(RecordId rid)
+{
+    const Node node = m_nodes.take(rid);
+
+    if (node.prev.isValid())
+        m_nodes[node.prev].next = node.next;
+    else
+        m_head = node.next;
+
+    if (node.next.isValid())
+        m_nodes[node.next].prev = node.prev;
+    else
+        m_tail = node.prev;
+
+    // Quitar del índice por capacidad solo la entrada de esta ranura
+    auto it = m_byCapacity.find(node.capacity, rid);
+    if (it != m_byCapacity.end())
+        m_byCapacity.erase(it);
+    m_freeBytes -= node.capacity;
+
+    Taken taken;
+    taken.rid = rid;
+    taken.prev = node.prev;
+    taken.next = node.next;
+    taken.capacity = node.capacity;
+    return taken;
+}
+
+const char *AvailList::policyName(Policy policy)
+{
+    switch (policy) {
+    case FirstFit: return "first-fit";
+    case BestFit:  return "best-fit";
+    case WorstFit: return "worst-fit";
+    }
+    return "desconocida";
+}
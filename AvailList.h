@@ -0,0 +1,78 @@
+#ifndef AVAILLIST_H
+#define AVAILLIST_H
+
+#include <QHash>
+#include <QMultiMap>
+#include <optional>
+#include "RecordId.h"
+
+// Avail List: lista de ranuras liberadas de un archivo .mad.
+//
+// En disco la lista está enlazada a través de los propios registros
+// eliminados (cada ranura libre guarda el RecordId de la siguiente) y la
+// cabeza vive en el encabezado del archivo; eso lo mantiene RecordFile.
+// Esta clase es el espejo en memoria que permite elegir una ranura sin
+// recorrer el archivo:
+//   - push() agrega al inicio: O(1).
+//   - First-fit toma la primera ranura que alcance; con registros de tamaño
+//     fijo siempre es la cabeza, así que también es O(1).
+//   - Best-fit y Worst-fit usan un índice por capacidad: O(log n).
+class AvailList {
+public:
+    enum Policy : quint8 {
+        FirstFit = 0,
+        BestFit  = 1,
+        WorstFit = 2
+    };
+
+    // Ranura tomada de la lista y sus vecinos, para que RecordFile
+    // re-enlace el anterior en disco
+    struct Taken {
+        RecordId rid;
+        RecordId prev;
+        RecordId next;
+        quint16 capacity = 0;
+    };
+
+    void clear();
+
+    Policy policy() const { return m_policy; }
+    void setPolicy(Policy policy) { m_policy = policy; }
+
+    RecordId head() const { return m_head; }
+    int count() const { return m_nodes.size(); }
+    quint64 freeBytes() const { return m_freeBytes; }
+    bool contains(RecordId rid) const { return m_nodes.contains(rid); }
+
+    // Agrega una ranura al final (solo al reconstruir la lista desde disco)
+    void append(RecordId rid, quint16 capacity);
+
+    // Agrega una ranura recién liberada como nueva cabeza
+    void push(RecordId rid, quint16 capacity);
+
+    // Busca una ranura con capacidad >= size según la política y la quita
+    std::optional<Taken> take(quint16 size);
+
+    // Quita una ranura concreta (p. ej. cuando se libera su página)
+    std::optional<Taken> takeSlot(RecordId rid);
+
+    static const char *policyName(Policy policy);
+
+private:
+    struct Node {
+        RecordId prev;
+        RecordId next;
+        quint16 capacity = 0;
+    };
+
+    Taken unlink(RecordId rid);
+
+    Policy m_policy = FirstFit;
+    RecordId m_head;
+    RecordId m_tail;
+    QHash<RecordId, Node> m_nodes;
+    QMultiMap<quint16, RecordId> m_byCapacity;
+    quint64 m_freeBytes = 0;
+};
+
+#endif // AVAILLIST_H
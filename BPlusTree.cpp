@@ -0,0 +1,392 @@
+#include "BPlusTree.h"
+
+#include <algorithm>
+#include <limits>
+
+bool BPlusTree::open(const QString &path, const QString &tableName, const QString &fieldName,
+                     IndexFile::Kind kind)
+{
+    m_error.clear();
+    if (kind != IndexFile::BPlusTreeKind && kind != IndexFile::BStarTreeKind)
+        return fail(QStringLiteral("Tipo de índice no soportado por el árbol B+"));
+    if (!m_index.open(path, kind, tableName, fieldName))
+        return fail(m_index.errorString());
+    return true;
+}
+
+int BPlusTree::maxEntries(bool leaf) const
+{
+    const int pageMax = IndexFile::maxEntries(leaf);
+    return (m_capacity >= 3 && m_capacity < pageMax) ? m_capacity : pageMax;
+}
+
+int BPlusTree::minEntries(bool leaf) const
+{
+    return isBStar() ? (2 * maxEntries(leaf)) / 3 : maxEntries(leaf) / 2;
+}
+
+bool BPlusTree::fail(const QString &error)
+{
+    m_error = error;
+    return false;
+}
+
+int BPlusTree::childFor(const IndexNode &node, const IndexEntry &entry)
+{
+    // Separador i: todo lo del hijo i es menor, todo lo del hijo i+1 es mayor o igual
+    return int(std::upper_bound(node.entries.cbegin(), node.entries.cend(), entry) - node.entries.cbegin());
+}
+
+bool BPlusTree::insert(qint64 key, RecordId rid)
+{
+    if (!isOpen())
+        return fail(QStringLiteral("El índice no está abierto"));
+
+    ++m_modificationCount;
+    const IndexEntry entry{ key, rid.toUInt64() };
+
+    if (m_index.root() == 0) {
+        const quint32 root = m_index.allocateNode();
+        if (root == 0)
+            return fail(m_index.errorString());
+        IndexNode leaf;
+        leaf.entries.append(entry);
+        if (!m_index.writeNode(root, leaf))
+            return fail(m_index.errorString());
+        m_index.setRoot(root, 1);
+        m_index.setFirstLeaf(root);
+        m_index.setEntryCount(1);
+        return true;
+    }
+
+    IndexNode rootNode;
+    if (!insertInto(m_index.root(), entry, &rootNode))
+        return false;
+
+    // La raíz desbordó: se divide en dos bajo una raíz nueva
+    if (rootNode.entries.size() > maxEntries(rootNode.leaf)) {
+        const quint32 newRoot = m_index.allocateNode();
+        if (newRoot == 0)
+            return fail(m_index.errorString());
+        IndexNode root;
+        root.leaf = false;
+        root.children.append(m_index.root());
+        if (!redistribute(root, 0, { rootNode }, 2))
+            return false;
+        if (!m_index.writeNode(newRoot, root))
+            return fail(m_index.errorString());
+        m_index.setRoot(newRoot, m_index.height() + 1);
+    }
+
+    m_index.setEntryCount(m_index.entryCount() + 1);
+    return true;
+}
+
+bool BPlusTree::insertInto(quint32 pageNo, const IndexEntry &entry, IndexNode *node)
+{
+    if (!m_index.readNode(pageNo, node))
+        return fail(m_index.errorString());
+
+    if (node->leaf) {
+        const auto it = std::lower_bound(node->entries.begin(), node->entries.end(), entry);
+        if (it != node->entries.end() && *it == entry)
+            return fail(QStringLiteral("La entrada ya existe en el índice"));
+        node->entries.insert(int(it - node->entries.begin()), entry);
+    } else {
+        const int child = childFor(*node, entry);
+        IndexNode childNode;
+        if (!insertInto(node->children.at(child), entry, &childNode))
+            return false;
+        if (childNode.entries.size() <= maxEntries(childNode.leaf))
+            return true;
+        if (!handleOverflow(*node, child, childNode))
+            return false;
+    }
+
+    if (node->entries.size() > maxEntries(node->leaf))
+        return true; // lo resuelve el padre
+    return m_index.writeNode(pageNo, *node) || fail(m_index.errorString());
+}
+
+bool BPlusTree::handleOverflow(IndexNode &parent, int childIndex, const IndexNode &child)
+{
+    // B+: el nodo se divide en dos
+    if (!isBStar())
+        return redistribute(parent, childIndex, { child }, 2);
+
+    // B*: primero se reparte con un hermano que tenga espacio
+    const int max = maxEntries(child.leaf);
+    IndexNode left, right;
+    const bool hasLeft = childIndex > 0;
+    const bool hasRight = childIndex + 1 < parent.children.size();
+
+    if (hasLeft) {
+        if (!m_index.readNode(parent.children.at(childIndex - 1), &left))
+            return fail(m_index.errorString());
+        if (left.entries.size() < max)
+            return redistribute(parent, childIndex - 1, { left, child }, 2);
+    }
+    if (hasRight) {
+        if (!m_index.readNode(parent.children.at(childIndex + 1), &right))
+            return fail(m_index.errorString());
+        if (right.entries.size() < max)
+            return redistribute(parent, childIndex, { child, right }, 2);
+    }
+
+    // Hermano también lleno: dos nodos se dividen en tres
+    if (hasRight)
+        return redistribute(parent, childIndex, { child, right }, 3);
+    if (hasLeft)
+        return redistribute(parent, childIndex - 1, { left, child }, 3);
+    return redistribute(parent, childIndex, { child }, 2);
+}
+
+bool BPlusTree::remove(qint64 key, RecordId rid)
+{
+    if (!isOpen() || m_index.root() == 0)
+        return false;
+
+    ++m_modificationCount;
+    bool found = false;
+    if (!removeFrom(m_index.root(), IndexEntry{ key, rid.toUInt64() }, &found))
+        return false;
+    if (!found)
+        return fail(QStringLiteral("La entrada no está en el índice"));
+
+    IndexNode root;
+    if (!m_index.readNode(m_index.root(), &root))
+        return fail(m_index.errorString());
+    if (!root.leaf && root.entries.isEmpty()) {
+        const quint32 oldRoot = m_index.root();
+        m_index.setRoot(root.children.at(0), m_index.height() - 1);
+        m_index.freeNode(oldRoot);
+    } else if (root.leaf && root.entries.isEmpty()) {
+        m_index.freeNode(m_index.root());
+        m_index.setRoot(0, 0);
+        m_index.setFirstLeaf(0);
+    }
+
+    m_index.setEntryCount(m_index.entryCount() - 1);
+    return true;
+}
+
+bool BPlusTree::removeFrom(quint32 pageNo, const IndexEntry &entry, bool *found)
+{
+    IndexNode node;
+    if (!m_index.readNode(pageNo, &node))
+        return fail(m_index.errorString());
+
+    if (node.leaf) {
+        const auto it = std::lower_bound(node.entries.begin(), node.entries.end(), entry);
+        *found = it != node.entries.end() && *it == entry;
+        if (!*found)
+            return true;
+        node.entries.remove(int(it - node.entries.begin()));
+        return m_index.writeNode(pageNo, node) || fail(m_index.errorString());
+    }
+
+    // Los separadores pueden quedar "viejos" tras un borrado; siguen siendo
+    // cotas válidas, así que no hace falta actualizarlos
+    const int child = childFor(node, entry);
+    if (!removeFrom(node.children.at(child), entry, found))
+        return false;
+    if (!*found)
+        return true;
+
+    bool changed = false;
+    if (!fixChild(node, child, &changed))
+        return false;
+    return !changed || m_index.writeNode(pageNo, node) || fail(m_index.errorString());
+}
+
+bool BPlusTree::fixChild(IndexNode &parent, int childIndex, bool *changed)
+{
+    IndexNode child;
+    if (!m_index.readNode(parent.children.at(childIndex), &child))
+        return fail(m_index.errorString());
+    if (child.entries.size() >= minEntries(child.leaf) || parent.children.size() < 2)
+        return true;
+
+    // Grupo de hermanos consecutivos: dos en B+, hasta tres en B*
+    const int groupSize = qMin(isBStar() ? 3 : 2, int(parent.children.size()));
+    const int first = qBound(0, childIndex - 1, int(parent.children.size()) - groupSize);
+
+    QVector<IndexNode> nodes(groupSize);
+    int total = 0;
+    for (int i = 0; i < groupSize; ++i) {
+        if (!m_index.readNode(parent.children.at(first + i), &nodes[i]))
+            return fail(m_index.errorString());
+        total += nodes.at(i).entries.size();
+    }
+    if (!child.leaf)
+        total += groupSize - 1; // los separadores del padre bajan al grupo
+
+    // La menor cantidad de nodos en la que cabe el grupo: fusiona si puede,
+    // si no reparte (equivale a pedir prestado a los hermanos)
+    const int max = maxEntries(child.leaf);
+    int newCount = 1;
+    while (newCount < groupSize && (child.leaf ? total : total - (newCount - 1)) > newCount * max)
+        ++newCount;
+
+    *changed = true;
+    return redistribute(parent, first, nodes, newCount);
+}
+
+bool BPlusTree::redistribute(IndexNode &parent, int first, const QVector<IndexNode> &nodes, int newCount)
+{
+    const bool leaf = nodes.first().leaf;
+    const int count = nodes.size();
+    QVector<quint32> pages = parent.children.mid(first, count);
+
+    // Contenido del grupo en orden; en nodos internos los separadores del padre
+    // quedan intercalados entre los hijos
+    QVector<IndexEntry> entries;
+    QVector<quint32> children;
+    for (int i = 0; i < count; ++i) {
+        if (i > 0 && !leaf)
+            entries.append(parent.entries.at(first + i - 1));
+        entries += nodes.at(i).entries;
+        children += nodes.at(i).children;
+    }
+    const quint32 lastNext = nodes.last().next;
+
+    while (pages.size() < newCount) {
+        const quint32 page = m_index.allocateNode();
+        if (page == 0)
+            return fail(m_index.errorString());
+        pages.append(page);
+    }
+
+    const int total = leaf ? entries.size() : entries.size() - (newCount - 1);
+    QVector<IndexEntry> separators;
+    int pos = 0;
+    int childPos = 0;
+    for (int i = 0; i < newCount; ++i) {
+        const int size = total / newCount + (i < total % newCount ? 1 : 0);
+        IndexNode node;
+        node.leaf = leaf;
+        node.entries = entries.mid(pos, size);
+        pos += size;
+        if (leaf) {
+            // La primera página del grupo se conserva: la hoja anterior sigue enlazada
+            node.next = i + 1 < newCount ? pages.at(i + 1) : lastNext;
+            if (i > 0)
+                separators.append(node.entries.first());
+        } else {
+            node.children = children.mid(childPos, size + 1);
+            childPos += size + 1;
+            if (i + 1 < newCount)
+                separators.append(entries.at(pos++));
+        }
+        if (!m_index.writeNode(pages.at(i), node))
+            return fail(m_index.errorString());
+    }
+    for (int i = newCount; i < pages.size(); ++i)
+        m_index.freeNode(pages.at(i));
+
+    // Reemplazar en el padre los separadores e hijos del grupo
+    parent.entries.remove(first, count - 1);
+    parent.children.remove(first, count);
+    for (int i = 0; i < separators.size(); ++i)
+        parent.entries.insert(first + i, separators.at(i));
+    for (int i = 0; i < newCount; ++i)
+        parent.children.insert(first + i, pages.at(i));
+    return true;
+}
+
+BPlusTreeIterator BPlusTree::range(std::optional<qint64> low, std::optional<qint64> high,
+                                   bool lowInclusive, bool highInclusive)
+{
+    BPlusTreeIterator it;
+    if (!isOpen())
+        return it;
+    it.m_tree = this;
+    it.m_high = high;
+    it.m_highInclusive = highInclusive;
+    if (m_index.root() == 0)
+        return it;
+
+    // Primera entrada que cumple el límite inferior
+    IndexEntry probe;
+    if (low) {
+        probe.key = *low;
+        probe.value = 0;
+        if (!lowInclusive) {
+            if (*low == std::numeric_limits<qint64>::max())
+                return it; // nada es mayor
+            probe.key = *low + 1;
+        }
+    } else {
+        probe.key = std::numeric_limits<qint64>::min();
+    }
+
+    quint32 pageNo = m_index.root();
+    IndexNode node;
+    while (true) {
+        if (!m_index.readNode(pageNo, &node)) {
+            m_error = m_index.errorString();
+            return it;
+        }
+        if (node.leaf)
+            break;
+        // Con claves repetidas la primera coincidencia puede estar a la
+        // izquierda de un separador igual; si no, se sigue por la cadena de hojas
+        pageNo = node.children.at(int(std::lower_bound(node.entries.cbegin(), node.entries.cend(), probe)
+                                      - node.entries.cbegin()));
+    }
+
+    it.m_leaf = node;
+    it.m_pos = int(std::lower_bound(node.entries.cbegin(), node.entries.cend(), probe) - node.entries.cbegin());
+    it.m_loaded = true;
+    return it;
+}
+
+bool BPlusTree::clear()
+{
+    ++m_modificationCount;
+    return m_index.clear() || fail(m_index.errorString());
+}
+
+bool BPlusTree::reloadHeader()
+{
+    // El contenido volvió atrás: los rangos abiertos sobre el árbol no valen
+    ++m_modificationCount;
+    return m_index.reloadHeader() || fail(m_index.errorString());
+}
+
+bool BPlusTree::setFieldName(const QString &fieldName)
+{
+    return m_index.setFieldName(fieldName) || fail(m_index.errorString());
+}
+
+bool BPlusTree::bulkLoad(IndexBulkLoader &loader)
+{
+    if (!isOpen())
+        return fail(QStringLiteral("El índice no está abierto"));
+    loader.setNodeCapacity(m_capacity);
+    ++m_modificationCount;
+    return loader.build(&m_index) || fail(loader.errorString());
+}
+
+bool BPlusTreeIterator::next()
+{
+    if (!m_tree || !m_loaded)
+        return false;
+
+    while (m_pos >= m_leaf.entries.size()) {
+        if (m_leaf.next == 0 || !m_tree->m_index.readNode(m_leaf.next, &m_leaf)) {
+            m_loaded = false;
+            return false;
+        }
+        m_pos = 0;
+    }
+
+    const IndexEntry &entry = m_leaf.entries.at(m_pos);
+    if (m_high && (entry.key > *m_high || (!m_highInclusive && entry.key == *m_high))) {
+        m_loaded = false;
+        return false;
+    }
+    m_current = entry;
+    ++m_pos;
+    return true;
+}
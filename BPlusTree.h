@@ -0,0 +1,115 @@
+#ifndef BPLUSTREE_H
+#define BPLUSTREE_H
+
+#include <QString>
+#include <optional>
+#include "IndexFile.h"
+#include "IndexBulkLoader.h"
+
+class BPlusTree;
+
+// Recorrido perezoso de un rango de claves: carga una hoja a la vez y sigue
+// el enlace a la hoja siguiente. Se invalida si el árbol se modifica.
+//
+//   BPlusTreeIterator it = tree.range(desde, hasta);
+//   while (it.next()) { it.key(); it.recordId(); }
+class BPlusTreeIterator {
+public:
+    BPlusTreeIterator() = default;
+
+    bool isValid() const { return m_tree != nullptr; }
+    bool next();
+    qint64 key() const { return m_current.key; }
+    RecordId recordId() const { return m_current.recordId(); }
+
+private:
+    friend class BPlusTree;
+
+    BPlusTree *m_tree = nullptr;
+    IndexNode m_leaf;
+    int m_pos = 0;
+    bool m_loaded = false;
+    std::optional<qint64> m_high;
+    bool m_highInclusive = true;
+    IndexEntry m_current;
+};
+
+// Árbol B+ en disco para índices secundarios (indexes/<tabla>.<campo>.bplus).
+//
+// Admite claves repetidas: cada entrada es (clave, registro). Todas las
+// entradas viven en las hojas, que están encadenadas en orden; los nodos
+// internos solo guardan separadores. Eso permite recorrer rangos
+// (BETWEEN, >=, <) leyendo hojas consecutivas.
+//
+// Con IndexFile::BStarTreeKind (indexes/<tabla>.<campo>.bstar) el mismo árbol
+// se comporta como B*: un nodo lleno primero reparte entradas con un hermano
+// y solo si ambos están llenos se dividen dos nodos en tres. Así todo nodo,
+// salvo la raíz y sus hijos directos, queda al menos 2/3 lleno.
+class BPlusTree {
+public:
+    BPlusTree() = default;
+
+    bool open(const QString &path, const QString &tableName, const QString &fieldName,
+              IndexFile::Kind kind = IndexFile::BPlusTreeKind);
+    void close() { m_index.close(); }
+    bool isOpen() const { return m_index.isOpen(); }
+    IndexFile::Kind kind() const { return m_index.kind(); }
+    bool isBStar() const { return m_index.kind() == IndexFile::BStarTreeKind; }
+
+    QString path() const { return m_index.path(); }
+    QString errorString() const { return m_error; }
+    QString fieldName() const { return m_index.fieldName(); }
+    bool setFieldName(const QString &fieldName);
+
+    quint64 size() const { return m_index.entryCount(); }
+    // Cambia con cada inserción, borrado o reconstrucción: los iteradores
+    // abiertos antes de un cambio ya no son válidos
+    quint64 modificationCount() const { return m_modificationCount; }
+    quint32 height() const { return m_index.height(); }
+    IndexStats statistics() { return m_index.statistics(); }
+
+    bool insert(qint64 key, RecordId rid);
+    bool remove(qint64 key, RecordId rid);
+
+    // Rango [low, high] (cada extremo opcional e inclusivo o no)
+    BPlusTreeIterator range(std::optional<qint64> low, std::optional<qint64> high,
+                            bool lowInclusive = true, bool highInclusive = true);
+    BPlusTreeIterator equal(qint64 key) { return range(key, key); }
+    BPlusTreeIterator all() { return range(std::nullopt, std::nullopt); }
+
+    bool clear();
+    bool sync() { return m_index.sync(); }
+    bool reloadHeader();
+    void setWriteAheadLog(WriteAheadLog *log) { m_index.setWriteAheadLog(log); }
+
+    // Reemplaza todo el contenido con las entradas del cargador (construcción de abajo hacia arriba)
+    bool bulkLoad(IndexBulkLoader &loader);
+
+    // Capacidad máxima por nodo (0 = lo que cabe en una página)
+    void setNodeCapacity(int maxEntries) { m_capacity = maxEntries; }
+
+private:
+    friend class BPlusTreeIterator;
+
+    int maxEntries(bool leaf) const;
+    int minEntries(bool leaf) const;
+    static int childFor(const IndexNode &node, const IndexEntry &entry);
+
+    // Un nodo que queda con más de maxEntries() no se escribe: lo resuelve el padre
+    bool insertInto(quint32 pageNo, const IndexEntry &entry, IndexNode *node);
+    bool handleOverflow(IndexNode &parent, int childIndex, const IndexNode &child);
+    bool removeFrom(quint32 pageNo, const IndexEntry &entry, bool *found);
+    bool fixChild(IndexNode &parent, int childIndex, bool *changed);
+
+    // Reparte el contenido de nodes (hijos consecutivos de parent desde first)
+    // en newCount nodos del mismo nivel y actualiza los separadores del padre
+    bool redistribute(IndexNode &parent, int first, const QVector<IndexNode> &nodes, int newCount);
+    bool fail(const QString &error);
+
+    IndexFile m_index;
+    int m_capacity = 0;
+    quint64 m_modificationCount = 0;
+    QString m_error;
+};
+
+#endif // BPLUSTREE_H
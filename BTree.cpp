@@ -0,0 +1,306 @@
+#include "BTree.h"
+
+#include <algorithm>
+
+bool BTree::open(const QString &path, const QString &tableName, const QString &fieldName)
+{
+    m_error.clear();
+    if (!m_index.open(path, IndexFile::BTreeKind, tableName, fieldName))
+        return fail(m_index.errorString());
+    return true;
+}
+
+int BTree::maxEntries(bool leaf) const
+{
+    const int pageMax = IndexFile::maxEntries(leaf);
+    return (m_capacity >= 3 && m_capacity < pageMax) ? m_capacity : pageMax;
+}
+
+bool BTree::fail(const QString &error)
+{
+    m_error = error;
+    return false;
+}
+
+std::optional<RecordId> BTree::find(qint64 key)
+{
+    IndexNode node;
+    quint32 pageNo = m_index.root();
+    const IndexEntry probe{ key, 0 };
+
+    while (pageNo != 0) {
+        if (!m_index.readNode(pageNo, &node)) {
+            m_error = m_index.errorString();
+            return std::nullopt;
+        }
+        const auto it = std::lower_bound(node.entries.cbegin(), node.entries.cend(), probe);
+        if (it != node.entries.cend() && it->key == key)
+            return it->recordId();
+        if (node.leaf)
+            return std::nullopt;
+        pageNo = node.children.at(int(it - node.entries.cbegin()));
+    }
+    return std::nullopt;
+}
+
+bool BTree::insert(qint64 key, RecordId rid)
+{
+    if (!isOpen())
+        return fail(QStringLiteral("El índice no está abierto"));
+    if (contains(key))
+        return fail(QStringLiteral("La clave %1 ya existe en el índice").arg(key));
+
+    const IndexEntry entry{ key, rid.toUInt64() };
+
+    // Árbol vacío: la raíz es una hoja
+    if (m_index.root() == 0) {
+        const quint32 root = m_index.allocateNode();
+        if (root == 0)
+            return fail(m_index.errorString());
+        IndexNode leaf;
+        leaf.entries.append(entry);
+        if (!m_index.writeNode(root, leaf))
+            return fail(m_index.errorString());
+        m_index.setRoot(root, 1);
+        m_index.setEntryCount(1);
+        return true;
+    }
+
+    std::optional<Split> split;
+    if (!insertInto(m_index.root(), entry, &split))
+        return false;
+
+    // La raíz se dividió: el árbol crece un nivel
+    if (split) {
+        const quint32 newRoot = m_index.allocateNode();
+        if (newRoot == 0)
+            return fail(m_index.errorString());
+        IndexNode root;
+        root.leaf = false;
+        root.entries.append(split->median);
+        root.children << m_index.root() << split->right;
+        if (!m_index.writeNode(newRoot, root))
+            return fail(m_index.errorString());
+        m_index.setRoot(newRoot, m_index.height() + 1);
+    }
+
+    m_index.setEntryCount(m_index.entryCount() + 1);
+    return true;
+}
+
+bool BTree::insertInto(quint32 pageNo, const IndexEntry &entry, std::optional<Split> *split)
+{
+    IndexNode node;
+    if (!m_index.readNode(pageNo, &node))
+        return fail(m_index.errorString());
+
+    const int pos = int(std::lower_bound(node.entries.cbegin(), node.entries.cend(), entry) - node.entries.cbegin());
+
+    if (node.leaf) {
+        node.entries.insert(pos, entry);
+    } else {
+        std::optional<Split> childSplit;
+        if (!insertInto(node.children.at(pos), entry, &childSplit))
+            return false;
+        if (!childSplit)
+            return true;
+        node.entries.insert(pos, childSplit->median);
+        node.children.insert(pos + 1, childSplit->right);
+    }
+
+    if (node.entries.size() <= maxEntries(node.leaf)) {
+        split->reset();
+        return m_index.writeNode(pageNo, node) || fail(m_index.errorString());
+    }
+
+    // Nodo lleno: la mediana sube al padre
+    const int mid = node.entries.size() / 2;
+    IndexNode right;
+    right.leaf = node.leaf;
+    right.entries = node.entries.mid(mid + 1);
+    if (!node.leaf)
+        right.children = node.children.mid(mid + 1);
+
+    Split result;
+    result.median = node.entries.at(mid);
+    node.entries.resize(mid);
+    if (!node.leaf)
+        node.children.resize(mid + 1);
+
+    result.right = m_index.allocateNode();
+    if (result.right == 0)
+        return fail(m_index.errorString());
+    if (!m_index.writeNode(pageNo, node) || !m_index.writeNode(result.right, right))
+        return fail(m_index.errorString());
+
+    *split = result;
+    return true;
+}
+
+bool BTree::remove(qint64 key, RecordId rid)
+{
+    if (!isOpen() || m_index.root() == 0)
+        return false;
+
+    bool found = false;
+    if (!removeFrom(m_index.root(), IndexEntry{ key, rid.toUInt64() }, &found))
+        return false;
+    if (!found)
+        return fail(QStringLiteral("La clave %1 no está en el índice").arg(key));
+
+    // Raíz interna sin entradas: su único hijo pasa a ser la raíz
+    IndexNode root;
+    if (!m_index.readNode(m_index.root(), &root))
+        return fail(m_index.errorString());
+    if (!root.leaf && root.entries.isEmpty()) {
+        const quint32 oldRoot = m_index.root();
+        m_index.setRoot(root.children.at(0), m_index.height() - 1);
+        m_index.freeNode(oldRoot);
+    } else if (root.leaf && root.entries.isEmpty()) {
+        m_index.freeNode(m_index.root());
+        m_index.setRoot(0, 0);
+    }
+
+    m_index.setEntryCount(m_index.entryCount() - 1);
+    return true;
+}
+
+bool BTree::removeFrom(quint32 pageNo, const IndexEntry &entry, bool *found)
+{
+    IndexNode node;
+    if (!m_index.readNode(pageNo, &node))
+        return fail(m_index.errorString());
+
+    const int pos = int(std::lower_bound(node.entries.cbegin(), node.entries.cend(), entry) - node.entries.cbegin());
+    const bool here = pos < node.entries.size() && node.entries.at(pos) == entry;
+
+    if (node.leaf) {
+        if (!here) {
+            *found = false;
+            return true;
+        }
+        node.entries.remove(pos);
+        *found = true;
+        return m_index.writeNode(pageNo, node) || fail(m_index.errorString());
+    }
+
+    if (here) {
+        // Entrada en nodo interno: se reemplaza por su predecesora, que se
+        // elimina luego de la hoja correspondiente
+        IndexEntry predecessor;
+        if (!maxEntry(node.children.at(pos), &predecessor))
+            return false;
+        node.entries[pos] = predecessor;
+        if (!m_index.writeNode(pageNo, node))
+            return fail(m_index.errorString());
+        bool removed = false;
+        if (!removeFrom(node.children.at(pos), predecessor, &removed))
+            return false;
+        *found = true;
+        return fixChild(pageNo, pos);
+    }
+
+    if (!removeFrom(node.children.at(pos), entry, found))
+        return false;
+    return !*found || fixChild(pageNo, pos);
+}
+
+bool BTree::maxEntry(quint32 pageNo, IndexEntry *entry)
+{
+    IndexNode node;
+    while (true) {
+        if (!m_index.readNode(pageNo, &node))
+            return fail(m_index.errorString());
+        if (node.leaf)
+            break;
+        pageNo = node.children.last();
+    }
+    if (node.entries.isEmpty())
+        return fail(QStringLiteral("Hoja vacía en el índice"));
+    *entry = node.entries.last();
+    return true;
+}
+
+bool BTree::fixChild(quint32 parentPage, int childIndex)
+{
+    IndexNode parent, child;
+    if (!m_index.readNode(parentPage, &parent)
+        || !m_index.readNode(parent.children.at(childIndex), &child))
+        return fail(m_index.errorString());
+
+    if (child.entries.size() >= minEntries(child.leaf))
+        return true;
+
+    const quint32 childPage = parent.children.at(childIndex);
+
+    // 1) Pedir prestado al hermano izquierdo
+    if (childIndex > 0) {
+        const quint32 leftPage = parent.children.at(childIndex - 1);
+        IndexNode left;
+        if (!m_index.readNode(leftPage, &left))
+            return fail(m_index.errorString());
+        if (left.entries.size() > minEntries(left.leaf)) {
+            child.entries.prepend(parent.entries.at(childIndex - 1));
+            parent.entries[childIndex - 1] = left.entries.takeLast();
+            if (!child.leaf)
+                child.children.prepend(left.children.takeLast());
+            return (m_index.writeNode(leftPage, left) && m_index.writeNode(childPage, child)
+                    && m_index.writeNode(parentPage, parent)) || fail(m_index.errorString());
+        }
+    }
+
+    // 2) Pedir prestado al hermano derecho
+    if (childIndex < parent.entries.size()) {
+        const quint32 rightPage = parent.children.at(childIndex + 1);
+        IndexNode right;
+        if (!m_index.readNode(rightPage, &right))
+            return fail(m_index.errorString());
+        if (right.entries.size() > minEntries(right.leaf)) {
+            child.entries.append(parent.entries.at(childIndex));
+            parent.entries[childIndex] = right.entries.takeFirst();
+            if (!child.leaf)
+                child.children.append(right.children.takeFirst());
+            return (m_index.writeNode(rightPage, right) && m_index.writeNode(childPage, child)
+                    && m_index.writeNode(parentPage, parent)) || fail(m_index.errorString());
+        }
+    }
+
+    // 3) Fusionar con un hermano (la entrada separadora baja del padre)
+    const int sep = childIndex > 0 ? childIndex - 1 : childIndex;
+    if (sep >= parent.entries.size())
+        return true; // padre sin hermanos: solo puede ser la raíz
+    const quint32 leftPage = parent.children.at(sep);
+    const quint32 rightPage = parent.children.at(sep + 1);
+    IndexNode left, right;
+    if (!m_index.readNode(leftPage, &left) || !m_index.readNode(rightPage, &right))
+        return fail(m_index.errorString());
+
+    left.entries.append(parent.entries.at(sep));
+    left.entries += right.entries;
+    left.children += right.children;
+    parent.entries.remove(sep);
+    parent.children.remove(sep + 1);
+
+    if (!m_index.writeNode(leftPage, left) || !m_index.writeNode(parentPage, parent))
+        return fail(m_index.errorString());
+    m_index.freeNode(rightPage);
+    return true;
+}
+
+bool BTree::clear()
+{
+    return m_index.clear() || fail(m_index.errorString());
+}
+
+bool BTree::reloadHeader()
+{
+    return m_index.reloadHeader() || fail(m_index.errorString());
+}
+
+bool BTree::bulkLoad(IndexBulkLoader &loader)
+{
+    if (!isOpen())
+        return fail(QStringLiteral("El índice no está abierto"));
+    loader.setNodeCapacity(m_capacity);
+    return loader.build(&m_index) || fail(loader.errorString());
+}
@@ -0,0 +1,70 @@
+#ifndef BTREE_H
+#define BTREE_H
+
+#include <QString>
+#include <optional>
+#include "IndexFile.h"
+#include "IndexBulkLoader.h"
+
+// Árbol B en disco para la llave primaria de una tabla
+// (indexes/<tabla>.<campo>.btree).
+//
+// Clave única qint64 → RecordId del registro en el .mad. Las entradas viven
+// tanto en nodos internos como en hojas; una búsqueda exacta lee a lo sumo
+// `height()` páginas.
+class BTree {
+public:
+    BTree() = default;
+
+    bool open(const QString &path, const QString &tableName, const QString &fieldName);
+    void close() { m_index.close(); }
+    bool isOpen() const { return m_index.isOpen(); }
+
+    QString path() const { return m_index.path(); }
+    QString errorString() const { return m_error; }
+    QString fieldName() const { return m_index.fieldName(); }
+
+    quint64 size() const { return m_index.entryCount(); }
+    quint64 sourceRecords() const { return m_index.sourceRecords(); }
+    void setSourceRecords(quint64 count) { m_index.setSourceRecords(count); }
+    quint32 height() const { return m_index.height(); }
+    IndexStats statistics() { return m_index.statistics(); }
+
+    // insert() falla si la clave ya existe
+    bool insert(qint64 key, RecordId rid);
+    bool remove(qint64 key, RecordId rid);
+    std::optional<RecordId> find(qint64 key);
+    bool contains(qint64 key) { return find(key).has_value(); }
+
+    bool clear();
+    bool sync() { return m_index.sync(); }
+    bool reloadHeader();
+    void setWriteAheadLog(WriteAheadLog *log) { m_index.setWriteAheadLog(log); }
+
+    // Reemplaza todo el contenido con las entradas del cargador (construcción de abajo hacia arriba)
+    bool bulkLoad(IndexBulkLoader &loader);
+
+    // Capacidad máxima por nodo (0 = lo que cabe en una página)
+    void setNodeCapacity(int maxEntries) { m_capacity = maxEntries; }
+
+private:
+    struct Split {
+        IndexEntry median;
+        quint32 right = 0;
+    };
+
+    int maxEntries(bool leaf) const;
+    int minEntries(bool leaf) const { return maxEntries(leaf) / 2; }
+
+    bool insertInto(quint32 pageNo, const IndexEntry &entry, std::optional<Split> *split);
+    bool removeFrom(quint32 pageNo, const IndexEntry &entry, bool *found);
+    bool maxEntry(quint32 pageNo, IndexEntry *entry);
+    bool fixChild(quint32 parentPage, int childIndex);
+    bool fail(const QString &error);
+
+    IndexFile m_index;
+    int m_capacity = 0;
+    QString m_error;
+};
+
+#endif // BTREE_H
@@ -0,0 +1,217 @@
+#include "BufferPool.h"
+#include "PagedFile.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+
+static_assert(PagedFile::PageSize == 8192, "BufferPool asume páginas de 8 KB");
+
+BufferPool &BufferPool::instance()
+{
+    static BufferPool pool;
+    return pool;
+}
+
+BufferPool::BufferPool()
+    : m_capacity(static_cast<int>(DefaultMemoryBudget / PageSizeBytes))
+{
+}
+
+quint64 BufferPool::keyFor(const PagedFile *file, quint32 pageNo)
+{
+    return (quint64(file->m_poolId) << 32) | pageNo;
+}
+
+quint32 BufferPool::registerFile()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_nextFileId++;
+}
+
+bool BufferPool::setMemoryBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    for (const Frame &frame : qAsConst(m_frames)) {
+        if (frame.used && frame.pinCount > 0) {
+            qDebug() << "WARNING: No se puede cambiar el tamaño de la caché con páginas fijadas";
+            return false;
+        }
+    }
+    for (Frame &frame : m_frames) {
+        if (frame.used && frame.dirty && !writeBack(frame))
+            return false;
+    }
+
+    // Al menos unas cuantas páginas: un recorrido de árbol fija la ruta completa
+    m_capacity = static_cast<int>(qMax<qint64>(16, bytes / PageSizeBytes));
+    m_arena.clear();
+    m_frames.clear();
+    m_table.clear();
+    m_clockHand = 0;
+    qDebug() << "DEBUG: Caché de páginas:" << m_capacity << "páginas," << (qint64(m_capacity) * PageSizeBytes) << "bytes";
+    return true;
+}
+
+qint64 BufferPool::memoryBudget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return qint64(m_capacity) * PageSizeBytes;
+}
+
+int BufferPool::frameCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_capacity;
+}
+
+char *BufferPool::pin(PagedFile *file, quint32 pageNo, bool overwrite)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // La memoria se reserva una sola vez, la primera vez que se usa
+    if (m_frames.isEmpty()) {
+        m_arena.resize(qint64(m_capacity) * PageSizeBytes);
+        m_frames.resize(m_capacity);
+    }
+
+    const quint64 key = keyFor(file, pageNo);
+    const auto found = m_table.constFind(key);
+    if (found != m_table.constEnd()) {
+        Frame &frame = m_frames[found.value()];
+        frame.pinCount++;
+        frame.referenced = true;
+        m_hits++;
+        return frameData(found.value());
+    }
+
+    m_misses++;
+    const int index = findVictim();
+    if (index < 0) {
+        qDebug() << "ERROR: Caché de páginas llena: todas las páginas están fijadas";
+        return nullptr;
+    }
+
+    Frame &frame = m_frames[index];
+    if (frame.used) {
+        if (frame.dirty && !writeBack(frame))
+            return nullptr;
+        m_table.remove(keyFor(frame.file, frame.pageNo));
+        frame.used = false;
+        m_evictions++;
+    }
+
+    char *data = frameData(index);
+    if (!overwrite && !file->readFromDisk(pageNo, data))
+        return nullptr;
+
+    frame.file = file;
+    frame.pageNo = pageNo;
+    frame.pinCount = 1;
+    frame.used = true;
+    frame.dirty = false;
+    frame.referenced = true;
+    m_table.insert(key, index);
+    return data;
+}
+
+void BufferPool::unpin(PagedFile *file, quint32 pageNo, bool dirty)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto found = m_table.constFind(keyFor(file, pageNo));
+    if (found == m_table.constEnd()) {
+        qDebug() << "WARNING: unpin de una página que no está en la caché:" << pageNo;
+        return;
+    }
+    Frame &frame = m_frames[found.value()];
+    if (frame.pinCount > 0)
+        frame.pinCount--;
+    if (dirty)
+        frame.dirty = true;
+}
+
+bool BufferPool::flush(PagedFile *file)
+{
+    QMutexLocker locker(&m_mutex);
+    bool ok = true;
+    for (Frame &frame : m_frames) {
+        if (frame.used && frame.dirty && (!file || frame.file == file))
+            ok = writeBack(frame) && ok;
+    }
+    return ok;
+}
+
+void BufferPool::discard(PagedFile *file, quint32 firstPage)
+{
+    QMutexLocker locker(&m_mutex);
+    for (Frame &frame : m_frames) {
+        if (!frame.used || frame.file != file || frame.pageNo < firstPage)
+            continue;
+        if (frame.pinCount > 0)
+            qDebug() << "WARNING: Se descarta una página fijada:" << file->path() << frame.pageNo;
+        m_table.remove(keyFor(frame.file, frame.pageNo));
+        frame = Frame();
+    }
+}
+
+int BufferPool::findVictim()
+{
+    // Reloj: una página referenciada recibe una segunda oportunidad; dos
+    // vueltas completas sin candidato significan que todo está fijado
+    for (int step = 0; step < 2 * m_capacity; ++step) {
+        const int index = m_clockHand;
+        m_clockHand = (m_clockHand + 1) % m_capacity;
+
+        Frame &frame = m_frames[index];
+        if (!frame.used)
+            return index;
+        if (frame.pinCount > 0)
+            continue;
+        if (frame.referenced) {
+            frame.referenced = false;
+            continue;
+        }
+        return index;
+    }
+    return -1;
+}
+
+bool BufferPool::writeBack(Frame &frame)
+{
+    const int index = static_cast<int>(&frame - m_frames.data());
+    if (!frame.file->writeToDisk(frame.pageNo, frameData(index))) {
+        qDebug() << "ERROR: No se pudo escribir la página" << frame.pageNo << "de" << frame.file->path()
+                 << ":" << frame.file->errorString();
+        return false;
+    }
+    frame.dirty = false;
+    return true;
+}
+
+quint64 BufferPool::hits() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+quint64 BufferPool::misses() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+quint64 BufferPool::evictions() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_evictions;
+}
+
+int BufferPool::dirtyCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    int count = 0;
+    for (const Frame &frame : m_frames) {
+        if (frame.used && frame.dirty)
+            count++;
+    }
+    return count;
+}
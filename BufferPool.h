@@ -0,0 +1,85 @@
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+
+class PagedFile;
+
+// Caché de páginas compartida por todos los archivos paginados del proceso
+// (tablas .mad e índices B/B+/B*). Tiene un presupuesto fijo de memoria:
+// cuando se llena, el algoritmo del reloj (segunda oportunidad) elige una
+// página no fijada para desalojar, escribiéndola antes si está modificada.
+//
+// PagedFile::readPage/writePage pasan por aquí, así que las búsquedas
+// repetidas sobre una tabla o un índice se resuelven en memoria y el uso
+// total no depende de cuántas tablas tenga el proyecto.
+//
+// pin() devuelve el búfer de la página y garantiza que no se desaloje hasta
+// el unpin() correspondiente; unpin(..., true) la marca como modificada.
+class BufferPool {
+public:
+    static constexpr qint64 DefaultMemoryBudget = 32 * 1024 * 1024;
+
+    static BufferPool &instance();
+
+    // Cambia el presupuesto (en bytes). Escribe las páginas modificadas y vacía
+    // la caché; falla si hay páginas fijadas.
+    bool setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const;
+    int frameCount() const;
+
+    // Identificador único para cada PagedFile (parte de la clave de la caché)
+    quint32 registerFile();
+
+    // overwrite = true: quien llama va a escribir la página completa, no hace falta leerla
+    char *pin(PagedFile *file, quint32 pageNo, bool overwrite = false);
+    void unpin(PagedFile *file, quint32 pageNo, bool dirty);
+
+    // Escribe las páginas modificadas de un archivo (o de todos con nullptr)
+    bool flush(PagedFile *file = nullptr);
+    // Olvida las páginas de un archivo desde firstPage (sin escribirlas)
+    void discard(PagedFile *file, quint32 firstPage = 0);
+
+    // Estadísticas
+    quint64 hits() const;
+    quint64 misses() const;
+    quint64 evictions() const;
+    int dirtyCount() const;
+
+private:
+    BufferPool();
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    struct Frame {
+        PagedFile *file = nullptr;
+        quint32 pageNo = 0;
+        int pinCount = 0;
+        bool used = false;
+        bool dirty = false;
+        bool referenced = false;
+    };
+
+    static quint64 keyFor(const PagedFile *file, quint32 pageNo);
+    int findVictim();
+    bool writeBack(Frame &frame);
+    char *frameData(int index) { return m_arena.data() + qint64(index) * PageSizeBytes; }
+
+    static constexpr int PageSizeBytes = 8192;
+
+    mutable QMutex m_mutex;
+    int m_capacity;
+    QByteArray m_arena;
+    QVector<Frame> m_frames;
+    QHash<quint64, int> m_table;   // (id del archivo, página) → marco
+    int m_clockHand = 0;
+    quint32 m_nextFileId = 1;
+    quint64 m_hits = 0;
+    quint64 m_misses = 0;
+    quint64 m_evictions = 0;
+};
+
+#endif // BUFFERPOOL_H
@@ -0,0 +1,274 @@
+#include "ColumnTable.h"
+#include "Currency.h"
+#include "CompactDate.h"
+
+#include <QLocale>
+#include <QtAlgorithms>
+#include <limits>
+
+// --- BitVector ---
+
+void BitVector::append(bool bit)
+{
+    if ((m_size & 63) == 0)
+        m_words.append(0);
+    if (bit)
+        m_words[m_size >> 6] |= quint64(1) << (m_size & 63);
+    m_size++;
+}
+
+int BitVector::count() const
+{
+    int total = 0;
+    for (quint64 word : m_words)
+        total += int(qPopulationCount(word));
+    return total;
+}
+
+// --- TypedColumn ---
+
+TypedColumn::TypedColumn(const QString &fieldType)
+    : m_kind(kindForType(fieldType))
+{
+}
+
+TypedColumn::Kind TypedColumn::kindForType(const QString &fieldType)
+{
+    if (fieldType == "Entero") return IntegerColumn;
+    if (fieldType == "Decimales") return DecimalColumn;
+    if (fieldType == "moneda") return CurrencyColumn;
+    if (fieldType == "Sí / No") return BooleanColumn;
+    if (fieldType == "fecha") return DateColumn;
+    return TextColumn;
+}
+
+void TypedColumn::append(const QString &value)
+{
+    const int row = size();
+    if (!value.isEmpty() && appendTyped(value)) {
+        m_valid.append(true);
+        return;
+    }
+
+    // Sin valor: se guarda un 0 para que los arreglos sigan alineados por fila
+    appendEmpty();
+    if (!value.isEmpty())
+        m_rawValues.insert(row, value);
+    m_valid.append(false);
+}
+
+bool TypedColumn::appendTyped(const QString &value)
+{
+    // Solo se tipa el valor si al volver a texto queda exactamente igual
+    switch (m_kind) {
+    case IntegerColumn: {
+        bool ok = false;
+        const qint64 number = value.toLongLong(&ok);
+        if (!ok || QString::number(number) != value)
+            return false;
+        const bool fits = number >= std::numeric_limits<qint32>::min()
+                          && number <= std::numeric_limits<qint32>::max();
+        if (!m_wide && !fits)
+            widen();
+        if (m_wide)
+            m_int64.append(number);
+        else
+            m_int32.append(qint32(number));
+        return true;
+    }
+    case DecimalColumn: {
+        bool ok = false;
+        const double number = value.toDouble(&ok);
+        if (!ok || QString::number(number, 'g', QLocale::FloatingPointShortest) != value)
+            return false;
+        m_doubles.append(number);
+        return true;
+    }
+    case CurrencyColumn: {
+        const std::optional<Currency> amount = Currency::parse(value);
+        if (!amount || !amount->isFormatted(value))
+            return false;
+        m_int64.append(amount->cents());
+        return true;
+    }
+    case BooleanColumn:
+        if (value != QStringLiteral("Sí") && value != QStringLiteral("No"))
+            return false;
+        m_bits.append(value == QStringLiteral("Sí"));
+        return true;
+    case DateColumn: {
+        const std::optional<CompactDate> date = CompactDate::parse(value, CompactDate::StorageFormat);
+        if (!date || !date->isFormatted(value))
+            return false;
+        m_int32.append(date->day());
+        return true;
+    }
+    case TextColumn: {
+        const auto it = m_dictionaryIndex.constFind(value);
+        if (it != m_dictionaryIndex.constEnd()) {
+            m_codes.append(*it);
+            return true;
+        }
+        const quint32 code = quint32(m_dictionary.size());
+        m_dictionaryIndex.insert(value, code);
+        m_dictionary.append(value);
+        m_codes.append(code);
+        return true;
+    }
+    }
+    return false;
+}
+
+void TypedColumn::appendEmpty()
+{
+    switch (m_kind) {
+    case IntegerColumn:
+        if (m_wide) m_int64.append(0);
+        else m_int32.append(0);
+        break;
+    case DecimalColumn:  m_doubles.append(0.0); break;
+    case CurrencyColumn: m_int64.append(0); break;
+    case BooleanColumn:  m_bits.append(false); break;
+    case DateColumn:     m_int32.append(0); break;
+    case TextColumn:     m_codes.append(0); break;
+    }
+}
+
+void TypedColumn::widen()
+{
+    // Un Entero que no cabe en 32 bits: toda la columna pasa a qint64
+    m_int64.reserve(m_int32.size() + 1);
+    for (qint32 number : qAsConst(m_int32))
+        m_int64.append(number);
+    m_int32 = QVector<qint32>();
+    m_wide = true;
+}
+
+qint64 TypedColumn::intAt(int row) const
+{
+    switch (m_kind) {
+    case IntegerColumn:  return m_wide ? m_int64.at(row) : m_int32.at(row);
+    case CurrencyColumn: return m_int64.at(row);
+    case DateColumn:     return m_int32.at(row);
+    case DecimalColumn:  return qint64(m_doubles.at(row));
+    case BooleanColumn:  return m_bits.at(row) ? 1 : 0;
+    case TextColumn:     return 0;
+    }
+    return 0;
+}
+
+double TypedColumn::doubleAt(int row) const
+{
+    switch (m_kind) {
+    case DecimalColumn:  return m_doubles.at(row);
+    case CurrencyColumn: return m_int64.at(row) / 100.0;
+    default:             return double(intAt(row));
+    }
+}
+
+QString TypedColumn::text(int row) const
+{
+    if (!m_valid.at(row))
+        return m_rawValues.value(row);
+
+    switch (m_kind) {
+    case IntegerColumn:  return QString::number(intAt(row));
+    case DecimalColumn:  return QString::number(m_doubles.at(row), 'g', QLocale::FloatingPointShortest);
+    case CurrencyColumn: return Currency(m_int64.at(row)).toString();
+    case BooleanColumn:  return m_bits.at(row) ? QStringLiteral("Sí") : QStringLiteral("No");
+    case DateColumn:     return CompactDate(m_int32.at(row)).toString();
+    case TextColumn:     return m_dictionary.at(int(m_codes.at(row)));
+    }
+    return QString();
+}
+
+qint64 TypedColumn::sumInt() const
+{
+    // Las filas sin valor guardan 0: se suma el arreglo completo, sin saltos
+    qint64 total = 0;
+    switch (m_kind) {
+    case IntegerColumn:
+        if (m_wide) {
+            for (qint64 number : m_int64) total += number;
+        } else {
+            for (qint32 number : m_int32) total += number;
+        }
+        return total;
+    case CurrencyColumn:
+        for (qint64 cents : m_int64) total += cents;
+        return total;
+    case BooleanColumn:
+        return countTrue();
+    case DecimalColumn:
+        return qint64(sumDouble());
+    default:
+        return 0;
+    }
+}
+
+double TypedColumn::sumDouble() const
+{
+    if (m_kind == DecimalColumn) {
+        double total = 0.0;
+        for (double number : m_doubles) total += number;
+        return total;
+    }
+    if (m_kind == CurrencyColumn)
+        return sumInt() / 100.0;
+    return double(sumInt());
+}
+
+int TypedColumn::countTrue() const
+{
+    return m_kind == BooleanColumn ? m_bits.count() : 0;
+}
+
+qint64 TypedColumn::memoryBytes() const
+{
+    qint64 bytes = m_valid.memoryBytes() + m_bits.memoryBytes()
+                   + qint64(m_int32.capacity()) * sizeof(qint32)
+                   + qint64(m_int64.capacity()) * sizeof(qint64)
+                   + qint64(m_doubles.capacity()) * sizeof(double)
+                   + qint64(m_codes.capacity()) * sizeof(quint32);
+    // Cada valor distinto una sola vez (más su entrada en el índice del diccionario)
+    for (const QString &value : m_dictionary)
+        bytes += 2 * (qint64(value.size()) * sizeof(QChar) + 32);
+    for (const QString &value : m_rawValues)
+        bytes += qint64(value.size()) * sizeof(QChar) + 32;
+    return bytes;
+}
+
+// --- ColumnTable ---
+
+ColumnTable::ColumnTable(const QStringList &fieldNames, const QStringList &fieldTypes)
+    : m_fieldNames(fieldNames)
+    , m_fieldTypes(fieldTypes)
+{
+    m_columns.reserve(fieldNames.size());
+    for (int col = 0; col < fieldNames.size(); col++)
+        m_columns.append(TypedColumn(fieldTypes.value(col)));
+}
+
+void ColumnTable::appendRow(const QStringList &values)
+{
+    for (int col = 0; col < m_columns.size(); col++)
+        m_columns[col].append(values.value(col));
+    m_rowCount++;
+}
+
+QStringList ColumnTable::rowValues(int row) const
+{
+    QStringList values;
+    values.reserve(m_columns.size());
+    for (const TypedColumn &column : m_columns)
+        values << column.text(row);
+    return values;
+}
+
+qint64 ColumnTable::memoryBytes() const
+{
+    qint64 bytes = 0;
+    for (const TypedColumn &column : m_columns)
+        bytes += column.memoryBytes();
+    return bytes;
+}
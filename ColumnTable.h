@@ -0,0 +1,130 @@
+#ifndef COLUMNTABLE_H
+#define COLUMNTABLE_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Vector de bits empaquetado en palabras de 64 bits
+class BitVector {
+public:
+    int size() const { return m_size; }
+    void append(bool bit);
+    bool at(int i) const { return (m_words.at(i >> 6) >> (i & 63)) & 1; }
+    int count() const;                      // bits en 1
+    const QVector<quint64> &words() const { return m_words; }
+    qint64 memoryBytes() const { return qint64(m_words.capacity()) * sizeof(quint64); }
+
+private:
+    QVector<quint64> m_words;
+    int m_size = 0;
+};
+
+// Una columna de la tabla con los valores en su tipo nativo, contiguos en memoria.
+//
+//   "Entero"    → qint32 (pasa a qint64 cuando aparece un valor que no cabe)
+//   "Decimales" → double
+//   "moneda"    → centavos en qint64
+//   "Sí / No"   → un bit por fila
+//   "fecha"     → número de día (juliano) en qint32, ver CompactDate
+//   texto       → código de diccionario en quint32 + diccionario de valores distintos
+//
+// Cada fila tiene un bit de validez. Las celdas vacías no tienen valor; las
+// que no se pueden representar sin cambiar el texto (p. ej. "012" en un
+// Entero, o un texto cualquiera en una fecha) se guardan tal cual aparte,
+// así que text() devuelve siempre el texto original.
+class TypedColumn {
+public:
+    enum Kind {
+        IntegerColumn,
+        DecimalColumn,
+        CurrencyColumn,
+        BooleanColumn,
+        DateColumn,
+        TextColumn
+    };
+
+    explicit TypedColumn(const QString &fieldType = QString());
+
+    static Kind kindForType(const QString &fieldType);
+    Kind kind() const { return m_kind; }
+    int size() const { return m_valid.size(); }
+
+    void append(const QString &value);
+    QString text(int row) const;
+
+    bool isValid(int row) const { return m_valid.at(row); }
+    int validCount() const { return m_valid.count(); }
+    const BitVector &validity() const { return m_valid; }
+
+    // Valores por fila (solo si isValid(row)); las filas sin valor guardan 0
+    qint64 intAt(int row) const;             // Entero, moneda (centavos), fecha (día)
+    double doubleAt(int row) const;          // Decimales (o cualquier numérico)
+    bool boolAt(int row) const { return m_bits.at(row); }
+    quint32 codeAt(int row) const { return m_codes.at(row); }
+
+    // Arreglos contiguos para los recorridos (agregados y filtros)
+    bool isWide() const { return m_wide; }
+    const QVector<qint32> &int32Values() const { return m_int32; }  // Entero angosto, fecha
+    const QVector<qint64> &int64Values() const { return m_int64; }  // Entero ancho, moneda
+    const QVector<double> &doubleValues() const { return m_doubles; }
+    const BitVector &boolValues() const { return m_bits; }
+    const QVector<quint32> &codes() const { return m_codes; }
+    const QStringList &dictionary() const { return m_dictionary; }
+
+    // Agregados sobre las filas válidas
+    qint64 sumInt() const;
+    double sumDouble() const;
+    int countTrue() const;
+
+    qint64 memoryBytes() const;
+
+private:
+    bool appendTyped(const QString &value);
+    void appendEmpty();
+    void widen();
+
+    Kind m_kind;
+    BitVector m_valid;
+    bool m_wide = false;
+    QVector<qint32> m_int32;
+    QVector<qint64> m_int64;
+    QVector<double> m_doubles;
+    BitVector m_bits;
+    QVector<quint32> m_codes;
+    QStringList m_dictionary;
+    QHash<QString, quint32> m_dictionaryIndex;
+    QHash<int, QString> m_rawValues;        // fila → texto que no se pudo tipar
+};
+
+// Filas de una tabla guardadas por columnas según los tipos de sus campos.
+class ColumnTable {
+public:
+    ColumnTable() = default;
+    ColumnTable(const QStringList &fieldNames, const QStringList &fieldTypes);
+
+    QStringList fieldNames() const { return m_fieldNames; }
+    QStringList fieldTypes() const { return m_fieldTypes; }
+    int rowCount() const { return m_rowCount; }
+    int columnCount() const { return m_columns.size(); }
+    bool isEmpty() const { return m_rowCount == 0; }
+
+    // Los valores faltantes quedan vacíos; los sobrantes se ignoran
+    void appendRow(const QStringList &values);
+    QStringList rowValues(int row) const;
+    QString text(int row, int column) const { return m_columns.at(column).text(row); }
+
+    const TypedColumn &column(int column) const { return m_columns.at(column); }
+    int columnIndex(const QString &fieldName) const { return m_fieldNames.indexOf(fieldName); }
+
+    qint64 memoryBytes() const;
+
+private:
+    QStringList m_fieldNames;
+    QStringList m_fieldTypes;
+    QVector<TypedColumn> m_columns;
+    int m_rowCount = 0;
+};
+
+#endif // COLUMNTABLE_H
@@ -0,0 +1,184 @@
+#include "CompactDate.h"
+
+namespace {
+
+// Disposición de cada formato, en el orden de CompactDate::Format
+struct Layout {
+    char separator;
+    int yearDigits;
+    bool monthName;
+};
+constexpr Layout Layouts[] = {
+    { '-', 4, false },   // StorageFormat
+    { '-', 2, false },   // DashShortFormat
+    { '/', 2, false },   // SlashShortFormat
+    { '/', 4, true  }    // MonthNameFormat
+};
+
+const char *const MonthNames[] = {
+    "Enero", "Febrero", "Marzo", "Abril", "Mayo", "Junio",
+    "Julio", "Agosto", "Septiembre", "Octubre", "Noviembre", "Diciembre"
+};
+
+enum MonthMode {
+    MonthDigits,
+    MonthText,
+    MonthEither
+};
+
+// Número de 1 a maxDigits dígitos ASCII; -1 si hay otra cosa
+int parseNumber(const QChar *chars, int length, int maxDigits)
+{
+    if (length < 1 || length > maxDigits)
+        return -1;
+    int value = 0;
+    for (int i = 0; i < length; ++i) {
+        const ushort c = chars[i].unicode();
+        if (c < '0' || c > '9')
+            return -1;
+        value = value * 10 + (c - '0');
+    }
+    return value;
+}
+
+// Mes en texto, sin distinguir mayúsculas; 0 si no es un mes
+int parseMonthName(const QChar *chars, int length)
+{
+    for (int month = 0; month < 12; ++month) {
+        const char *name = MonthNames[month];
+        int i = 0;
+        while (i < length && name[i] && chars[i].toLower() == QLatin1Char(name[i]).toLower())
+            ++i;
+        if (i == length && !name[i])
+            return month + 1;
+    }
+    return 0;
+}
+
+std::optional<CompactDate> parseParts(const QString &text, QChar separator, int yearDigits, MonthMode monthMode)
+{
+    const QChar *chars = text.constData();
+    int begin = 0;
+    int end = text.size();
+    while (begin < end && chars[begin].isSpace()) begin++;
+    while (end > begin && chars[end - 1].isSpace()) end--;
+
+    // Exactamente dos separadores
+    int first = -1;
+    int second = -1;
+    for (int i = begin; i < end; ++i) {
+        if (chars[i] != separator) continue;
+        if (first < 0) first = i;
+        else if (second < 0) second = i;
+        else return std::nullopt;
+    }
+    if (second < 0)
+        return std::nullopt;
+
+    // Año de 4 dígitos solo si el último tramo mide 4; si no, de 2
+    if (yearDigits == 0)
+        yearDigits = (end - second - 1) == 4 ? 4 : 2;
+    if (end - second - 1 != yearDigits)
+        return std::nullopt;
+
+    const int day = parseNumber(chars + begin, first - begin, 2);
+    int month = -1;
+    if (monthMode != MonthText)
+        month = parseNumber(chars + first + 1, second - first - 1, 2);
+    if (month < 0 && monthMode != MonthDigits)
+        month = parseMonthName(chars + first + 1, second - first - 1);
+    int year = parseNumber(chars + second + 1, yearDigits, yearDigits);
+    if (day < 0 || month <= 0 || year < 0)
+        return std::nullopt;
+    if (yearDigits == 2)
+        year += 1900;
+    return CompactDate::fromYmd(year, month, day);
+}
+
+int writeNumber(QChar *buffer, int value, int digits)
+{
+    for (int i = digits - 1; i >= 0; --i) {
+        buffer[i] = QLatin1Char(char('0' + value % 10));
+        value /= 10;
+    }
+    return digits;
+}
+
+} // namespace
+
+std::optional<CompactDate> CompactDate::fromQDate(const QDate &date)
+{
+    if (!date.isValid())
+        return std::nullopt;
+    return CompactDate(qint32(date.toJulianDay()));
+}
+
+std::optional<CompactDate> CompactDate::fromYmd(int year, int month, int day)
+{
+    return fromQDate(QDate(year, month, day));
+}
+
+std::optional<CompactDate> CompactDate::parse(const QString &text)
+{
+    const QChar separator = text.contains(QLatin1Char('/')) ? QLatin1Char('/')
+                          : (text.contains(QLatin1Char('-')) ? QLatin1Char('-') : QChar());
+    if (separator.isNull())
+        return std::nullopt;
+    return parseParts(text, separator, 0, separator == QLatin1Char('/') ? MonthEither : MonthDigits);
+}
+
+std::optional<CompactDate> CompactDate::parse(const QString &text, Format format)
+{
+    const Layout &layout = Layouts[format];
+    return parseParts(text, QLatin1Char(layout.separator), layout.yearDigits,
+                      layout.monthName ? MonthText : MonthDigits);
+}
+
+CompactDate::Format CompactDate::formatFromName(const QString &name)
+{
+    if (name == QLatin1String("DD-MM-YY")) return DashShortFormat;
+    if (name == QLatin1String("DD/MM/YY")) return SlashShortFormat;
+    if (name == QLatin1String("DD/MESTEXTO/YYYY")) return MonthNameFormat;
+    return StorageFormat;
+}
+
+int CompactDate::format(QChar *buffer, Format format) const
+{
+    const Layout &layout = Layouts[format];
+    const QDate date = toQDate();
+    const QChar separator = QLatin1Char(layout.separator);
+
+    int pos = writeNumber(buffer, date.day(), 2);
+    buffer[pos++] = separator;
+    if (layout.monthName) {
+        for (const char *name = MonthNames[date.month() - 1]; *name; ++name)
+            buffer[pos++] = QLatin1Char(*name);
+    } else {
+        pos += writeNumber(buffer + pos, date.month(), 2);
+    }
+    buffer[pos++] = separator;
+    const int year = date.year();
+    pos += layout.yearDigits == 2 ? writeNumber(buffer + pos, year % 100, 2)
+                                  : writeNumber(buffer + pos, qBound(0, year, 9999), 4);
+    return pos;
+}
+
+QString CompactDate::toString(Format format) const
+{
+    QChar buffer[MaxFormattedLength];
+    const int length = this->format(buffer, format);
+    return QString(buffer, length);
+}
+
+bool CompactDate::isFormatted(const QString &text, Format format) const
+{
+    QChar buffer[MaxFormattedLength];
+    const int length = this->format(buffer, format);
+    if (text.size() != length)
+        return false;
+    const QChar *chars = text.constData();
+    for (int i = 0; i < length; ++i) {
+        if (chars[i] != buffer[i]) return false;
+    }
+    return true;
+}
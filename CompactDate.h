@@ -0,0 +1,60 @@
+#ifndef COMPACTDATE_H
+#define COMPACTDATE_H
+
+#include <QDate>
+#include <QString>
+#include <optional>
+
+// Fecha de un campo "fecha" como número de día (juliano, igual que QDate::toJulianDay).
+//
+// Ordenar y comparar fechas es comparar enteros; el mismo número es la clave
+// de los índices por rango y el valor de las columnas en memoria.
+//
+// Cada formato tiene su disposición fija (separador, largo del año, mes en
+// número o en texto), así que parse() y format() no arman cadenas de formato
+// ni pasan por QDate::fromString; format() escribe en un búfer del llamador.
+class CompactDate
+{
+public:
+    enum Format {
+        StorageFormat,      // dd-MM-aaaa: como se guardan los valores
+        DashShortFormat,    // DD-MM-YY
+        SlashShortFormat,   // DD/MM/YY
+        MonthNameFormat     // DD/MESTEXTO/YYYY
+    };
+
+    static constexpr int MaxFormattedLength = 24;
+
+    constexpr CompactDate() = default;
+    explicit constexpr CompactDate(qint32 day) : m_day(day) {}
+
+    constexpr qint32 day() const { return m_day; }
+    QDate toQDate() const { return QDate::fromJulianDay(m_day); }
+    static std::optional<CompactDate> fromQDate(const QDate &date);
+    static std::optional<CompactDate> fromYmd(int year, int month, int day);
+
+    // Mismo criterio que la vista de datos: separador '/' o '-', año de 4 o
+    // de 2 dígitos (siglo 1900, como QDate::fromString en Qt 5). Con '/' el
+    // mes también puede venir en texto ("15/Agosto/2024").
+    static std::optional<CompactDate> parse(const QString &text);
+    static std::optional<CompactDate> parse(const QString &text, Format format);
+
+    // Formatos de TableView (combo "Formato" de fecha)
+    static Format formatFromName(const QString &name);
+
+    // Devuelve la cantidad de caracteres escritos en buffer (MaxFormattedLength como mínimo)
+    int format(QChar *buffer, Format format = StorageFormat) const;
+    QString toString(Format format = StorageFormat) const;
+
+    // text ya es exactamente toString(format)
+    bool isFormatted(const QString &text, Format format = StorageFormat) const;
+
+    constexpr bool operator==(CompactDate other) const { return m_day == other.m_day; }
+    constexpr bool operator!=(CompactDate other) const { return m_day != other.m_day; }
+    constexpr bool operator<(CompactDate other) const { return m_day < other.m_day; }
+
+private:
+    qint32 m_day = 0;
+};
+
+#endif // COMPACTDATE_H
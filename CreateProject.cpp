@@ -3,7 +3,174 @@
 #include "ThemeTokens.h"
 #include "mainwindow.h"
 #include "projectpathsqt.h"
+#include "ProjectCatalog.h"
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QPainter>
+#include <QPainterPath>
+
+// --- ProjectCardDelegate ---
+
+namespace {
+// Sombra suave bajo la tarjeta: unas pocas capas translúcidas en lugar de un
+// QGraphicsDropShadowEffect por tarjeta
+void paintCardShadow(QPainter *painter, const QRectF &card, qreal radius, bool isDark)
+{
+    const int baseAlpha = isDark ? 24 : 8;
+    painter->setPen(Qt::NoPen);
+    for (int layer = 3; layer >= 1; --layer) {
+        const qreal grow = layer * 2.0;
+        painter->setBrush(QColor(0, 0, 0, baseAlpha * (4 - layer)));
+        painter->drawRoundedRect(card.translated(0, 4).adjusted(-grow, -grow + 2, grow, grow),
+                                 radius + grow, radius + grow);
+    }
+}
+
+QString tableCountText(int tableCount)
+{
+    return tableCount == 1 ? QString("1 tabla") : QString("%1 tablas").arg(tableCount);
+}
+} // namespace
+
+ProjectCardDelegate::ProjectCardDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+    , m_gridIconFont("System", 32)
+    , m_gridNameFont("Inter", 16, QFont::Bold)
+    , m_listIconFont("System", 24)
+    , m_listNameFont("Inter", 15, QFont::Medium)
+    , m_detailFont("Inter", 13)
+    , m_dateFont("Inter", 12)
+    , m_arrowFont("Inter", 16)
+{
+}
+
+QSize ProjectCardDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(option);
+    Q_UNUSED(index);
+    // En lista la vista estira cada fila al ancho disponible
+    if (m_mode == GridMode)
+        return QSize(GridCardWidth + 2 * ShadowMargin, GridCardHeight + 2 * ShadowMargin);
+    return QSize(GridCardWidth, ListItemHeight);
+}
+
+void ProjectCardDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                                const QModelIndex &index) const
+{
+    const bool isDark = ThemeManager::instance().isDark();
+    const bool hovered = option.state & QStyle::State_MouseOver;
+    const qreal radius = m_mode == GridMode ? 16 : 12;
+
+    // Mismos colores que tenían las tarjetas hechas con widgets
+    const QColor background = hovered ? QColor(isDark ? "#333333" : "#F9FAFB")
+                                      : QColor(isDark ? "#2A2A2A" : "#FFFFFF");
+    const QColor border = hovered ? QColor("#A4373A") : QColor(isDark ? "#404040" : "#E5E7EB");
+    const QColor textPrimary(isDark ? "#FFFFFF" : "#111827");
+    const QColor textSecondary(isDark ? "#A0A0A0" : "#6B7280");
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    // En cuadrícula la sombra queda dentro del rectángulo del ítem, que es lo que se repinta
+    const QRect cardRect = m_mode == GridMode
+        ? option.rect.adjusted(ShadowMargin, ShadowMargin / 2, -ShadowMargin, -ShadowMargin * 3 / 2)
+        : option.rect;
+    const QRectF card = QRectF(cardRect).adjusted(0.5, 0.5, -0.5, -0.5);
+    if (m_mode == GridMode)
+        paintCardShadow(painter, card, radius, isDark);
+    painter->setPen(QPen(border, 1));
+    painter->setBrush(background);
+    painter->drawRoundedRect(card, radius, radius);
+
+    if (m_mode == GridMode)
+        paintGridCard(painter, cardRect, index, textPrimary, textSecondary);
+    else
+        paintListItem(painter, cardRect, index, textPrimary, textSecondary);
+
+    painter->restore();
+}
+
+void ProjectCardDelegate::paintGridCard(QPainter *painter, const QRect &rect, const QModelIndex &index,
+                                        const QColor &textPrimary, const QColor &textSecondary) const
+{
+    const QRect content = rect.adjusted(24, 24, -24, -24);
+    const QString name = index.data(ProjectListModel::NameRole).toString();
+    const int tableCount = index.data(ProjectListModel::TableCountRole).toInt();
+    const QDateTime modified = index.data(ProjectListModel::ModifiedRole).toDateTime();
+
+    // Ícono y, a su lado, nombre y número de tablas
+    const QRect iconRect(content.left(), content.top(), 48, 48);
+    painter->setFont(m_gridIconFont);
+    painter->setPen(textPrimary);
+    painter->drawText(iconRect, Qt::AlignCenter, "🗂️");
+
+    const int textLeft = iconRect.right() + 1 + 12;
+    const QRect infoRect(textLeft, content.top(), content.right() - textLeft, 48);
+    const QFontMetrics nameMetrics(m_gridNameFont);
+    const QFontMetrics detailMetrics(m_detailFont);
+    const int infoHeight = nameMetrics.height() + 4 + detailMetrics.height();
+    const int infoTop = infoRect.top() + qMax(0, (infoRect.height() - infoHeight) / 2);
+
+    painter->setFont(m_gridNameFont);
+    painter->drawText(QRect(infoRect.left(), infoTop, infoRect.width(), nameMetrics.height()),
+                      Qt::AlignLeft | Qt::AlignVCenter,
+                      nameMetrics.elidedText(name, Qt::ElideRight, infoRect.width()));
+
+    painter->setFont(m_detailFont);
+    painter->setPen(textSecondary);
+    painter->drawText(QRect(infoRect.left(), infoTop + nameMetrics.height() + 4, infoRect.width(), detailMetrics.height()),
+                      Qt::AlignLeft | Qt::AlignVCenter, tableCountText(tableCount));
+
+    // Fecha de modificación al pie
+    const QFontMetrics dateMetrics(m_dateFont);
+    painter->setFont(m_dateFont);
+    painter->drawText(QRect(content.left(), content.bottom() + 1 - dateMetrics.height(), content.width(), dateMetrics.height()),
+                      Qt::AlignLeft | Qt::AlignVCenter,
+                      QString("Actualizado %1").arg(modified.toString("dd/MM/yyyy")));
+}
+
+void ProjectCardDelegate::paintListItem(QPainter *painter, const QRect &rect, const QModelIndex &index,
+                                        const QColor &textPrimary, const QColor &textSecondary) const
+{
+    const QRect content = rect.adjusted(20, 16, -20, -16);
+    const QString name = index.data(ProjectListModel::NameRole).toString();
+    const int tableCount = index.data(ProjectListModel::TableCountRole).toInt();
+    const QDateTime modified = index.data(ProjectListModel::ModifiedRole).toDateTime();
+
+    const QRect iconRect(content.left(), content.center().y() - 20, 40, 40);
+    painter->setFont(m_listIconFont);
+    painter->setPen(textPrimary);
+    painter->drawText(iconRect, Qt::AlignCenter, "🗂️");
+
+    // Flecha a la derecha
+    const QRect arrowRect(content.right() + 1 - 24, content.center().y() - 12, 24, 24);
+    painter->setFont(m_arrowFont);
+    painter->setPen(textSecondary);
+    painter->drawText(arrowRect, Qt::AlignCenter, "→");
+
+    const int textLeft = iconRect.right() + 1 + 16;
+    const int textWidth = arrowRect.left() - 16 - textLeft;
+    const QFontMetrics nameMetrics(m_listNameFont);
+    const QFontMetrics detailMetrics(m_detailFont);
+    const int infoHeight = nameMetrics.height() + 4 + detailMetrics.height();
+    const int infoTop = content.top() + qMax(0, (content.height() - infoHeight) / 2);
+
+    painter->setFont(m_listNameFont);
+    painter->setPen(textPrimary);
+    painter->drawText(QRect(textLeft, infoTop, textWidth, nameMetrics.height()),
+                      Qt::AlignLeft | Qt::AlignVCenter,
+                      nameMetrics.elidedText(name, Qt::ElideRight, textWidth));
+
+    const QString details = QString("%1 • Actualizado %2")
+                                .arg(tableCountText(tableCount), modified.toString("dd/MM/yyyy"));
+    painter->setFont(m_detailFont);
+    painter->setPen(textSecondary);
+    painter->drawText(QRect(textLeft, infoTop + nameMetrics.height() + 4, textWidth, detailMetrics.height()),
+                      Qt::AlignLeft | Qt::AlignVCenter,
+                      detailMetrics.elidedText(details, Qt::ElideRight, textWidth));
+}
+
+// --- CreateProject ---
 
 CreateProject::CreateProject(QWidget *parent)
     : QMainWindow(parent), isGridView(true), isModalVisible(false), isAnimating(false)
@@ -91,11 +258,6 @@ void CreateProject::setupUI()
         styleComponents();
         qDebug() << "DEBUG: styleComponents() completado";
         
-        qDebug() << "DEBUG: Cargando y mostrando proyectos...";
-        // Cargar y mostrar proyectos existentes
-        loadAndDisplayProjects();
-        qDebug() << "DEBUG: Proyectos cargados y mostrados";
-        
     } catch (const std::exception& e) {
         qDebug() << "DEBUG: Excepción en setupUI():" << e.what();
     } catch (...) {
@@ -245,8 +407,11 @@ void CreateProject::createMainContent()
     connect(newProjectButton, &QPushButton::clicked, this, &CreateProject::onNewProjectClicked);
     connect(gridViewButton, &QPushButton::clicked, this, &CreateProject::onGridViewClicked);
     connect(listViewButton, &QPushButton::clicked, this, &CreateProject::onListViewClicked);
-    connect(searchBar, &QLineEdit::textChanged, this, [this]() {
-        loadAndDisplayProjects(); // Recargar proyectos con filtro de búsqueda
+    connect(searchBar, &QLineEdit::textChanged, this, [this](const QString &text) {
+        // Sin texto se muestran todos ya; con texto la búsqueda corre en otro hilo
+        if (text.trimmed().isEmpty())
+            projectsFilter->clearSearch();
+        projectSearcher->search(text);
     });
 }
 
@@ -369,6 +534,9 @@ void CreateProject::styleComponents()
         ).arg(accentColor, hoverColor));
     }
     
+    // Las tarjetas toman los colores del tema al pintarse
+    projectsView->viewport()->update();
+    
     // Actualizar estilos del modal si está visible
     if (modalOverlay && modalOverlay->isVisible()) {
         styleModalComponents();
@@ -514,7 +682,7 @@ void CreateProject::onGridViewClicked()
     if (!isGridView) {
         isGridView = true;
         styleComponents(); // Actualizar estilos para resaltar el botón activo
-        loadAndDisplayProjects(); // Recargar proyectos en vista de cuadrícula
+        applyProjectsViewMode(); // Mismas tarjetas, en cuadrícula
         qDebug() << "Vista en cuadrícula activada";
     }
 }
@@ -524,7 +692,7 @@ void CreateProject::onListViewClicked()
     if (isGridView) {
         isGridView = false;
         styleComponents(); // Actualizar estilos para resaltar el botón activo
-        loadAndDisplayProjects(); // Recargar proyectos en vista de lista
+        applyProjectsViewMode(); // Mismas tarjetas, en lista
         qDebug() << "Vista en lista activada";
     }
 }
@@ -966,8 +1134,8 @@ void CreateProject::onCreateProjectConfirmed()
     // Cerrar el modal primero
     hideNewProjectModal();
     
-    // Recargar la lista de proyectos para mostrar el nuevo
-    loadAndDisplayProjects();
+    // Agregar el nuevo proyecto al catálogo (el modelo se actualiza con projectsChanged)
+    ProjectCatalog::instance().refreshProject(projectName);
     
     // Navegar a la vista del proyecto (MainWindow)
     navigateToProjectView(projectName);
@@ -980,10 +1148,14 @@ void CreateProject::navigateToProjectView(const QString &projectName)
 {
     qDebug() << "Navegando a la vista del proyecto:" << projectName;
     
-    // Crear y mostrar MainWindow con el proyecto
+    // Crear y mostrar MainWindow con el proyecto. setProjectName no espera al
+    // disco: las tablas se cargan en segundo plano (ProjectOpener)
+    QElapsedTimer clock;
+    clock.start();
     MainWindow *mainWindow = new MainWindow();
     mainWindow->setProjectName(projectName); // Pasaremos el nombre del proyecto
     mainWindow->show();
+    qDebug() << "DEBUG: Ventana del proyecto" << projectName << "mostrada en" << clock.elapsed() << "ms";
     
     // Cerrar la ventana actual de CreateProject
     this->close();
@@ -1124,363 +1296,107 @@ void CreateProject::createProjectsArea()
     projectsAreaLayout->setContentsMargins(0, 20, 0, 0);
     projectsAreaLayout->setSpacing(0);
     
-    // Scroll area para manejar muchos proyectos
-    projectsScrollArea = new QScrollArea();
-    projectsScrollArea->setWidgetResizable(true);
-    projectsScrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    projectsScrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-    projectsScrollArea->setFrameShape(QFrame::NoFrame);
-    
-    // Contenedor para los proyectos
-    projectsContainer = new QWidget();
-    projectsContainer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::MinimumExpanding);
-    
-    // Los layouts se crearán dinámicamente según la vista seleccionada
-    projectsGridLayout = nullptr;
-    projectsListLayout = nullptr;
-    
-    projectsScrollArea->setWidget(projectsContainer);
-    projectsAreaLayout->addWidget(projectsScrollArea);
-    
-    qDebug() << "DEBUG: Área de proyectos creada correctamente";
-}
-
-void CreateProject::loadAndDisplayProjects()
-{
-    qDebug() << "DEBUG: Cargando y mostrando proyectos...";
-    
-    try {
-        // Limpiar visualización anterior
-        clearProjectsDisplay();
-        
-        // Obtener filtro de búsqueda
-        QString searchFilter = searchBar ? searchBar->text().trimmed().toLower() : QString();
-        qDebug() << "DEBUG: Filtro de búsqueda:" << searchFilter;
-        
-        // Usar ProjectStorageQt para obtener proyectos
-        ProjectStorageQt storage("");
-        auto projects = storage.listExistingProjects();
-        
-        qDebug() << "DEBUG: Proyectos encontrados:" << projects.size();
-        
-        if (projects.isEmpty()) {
-            // Mostrar mensaje de "No hay proyectos"
-            QLabel *emptyLabel = new QLabel();
-            emptyLabel->setText("📁\n\nNo hay proyectos aún\n\nCrea tu primer proyecto haciendo clic en \"Nuevo Proyecto\"");
-            emptyLabel->setAlignment(Qt::AlignCenter);
-            emptyLabel->setStyleSheet(
-                "QLabel {"
-                "    color: #6B7280;"
-                "    font-size: 16px;"
-                "    line-height: 1.5;"
-                "    margin: 60px;"
-                "}"
-            );
-            
-            if (isGridView) {
-                if (!projectsGridLayout) {
-                    projectsGridLayout = new QGridLayout(projectsContainer);
-                    projectsGridLayout->setContentsMargins(0, 0, 0, 0);
-                    projectsGridLayout->setSpacing(24);
-                }
-                projectsGridLayout->addWidget(emptyLabel, 0, 0, Qt::AlignCenter);
-            } else {
-                if (!projectsListLayout) {
-                    projectsListLayout = new QVBoxLayout(projectsContainer);
-                    projectsListLayout->setContentsMargins(0, 0, 0, 0);
-                    projectsListLayout->setSpacing(16);
-                }
-                projectsListLayout->addWidget(emptyLabel);
-            }
-            return;
-        }
-        
-        // Filtrar proyectos si hay búsqueda
-        QList<ProjectInfoQt> filteredProjects;
-        for (const auto &project : projects) {
-            if (searchFilter.isEmpty() || 
-                project.name.toLower().contains(searchFilter)) {
-                filteredProjects.append(project);
-            }
-        }
-        
-        qDebug() << "DEBUG: Proyectos después del filtro:" << filteredProjects.size();
-        
-        if (filteredProjects.isEmpty()) {
-            // Mostrar mensaje de "No se encontraron proyectos"
-            QLabel *noResultsLabel = new QLabel();
-            noResultsLabel->setText("🔍\n\nNo se encontraron proyectos\n\nTrata con otros términos de búsqueda");
-            noResultsLabel->setAlignment(Qt::AlignCenter);
-            noResultsLabel->setStyleSheet(
-                "QLabel {"
-                "    color: #6B7280;"
-                "    font-size: 16px;"
-                "    line-height: 1.5;"
-                "    margin: 60px;"
-                "}"
-            );
-            
-            if (isGridView) {
-                if (!projectsGridLayout) {
-                    projectsGridLayout = new QGridLayout(projectsContainer);
-                    projectsGridLayout->setContentsMargins(0, 0, 0, 0);
-                    projectsGridLayout->setSpacing(24);
-                }
-                projectsGridLayout->addWidget(noResultsLabel, 0, 0, Qt::AlignCenter);
-            } else {
-                if (!projectsListLayout) {
-                    projectsListLayout = new QVBoxLayout(projectsContainer);
-                    projectsListLayout->setContentsMargins(0, 0, 0, 0);
-                    projectsListLayout->setSpacing(16);
-                }
-                projectsListLayout->addWidget(noResultsLabel);
-            }
-            return;
-        }
-        
-        // Mostrar proyectos según la vista seleccionada
-        if (isGridView) {
-            // Vista en cuadrícula
-            if (!projectsGridLayout) {
-                projectsGridLayout = new QGridLayout(projectsContainer);
-                projectsGridLayout->setContentsMargins(0, 0, 0, 0);
-                projectsGridLayout->setSpacing(24);
-            }
-            
-            int row = 0, col = 0;
-            const int maxColumns = 3; // 3 proyectos por fila
-            
-            for (const auto &project : filteredProjects) {
-                QString lastModified = project.modified.toString("dd/MM/yyyy");
-                createGridProjectCard(project.name, lastModified, project.tableCount);
-                
-                col++;
-                if (col >= maxColumns) {
-                    col = 0;
-                    row++;
-                }
-            }
-            
-            // Agregar espaciador al final
-            projectsGridLayout->setRowStretch(row + 1, 1);
-            
-        } else {
-            // Vista en lista
-            if (!projectsListLayout) {
-                projectsListLayout = new QVBoxLayout(projectsContainer);
-                projectsListLayout->setContentsMargins(0, 0, 0, 0);
-                projectsListLayout->setSpacing(16);
-            }
-            
-            for (const auto &project : filteredProjects) {
-                QString lastModified = project.modified.toString("dd/MM/yyyy");
-                createListProjectItem(project.name, lastModified, project.tableCount);
-            }
-            
-            // Agregar espaciador al final
-            projectsListLayout->addStretch();
-        }
-        
-        qDebug() << "DEBUG: Proyectos mostrados correctamente";
-        
-    } catch (const std::exception& e) {
-        qDebug() << "ERROR: Excepción en loadAndDisplayProjects:" << e.what();
-    } catch (...) {
-        qDebug() << "ERROR: Excepción desconocida en loadAndDisplayProjects";
-    }
-}
-
-void CreateProject::createGridProjectCard(const QString &projectName, const QString &lastModified, int tableCount)
-{
-    if (!projectsGridLayout) return;
-    
-    // Card contenedor
-    QWidget *projectCard = new QWidget();
-    projectCard->setFixedSize(320, 200);
-    projectCard->setCursor(Qt::PointingHandCursor);
-    
-    // Layout del card
-    QVBoxLayout *cardLayout = new QVBoxLayout(projectCard);
-    cardLayout->setContentsMargins(24, 24, 24, 24);
-    cardLayout->setSpacing(16);
-    
-    // Header del card con ícono
-    QHBoxLayout *headerLayout = new QHBoxLayout();
-    headerLayout->setSpacing(12);
-    
-    QLabel *iconLabel = new QLabel("🗂️");
-    iconLabel->setFont(QFont("System", 32));
-    iconLabel->setFixedSize(48, 48);
-    iconLabel->setAlignment(Qt::AlignCenter);
-    
-    QVBoxLayout *infoLayout = new QVBoxLayout();
-    infoLayout->setSpacing(4);
-    
-    QLabel *nameLabel = new QLabel(projectName);
-    nameLabel->setFont(QFont("Inter", 16, QFont::Bold));
-    nameLabel->setWordWrap(true);
-    
-    QString tableText = tableCount == 1 ? "1 tabla" : QString("%1 tablas").arg(tableCount);
-    QLabel *tableLabel = new QLabel(tableText);
-    tableLabel->setFont(QFont("Inter", 13));
-    
-    infoLayout->addWidget(nameLabel);
-    infoLayout->addWidget(tableLabel);
-    
-    headerLayout->addWidget(iconLabel);
-    headerLayout->addLayout(infoLayout);
-    headerLayout->addStretch();
-    
-    // Fecha de modificación
-    QLabel *dateLabel = new QLabel(QString("Actualizado %1").arg(lastModified));
-    dateLabel->setFont(QFont("Inter", 12));
-    
-    cardLayout->addLayout(headerLayout);
-    cardLayout->addStretch();
-    cardLayout->addWidget(dateLabel);
-    
-    // Aplicar estilos del card
-    bool isDark = ThemeManager::instance().isDark();
-    QString cardBackground = isDark ? "#2A2A2A" : "#FFFFFF";
-    QString borderColor = isDark ? "#404040" : "#E5E7EB";
-    QString textPrimary = isDark ? "#FFFFFF" : "#111827";
-    QString textSecondary = isDark ? "#A0A0A0" : "#6B7280";
-    
-    projectCard->setStyleSheet(QString(
-        "QWidget {"
-        "    background-color: %1;"
-        "    border: 1px solid %2;"
-        "    border-radius: 16px;"
-        "}"
-        "QWidget:hover {"
-        "    border-color: #A4373A;"
-        "    background-color: %3;"
+    // Modelo sobre el catálogo y resultado de la barra de búsqueda
+    projectsModel = new ProjectListModel(this);
+    projectsFilter = new ProjectFilterModel(this);
+    projectsFilter->setSourceModel(projectsModel);
+    projectSearcher = new ProjectSearcher(this);
+    
+    // Una sola vista: solo se pintan las tarjetas visibles
+    projectCardDelegate = new ProjectCardDelegate(this);
+    projectsView = new QListView();
+    projectsView->setModel(projectsFilter);
+    projectsView->setItemDelegate(projectCardDelegate);
+    projectsView->setUniformItemSizes(true);
+    projectsView->setMovement(QListView::Static);
+    projectsView->setResizeMode(QListView::Adjust);
+    projectsView->setSelectionMode(QAbstractItemView::NoSelection);
+    projectsView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    projectsView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    projectsView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    projectsView->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    projectsView->setFrameShape(QFrame::NoFrame);
+    projectsView->setFocusPolicy(Qt::NoFocus);
+    projectsView->setMouseTracking(true);
+    projectsView->viewport()->setAttribute(Qt::WA_Hover);
+    projectsView->viewport()->setCursor(Qt::PointingHandCursor);
+    projectsView->setStyleSheet("QListView { background: transparent; border: none; }");
+    
+    // Mensaje cuando no hay nada que mostrar
+    projectsEmptyLabel = new QLabel();
+    projectsEmptyLabel->setAlignment(Qt::AlignCenter);
+    projectsEmptyLabel->setStyleSheet(
+        "QLabel {"
+        "    color: #6B7280;"
+        "    font-size: 16px;"
+        "    line-height: 1.5;"
+        "    margin: 60px;"
         "}"
-    ).arg(cardBackground, borderColor, isDark ? "#333333" : "#F9FAFB"));
-    
-    nameLabel->setStyleSheet(QString("color: %1;").arg(textPrimary));
-    tableLabel->setStyleSheet(QString("color: %1;").arg(textSecondary));
-    dateLabel->setStyleSheet(QString("color: %1;").arg(textSecondary));
-    
-    // Configurar propiedad del proyecto para eventFilter
-    projectCard->setProperty("projectName", projectName);
+    );
     
-    // Conectar clic del card usando eventFilter
-    projectCard->installEventFilter(this);
+    projectsAreaLayout->addWidget(projectsView);
+    projectsAreaLayout->addWidget(projectsEmptyLabel);
     
-    // Agregar sombra
-    QGraphicsDropShadowEffect *shadow = new QGraphicsDropShadowEffect();
-    shadow->setBlurRadius(12);
-    shadow->setXOffset(0);
-    shadow->setYOffset(4);
-    shadow->setColor(QColor(0, 0, 0, isDark ? 80 : 25));
-    projectCard->setGraphicsEffect(shadow);
+    connect(projectsView, &QListView::clicked, this, [this](const QModelIndex &index) {
+        onProjectCardClicked(index.data(ProjectListModel::NameRole).toString());
+    });
+    connect(projectSearcher, &ProjectSearcher::resultsReady, this,
+            [this](const QString &text, const QVector<ProjectSearchIndex::Match> &matches) {
+        // Un resultado de un texto que ya no está en la barra no sirve
+        if (text.isEmpty() || text != searchBar->text().trimmed())
+            return;
+        QStringList names;
+        names.reserve(matches.size());
+        for (const ProjectSearchIndex::Match &match : matches)
+            names << match.name;
+        projectsFilter->setSearchResults(names);
+    });
+    connect(projectsFilter, &QAbstractItemModel::modelReset, this, &CreateProject::updateProjectsEmptyState);
+    connect(projectsFilter, &QAbstractItemModel::rowsInserted, this, &CreateProject::updateProjectsEmptyState);
+    connect(projectsFilter, &QAbstractItemModel::rowsRemoved, this, &CreateProject::updateProjectsEmptyState);
+    connect(projectsFilter, &QAbstractItemModel::layoutChanged, this, &CreateProject::updateProjectsEmptyState);
     
-    // Calcular posición en la grilla
-    int currentItems = projectsGridLayout->count();
-    int row = currentItems / 3;
-    int col = currentItems % 3;
+    applyProjectsViewMode();
+    updateProjectsEmptyState();
     
-    projectsGridLayout->addWidget(projectCard, row, col);
+    qDebug() << "DEBUG: Área de proyectos creada correctamente:" << projectsModel->rowCount() << "proyectos";
 }
 
-void CreateProject::createListProjectItem(const QString &projectName, const QString &lastModified, int tableCount)
+void CreateProject::applyProjectsViewMode()
 {
-    if (!projectsListLayout) return;
-    
-    // Item contenedor
-    QWidget *projectItem = new QWidget();
-    projectItem->setFixedHeight(80);
-    projectItem->setCursor(Qt::PointingHandCursor);
-    
-    // Layout horizontal del item
-    QHBoxLayout *itemLayout = new QHBoxLayout(projectItem);
-    itemLayout->setContentsMargins(20, 16, 20, 16);
-    itemLayout->setSpacing(16);
-    
-    // Ícono del proyecto
-    QLabel *iconLabel = new QLabel("🗂️");
-    iconLabel->setFont(QFont("System", 24));
-    iconLabel->setFixedSize(40, 40);
-    iconLabel->setAlignment(Qt::AlignCenter);
-    
-    // Información del proyecto
-    QVBoxLayout *infoLayout = new QVBoxLayout();
-    infoLayout->setSpacing(4);
-    
-    QLabel *nameLabel = new QLabel(projectName);
-    nameLabel->setFont(QFont("Inter", 15, QFont::Medium));
-    
-    QString tableText = tableCount == 1 ? "1 tabla" : QString("%1 tablas").arg(tableCount);
-    QLabel *detailsLabel = new QLabel(QString("%1 • Actualizado %2").arg(tableText, lastModified));
-    detailsLabel->setFont(QFont("Inter", 13));
-    
-    infoLayout->addWidget(nameLabel);
-    infoLayout->addWidget(detailsLabel);
-    
-    // Espaciador
-    QWidget *spacer = new QWidget();
-    spacer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
-    
-    // Ícono de flecha
-    QLabel *arrowLabel = new QLabel("→");
-    arrowLabel->setFont(QFont("Inter", 16));
-    arrowLabel->setFixedSize(24, 24);
-    arrowLabel->setAlignment(Qt::AlignCenter);
-    
-    itemLayout->addWidget(iconLabel);
-    itemLayout->addLayout(infoLayout);
-    itemLayout->addWidget(spacer);
-    itemLayout->addWidget(arrowLabel);
-    
-    // Aplicar estilos del item
-    bool isDark = ThemeManager::instance().isDark();
-    QString itemBackground = isDark ? "#2A2A2A" : "#FFFFFF";
-    QString borderColor = isDark ? "#404040" : "#E5E7EB";
-    QString textPrimary = isDark ? "#FFFFFF" : "#111827";
-    QString textSecondary = isDark ? "#A0A0A0" : "#6B7280";
-    
-    projectItem->setStyleSheet(QString(
-        "QWidget {"
-        "    background-color: %1;"
-        "    border: 1px solid %2;"
-        "    border-radius: 12px;"
-        "}"
-        "QWidget:hover {"
-        "    border-color: #A4373A;"
-        "    background-color: %3;"
-        "}"
-    ).arg(itemBackground, borderColor, isDark ? "#333333" : "#F9FAFB"));
-    
-    nameLabel->setStyleSheet(QString("color: %1;").arg(textPrimary));
-    detailsLabel->setStyleSheet(QString("color: %1;").arg(textSecondary));
-    arrowLabel->setStyleSheet(QString("color: %1;").arg(textSecondary));
-    
-    // Configurar propiedad del proyecto para eventFilter
-    projectItem->setProperty("projectName", projectName);
-    
-    // Conectar clic del item usando eventFilter
-    projectItem->installEventFilter(this);
-    
-    projectsListLayout->addWidget(projectItem);
+    if (isGridView) {
+        // Cuadrícula: 3 tarjetas por fila que se acomodan al ancho
+        projectCardDelegate->setMode(ProjectCardDelegate::GridMode);
+        projectsView->setViewMode(QListView::IconMode);
+        projectsView->setFlow(QListView::LeftToRight);
+        projectsView->setWrapping(true);
+        projectsView->setSpacing(4);
+    } else {
+        projectCardDelegate->setMode(ProjectCardDelegate::ListMode);
+        projectsView->setViewMode(QListView::ListMode);
+        projectsView->setFlow(QListView::TopToBottom);
+        projectsView->setWrapping(false);
+        projectsView->setSpacing(8);
+    }
+    // setViewMode() vuelve a activar el arrastre de íconos
+    projectsView->setMovement(QListView::Static);
+    // El tamaño de las tarjetas cambió: la vista vuelve a calcular la distribución
+    projectsView->reset();
+    projectsView->scrollToTop();
 }
 
-void CreateProject::clearProjectsDisplay()
+void CreateProject::updateProjectsEmptyState()
 {
-    if (projectsContainer && projectsContainer->layout()) {
-        QLayoutItem *item;
-        while ((item = projectsContainer->layout()->takeAt(0)) != nullptr) {
-            if (item->widget()) {
-                item->widget()->deleteLater();
-            }
-            delete item;
+    const bool empty = projectsFilter->rowCount() == 0;
+    if (empty) {
+        if (projectsModel->rowCount() == 0) {
+            projectsEmptyLabel->setText("📁\n\nNo hay proyectos aún\n\nCrea tu primer proyecto haciendo clic en \"Nuevo Proyecto\"");
+        } else {
+            projectsEmptyLabel->setText("🔍\n\nNo se encontraron proyectos\n\nTrata con otros términos de búsqueda");
         }
-        delete projectsContainer->layout();
-        
-        // Resetear layouts
-        projectsGridLayout = nullptr;
-        projectsListLayout = nullptr;
     }
+    projectsEmptyLabel->setVisible(empty);
+    projectsView->setVisible(!empty);
 }
 
 void CreateProject::onProjectCardClicked(const QString &projectName)
@@ -1490,25 +1406,3 @@ void CreateProject::onProjectCardClicked(const QString &projectName)
     // Navegar a la vista del proyecto
     navigateToProjectView(projectName);
 }
-
-bool CreateProject::eventFilter(QObject *obj, QEvent *event)
-{
-    if (event->type() == QEvent::MouseButtonPress) {
-        QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
-        if (mouseEvent->button() == Qt::LeftButton) {
-            // Buscar el project name en las propiedades del widget
-            QWidget *widget = qobject_cast<QWidget*>(obj);
-            if (widget) {
-                QString projectName = widget->property("projectName").toString();
-                if (!projectName.isEmpty()) {
-                    qDebug() << "Clic en proyecto:" << projectName;
-                    onProjectCardClicked(projectName);
-                    return true; // Evento manejado
-                }
-            }
-        }
-    }
-    
-    // Llamar al eventFilter padre para otros eventos
-    return QMainWindow::eventFilter(obj, event);
-}
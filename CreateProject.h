@@ -26,7 +26,52 @@
 #include <QFileInfo>
 #include <QDateTime>
 #include <QMessageBox>
+#include <QListView>
+#include <QStyledItemDelegate>
 #include "ThemePopover.h"
+#include "ProjectListModel.h"
+#include "ProjectSearchIndex.h"
+
+// Tarjeta de un proyecto del lanzador, pintada directamente (sin widgets).
+// En cuadrícula es la tarjeta de 320x200; en lista, la fila de 80 px de alto.
+class ProjectCardDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+public:
+    enum Mode {
+        GridMode,
+        ListMode
+    };
+
+    static constexpr int GridCardWidth = 320;
+    static constexpr int GridCardHeight = 200;
+    static constexpr int ListItemHeight = 80;
+    static constexpr int ShadowMargin = 8;   // alrededor de la tarjeta, para la sombra
+
+    explicit ProjectCardDelegate(QObject *parent = nullptr);
+
+    void setMode(Mode mode) { m_mode = mode; }
+    Mode mode() const { return m_mode; }
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+private:
+    void paintGridCard(QPainter *painter, const QRect &rect, const QModelIndex &index,
+                       const QColor &textPrimary, const QColor &textSecondary) const;
+    void paintListItem(QPainter *painter, const QRect &rect, const QModelIndex &index,
+                       const QColor &textPrimary, const QColor &textSecondary) const;
+
+    Mode m_mode = GridMode;
+    QFont m_gridIconFont;
+    QFont m_gridNameFont;
+    QFont m_listIconFont;
+    QFont m_listNameFont;
+    QFont m_detailFont;
+    QFont m_dateFont;
+    QFont m_arrowFont;
+};
 
 class CreateProject : public QMainWindow
 {
@@ -56,12 +101,9 @@ private:
     void navigateToProjectView(const QString &projectName);
     
 protected:
-    bool eventFilter(QObject *obj, QEvent *event) override;
     void createProjectsArea();
-    void loadAndDisplayProjects();
-    void createGridProjectCard(const QString &projectName, const QString &lastModified, int tableCount);
-    void createListProjectItem(const QString &projectName, const QString &lastModified, int tableCount);
-    void clearProjectsDisplay();
+    void applyProjectsViewMode();
+    void updateProjectsEmptyState();
     void onProjectCardClicked(const QString &projectName);
 
     // Widgets principales
@@ -86,13 +128,15 @@ protected:
     QPushButton *gridViewButton;
     QPushButton *listViewButton;
     
-    // Área de proyectos
+    // Área de proyectos: una sola vista sobre el catálogo
     QWidget *projectsAreaWidget;
     QVBoxLayout *projectsAreaLayout;
-    QScrollArea *projectsScrollArea;
-    QWidget *projectsContainer;
-    QGridLayout *projectsGridLayout;
-    QVBoxLayout *projectsListLayout;
+    QListView *projectsView;
+    ProjectListModel *projectsModel;
+    ProjectFilterModel *projectsFilter;
+    ProjectSearcher *projectSearcher;
+    ProjectCardDelegate *projectCardDelegate;
+    QLabel *projectsEmptyLabel;
     
     // Theme popover
     ThemePopover *themePopover;
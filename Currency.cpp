@@ -0,0 +1,182 @@
+#include "Currency.h"
+
+#include <limits>
+
+namespace {
+// Unidades más grandes ya no caben en qint64 como centavos
+constexpr qint64 MaxUnits = (std::numeric_limits<qint64>::max() - 99) / 100;
+
+inline bool isSeparator(QChar c)
+{
+    return c == QLatin1Char('.') || c == QLatin1Char(',');
+}
+
+// Largo del símbolo de moneda en pos ("Lps", "L", "$" o "€"), 0 si no hay
+int symbolLength(const QChar *chars, int pos, int length)
+{
+    if (pos >= length)
+        return 0;
+    const QChar c = chars[pos];
+    if (c == QLatin1Char('$') || c == QChar(0x20AC))
+        return 1;
+    if (c.toUpper() != QLatin1Char('L'))
+        return 0;
+    if (pos + 2 < length && chars[pos + 1].toLower() == QLatin1Char('p') && chars[pos + 2].toLower() == QLatin1Char('s'))
+        return 3;
+    return 1;
+}
+} // namespace
+
+std::optional<Currency> Currency::parse(const QString &text)
+{
+    const QChar *chars = text.constData();
+    const int length = text.size();
+
+    // Primera pasada, con la gramática completa:
+    //   [espacios] [-] [símbolo [espacios]] [-] dígitos y separadores [espacios]
+    // Cualquier otro carácter hace inválido el texto.
+    int pos = 0;
+    int end = length;
+    while (pos < end && chars[pos].isSpace()) ++pos;
+    while (end > pos && chars[end - 1].isSpace()) --end;
+
+    bool negative = false;
+    if (pos < end && chars[pos] == QLatin1Char('-')) {
+        negative = true;
+        ++pos;
+    }
+    if (const int symbol = symbolLength(chars, pos, end)) {
+        pos += symbol;
+        while (pos < end && chars[pos].isSpace()) ++pos;
+    }
+    if (pos < end && chars[pos] == QLatin1Char('-')) {
+        if (negative)
+            return std::nullopt;
+        negative = true;
+        ++pos;
+    }
+
+    const int begin = pos;
+    bool anyDigit = false;
+    int lastSep = -1;
+    int digitsAfterSep = 0;
+    for (; pos < end; ++pos) {
+        const QChar c = chars[pos];
+        if (c.isDigit()) {
+            anyDigit = true;
+            digitsAfterSep++;
+        } else if (isSeparator(c)) {
+            lastSep = pos;
+            digitsAfterSep = 0;
+        } else {
+            return std::nullopt;
+        }
+    }
+    // Sin dígitos no hay monto, aunque haya separadores ("." o "," solos no son 0.00)
+    if (!anyDigit)
+        return std::nullopt;
+    const bool hasFraction = lastSep >= 0 && digitsAfterSep >= 1 && digitsAfterSep <= 2;
+
+    // Segunda pasada: acumular unidades y centavos
+    qint64 units = 0;
+    qint64 cents = 0;
+    for (int i = begin; i < end; ++i) {
+        const QChar c = chars[i];
+        if (!c.isDigit()) continue;
+        if (hasFraction && i > lastSep) {
+            cents = cents * 10 + c.digitValue();
+        } else {
+            if (units > (MaxUnits - c.digitValue()) / 10)
+                return std::nullopt;
+            units = units * 10 + c.digitValue();
+        }
+    }
+    if (hasFraction && digitsAfterSep == 1)
+        cents *= 10;
+
+    const qint64 total = units * 100 + cents;
+    return Currency(negative ? -total : total);
+}
+
+Currency::Format Currency::formatFromName(const QString &name)
+{
+    if (name.contains(QLatin1String("Dollar"))) return Dollar;
+    if (name.contains(QLatin1String("Euro"))) return Euro;
+    if (name.contains(QLatin1String("Millares"))) return Millares;
+    return Lempiras;
+}
+
+int Currency::format(QChar *buffer, Format format) const
+{
+    const bool negative = m_cents < 0;
+    quint64 magnitude = negative ? quint64(-(m_cents + 1)) + 1 : quint64(m_cents);
+    int fraction = int(magnitude % 100);
+    quint64 units = magnitude / 100;
+    if (format == Millares) {
+        // Sin centavos: se redondea al entero (la mitad se aleja del cero)
+        if (fraction >= 50) units++;
+        fraction = 0;
+    }
+
+    // Dígitos de las unidades de derecha a izquierda, con ',' cada tres
+    QChar digits[MaxFormattedLength];
+    int count = 0;
+    int group = 0;
+    do {
+        if (group == 3) {
+            digits[count++] = QLatin1Char(',');
+            group = 0;
+        }
+        digits[count++] = QLatin1Char(char('0' + units % 10));
+        units /= 10;
+        group++;
+    } while (units > 0);
+
+    int pos = 0;
+    switch (format) {
+    case Lempiras:
+        buffer[pos++] = QLatin1Char('L');
+        buffer[pos++] = QLatin1Char('p');
+        buffer[pos++] = QLatin1Char('s');
+        buffer[pos++] = QLatin1Char(' ');
+        break;
+    case Dollar:
+        buffer[pos++] = QLatin1Char('$');
+        break;
+    case Euro:
+        buffer[pos++] = QChar(0x20AC);
+        break;
+    case Millares:
+        break;
+    }
+    if (negative && (magnitude >= 50 || format != Millares))
+        buffer[pos++] = QLatin1Char('-');
+    while (count > 0)
+        buffer[pos++] = digits[--count];
+    if (format != Millares) {
+        buffer[pos++] = QLatin1Char('.');
+        buffer[pos++] = QLatin1Char(char('0' + fraction / 10));
+        buffer[pos++] = QLatin1Char(char('0' + fraction % 10));
+    }
+    return pos;
+}
+
+QString Currency::toString(Format format) const
+{
+    QChar buffer[MaxFormattedLength];
+    const int length = this->format(buffer, format);
+    return QString(buffer, length);
+}
+
+bool Currency::isFormatted(const QString &text, Format format) const
+{
+    QChar buffer[MaxFormattedLength];
+    const int length = this->format(buffer, format);
+    if (text.size() != length)
+        return false;
+    const QChar *chars = text.constData();
+    for (int i = 0; i < length; ++i) {
+        if (chars[i] != buffer[i]) return false;
+    }
+    return true;
+}
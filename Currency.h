@@ -0,0 +1,58 @@
+#ifndef CURRENCY_H
+#define CURRENCY_H
+
+#include <QString>
+#include <optional>
+
+// Monto de moneda en centavos (punto fijo, sin redondeos de double).
+//
+// parse() acepta lo que escribe el usuario y lo que producen los formatos:
+// "Lps 1,500.00", "$1,500.00", "€1,500.00", "1,500", "1500", "-12,5",
+// "Lps -3.00"... Un signo '-' (antes o después del símbolo), un símbolo
+// opcional (Lps, L, $, €) y después solo dígitos y separadores. El último
+// separador ('.' o ',') es decimal solo si le siguen 1 o 2 dígitos. Es la
+// misma regla con la que TypeValidator valida los campos "moneda".
+//
+// format() escribe en un búfer del llamador: parsear y formatear no reservan
+// memoria, así que se puede usar al pintar cada celda.
+class Currency
+{
+public:
+    // Formatos de TableView (combo "Formato")
+    enum Format {
+        Lempiras,   // Lps 1,234.56
+        Dollar,     // $1,234.56
+        Euro,       // €1,234.56
+        Millares    // 1,235 (sin centavos)
+    };
+
+    // Largo máximo de format(): signo, prefijo, 17 dígitos con separadores y centavos
+    static constexpr int MaxFormattedLength = 32;
+
+    constexpr Currency() = default;
+    explicit constexpr Currency(qint64 cents) : m_cents(cents) {}
+
+    constexpr qint64 cents() const { return m_cents; }
+
+    // Vacío si el texto no sigue la gramática, no tiene dígitos o el monto no cabe en qint64
+    static std::optional<Currency> parse(const QString &text);
+    static Format formatFromName(const QString &name);
+
+    // Devuelve la cantidad de caracteres escritos en buffer (MaxFormattedLength como mínimo)
+    int format(QChar *buffer, Format format = Lempiras) const;
+    QString toString(Format format = Lempiras) const;
+
+    // text ya es exactamente toString(format)
+    bool isFormatted(const QString &text, Format format = Lempiras) const;
+
+    constexpr bool operator==(Currency other) const { return m_cents == other.m_cents; }
+    constexpr bool operator!=(Currency other) const { return m_cents != other.m_cents; }
+    constexpr bool operator<(Currency other) const { return m_cents < other.m_cents; }
+    constexpr Currency operator+(Currency other) const { return Currency(m_cents + other.m_cents); }
+    constexpr Currency operator-(Currency other) const { return Currency(m_cents - other.m_cents); }
+
+private:
+    qint64 m_cents = 0;
+};
+
+#endif // CURRENCY_H
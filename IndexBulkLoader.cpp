@@ -0,0 +1,391 @@
+#include "IndexBulkLoader.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <QFile>
+#include <algorithm>
+#include <memory>
+#include <queue>
+#include <vector>
+
+namespace {
+constexpr int EntrySize = 16;           // { qint64 clave, quint64 registro }
+constexpr int ChunkEntries = 4096;      // entradas por lectura/escritura de una corrida
+
+void encodeEntry(char *p, const IndexEntry &entry)
+{
+    pageWriteU64(p, 0, quint64(entry.key));
+    pageWriteU64(p, 8, entry.value);
+}
+
+bool writeEntries(QFile &file, const IndexEntry *entries, int count)
+{
+    QByteArray chunk;
+    for (int done = 0; done < count; done += ChunkEntries) {
+        const int n = qMin(ChunkEntries, count - done);
+        chunk.resize(n * EntrySize);
+        for (int i = 0; i < n; ++i)
+            encodeEntry(chunk.data() + i * EntrySize, entries[done + i]);
+        if (file.write(chunk.constData(), chunk.size()) != chunk.size())
+            return false;
+    }
+    return true;
+}
+} // namespace
+
+// Secuencia ordenada de entradas: el búfer en memoria o la mezcla de las corridas
+class IndexBulkLoader::SortedSource {
+public:
+    explicit SortedSource(const QVector<IndexEntry> *memory) : m_memory(memory) {}
+    explicit SortedSource(const QStringList &runs) : m_runPaths(runs) {}
+
+    bool open(QString *error)
+    {
+        for (const QString &path : m_runPaths) {
+            auto run = std::make_unique<Run>();
+            run->file.setFileName(path);
+            if (!run->file.open(QIODevice::ReadOnly)) {
+                *error = QStringLiteral("No se pudo leer %1: %2").arg(path, run->file.errorString());
+                return false;
+            }
+            IndexEntry first;
+            if (run->read(&first))
+                m_heap.push(HeapItem{ first, int(m_runs.size()) });
+            m_runs.push_back(std::move(run));
+        }
+        return true;
+    }
+
+    bool next(IndexEntry *entry)
+    {
+        if (m_hasPeek) {
+            *entry = m_peek;
+            m_hasPeek = false;
+            return true;
+        }
+        return pull(entry);
+    }
+
+    bool peek(IndexEntry *entry)
+    {
+        if (!m_hasPeek)
+            m_hasPeek = pull(&m_peek);
+        *entry = m_peek;
+        return m_hasPeek;
+    }
+
+private:
+    struct Run {
+        QFile file;
+        QByteArray buffer;
+        int pos = 0;
+
+        bool read(IndexEntry *entry)
+        {
+            if (pos >= buffer.size()) {
+                buffer = file.read(qint64(ChunkEntries) * EntrySize);
+                pos = 0;
+                if (buffer.size() < EntrySize)
+                    return false;
+            }
+            entry->key = qint64(pageReadU64(buffer.constData(), pos));
+            entry->value = pageReadU64(buffer.constData(), pos + 8);
+            pos += EntrySize;
+            return true;
+        }
+    };
+
+    struct HeapItem {
+        IndexEntry entry;
+        int run;
+        bool operator>(const HeapItem &other) const { return other.entry < entry; }
+    };
+
+    bool pull(IndexEntry *entry)
+    {
+        if (m_memory) {
+            if (m_memoryPos >= m_memory->size())
+                return false;
+            *entry = m_memory->at(m_memoryPos++);
+            return true;
+        }
+
+        // Mezcla de k corridas: siempre sale la menor de las cabezas
+        if (m_heap.empty())
+            return false;
+        const HeapItem top = m_heap.top();
+        m_heap.pop();
+        *entry = top.entry;
+        IndexEntry following;
+        if (m_runs[top.run]->read(&following))
+            m_heap.push(HeapItem{ following, top.run });
+        return true;
+    }
+
+    const QVector<IndexEntry> *m_memory = nullptr;
+    int m_memoryPos = 0;
+    QStringList m_runPaths;
+    std::vector<std::unique_ptr<Run>> m_runs;
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> m_heap;
+    bool m_hasPeek = false;
+    IndexEntry m_peek;
+};
+
+IndexBulkLoader::IndexBulkLoader(const QString &tempPrefix, int runEntries)
+    : m_prefix(tempPrefix), m_runEntries(qMax(1024, runEntries))
+{
+}
+
+IndexBulkLoader::~IndexBulkLoader()
+{
+    removeRuns();
+}
+
+bool IndexBulkLoader::fail(const QString &error)
+{
+    m_error = error;
+    return false;
+}
+
+int IndexBulkLoader::capacity(bool leaf) const
+{
+    const int pageMax = IndexFile::maxEntries(leaf);
+    return (m_capacity >= 3 && m_capacity < pageMax) ? m_capacity : pageMax;
+}
+
+bool IndexBulkLoader::add(qint64 key, RecordId rid)
+{
+    m_buffer.append(IndexEntry{ key, rid.toUInt64() });
+    m_added++;
+    if (m_buffer.size() >= m_runEntries)
+        return spillRun();
+    return true;
+}
+
+bool IndexBulkLoader::spillRun()
+{
+    std::sort(m_buffer.begin(), m_buffer.end());
+
+    const QString path = QStringLiteral("%1.run%2").arg(m_prefix).arg(m_runs.size());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return fail(QStringLiteral("No se pudo crear %1: %2").arg(path, file.errorString()));
+    m_runs.append(path);
+    if (!writeEntries(file, m_buffer.constData(), m_buffer.size()))
+        return fail(QStringLiteral("No se pudo escribir %1: %2").arg(path, file.errorString()));
+
+    m_buffer.clear();
+    return true;
+}
+
+void IndexBulkLoader::removeRuns()
+{
+    for (const QString &path : qAsConst(m_runs))
+        QFile::remove(path);
+    m_runs.clear();
+}
+
+bool IndexBulkLoader::build(IndexFile *index)
+{
+    m_error.clear();
+    m_duplicates = 0;
+    if (!index || !index->isOpen())
+        return fail(QStringLiteral("El índice no está abierto"));
+
+    // En un árbol B cada clave aparece una sola vez
+    const bool unique = index->kind() == IndexFile::BTreeKind;
+    auto sameKey = [](const IndexEntry &a, const IndexEntry &b) { return a.key == b.key; };
+    bool ok = false;
+
+    if (m_runs.isEmpty()) {
+        // Todo cupo en memoria: no hace falta tocar el disco
+        std::sort(m_buffer.begin(), m_buffer.end());
+        if (unique) {
+            const auto end = std::unique(m_buffer.begin(), m_buffer.end(), sameKey);
+            m_duplicates += quint64(m_buffer.end() - end);
+            m_buffer.erase(end, m_buffer.end());
+        }
+        SortedSource source(&m_buffer);
+        ok = writeTree(index, source, quint64(m_buffer.size()));
+    } else {
+        if (!m_buffer.isEmpty() && !spillRun()) {
+            removeRuns();
+            return false;
+        }
+
+        quint64 total = m_added;
+        if (unique) {
+            // Primera pasada: mezclar todo en una corrida sin claves repetidas
+            // (el diseño del árbol necesita saber cuántas entradas quedan)
+            SortedSource merged(m_runs);
+            const QString path = m_prefix + ".sorted";
+            QFile out(path);
+            if (!merged.open(&m_error) || !out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+                if (m_error.isEmpty())
+                    m_error = QStringLiteral("No se pudo crear %1: %2").arg(path, out.errorString());
+                removeRuns();
+                return false;
+            }
+
+            QVector<IndexEntry> chunk;
+            chunk.reserve(ChunkEntries);
+            IndexEntry entry;
+            bool hasLast = false;
+            qint64 lastKey = 0;
+            total = 0;
+            bool written = true;
+            while (written && merged.next(&entry)) {
+                if (hasLast && entry.key == lastKey) {
+                    m_duplicates++;
+                    continue;
+                }
+                hasLast = true;
+                lastKey = entry.key;
+                chunk.append(entry);
+                total++;
+                if (chunk.size() == ChunkEntries) {
+                    written = writeEntries(out, chunk.constData(), chunk.size());
+                    chunk.clear();
+                }
+            }
+            written = written && writeEntries(out, chunk.constData(), chunk.size());
+            out.close();
+            removeRuns();
+            m_runs.append(path);
+            if (!written) {
+                removeRuns();
+                return fail(QStringLiteral("No se pudo escribir %1").arg(path));
+            }
+        }
+
+        SortedSource source(m_runs);
+        ok = source.open(&m_error) && writeTree(index, source, total);
+    }
+
+    if (m_duplicates > 0)
+        qDebug() << "WARNING: Carga masiva de" << index->path() << "descartó" << m_duplicates << "claves repetidas";
+
+    removeRuns();
+    m_buffer.clear();
+    m_added = 0;
+    return ok;
+}
+
+bool IndexBulkLoader::writeTree(IndexFile *index, SortedSource &source, quint64 total)
+{
+    if (!index->clear())
+        return fail(index->errorString());
+    if (total == 0)
+        return index->sync() || fail(index->errorString());
+
+    const bool bTree = index->kind() == IndexFile::BTreeKind;
+
+    // Entradas por hoja e hijos por nodo interno según el factor de llenado.
+    // El mínimo es el de cada tipo de árbol: la mitad, o 2/3 en un B*.
+    const double minFill = index->kind() == IndexFile::BStarTreeKind ? 2.0 / 3.0 : 0.5;
+    const double fill = qBound(minFill, m_fillFactor, 1.0);
+    const int leafSize = qBound(2, int(capacity(true) * fill), capacity(true));
+    const int fanout = qBound(2, int(capacity(false) * fill) + 1, capacity(false) + 1);
+
+    // Forma del árbol, nivel por nivel (0 = hojas). En un árbol B la entrada
+    // que separa dos hojas sube al padre, por eso hay menos entradas en hojas.
+    struct Level {
+        quint64 nodes = 0;
+        quint64 base = 0;   // tamaño de cada nodo; los primeros `extra` llevan uno más
+        quint64 extra = 0;
+        quint64 done = 0;
+        quint64 sizeOf(quint64 node) const { return base + (node < extra ? 1 : 0); }
+    };
+    QVector<Level> levels;
+
+    Level leaves;
+    quint64 leafEntries = total;
+    if (bTree) {
+        leaves.nodes = (total + 1 + leafSize) / (leafSize + 1);
+        leafEntries = total - (leaves.nodes - 1);
+    } else {
+        leaves.nodes = (total + leafSize - 1) / leafSize;
+    }
+    leaves.base = leafEntries / leaves.nodes;
+    leaves.extra = leafEntries % leaves.nodes;
+    levels.append(leaves);
+
+    for (quint64 below = leaves.nodes; below > 1; below = levels.last().nodes) {
+        Level level;
+        // Sin nodos internos de un solo hijo
+        level.nodes = qMax<quint64>(1, qMin<quint64>((below + fanout - 1) / fanout, below / 2));
+        level.base = below / level.nodes;
+        level.extra = below % level.nodes;
+        levels.append(level);
+    }
+
+    QVector<IndexNode> current(levels.size());
+    for (int lv = 1; lv < levels.size(); ++lv)
+        current[lv].leaf = false;
+
+    quint32 root = 0;
+    quint32 firstLeaf = 0;
+    quint32 leafPage = index->allocateNode();
+    if (leafPage == 0)
+        return fail(index->errorString());
+
+    for (quint64 j = 0; j < leaves.nodes; ++j) {
+        // Separador con la hoja anterior: va al nivel más bajo que tenga un nodo abierto
+        if (j > 0) {
+            IndexEntry separator;
+            if (!(bTree ? source.next(&separator) : source.peek(&separator)))
+                return fail(QStringLiteral("Faltan entradas para construir el índice"));
+            for (int lv = 1; lv < levels.size(); ++lv) {
+                if (!current[lv].children.isEmpty()) {
+                    current[lv].entries.append(separator);
+                    break;
+                }
+            }
+        }
+
+        IndexNode leaf;
+        const quint64 size = levels[0].sizeOf(j);
+        leaf.entries.resize(int(size));
+        for (quint64 i = 0; i < size; ++i) {
+            if (!source.next(&leaf.entries[int(i)]))
+                return fail(QStringLiteral("Faltan entradas para construir el índice"));
+        }
+
+        // La página de la hoja siguiente se reserva antes para poder enlazarla
+        quint32 page = leafPage;
+        if (j + 1 < leaves.nodes) {
+            leafPage = index->allocateNode();
+            if (leafPage == 0)
+                return fail(index->errorString());
+            if (!bTree)
+                leaf.next = leafPage;
+        }
+        if (!index->writeNode(page, leaf))
+            return fail(index->errorString());
+        if (j == 0)
+            firstLeaf = page;
+
+        // Subir la página al padre; los nodos que se completan se escriben y suben a su vez
+        int lv = 1;
+        while (lv < levels.size()) {
+            current[lv].children.append(page);
+            if (quint64(current[lv].children.size()) < levels[lv].sizeOf(levels[lv].done))
+                break;
+            page = index->allocateNode();
+            if (page == 0 || !index->writeNode(page, current[lv]))
+                return fail(index->errorString());
+            levels[lv].done++;
+            current[lv] = IndexNode();
+            current[lv].leaf = false;
+            lv++;
+        }
+        if (lv == levels.size())
+            root = page;
+    }
+
+    index->setRoot(root, quint32(levels.size()));
+    index->setEntryCount(total);
+    if (!bTree)
+        index->setFirstLeaf(firstLeaf);
+    return index->sync() || fail(index->errorString());
+}
@@ -0,0 +1,68 @@
+#ifndef INDEXBULKLOADER_H
+#define INDEXBULKLOADER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "IndexFile.h"
+
+// Construcción de un índice completo "de abajo hacia arriba".
+//
+// Las entradas se agregan en cualquier orden; se ordenan en corridas de
+// tamaño fijo que se vuelcan a archivos temporales (<prefijo>.run<N>) y luego
+// se mezclan. Con la secuencia ordenada se escriben las hojas una tras otra
+// y después cada nivel interno, dejando los nodos llenos hasta fillFactor.
+// Es mucho más rápido que insertar entrada por entrada en un árbol grande.
+//
+// El diseño del árbol depende del tipo del IndexFile:
+//   B      → claves únicas (las repetidas se descartan), entradas en todos los niveles
+//   B+ / B* → claves repetidas, entradas solo en hojas encadenadas
+class IndexBulkLoader {
+public:
+    static constexpr int DefaultRunEntries = 65536; // 1 MB por corrida
+    static constexpr double DefaultFillFactor = 0.9;
+
+    explicit IndexBulkLoader(const QString &tempPrefix, int runEntries = DefaultRunEntries);
+    ~IndexBulkLoader();
+
+    IndexBulkLoader(const IndexBulkLoader&) = delete;
+    IndexBulkLoader& operator=(const IndexBulkLoader&) = delete;
+
+    // Fracción de cada nodo que se llena (se ajusta al mínimo del tipo de árbol)
+    void setFillFactor(double fillFactor) { m_fillFactor = fillFactor; }
+    double fillFactor() const { return m_fillFactor; }
+
+    // Capacidad máxima por nodo (0 = lo que cabe en una página), igual que en los árboles
+    void setNodeCapacity(int maxEntries) { m_capacity = maxEntries; }
+
+    bool add(qint64 key, RecordId rid);
+    quint64 count() const { return m_added; }
+    int runCount() const { return m_runs.size(); }
+    quint64 duplicatesSkipped() const { return m_duplicates; }
+
+    // Vacía el índice (ya abierto) y lo llena con las entradas agregadas
+    bool build(IndexFile *index);
+
+    QString errorString() const { return m_error; }
+
+private:
+    class SortedSource;
+
+    bool spillRun();
+    bool writeTree(IndexFile *index, SortedSource &source, quint64 total);
+    int capacity(bool leaf) const;
+    void removeRuns();
+    bool fail(const QString &error);
+
+    QString m_prefix;
+    int m_runEntries;
+    double m_fillFactor = DefaultFillFactor;
+    int m_capacity = 0;
+    QVector<IndexEntry> m_buffer;
+    QStringList m_runs;
+    quint64 m_added = 0;
+    quint64 m_duplicates = 0;
+    QString m_error;
+};
+
+#endif // INDEXBULKLOADER_H
@@ -0,0 +1,392 @@
+#include "IndexFile.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+// Distribución de la página de encabezado (después del encabezado común)
+constexpr char HeaderMagic[4] = { 'M', 'I', 'D', 'X' };
+constexpr int MagicOffset      = 16;
+constexpr int VersionOffset    = 20;
+constexpr int KindOffset       = 22;
+constexpr int RootOffset       = 24;
+constexpr int HeightOffset     = 28;
+constexpr int EntryCountOffset = 32;
+constexpr int FreeHeadOffset   = 40;
+constexpr int FirstLeafOffset  = 44;
+constexpr int SourceRecordsOffset = 48;
+constexpr int NamesOffset      = 64;
+
+void writeName(char *page, int &pos, const QString &name)
+{
+    const QByteArray utf8 = name.toUtf8().left(255);
+    pageWriteU16(page, pos, quint16(utf8.size()));
+    std::memcpy(page + pos + 2, utf8.constData(), utf8.size());
+    pos += 2 + utf8.size();
+}
+
+QString readName(const char *page, int &pos)
+{
+    const int len = qMin<int>(pageReadU16(page, pos), 255);
+    const QString name = QString::fromUtf8(page + pos + 2, len);
+    pos += 2 + len;
+    return name;
+}
+} // namespace
+
+IndexFile::~IndexFile()
+{
+    close();
+}
+
+bool IndexFile::open(const QString &path, Kind kind, const QString &tableName, const QString &fieldName)
+{
+    close();
+    m_error.clear();
+
+    if (!m_file.open(path)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    if (m_file.pageCount() == 0) {
+        if (m_file.allocatePage() != 0) {
+            m_error = m_file.errorString();
+            m_file.close();
+            return false;
+        }
+        m_kind = kind;
+        m_tableName = tableName;
+        m_fieldName = fieldName;
+        m_root = 0;
+        m_height = 0;
+        m_entryCount = 0;
+        m_freeHead = 0;
+        m_firstLeaf = 0;
+        m_sourceRecords = 0;
+        if (!writeHeader()) {
+            m_file.close();
+            return false;
+        }
+        return true;
+    }
+
+    if (!loadHeader()) {
+        m_file.close();
+        return false;
+    }
+    if (m_kind != kind) {
+        m_error = QStringLiteral("%1 es un índice de otro tipo").arg(path);
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+void IndexFile::close()
+{
+    if (!m_file.isOpen())
+        return;
+    if (m_headerDirty)
+        writeHeader();
+    m_file.close();
+}
+
+bool IndexFile::loadHeader()
+{
+    QByteArray page(PagedFile::PageSize, '\0');
+    if (!m_file.readPage(0, page.data())) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    const char *p = page.constData();
+    if (quint8(p[PagedFile::PageTypeOffset]) != HeaderPageType
+        || std::memcmp(p + MagicOffset, HeaderMagic, sizeof(HeaderMagic)) != 0) {
+        m_error = QStringLiteral("%1 no es un archivo de índice válido").arg(m_file.path());
+        return false;
+    }
+    if (pageReadU16(p, VersionOffset) > FormatVersion) {
+        m_error = QStringLiteral("Versión de índice no soportada");
+        return false;
+    }
+
+    m_kind = Kind(quint8(p[KindOffset]));
+    m_root = pageReadU32(p, RootOffset);
+    m_height = pageReadU32(p, HeightOffset);
+    m_entryCount = pageReadU64(p, EntryCountOffset);
+    m_freeHead = pageReadU32(p, FreeHeadOffset);
+    m_firstLeaf = pageReadU32(p, FirstLeafOffset);
+    m_sourceRecords = pageReadU64(p, SourceRecordsOffset);
+
+    int pos = NamesOffset;
+    m_tableName = readName(p, pos);
+    m_fieldName = readName(p, pos);
+
+    if (m_root >= m_file.pageCount() || m_freeHead >= m_file.pageCount()) {
+        m_error = QStringLiteral("Encabezado de índice dañado en %1").arg(m_file.path());
+        return false;
+    }
+    m_headerDirty = false;
+    return true;
+}
+
+bool IndexFile::writeHeader()
+{
+    QByteArray page(PagedFile::PageSize, '\0');
+    char *p = page.data();
+    p[PagedFile::PageTypeOffset] = char(HeaderPageType);
+    std::memcpy(p + MagicOffset, HeaderMagic, sizeof(HeaderMagic));
+    pageWriteU16(p, VersionOffset, FormatVersion);
+    p[KindOffset] = char(m_kind);
+    pageWriteU32(p, RootOffset, m_root);
+    pageWriteU32(p, HeightOffset, m_height);
+    pageWriteU64(p, EntryCountOffset, m_entryCount);
+    pageWriteU32(p, FreeHeadOffset, m_freeHead);
+    pageWriteU32(p, FirstLeafOffset, m_firstLeaf);
+    pageWriteU64(p, SourceRecordsOffset, m_sourceRecords);
+
+    int pos = NamesOffset;
+    writeName(p, pos, m_tableName);
+    writeName(p, pos, m_fieldName);
+
+    if (!m_file.writePage(0, p)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_headerDirty = false;
+    return true;
+}
+
+bool IndexFile::setFieldName(const QString &fieldName)
+{
+    m_fieldName = fieldName;
+    return writeHeader();
+}
+
+void IndexFile::setRoot(quint32 root, quint32 height)
+{
+    m_root = root;
+    m_height = height;
+    m_headerDirty = true;
+}
+
+void IndexFile::setEntryCount(quint64 count)
+{
+    m_entryCount = count;
+    m_headerDirty = true;
+}
+
+void IndexFile::setFirstLeaf(quint32 page)
+{
+    m_firstLeaf = page;
+    m_headerDirty = true;
+}
+
+void IndexFile::setSourceRecords(quint64 count)
+{
+    if (m_sourceRecords == count)
+        return;
+    m_sourceRecords = count;
+    m_headerDirty = true;
+}
+
+bool IndexFile::readNode(quint32 pageNo, IndexNode *node)
+{
+    if (pageNo == 0) {
+        m_error = QStringLiteral("Nodo de índice inválido");
+        return false;
+    }
+    QByteArray page(PagedFile::PageSize, '\0');
+    if (!m_file.readPage(pageNo, page.data())) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    const char *p = page.constData();
+    const quint8 type = quint8(p[PagedFile::PageTypeOffset]);
+    if (type != LeafPageType && type != InternalPageType) {
+        m_error = QStringLiteral("La página %1 no es un nodo de índice").arg(pageNo);
+        return false;
+    }
+
+    node->leaf = (type == LeafPageType);
+    node->next = pageReadU32(p, NextOffset);
+    const int count = qMin<int>(pageReadU16(p, CountOffset), maxEntries(node->leaf));
+    node->entries.resize(count);
+    node->children.clear();
+
+    if (node->leaf) {
+        int pos = PagedFile::PageHeaderSize;
+        for (int i = 0; i < count; ++i, pos += LeafEntrySize) {
+            node->entries[i].key = qint64(pageReadU64(p, pos));
+            node->entries[i].value = pageReadU64(p, pos + 8);
+        }
+    } else {
+        node->children.resize(count + 1);
+        node->children[0] = pageReadU32(p, PagedFile::PageHeaderSize);
+        int pos = PagedFile::PageHeaderSize + 4;
+        for (int i = 0; i < count; ++i, pos += InternalEntrySize) {
+            node->entries[i].key = qint64(pageReadU64(p, pos));
+            node->entries[i].value = pageReadU64(p, pos + 8);
+            node->children[i + 1] = pageReadU32(p, pos + 16);
+        }
+    }
+    return true;
+}
+
+bool IndexFile::writeNode(quint32 pageNo, const IndexNode &node)
+{
+    const int count = node.entries.size();
+    if (count > maxEntries(node.leaf) || (!node.leaf && node.children.size() != count + 1)) {
+        m_error = QStringLiteral("Nodo de índice con tamaño inválido (%1 entradas)").arg(count);
+        return false;
+    }
+
+    QByteArray page(PagedFile::PageSize, '\0');
+    char *p = page.data();
+    p[PagedFile::PageTypeOffset] = char(node.leaf ? LeafPageType : InternalPageType);
+    pageWriteU16(p, CountOffset, quint16(count));
+    pageWriteU32(p, NextOffset, node.next);
+
+    if (node.leaf) {
+        int pos = PagedFile::PageHeaderSize;
+        for (const IndexEntry &entry : node.entries) {
+            pageWriteU64(p, pos, quint64(entry.key));
+            pageWriteU64(p, pos + 8, entry.value);
+            pos += LeafEntrySize;
+        }
+    } else {
+        pageWriteU32(p, PagedFile::PageHeaderSize, node.children.at(0));
+        int pos = PagedFile::PageHeaderSize + 4;
+        for (int i = 0; i < count; ++i, pos += InternalEntrySize) {
+            pageWriteU64(p, pos, quint64(node.entries.at(i).key));
+            pageWriteU64(p, pos + 8, node.entries.at(i).value);
+            pageWriteU32(p, pos + 16, node.children.at(i + 1));
+        }
+    }
+
+    if (!m_file.writePage(pageNo, p)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    return true;
+}
+
+quint32 IndexFile::allocateNode()
+{
+    if (m_freeHead != 0) {
+        QByteArray page(PagedFile::PageSize, '\0');
+        if (m_file.readPage(m_freeHead, page.data())) {
+            const quint32 pageNo = m_freeHead;
+            m_freeHead = pageReadU32(page.constData(), NextOffset);
+            m_headerDirty = true;
+            return pageNo;
+        }
+        // Lista de páginas libres dañada: se descarta
+        qDebug() << "WARNING: Lista de páginas libres del índice dañada:" << m_file.path();
+        m_freeHead = 0;
+        m_headerDirty = true;
+    }
+
+    const quint32 pageNo = m_file.allocatePage();
+    if (pageNo == 0xFFFFFFFF) {
+        m_error = m_file.errorString();
+        return 0;
+    }
+    return pageNo;
+}
+
+void IndexFile::freeNode(quint32 pageNo)
+{
+    if (pageNo == 0 || pageNo >= m_file.pageCount())
+        return;
+
+    QByteArray page(PagedFile::PageSize, '\0');
+    page[PagedFile::PageTypeOffset] = char(FreePageType);
+    pageWriteU32(page.data(), NextOffset, m_freeHead);
+    if (m_file.writePage(pageNo, page.constData())) {
+        m_freeHead = pageNo;
+        m_headerDirty = true;
+    }
+}
+
+IndexStats IndexFile::statistics()
+{
+    IndexStats stats;
+    stats.height = m_height;
+    if (m_root == 0)
+        return stats;
+
+    quint64 leafEntries = 0;
+    quint64 internalEntries = 0;
+    QVector<quint32> level{ m_root };
+    IndexNode node;
+    while (!level.isEmpty()) {
+        QVector<quint32> nextLevel;
+        for (const quint32 pageNo : level) {
+            if (!readNode(pageNo, &node))
+                return stats;
+            if (node.leaf) {
+                stats.leafNodes++;
+                leafEntries += node.entries.size();
+            } else {
+                stats.internalNodes++;
+                internalEntries += node.entries.size();
+                nextLevel += node.children;
+            }
+            stats.entries += node.entries.size();
+        }
+        level = nextLevel;
+    }
+
+    if (stats.leafNodes > 0)
+        stats.leafFill = double(leafEntries) / (double(stats.leafNodes) * MaxLeafEntries);
+    if (stats.internalNodes > 0)
+        stats.internalFill = double(internalEntries) / (double(stats.internalNodes) * MaxInternalEntries);
+    return stats;
+}
+
+bool IndexFile::clear()
+{
+    if (!isOpen())
+        return false;
+    if (!m_file.truncate(1)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_root = 0;
+    m_height = 0;
+    m_entryCount = 0;
+    m_freeHead = 0;
+    m_firstLeaf = 0;
+    m_sourceRecords = 0;
+    return writeHeader();
+}
+
+bool IndexFile::sync()
+{
+    if (!isOpen())
+        return false;
+    if (m_headerDirty && !writeHeader())
+        return false;
+    return m_file.sync();
+}
+
+bool IndexFile::reloadHeader()
+{
+    if (!isOpen())
+        return false;
+    return loadHeader();
+}
+
+QString IndexFile::fileNameFor(const QString &tableName, const QString &fieldName, const QString &extension)
+{
+    auto safe = [](const QString &name) {
+        QString out;
+        for (const QChar c : name)
+            out.append((c.isLetterOrNumber() || c == '_' || c == '-') ? c : QChar('_'));
+        return out;
+    };
+    return safe(tableName) + "." + safe(fieldName) + "." + extension;
+}
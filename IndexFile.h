@@ -0,0 +1,148 @@
+#ifndef INDEXFILE_H
+#define INDEXFILE_H
+
+#include <QString>
+#include <QVector>
+#include "PagedFile.h"
+#include "RecordId.h"
+
+// Entrada de un índice: clave numérica + identificador del registro.
+// Las entradas se ordenan por (clave, registro), así las claves repetidas
+// quedan juntas y cada entrada sigue siendo única dentro del árbol.
+struct IndexEntry {
+    qint64 key = 0;
+    quint64 value = 0; // RecordId::toUInt64()
+
+    RecordId recordId() const { return RecordId::fromUInt64(value); }
+
+    bool operator==(const IndexEntry &other) const { return key == other.key && value == other.value; }
+    bool operator!=(const IndexEntry &other) const { return !(*this == other); }
+    bool operator<(const IndexEntry &other) const {
+        return key < other.key || (key == other.key && value < other.value);
+    }
+};
+
+// Nodo de un árbol decodificado en memoria
+struct IndexNode {
+    bool leaf = true;
+    quint32 next = 0;               // hoja siguiente (B+) o 0
+    QVector<IndexEntry> entries;
+    QVector<quint32> children;      // entries.size() + 1 en nodos internos
+};
+
+// Ocupación de un árbol: se calcula recorriendo todos sus nodos
+struct IndexStats {
+    quint32 height = 0;
+    quint64 entries = 0;
+    quint32 leafNodes = 0;
+    quint32 internalNodes = 0;
+    double leafFill = 0.0;      // entradas / capacidad, promedio sobre las hojas
+    double internalFill = 0.0;  // ídem para los nodos internos
+};
+
+// Archivo de índice (indexes/<tabla>.<campo>.<tipo>), común a los árboles B, B+ y B*.
+//
+// Página 0: encabezado (raíz, altura, cantidad de entradas, registros de la
+// tabla al sincronizar, tabla y campo).
+// Páginas de nodo, después del encabezado común de 16 bytes:
+//   [2] quint16 cantidad de entradas
+//   [4] quint32 siguiente hoja (B+) o siguiente página libre
+//   hoja:    entradas { qint64 clave, quint64 registro }
+//   interno: quint32 hijo0, luego { qint64 clave, quint64 registro, quint32 hijo }
+class IndexFile {
+public:
+    enum Kind : quint8 {
+        BTreeKind     = 0,
+        BPlusTreeKind = 1,
+        BStarTreeKind = 2
+    };
+
+    static constexpr quint16 FormatVersion = 1;
+    static constexpr int LeafEntrySize = 16;
+    static constexpr int InternalEntrySize = 20;
+    static constexpr int MaxLeafEntries = (PagedFile::PageSize - PagedFile::PageHeaderSize) / LeafEntrySize;
+    static constexpr int MaxInternalEntries = (PagedFile::PageSize - PagedFile::PageHeaderSize - 4) / InternalEntrySize;
+
+    IndexFile() = default;
+    ~IndexFile();
+
+    IndexFile(const IndexFile&) = delete;
+    IndexFile& operator=(const IndexFile&) = delete;
+
+    // Abre el índice; si no existe lo crea vacío. Falla si el archivo es de otro tipo.
+    bool open(const QString &path, Kind kind, const QString &tableName, const QString &fieldName);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    QString path() const { return m_file.path(); }
+    QString errorString() const { return m_error; }
+    Kind kind() const { return m_kind; }
+    QString tableName() const { return m_tableName; }
+    QString fieldName() const { return m_fieldName; }
+
+    quint32 root() const { return m_root; }
+    quint32 height() const { return m_height; }
+    quint64 entryCount() const { return m_entryCount; }
+    quint32 firstLeaf() const { return m_firstLeaf; }
+    quint32 pageCount() const { return m_file.pageCount(); }
+    void setRoot(quint32 root, quint32 height);
+    void setEntryCount(quint64 count);
+    void setFirstLeaf(quint32 page);
+    // Registros que tenía la tabla la última vez que el índice se sincronizó
+    // con ella (0 en índices anteriores a este campo). Las entradas no sirven
+    // para eso: los registros sin clave no tienen entrada.
+    quint64 sourceRecords() const { return m_sourceRecords; }
+    void setSourceRecords(quint64 count);
+    bool setFieldName(const QString &fieldName);   // el campo indexado cambió de nombre
+
+    bool readNode(quint32 pageNo, IndexNode *node);
+    bool writeNode(quint32 pageNo, const IndexNode &node);
+
+    // Páginas de nodo (reutiliza las liberadas)
+    quint32 allocateNode();
+    void freeNode(quint32 pageNo);
+
+    // Recorre el árbol completo (para diagnósticos y benchmarks)
+    IndexStats statistics();
+
+    // Deja el índice vacío
+    bool clear();
+    bool sync();
+    // Vuelve a leer el encabezado de la página 0 (tras deshacer una
+    // transacción del log, el que está en memoria quedó adelantado)
+    bool reloadHeader();
+
+    // Registra las escrituras en el log del proyecto (ver WriteAheadLog)
+    void setWriteAheadLog(WriteAheadLog *log) { m_file.setWriteAheadLog(log); }
+
+    static int maxEntries(bool leaf) { return leaf ? MaxLeafEntries : MaxInternalEntries; }
+
+    // Nombre de archivo seguro para <tabla>.<campo>.<extensión>
+    static QString fileNameFor(const QString &tableName, const QString &fieldName, const QString &extension);
+
+private:
+    static constexpr quint8 HeaderPageType = 10;
+    static constexpr quint8 InternalPageType = 11;
+    static constexpr quint8 LeafPageType = 12;
+    static constexpr quint8 FreePageType = 13;
+    static constexpr int CountOffset = 2;
+    static constexpr int NextOffset = 4;
+
+    bool loadHeader();
+    bool writeHeader();
+
+    PagedFile m_file;
+    Kind m_kind = BTreeKind;
+    QString m_tableName;
+    QString m_fieldName;
+    quint32 m_root = 0;
+    quint32 m_height = 0;
+    quint64 m_entryCount = 0;
+    quint32 m_freeHead = 0;
+    quint32 m_firstLeaf = 0;
+    quint64 m_sourceRecords = 0;
+    bool m_headerDirty = false;
+    QString m_error;
+};
+
+#endif // INDEXFILE_H
@@ -0,0 +1,63 @@
+#include "IndexKey.h"
+#include "Currency.h"
+#include "CompactDate.h"
+
+#include <cstring>
+
+bool IndexKey::isIndexableType(const QString &fieldType)
+{
+    return fieldType == "Entero" || fieldType == "Decimales"
+           || fieldType == "moneda" || fieldType == "fecha";
+}
+
+std::optional<qint64> IndexKey::encode(const QString &fieldType, const QString &value)
+{
+    const QString v = value.trimmed();
+    if (v.isEmpty())
+        return std::nullopt;
+
+    if (fieldType == "Entero") {
+        bool ok = false;
+        const qint64 number = v.toLongLong(&ok);
+        return ok ? std::optional<qint64>(number) : std::nullopt;
+    }
+    if (fieldType == "Decimales") {
+        bool ok = false;
+        const double number = v.toDouble(&ok);
+        return ok ? std::optional<qint64>(fromDouble(number)) : std::nullopt;
+    }
+    if (fieldType == "moneda")
+        return parseCents(v);
+    if (fieldType == "fecha")
+        return parseDay(v);
+    return std::nullopt;
+}
+
+qint64 IndexKey::fromDouble(double value)
+{
+    if (value == 0.0)
+        value = 0.0; // -0.0 y 0.0 son la misma clave
+
+    qint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // Los negativos tienen el orden invertido en su representación
+    return bits < 0 ? bits ^ Q_INT64_C(0x7FFFFFFFFFFFFFFF) : bits;
+}
+
+std::optional<qint64> IndexKey::parseCents(const QString &value)
+{
+    // Acepta "Lps 1,500.00", "$1,500.00", "1500", "-12,5"... (ver Currency::parse)
+    const std::optional<Currency> amount = Currency::parse(value);
+    if (!amount)
+        return std::nullopt;
+    return amount->cents();
+}
+
+std::optional<qint64> IndexKey::parseDay(const QString &value)
+{
+    // Mismos formatos que acepta la vista de datos: dd-MM-aaaa, dd/MM/aa...
+    const std::optional<CompactDate> date = CompactDate::parse(value);
+    if (!date)
+        return std::nullopt;
+    return date->day();
+}
@@ -0,0 +1,23 @@
+#ifndef INDEXKEY_H
+#define INDEXKEY_H
+
+#include <QString>
+#include <optional>
+
+// Conversión de valores de celda a claves de índice qint64 que conservan el
+// orden del tipo de campo, para poder hacer búsquedas por rango:
+//   "Entero"    → el mismo número
+//   "Decimales" → bits del double reordenados (negativos antes que positivos)
+//   "moneda"    → centavos
+//   "fecha"     → número de día juliano
+class IndexKey {
+public:
+    static bool isIndexableType(const QString &fieldType);
+    static std::optional<qint64> encode(const QString &fieldType, const QString &value);
+
+    static qint64 fromDouble(double value);
+    static std::optional<qint64> parseCents(const QString &value);
+    static std::optional<qint64> parseDay(const QString &value);
+};
+
+#endif // INDEXKEY_H
@@ -0,0 +1,233 @@
+#include "PagedFile.h"
+#include "BufferPool.h"
+#include "WriteAheadLog.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+PagedFile::PagedFile()
+    : m_poolId(BufferPool::instance().registerFile())
+{
+}
+
+PagedFile::~PagedFile()
+{
+    close();
+}
+
+bool PagedFile::open(const QString &path)
+{
+    close();
+    m_error.clear();
+
+    m_file.setFileName(path);
+    // Sin buffer: cada página escrita llega al sistema de archivos de inmediato
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Unbuffered)) {
+        m_error = QStringLiteral("No se pudo abrir %1: %2").arg(path, m_file.errorString());
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    if (size % PageSize != 0) {
+        // Una escritura interrumpida dejó una página incompleta: se descarta
+        qDebug() << "WARNING: Archivo con página incompleta, se truncará:" << path;
+        m_file.resize(size - (size % PageSize));
+    }
+    m_pageCount = static_cast<quint32>(m_file.size() / PageSize);
+    if (m_log)
+        m_log->attach(this);
+    return true;
+}
+
+void PagedFile::close()
+{
+    if (m_file.isOpen()) {
+        if (m_log)
+            m_log->detach(this);
+        BufferPool &pool = BufferPool::instance();
+        pool.flush(this);
+        pool.discard(this);
+        m_file.flush();
+        m_file.close();
+    }
+    m_pageCount = 0;
+}
+
+bool PagedFile::readPage(quint32 pageNo, char *buffer)
+{
+    if (!m_file.isOpen() || pageNo >= m_pageCount) {
+        m_error = QStringLiteral("Página fuera de rango: %1").arg(pageNo);
+        return false;
+    }
+    BufferPool &pool = BufferPool::instance();
+    const char *page = pool.pin(this, pageNo);
+    if (!page) {
+        m_error = QStringLiteral("No se pudo cargar la página %1").arg(pageNo);
+        return false;
+    }
+    std::memcpy(buffer, page, PageSize);
+    pool.unpin(this, pageNo, false);
+    return true;
+}
+
+bool PagedFile::writePage(quint32 pageNo, const char *buffer)
+{
+    if (!m_file.isOpen() || pageNo >= m_pageCount) {
+        m_error = QStringLiteral("Página fuera de rango: %1").arg(pageNo);
+        return false;
+    }
+    // Sin log la página se reemplaza completa: no hace falta leerla del disco
+    BufferPool &pool = BufferPool::instance();
+    char *page = pool.pin(this, pageNo, m_log == nullptr);
+    if (!page) {
+        m_error = QStringLiteral("No se pudo cargar la página %1").arg(pageNo);
+        return false;
+    }
+    if (!m_log) {
+        std::memcpy(page, buffer, PageSize);
+        pool.unpin(this, pageNo, true);
+        return true;
+    }
+
+    // Con log: se registran los bytes que cambian y la página toma el LSN del registro
+    char after[PageSize];
+    std::memcpy(after, buffer, PageSize);
+    std::memcpy(after + PageLsnOffset, page + PageLsnOffset, 8);
+    quint64 lsn = 0;
+    if (!m_log->logPageWrite(this, pageNo, page, after, &lsn)) {
+        pool.unpin(this, pageNo, false);
+        m_error = QStringLiteral("No se pudo registrar la página %1 en el log").arg(pageNo);
+        return false;
+    }
+    if (lsn != 0) {
+        std::memcpy(page, after, PageSize);
+        pageWriteU64(page, PageLsnOffset, lsn);
+    }
+    pool.unpin(this, pageNo, lsn != 0);
+    return true;
+}
+
+bool PagedFile::readFromDisk(quint32 pageNo, char *buffer)
+{
+    if (!m_file.seek(qint64(pageNo) * PageSize)
+        || m_file.read(buffer, PageSize) != PageSize) {
+        m_error = QStringLiteral("Error leyendo la página %1: %2").arg(pageNo).arg(m_file.errorString());
+        return false;
+    }
+    return true;
+}
+
+bool PagedFile::writeToDisk(quint32 pageNo, const char *buffer)
+{
+    // Regla del log: la página no llega al disco antes que su registro
+    const quint64 lsn = pageReadU64(buffer, PageLsnOffset);
+    if (m_log && lsn != 0 && !m_log->flushTo(lsn)) {
+        m_error = QStringLiteral("No se pudo escribir el log antes de la página %1").arg(pageNo);
+        return false;
+    }
+    if (!m_file.seek(qint64(pageNo) * PageSize)
+        || m_file.write(buffer, PageSize) != PageSize) {
+        m_error = QStringLiteral("Error escribiendo la página %1: %2").arg(pageNo).arg(m_file.errorString());
+        return false;
+    }
+    return true;
+}
+
+quint32 PagedFile::allocatePage()
+{
+    if (!m_file.isOpen())
+        return 0xFFFFFFFF;
+
+    const QByteArray zeros(PageSize, '\0');
+    if (!m_file.seek(qint64(m_pageCount) * PageSize)
+        || m_file.write(zeros.constData(), PageSize) != PageSize) {
+        m_error = QStringLiteral("No se pudo agregar una página: %1").arg(m_file.errorString());
+        return 0xFFFFFFFF;
+    }
+    return m_pageCount++;
+}
+
+bool PagedFile::truncate(quint32 pageCount)
+{
+    if (!m_file.isOpen() || pageCount > m_pageCount)
+        return false;
+    if (m_log && !m_log->logTruncate(this, pageCount)) {
+        m_error = QStringLiteral("No se pudo registrar el truncado en el log");
+        return false;
+    }
+    // Las páginas que desaparecen no deben volver al disco desde la caché
+    BufferPool::instance().discard(this, pageCount);
+    m_file.flush();
+    if (!m_file.resize(qint64(pageCount) * PageSize)) {
+        m_error = QStringLiteral("No se pudo truncar el archivo: %1").arg(m_file.errorString());
+        return false;
+    }
+    m_pageCount = pageCount;
+    return true;
+}
+
+bool PagedFile::sync()
+{
+    if (!m_file.isOpen())
+        return false;
+    if (m_log)
+        return true;
+    return BufferPool::instance().flush(this) && m_file.flush();
+}
+
+bool PagedFile::flushToDisk()
+{
+    if (!m_file.isOpen())
+        return false;
+    if (!BufferPool::instance().flush(this) || !fsyncFile(m_file)) {
+        if (m_error.isEmpty())
+            m_error = QStringLiteral("No se pudo sincronizar el archivo: %1").arg(m_file.errorString());
+        return false;
+    }
+    return true;
+}
+
+void PagedFile::setWriteAheadLog(WriteAheadLog *log)
+{
+    if (log == m_log)
+        return;
+    if (m_file.isOpen() && m_log)
+        m_log->detach(this);
+    m_log = log;
+    if (m_file.isOpen() && m_log)
+        m_log->attach(this);
+}
+
+bool PagedFile::fsyncDirectory(const QString &dirPath)
+{
+#ifdef Q_OS_WIN
+    Q_UNUSED(dirPath);
+    return true;
+#else
+    const int fd = ::open(QFile::encodeName(dirPath).constData(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    const bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+#endif
+}
+
+bool PagedFile::fsyncFile(QFile &file)
+{
+    if (!file.flush())
+        return false;
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
@@ -0,0 +1,96 @@
+#ifndef PAGEDFILE_H
+#define PAGEDFILE_H
+
+#include <QFile>
+#include <QString>
+#include <QtEndian>
+
+class WriteAheadLog;
+
+// Archivo dividido en páginas de tamaño fijo. Es la capa más baja del motor de
+// almacenamiento: las tablas (.mad) leen y escriben páginas completas a través
+// de esta clase, nunca bytes sueltos.
+//
+// Las lecturas y escrituras pasan por la caché compartida (BufferPool): una
+// página escrita queda en memoria hasta que se desaloja o hasta sync()/close().
+// Con un WriteAheadLog enlazado, cada escritura se registra antes en el log.
+//
+// Todas las páginas comienzan con un encabezado común de 16 bytes:
+//   [0]  quint8  tipo de página
+//   [1]  quint8  banderas (libre para cada tipo)
+//   [2]  6 bytes que define cada tipo de página
+//   [8]  quint64 LSN de la última modificación (0 si no se usa)
+class PagedFile {
+public:
+    static constexpr int PageSize = 8192;
+    static constexpr int PageHeaderSize = 16;
+    static constexpr int PageTypeOffset = 0;
+    static constexpr int PageLsnOffset = 8;
+
+    PagedFile();
+    ~PagedFile();
+
+    PagedFile(const PagedFile&) = delete;
+    PagedFile& operator=(const PagedFile&) = delete;
+
+    // Abre el archivo (lo crea vacío si no existe)
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    QString path() const { return m_file.fileName(); }
+    QString errorString() const { return m_error; }
+
+    quint32 pageCount() const { return m_pageCount; }
+
+    // Lee/escribe la página completa (buffer de PageSize bytes)
+    bool readPage(quint32 pageNo, char *buffer);
+    bool writePage(quint32 pageNo, const char *buffer);
+
+    // Agrega una página en ceros al final del archivo y retorna su número
+    // (0xFFFFFFFF si falla)
+    quint32 allocatePage();
+
+    // Deja el archivo con las primeras `pageCount` páginas
+    bool truncate(quint32 pageCount);
+
+    // Escribe las páginas modificadas que están en la caché. Con log no hace
+    // nada: la durabilidad la da la confirmación de la transacción.
+    bool sync();
+
+    // Escribe las páginas de la caché y fuerza el fsync del archivo
+    bool flushToDisk();
+
+    // Log del proyecto; se mantiene al cerrar y reabrir (p. ej. al compactar)
+    void setWriteAheadLog(WriteAheadLog *log);
+    WriteAheadLog *writeAheadLog() const { return m_log; }
+
+    // QFile::flush() solo vacía el buffer de Qt; esto llega hasta el disco
+    static bool fsyncFile(QFile &file);
+    // Hace durables los renombres y borrados dentro de una carpeta (sin efecto en Windows)
+    static bool fsyncDirectory(const QString &dirPath);
+
+private:
+    friend class BufferPool;
+    friend class WriteAheadLog;
+
+    // Acceso directo al disco, solo para la caché
+    bool readFromDisk(quint32 pageNo, char *buffer);
+    bool writeToDisk(quint32 pageNo, const char *buffer);
+
+    QFile m_file;
+    quint32 m_poolId;
+    WriteAheadLog *m_log = nullptr;
+    quint32 m_pageCount = 0;
+    QString m_error;
+};
+
+// Acceso little-endian a campos dentro de un buffer de página
+inline quint16 pageReadU16(const char *page, int offset) { return qFromLittleEndian<quint16>(page + offset); }
+inline quint32 pageReadU32(const char *page, int offset) { return qFromLittleEndian<quint32>(page + offset); }
+inline quint64 pageReadU64(const char *page, int offset) { return qFromLittleEndian<quint64>(page + offset); }
+inline void pageWriteU16(char *page, int offset, quint16 value) { qToLittleEndian<quint16>(value, page + offset); }
+inline void pageWriteU32(char *page, int offset, quint32 value) { qToLittleEndian<quint32>(value, page + offset); }
+inline void pageWriteU64(char *page, int offset, quint64 value) { qToLittleEndian<quint64>(value, page + offset); }
+
+#endif // PAGEDFILE_H
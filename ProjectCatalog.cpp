@@ -0,0 +1,358 @@
+#include "ProjectCatalog.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace {
+const char *const IndexFileName = ".catalog";
+const char *const MetaFileName = "project.meta.json";
+const char *const TablesDirName = "tables";
+
+qint64 modifiedStamp(const QFileInfo &info)
+{
+    return info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0;
+}
+} // namespace
+
+ProjectCatalog& ProjectCatalog::instance()
+{
+    static ProjectCatalog instance;
+    return instance;
+}
+
+ProjectCatalog::ProjectCatalog(QObject *parent)
+    : QObject(parent)
+{
+    m_pendingTimer.setSingleShot(true);
+    m_pendingTimer.setInterval(RefreshDelayMs);
+    connect(&m_pendingTimer, &QTimer::timeout, this, &ProjectCatalog::processPending);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &ProjectCatalog::onPathChanged);
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, &ProjectCatalog::onPathChanged);
+}
+
+QString ProjectCatalog::indexPath() const
+{
+    return m_root.isEmpty() ? QString() : QDir(m_root).filePath(IndexFileName);
+}
+
+QString ProjectCatalog::projectPath(const QString &name) const
+{
+    return QDir(m_root).filePath(name);
+}
+
+QString ProjectCatalog::projectForPath(const QString &path) const
+{
+    const QString relative = QDir(m_root).relativeFilePath(path);
+    if (relative.isEmpty() || relative == "." || relative.startsWith(".."))
+        return QString();
+    return relative.section('/', 0, 0);
+}
+
+void ProjectCatalog::ensureLoaded()
+{
+    if (m_loaded)
+        return;
+    m_loaded = true;
+
+    auto rootOpt = ProjectStorageQt::projectsRoot();
+    if (!rootOpt.has_value()) {
+        qDebug() << "WARNING: No se encontró la raíz del repositorio; el catálogo de proyectos queda vacío";
+        return;
+    }
+    m_root = rootOpt.value();
+
+    if (loadIndex()) {
+        // Se muestra lo del índice y se compara con el disco en el próximo ciclo de eventos
+        watchRoot();
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it)
+            watchProject(it.key());
+        QTimer::singleShot(0, this, &ProjectCatalog::refresh);
+        return;
+    }
+
+    // Sin índice (primera vez o formato viejo): hay que leer todo una vez
+    watchRoot();
+    rescanAll();
+    saveIndex();
+}
+
+QList<ProjectInfoQt> ProjectCatalog::projects()
+{
+    ensureLoaded();
+    if (m_sortedDirty) {
+        m_sorted.clear();
+        m_sorted.reserve(m_entries.size());
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it)
+            m_sorted.append(it->info);
+        std::sort(m_sorted.begin(), m_sorted.end(),
+                  [](const ProjectInfoQt &a, const ProjectInfoQt &b) {
+                      if (a.modified != b.modified)
+                          return a.modified > b.modified;
+                      return a.name < b.name;
+                  });
+        m_sortedDirty = false;
+    }
+    return m_sorted;
+}
+
+std::optional<ProjectInfoQt> ProjectCatalog::project(const QString &name)
+{
+    ensureLoaded();
+    auto it = m_entries.constFind(name);
+    if (it == m_entries.constEnd())
+        return std::nullopt;
+    return it->info;
+}
+
+int ProjectCatalog::count()
+{
+    ensureLoaded();
+    return m_entries.size();
+}
+
+void ProjectCatalog::refreshProject(const QString &name)
+{
+    ensureLoaded();
+    if (m_root.isEmpty())
+        return;
+    watchRoot(); // proyectos/ puede haberse creado con este proyecto
+    if (revalidate(name)) {
+        saveIndex();
+        emit projectsChanged();
+    }
+}
+
+void ProjectCatalog::refresh()
+{
+    ensureLoaded();
+    if (m_root.isEmpty())
+        return;
+    watchRoot();
+    if (rescanAll()) {
+        saveIndex();
+        emit projectsChanged();
+    }
+}
+
+ProjectCatalog::Stamps ProjectCatalog::readStamps(const QString &name) const
+{
+    const QString path = projectPath(name);
+    const QFileInfo meta(QDir(path).filePath(MetaFileName));
+
+    Stamps stamps;
+    stamps.dir = modifiedStamp(QFileInfo(path));
+    stamps.meta = modifiedStamp(meta);
+    stamps.metaSize = meta.exists() ? meta.size() : -1;
+    stamps.tables = modifiedStamp(QFileInfo(QDir(path).filePath(TablesDirName)));
+    return stamps;
+}
+
+bool ProjectCatalog::revalidate(const QString &name)
+{
+    const QString path = projectPath(name);
+    auto it = m_entries.find(name);
+
+    std::optional<ProjectInfoQt> info;
+    Stamps stamps;
+    if (QFileInfo(path).isDir()) {
+        stamps = readStamps(name);
+        // Las fechas no cambiaron: lo del catálogo sigue valiendo
+        if (it != m_entries.end() && it->stamps == stamps)
+            return false;
+        info = ProjectStorageQt::readProjectInfo(path);
+    }
+
+    if (!info.has_value()) {
+        if (it == m_entries.end())
+            return false;
+        qDebug() << "DEBUG: Proyecto quitado del catálogo:" << name;
+        unwatchProject(name);
+        m_entries.erase(it);
+        m_sortedDirty = true;
+        return true;
+    }
+
+    m_entries.insert(name, Entry{ info.value(), stamps });
+    watchProject(name);
+    m_sortedDirty = true;
+    return true;
+}
+
+bool ProjectCatalog::rescanRoot()
+{
+    const QStringList names = QDir(m_root).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    const QSet<QString> onDisk(names.begin(), names.end());
+
+    bool changed = false;
+    const QStringList known = m_entries.keys();
+    for (const QString &name : known) {
+        if (!onDisk.contains(name))
+            changed = revalidate(name) || changed;
+    }
+    for (const QString &name : names) {
+        if (!m_entries.contains(name))
+            changed = revalidate(name) || changed;
+    }
+    return changed;
+}
+
+bool ProjectCatalog::rescanAll()
+{
+    bool changed = rescanRoot();
+    const QStringList known = m_entries.keys();
+    for (const QString &name : known)
+        changed = revalidate(name) || changed;
+    return changed;
+}
+
+void ProjectCatalog::watchRoot()
+{
+    if (!m_watched.contains(m_root) && QFileInfo(m_root).isDir() && m_watcher.addPath(m_root))
+        m_watched.insert(m_root);
+}
+
+void ProjectCatalog::watchProject(const QString &name)
+{
+    const QString path = projectPath(name);
+    const QStringList paths = {
+        path,
+        QDir(path).filePath(MetaFileName),
+        QDir(path).filePath(TablesDirName)
+    };
+    for (const QString &p : paths) {
+        if (!m_watched.contains(p) && QFileInfo::exists(p) && m_watcher.addPath(p))
+            m_watched.insert(p);
+    }
+}
+
+void ProjectCatalog::unwatchProject(const QString &name)
+{
+    const QString path = projectPath(name);
+    const QStringList paths = {
+        path,
+        QDir(path).filePath(MetaFileName),
+        QDir(path).filePath(TablesDirName)
+    };
+    for (const QString &p : paths) {
+        if (m_watched.remove(p) && QFileInfo::exists(p))
+            m_watcher.removePath(p);
+    }
+}
+
+void ProjectCatalog::onPathChanged(const QString &path)
+{
+    // Una ruta borrada (o reemplazada al guardar) deja de vigilarse sola
+    if (!QFileInfo::exists(path))
+        m_watched.remove(path);
+
+    if (path == m_root) {
+        m_pendingRescan = true;
+    } else {
+        const QString name = projectForPath(path);
+        if (!name.isEmpty())
+            m_pending.insert(name);
+    }
+    m_pendingTimer.start();
+}
+
+void ProjectCatalog::processPending()
+{
+    bool changed = false;
+    if (m_pendingRescan) {
+        m_pendingRescan = false;
+        changed = rescanRoot();
+    }
+    const QSet<QString> pending = m_pending;
+    m_pending.clear();
+    for (const QString &name : pending) {
+        changed = revalidate(name) || changed;
+        // Una meta reemplazada se vuelve a vigilar aunque no haya cambiado nada
+        if (m_entries.contains(name))
+            watchProject(name);
+    }
+
+    if (changed) {
+        qDebug() << "DEBUG: Catálogo de proyectos actualizado:" << m_entries.size() << "proyectos";
+        saveIndex();
+        emit projectsChanged();
+    }
+}
+
+bool ProjectCatalog::loadIndex()
+{
+    QFile file(indexPath());
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 count = 0;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != IndexMagic || version != IndexVersion) {
+        qDebug() << "WARNING: Índice de proyectos ignorado (formato desconocido):" << file.fileName();
+        return false;
+    }
+
+    QHash<QString, Entry> entries;
+    entries.reserve(int(count));
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Entry entry;
+        ProjectInfoQt &info = entry.info;
+        qint32 projectVersion = 1;
+        qint32 tableCount = 0;
+        in >> info.name >> info.displayName >> info.description >> projectVersion
+           >> info.created >> info.modified >> info.isValid >> tableCount >> info.tableNames
+           >> entry.stamps.dir >> entry.stamps.meta >> entry.stamps.metaSize >> entry.stamps.tables;
+        // Las rutas no se guardan: el repo pudo moverse de lugar
+        info.path = projectPath(info.name);
+        info.metaPath = QDir(info.path).filePath(MetaFileName);
+        info.version = projectVersion;
+        info.tableCount = tableCount;
+        entries.insert(info.name, entry);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qDebug() << "WARNING: Índice de proyectos dañado, se vuelve a leer proyectos/";
+        return false;
+    }
+
+    m_entries = entries;
+    m_sortedDirty = true;
+    qDebug() << "DEBUG: Catálogo de proyectos cargado del índice:" << m_entries.size() << "proyectos";
+    return true;
+}
+
+bool ProjectCatalog::saveIndex()
+{
+    // El índice no crea proyectos/: sin proyectos no hay nada que guardar
+    if (m_root.isEmpty() || !QFileInfo(m_root).isDir())
+        return false;
+
+    QSaveFile file(indexPath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "WARNING: No se pudo escribir el índice de proyectos:" << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << IndexMagic << IndexVersion << quint32(m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        const ProjectInfoQt &info = it->info;
+        out << info.name << info.displayName << info.description << qint32(info.version)
+            << info.created << info.modified << info.isValid << qint32(info.tableCount) << info.tableNames
+            << it->stamps.dir << it->stamps.meta << it->stamps.metaSize << it->stamps.tables;
+    }
+
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qDebug() << "WARNING: No se pudo escribir el índice de proyectos:" << file.errorString();
+        return false;
+    }
+    return true;
+}
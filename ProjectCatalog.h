@@ -0,0 +1,103 @@
+#ifndef PROJECTCATALOG_H
+#define PROJECTCATALOG_H
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+#include <optional>
+#include "projectpathsqt.h"
+
+// Catálogo en memoria de los proyectos de proyectos/.
+//
+// Leer un proyecto (project.meta.json y la carpeta tables) es caro, así que
+// se hace una sola vez: el catálogo se guarda en proyectos/.catalog junto con
+// la fecha de modificación de la carpeta del proyecto, de su meta y de su
+// carpeta tables. Al abrir se carga ese índice (el lanzador se muestra al
+// instante) y después se compara cada proyecto con esas fechas: solo se relee
+// el que cambió.
+//
+// Mientras la aplicación corre, un QFileSystemWatcher vigila proyectos/ y la
+// carpeta, la meta y las tablas de cada proyecto. Los avisos se juntan durante
+// RefreshDelayMs y se revisan solo los proyectos afectados; projectsChanged()
+// avisa a la interfaz si algo cambió de verdad.
+class ProjectCatalog : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr quint32 IndexMagic = 0x4D414354; // "MACT"
+    static constexpr quint16 IndexVersion = 1;
+    static constexpr int RefreshDelayMs = 150;
+
+    static ProjectCatalog& instance();
+
+    // Proyectos ordenados por fecha de modificación (más reciente primero)
+    QList<ProjectInfoQt> projects();
+    std::optional<ProjectInfoQt> project(const QString &name);
+    int count();
+
+    // Relee un proyecto ya (p. ej. recién creado), sin esperar al watcher
+    void refreshProject(const QString &name);
+    // Revisa todo proyectos/: proyectos nuevos, borrados y cambiados
+    void refresh();
+
+    QString indexPath() const;
+
+signals:
+    void projectsChanged();
+
+private slots:
+    void onPathChanged(const QString &path);
+    void processPending();
+
+private:
+    struct Stamps {
+        qint64 dir = 0;
+        qint64 meta = 0;
+        qint64 metaSize = -1;
+        qint64 tables = 0;
+
+        bool operator==(const Stamps &other) const {
+            return dir == other.dir && meta == other.meta
+                && metaSize == other.metaSize && tables == other.tables;
+        }
+    };
+    struct Entry {
+        ProjectInfoQt info;
+        Stamps stamps;
+    };
+
+    explicit ProjectCatalog(QObject *parent = nullptr);
+
+    void ensureLoaded();
+    bool loadIndex();
+    bool saveIndex();
+    Stamps readStamps(const QString &name) const;
+    // true si la entrada cambió (o apareció o desapareció)
+    bool revalidate(const QString &name);
+    bool rescanRoot();
+    bool rescanAll();
+    void watchRoot();
+    void watchProject(const QString &name);
+    void unwatchProject(const QString &name);
+    QString projectPath(const QString &name) const;
+    QString projectForPath(const QString &path) const;
+
+    bool m_loaded = false;
+    QString m_root;                     // <repo>/proyectos (vacío si no hay raíz)
+    QHash<QString, Entry> m_entries;
+    QList<ProjectInfoQt> m_sorted;      // caché de projects()
+    bool m_sortedDirty = true;
+
+    QFileSystemWatcher m_watcher;
+    QSet<QString> m_watched;            // rutas agregadas a m_watcher
+    QTimer m_pendingTimer;
+    QSet<QString> m_pending;            // proyectos a revisar
+    bool m_pendingRescan = false;       // cambió proyectos/ (altas o bajas)
+};
+
+#endif // PROJECTCATALOG_H
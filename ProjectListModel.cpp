@@ -0,0 +1,119 @@
+#include "ProjectListModel.h"
+#include "ProjectCatalog.h"
+
+#include <QDebug>
+#include <climits>
+
+// --- ProjectListModel ---
+
+ProjectListModel::ProjectListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    m_projects = ProjectCatalog::instance().projects();
+    connect(&ProjectCatalog::instance(), &ProjectCatalog::projectsChanged,
+            this, &ProjectListModel::reload);
+}
+
+int ProjectListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_projects.size();
+}
+
+QVariant ProjectListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_projects.size())
+        return QVariant();
+
+    const ProjectInfoQt &project = m_projects.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole:
+        return project.name;
+    case Qt::ToolTipRole:
+        return project.description.isEmpty() ? project.path : project.description;
+    case ModifiedRole:
+        return project.modified;
+    case TableCountRole:
+        return project.tableCount;
+    case DescriptionRole:
+        return project.description;
+    case TableNamesRole:
+        return project.tableNames;
+    case PathRole:
+        return project.path;
+    default:
+        return QVariant();
+    }
+}
+
+void ProjectListModel::reload()
+{
+    const QList<ProjectInfoQt> projects = ProjectCatalog::instance().projects();
+
+    bool sameRows = projects.size() == m_projects.size();
+    for (int i = 0; sameRows && i < projects.size(); ++i)
+        sameRows = projects.at(i).name == m_projects.at(i).name;
+
+    if (!sameRows) {
+        beginResetModel();
+        m_projects = projects;
+        endResetModel();
+        qDebug() << "DEBUG: Lista de proyectos recargada:" << m_projects.size() << "proyectos";
+        return;
+    }
+
+    // Mismos proyectos en el mismo orden: solo se repintan los que cambiaron
+    const QList<ProjectInfoQt> previous = m_projects;
+    m_projects = projects;
+    for (int i = 0; i < projects.size(); ++i) {
+        const ProjectInfoQt &a = previous.at(i);
+        const ProjectInfoQt &b = projects.at(i);
+        if (a.modified != b.modified || a.tableCount != b.tableCount
+            || a.description != b.description || a.tableNames != b.tableNames) {
+            emit dataChanged(index(i), index(i));
+        }
+    }
+}
+
+// --- ProjectFilterModel ---
+
+ProjectFilterModel::ProjectFilterModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+}
+
+void ProjectFilterModel::setSearchResults(const QStringList &rankedNames)
+{
+    m_rank.clear();
+    m_rank.reserve(rankedNames.size());
+    for (int i = 0; i < rankedNames.size(); ++i)
+        m_rank.insert(rankedNames.at(i), i);
+    m_searching = true;
+    invalidateFilter();
+    sort(0);
+}
+
+void ProjectFilterModel::clearSearch()
+{
+    if (!m_searching)
+        return;
+    m_searching = false;
+    m_rank.clear();
+    sort(-1); // vuelve al orden del catálogo
+    invalidateFilter();
+}
+
+bool ProjectFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (!m_searching)
+        return true;
+    const QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
+    return m_rank.contains(index.data(ProjectListModel::NameRole).toString());
+}
+
+bool ProjectFilterModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    const int leftRank = m_rank.value(left.data(ProjectListModel::NameRole).toString(), INT_MAX);
+    const int rightRank = m_rank.value(right.data(ProjectListModel::NameRole).toString(), INT_MAX);
+    return leftRank < rightRank;
+}
@@ -0,0 +1,73 @@
+#ifndef PROJECTLISTMODEL_H
+#define PROJECTLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QSortFilterProxyModel>
+#include <QList>
+#include <QHash>
+#include "projectpathsqt.h"
+
+// Modelo del lanzador sobre ProjectCatalog.
+//
+// Una fila por proyecto, en el orden del catálogo (más reciente primero). La
+// vista pinta cada tarjeta con ProjectCardDelegate a partir de los roles, así
+// que solo se dibujan las visibles y no hay un QWidget por proyecto.
+//
+// Cuando el catálogo cambia, si los proyectos y su orden son los mismos solo
+// se avisa de las filas que cambiaron; si no, el modelo se reinicia.
+class ProjectListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        NameRole = Qt::UserRole + 1,
+        ModifiedRole,
+        TableCountRole,
+        DescriptionRole,
+        TableNamesRole,
+        PathRole
+    };
+
+    explicit ProjectListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    const ProjectInfoQt &projectAt(int row) const { return m_projects.at(row); }
+
+public slots:
+    // Vuelve a tomar los proyectos del catálogo
+    void reload();
+
+private:
+    QList<ProjectInfoQt> m_projects;
+};
+
+// Resultado de la barra de búsqueda sobre ProjectListModel.
+//
+// La búsqueda la resuelve ProjectSearcher en otro hilo; aquí solo se muestran
+// los proyectos que devolvió, en el orden de su puntaje. Sin búsqueda se ven
+// todos, en el orden del catálogo.
+class ProjectFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit ProjectFilterModel(QObject *parent = nullptr);
+
+    // Nombres de los proyectos que coinciden, del mejor al peor
+    void setSearchResults(const QStringList &rankedNames);
+    void clearSearch();
+    bool isSearching() const { return m_searching; }
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    bool m_searching = false;
+    QHash<QString, int> m_rank;           // nombre → posición en el resultado
+};
+
+#endif // PROJECTLISTMODEL_H
@@ -0,0 +1,174 @@
+#include "ProjectOpener.h"
+#include "ProjectCatalog.h"
+#include "RecordFile.h"
+#include "WriteAheadLog.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QRunnable>
+#include <QTimer>
+#include <functional>
+
+namespace {
+class OpenTask : public QRunnable
+{
+public:
+    explicit OpenTask(std::function<void()> work) : m_work(std::move(work)) {}
+    void run() override { m_work(); }
+
+private:
+    std::function<void()> m_work;
+};
+} // namespace
+
+ProjectOpener::ProjectOpener(const QString &projectName, QObject *parent)
+    : QObject(parent), m_projectName(projectName)
+{
+    // Los pasos dependen uno del otro: un solo hilo
+    m_pool.setMaxThreadCount(1);
+}
+
+ProjectOpener::~ProjectOpener()
+{
+    m_cancelled = true;
+    // El paso en curso usa this: hay que esperarlo
+    m_pool.waitForDone();
+}
+
+void ProjectOpener::start()
+{
+    m_clock.start();
+
+    // El catálogo ya está en memoria desde el lanzador
+    m_catalogInfo = ProjectCatalog::instance().project(m_projectName);
+    m_telemetry.catalogMs = m_clock.elapsed();
+    if (m_catalogInfo.has_value())
+        emit catalogLoaded(m_catalogInfo.value());
+
+    // La recuperación va en este hilo, pero después de que la ventana se pinte
+    QTimer::singleShot(0, this, [this] { recoverStorage(); });
+}
+
+void ProjectOpener::recoverStorage()
+{
+    // 1) Carpetas y log: el log se recupera y se cierra con un checkpoint,
+    //    así el que abre TableEditor ya no tiene nada que rehacer. Rehacer y
+    //    deshacer escriben páginas a través de BufferPool, que es de todo el
+    //    proceso: por eso no corre en el hilo de fondo.
+    const std::optional<ProjectPathsQt> paths = ProjectStorageQt(m_projectName).create();
+    if (!paths.has_value()) {
+        deliverStorage(paths, QStringLiteral("No se encontró la carpeta del proyecto %1").arg(m_projectName));
+        deliverFinished(0);
+        return;
+    }
+    {
+        WriteAheadLog log;
+        if (log.open(paths->root, paths->logs)) {
+            const RecoveryStats stats = log.lastRecovery();
+            if (stats.redone > 0 || stats.undone > 0) {
+                qDebug() << "DEBUG: Proyecto" << m_projectName << "recuperado:" << stats.redone
+                         << "páginas rehechas," << stats.undone << "transacciones deshechas";
+            }
+            log.close();
+        } else {
+            qDebug() << "ERROR: No se pudo recuperar el log del proyecto:" << log.errorString();
+        }
+    }
+    deliverStorage(paths, QString());
+    if (m_cancelled)
+        return;
+
+    // 2) Catálogo de esquemas y cabeceras de los .mad en el hilo de fondo:
+    //    solo lee archivos con QFile, sin BufferPool ni log
+    const ProjectPathsQt projectPaths = paths.value();
+    m_pool.start(new OpenTask([this, projectPaths] {
+        SchemaCatalog::Contents catalog;
+        if (auto contents = SchemaCatalog::read(SchemaCatalog::pathFor(projectPaths.root)))
+            catalog = contents.value();
+        QMetaObject::invokeMethod(this, [this, catalog] {
+            emit schemaCatalogRead(catalog);
+        }, Qt::QueuedConnection);
+
+        // 3) Esquemas, uno por uno: la barra lateral se llena mientras se leen
+        QHash<QString, TableSchema> byFile;
+        for (const TableSchema &table : qAsConst(catalog.tables))
+            byFile.insert(table.fileName, table);
+
+        const QDir tablesDir(projectPaths.tables);
+        const QStringList files = tablesDir.entryList(QStringList() << "*.mad", QDir::Files, QDir::Name);
+        int invalidTables = 0;
+        for (const QString &fileName : files) {
+            if (m_cancelled)
+                return;
+            const QString filePath = tablesDir.filePath(fileName);
+            const QString baseName = QFileInfo(fileName).completeBaseName();
+            const TableSchema known = byFile.value(baseName);
+
+            // El .mad no cambió desde que se guardó el catálogo: no hace falta abrirlo
+            if (!known.name.isEmpty() && known.matchesFile(filePath)) {
+                QMetaObject::invokeMethod(this, [this, known] {
+                    deliverSchema(known, true);
+                }, Qt::QueuedConnection);
+                continue;
+            }
+
+            QString tableName;
+            QStringList fieldNames, fieldTypes;
+            if (!RecordFile::readSchema(filePath, &tableName, &fieldNames, &fieldTypes)) {
+                qDebug() << "WARNING: Archivo de tabla inválido, se ignora:" << fileName;
+                ++invalidTables;
+                continue;
+            }
+            TableSchema schema;
+            schema.name = tableName.isEmpty() ? baseName : tableName;
+            schema.fileName = baseName;
+            schema.fields = SchemaCatalog::mergeFields(known.fields, fieldNames, fieldTypes);
+            const QFileInfo info(filePath);
+            schema.fileModified = info.lastModified().toMSecsSinceEpoch();
+            schema.fileSize = info.size();
+            QMetaObject::invokeMethod(this, [this, schema] {
+                deliverSchema(schema, false);
+            }, Qt::QueuedConnection);
+        }
+        QMetaObject::invokeMethod(this, [this, invalidTables] {
+            deliverFinished(invalidTables);
+        }, Qt::QueuedConnection);
+    }));
+}
+
+void ProjectOpener::deliverStorage(const std::optional<ProjectPathsQt> &paths, const QString &error)
+{
+    m_telemetry.storageMs = m_clock.elapsed();
+    if (!paths.has_value()) {
+        qDebug() << "ERROR:" << error << "- las tablas no se guardarán";
+        emit storageFailed(error);
+        return;
+    }
+    emit storageReady(paths.value());
+}
+
+void ProjectOpener::deliverSchema(const TableSchema &schema, bool fromCatalog)
+{
+    if (m_telemetry.firstSchemaMs < 0)
+        m_telemetry.firstSchemaMs = m_clock.elapsed();
+    ++m_telemetry.tables;
+    if (fromCatalog)
+        ++m_telemetry.catalogTables;
+    m_loadedTables << schema.name;
+    emit tableSchemaLoaded(schema);
+}
+
+void ProjectOpener::deliverFinished(int invalidTables)
+{
+    m_telemetry.schemasMs = m_clock.elapsed();
+    m_telemetry.invalidTables = invalidTables;
+    m_finished = true;
+    qDebug() << "DEBUG: Proyecto" << m_projectName << "abierto en" << m_telemetry.schemasMs << "ms"
+             << "(catálogo" << m_telemetry.catalogMs << "ms, log" << m_telemetry.storageMs
+             << "ms, primera tabla" << m_telemetry.firstSchemaMs << "ms," << m_telemetry.tables
+             << "tablas," << m_telemetry.catalogTables << "del catálogo,"
+             << m_telemetry.invalidTables << "inválidas)";
+    emit finished();
+}
@@ -0,0 +1,88 @@
+#ifndef PROJECTOPENER_H
+#define PROJECTOPENER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+#include <optional>
+#include "projectpathsqt.h"
+#include "SchemaCatalog.h"
+
+// Tiempos de la apertura de un proyecto, en ms desde ProjectOpener::start()
+// (-1 = ese paso todavía no terminó o no se hizo)
+struct ProjectOpenTelemetry {
+    qint64 catalogMs = -1;       // datos del proyecto tomados del catálogo
+    qint64 storageMs = -1;       // carpetas listas y log recuperado
+    qint64 firstSchemaMs = -1;   // primera tabla en la barra lateral
+    qint64 schemasMs = -1;       // todas las tablas en la barra lateral
+    int tables = 0;              // esquemas leídos
+    int catalogTables = 0;       // de ellos, tomados de schema.meta sin abrir el .mad
+    int invalidTables = 0;       // archivos .mad que no se pudieron leer
+};
+
+// Apertura de un proyecto sin bloquear la interfaz.
+//
+// start() toma del catálogo lo que ya se sabe del proyecto (nombre, tablas) y
+// lo avisa en el acto, así la ventana se puede mostrar y la barra lateral
+// llenar con las tablas conocidas. Después, en este orden:
+//   1. carpetas del proyecto y recuperación del log (si la sesión anterior no
+//      cerró bien, las tablas se corrigen antes de que nadie las lea). Corre
+//      en el hilo del opener (el de la interfaz) en la vuelta siguiente del
+//      ciclo de eventos: rehacer y deshacer escriben páginas a través de
+//      BufferPool, que comparten todas las tablas abiertas
+//   2. en el QThreadPool propio, el catálogo de esquemas (schema.meta) y el
+//      esquema de cada tabla, que se entrega apenas se tiene: del catálogo si
+//      el .mad no cambió desde que se guardó, o de la cabecera del .mad si
+//      cambió o el catálogo no lo tiene. Ese hilo solo lee archivos con QFile:
+//      no toca BufferPool, ni el log, ni objetos de la interfaz
+// Los archivos de registros y los índices no se abren aquí: los abre
+// TableEditor la primera vez que se usa cada tabla.
+class ProjectOpener : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProjectOpener(const QString &projectName, QObject *parent = nullptr);
+    ~ProjectOpener();
+
+    void start();
+    bool isFinished() const { return m_finished; }
+
+    QString projectName() const { return m_projectName; }
+    const std::optional<ProjectInfoQt> &catalogInfo() const { return m_catalogInfo; }
+    const ProjectOpenTelemetry &telemetry() const { return m_telemetry; }
+    // Tablas entregadas hasta ahora (por nombre)
+    QStringList loadedTables() const { return m_loadedTables; }
+    qint64 elapsedMs() const { return m_clock.elapsed(); }
+
+signals:
+    // Lo que el catálogo sabe del proyecto (puede estar desactualizado)
+    void catalogLoaded(const ProjectInfoQt &info);
+    // El log ya se recuperó; a partir de aquí se pueden abrir las tablas
+    void storageReady(const ProjectPathsQt &paths);
+    void storageFailed(const QString &error);
+    // Lo guardado en schema.meta (vacío si no hay catálogo), antes de las tablas
+    void schemaCatalogRead(const SchemaCatalog::Contents &contents);
+    void tableSchemaLoaded(const TableSchema &schema);
+    void finished();
+
+private:
+    void recoverStorage();
+    void deliverStorage(const std::optional<ProjectPathsQt> &paths, const QString &error);
+    void deliverSchema(const TableSchema &schema, bool fromCatalog);
+    void deliverFinished(int invalidTables);
+
+    QString m_projectName;
+    std::optional<ProjectInfoQt> m_catalogInfo;
+    ProjectOpenTelemetry m_telemetry;
+    QStringList m_loadedTables;
+    QElapsedTimer m_clock;
+    QThreadPool m_pool;
+    std::atomic<bool> m_cancelled { false };
+    bool m_finished = false;
+};
+
+#endif // PROJECTOPENER_H
@@ -0,0 +1,383 @@
+#include "ProjectSearchIndex.h"
+#include "ProjectCatalog.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QRunnable>
+#include <QSet>
+#include <algorithm>
+#include <functional>
+
+namespace {
+// Peso de cada campo en el puntaje: el nombre pesa más que las tablas y la descripción
+constexpr int FieldWeights[] = { 3, 2, 1 };
+
+// Puntaje de una palabra de la consulta contra un término
+constexpr int ExactScore = 100;
+constexpr int PrefixScore = 80;
+constexpr int SubstringScore = 60;
+constexpr int SimilarScore = 50;          // por el coeficiente de Dice de los trigramas
+constexpr double MinSimilarity = 0.5;
+// Bonos por nombre completo (igual a la consulta o que empieza con ella)
+constexpr int NameEqualsBonus = 200;
+constexpr int NameStartsBonus = 100;
+// Fracción mínima de trigramas en común para ser candidato
+constexpr double MinSharedTrigrams = 0.4;
+
+class SearchTask : public QRunnable
+{
+public:
+    explicit SearchTask(std::function<void()> work) : m_work(std::move(work)) {}
+    void run() override { m_work(); }
+
+private:
+    std::function<void()> m_work;
+};
+
+// Coeficiente de Dice de dos listas ordenadas y sin repetir
+double diceSimilarity(const QVector<quint64> &a, const QVector<quint64> &b)
+{
+    if (a.isEmpty() || b.isEmpty())
+        return 0.0;
+    int shared = 0;
+    for (int i = 0, j = 0; i < a.size() && j < b.size();) {
+        if (a.at(i) < b.at(j)) {
+            ++i;
+        } else if (b.at(j) < a.at(i)) {
+            ++j;
+        } else {
+            ++shared;
+            ++i;
+            ++j;
+        }
+    }
+    return 2.0 * shared / (a.size() + b.size());
+}
+
+void sortUnique(QVector<quint64> *values)
+{
+    std::sort(values->begin(), values->end());
+    values->erase(std::unique(values->begin(), values->end()), values->end());
+}
+} // namespace
+
+// --- ProjectSearchIndex ---
+
+QString ProjectSearchIndex::normalize(const QString &text)
+{
+    // En forma D las tildes quedan como marcas aparte y se pueden saltar
+    const QString decomposed = text.normalized(QString::NormalizationForm_D);
+    QString out;
+    out.reserve(decomposed.size());
+    for (const QChar c : decomposed) {
+        if (c.category() != QChar::Mark_NonSpacing)
+            out.append(c.toLower());
+    }
+    return out;
+}
+
+QStringList ProjectSearchIndex::tokens(const QString &normalized)
+{
+    QStringList out;
+    int start = -1;
+    for (int i = 0; i <= normalized.size(); ++i) {
+        const bool inWord = i < normalized.size() && normalized.at(i).isLetterOrNumber();
+        if (inWord && start < 0) {
+            start = i;
+        } else if (!inWord && start >= 0) {
+            out << normalized.mid(start, i - start);
+            start = -1;
+        }
+    }
+    return out;
+}
+
+void ProjectSearchIndex::appendTrigrams(const QString &term, QVector<quint64> *out)
+{
+    // Con los bordes: " ventas " → " ve", "ven", ..., "as "
+    const QString padded = QLatin1Char(' ') + term + QLatin1Char(' ');
+    for (int i = 0; i + 2 < padded.size(); ++i) {
+        out->append((quint64(padded.at(i).unicode()) << 32)
+                    | (quint64(padded.at(i + 1).unicode()) << 16)
+                    | quint64(padded.at(i + 2).unicode()));
+    }
+}
+
+void ProjectSearchIndex::addProject(const ProjectInfoQt &project)
+{
+    removeProject(project.name);
+
+    Document doc;
+    doc.name = project.name;
+    doc.normalizedName = normalize(project.name);
+
+    // Cada término una vez, con el campo de más peso en que aparece
+    QHash<QString, Field> fields;
+    auto addField = [&fields](const QString &text, Field field) {
+        for (const QString &token : tokens(normalize(text))) {
+            auto it = fields.find(token);
+            if (it == fields.end())
+                fields.insert(token, field);
+            else if (field < it.value())
+                it.value() = field;
+        }
+    };
+    addField(project.name, NameField);
+    if (project.displayName != project.name)
+        addField(project.displayName, NameField);
+    for (const QString &table : project.tableNames)
+        addField(table, TableField);
+    addField(project.description, DescriptionField);
+
+    for (auto it = fields.constBegin(); it != fields.constEnd(); ++it) {
+        Term term{ it.key(), it.value(), QVector<quint64>() };
+        appendTrigrams(term.text, &term.trigrams);
+        sortUnique(&term.trigrams);
+        doc.trigrams += term.trigrams;
+        doc.terms.append(term);
+    }
+    sortUnique(&doc.trigrams);
+
+    int slot;
+    if (!m_freeSlots.isEmpty()) {
+        slot = m_freeSlots.takeLast();
+    } else {
+        slot = m_docs.size();
+        m_docs.append(Document());
+    }
+    for (const Term &term : qAsConst(doc.terms))
+        m_terms[term.text].append(slot);
+    for (quint64 trigram : qAsConst(doc.trigrams))
+        m_trigrams[trigram].append(slot);
+    m_docs[slot] = doc;
+    m_slotByName.insert(project.name, slot);
+}
+
+void ProjectSearchIndex::removeProject(const QString &name)
+{
+    auto found = m_slotByName.find(name);
+    if (found == m_slotByName.end())
+        return;
+    const int slot = found.value();
+    m_slotByName.erase(found);
+
+    const Document &doc = m_docs.at(slot);
+    for (const Term &term : doc.terms) {
+        auto it = m_terms.find(term.text);
+        if (it == m_terms.end())
+            continue;
+        it.value().removeOne(slot);
+        if (it.value().isEmpty())
+            m_terms.erase(it);
+    }
+    for (quint64 trigram : doc.trigrams) {
+        auto it = m_trigrams.find(trigram);
+        if (it == m_trigrams.end())
+            continue;
+        it.value().removeOne(slot);
+        if (it.value().isEmpty())
+            m_trigrams.erase(it);
+    }
+    m_docs[slot] = Document();
+    m_freeSlots.append(slot);
+}
+
+int ProjectSearchIndex::scoreToken(const Document &doc, const QString &token,
+                                   const QVector<quint64> &tokenTrigrams) const
+{
+    int best = 0;
+    for (const Term &term : doc.terms) {
+        int score = 0;
+        if (term.text == token) {
+            score = ExactScore;
+        } else if (term.text.startsWith(token)) {
+            score = PrefixScore;
+        } else if (term.text.contains(token)) {
+            score = SubstringScore;
+        } else if (token.size() >= 3) {
+            const double similarity = diceSimilarity(term.trigrams, tokenTrigrams);
+            if (similarity >= MinSimilarity)
+                score = int(SimilarScore * similarity);
+        }
+        best = qMax(best, score * FieldWeights[term.field]);
+    }
+    return best;
+}
+
+QVector<ProjectSearchIndex::Match> ProjectSearchIndex::query(const QString &text) const
+{
+    const QString normalizedQuery = normalize(text).trimmed();
+    const QStringList words = tokens(normalizedQuery);
+    if (words.isEmpty())
+        return {};
+
+    const int slotCount = m_docs.size();
+    QVector<int> totals(slotCount, 0);
+    QVector<int> matchedWords(slotCount, 0);
+    QVector<int> shared(slotCount, 0);
+    QVector<int> candidates;
+
+    for (int w = 0; w < words.size(); ++w) {
+        const QString &word = words.at(w);
+        QVector<quint64> wordTrigrams;
+        appendTrigrams(word, &wordTrigrams);
+        sortUnique(&wordTrigrams);
+
+        // Solo siguen en carrera los proyectos que coincidieron con las palabras anteriores
+        auto addCandidate = [&](int slot) {
+            if (matchedWords.at(slot) == w && shared.at(slot) >= 0) {
+                shared[slot] = -1; // ya está en candidates
+                candidates.append(slot);
+            }
+        };
+        candidates.clear();
+
+        // Términos que empiezan con la palabra
+        for (auto it = m_terms.lowerBound(word); it != m_terms.constEnd() && it.key().startsWith(word); ++it) {
+            for (int slot : it.value())
+                addCandidate(slot);
+        }
+
+        if (word.size() >= 3) {
+            // Suficientes trigramas en común: subcadenas y errores de tipeo
+            const int threshold = qMax(1, int(wordTrigrams.size() * MinSharedTrigrams));
+            for (quint64 trigram : qAsConst(wordTrigrams)) {
+                auto it = m_trigrams.constFind(trigram);
+                if (it == m_trigrams.constEnd())
+                    continue;
+                for (int slot : it.value()) {
+                    if (shared.at(slot) >= 0 && ++shared[slot] >= threshold)
+                        addCandidate(slot);
+                }
+            }
+        } else {
+            // Palabras cortas: también dentro del nombre, como el filtro de antes
+            for (auto it = m_slotByName.constBegin(); it != m_slotByName.constEnd(); ++it) {
+                if (m_docs.at(it.value()).normalizedName.contains(word))
+                    addCandidate(it.value());
+            }
+        }
+
+        for (int slot : qAsConst(candidates)) {
+            const int score = scoreToken(m_docs.at(slot), word, wordTrigrams);
+            if (score > 0) {
+                totals[slot] += score;
+                matchedWords[slot]++;
+            }
+        }
+        std::fill(shared.begin(), shared.end(), 0);
+    }
+
+    QVector<Match> matches;
+    for (auto it = m_slotByName.constBegin(); it != m_slotByName.constEnd(); ++it) {
+        const int slot = it.value();
+        if (matchedWords.at(slot) != words.size())
+            continue;
+        const Document &doc = m_docs.at(slot);
+        int score = totals.at(slot);
+        if (doc.normalizedName == normalizedQuery)
+            score += NameEqualsBonus;
+        else if (doc.normalizedName.startsWith(normalizedQuery))
+            score += NameStartsBonus;
+        matches.append(Match{ doc.name, score });
+    }
+    std::sort(matches.begin(), matches.end(), [](const Match &a, const Match &b) {
+        if (a.score != b.score)
+            return a.score > b.score;
+        return a.name.compare(b.name, Qt::CaseInsensitive) < 0;
+    });
+    return matches;
+}
+
+// --- ProjectSearcher ---
+
+ProjectSearcher::ProjectSearcher(QObject *parent)
+    : QObject(parent)
+{
+    // Una consulta a la vez: las que se acumulan se descartan al llegar su turno
+    m_pool.setMaxThreadCount(1);
+    syncWithCatalog();
+    connect(&ProjectCatalog::instance(), &ProjectCatalog::projectsChanged,
+            this, &ProjectSearcher::syncWithCatalog);
+}
+
+ProjectSearcher::~ProjectSearcher()
+{
+    ++m_generation;
+    // La consulta en curso usa this: hay que esperarla
+    m_pool.waitForDone();
+}
+
+void ProjectSearcher::search(const QString &text)
+{
+    m_query = text.trimmed();
+    const int generation = ++m_generation;
+    if (m_query.isEmpty()) {
+        emit resultsReady(m_query, QVector<ProjectSearchIndex::Match>());
+        return;
+    }
+
+    // La copia comparte los datos: el índice se puede seguir actualizando aquí
+    const ProjectSearchIndex snapshot = m_index;
+    const QString query = m_query;
+    m_pool.start(new SearchTask([this, generation, snapshot, query] {
+        if (generation != m_generation.load())
+            return; // ya hay una consulta más nueva
+
+        QElapsedTimer clock;
+        clock.start();
+        const QVector<ProjectSearchIndex::Match> matches = snapshot.query(query);
+        const qint64 elapsed = clock.elapsed();
+        if (elapsed > FrameBudgetMs) {
+            qDebug() << "WARNING: Búsqueda de proyectos lenta:" << query << "tardó" << elapsed
+                     << "ms sobre" << snapshot.size() << "proyectos";
+        }
+        QMetaObject::invokeMethod(this, [this, generation, query, matches] {
+            deliver(generation, query, matches);
+        }, Qt::QueuedConnection);
+    }));
+}
+
+void ProjectSearcher::deliver(int generation, const QString &text,
+                              const QVector<ProjectSearchIndex::Match> &matches)
+{
+    if (generation != m_generation.load())
+        return;
+    emit resultsReady(text, matches);
+}
+
+void ProjectSearcher::syncWithCatalog()
+{
+    const QList<ProjectInfoQt> projects = ProjectCatalog::instance().projects();
+
+    // Solo se reindexan los proyectos nuevos o con otro texto buscable
+    int updated = 0;
+    QSet<QString> current;
+    for (const ProjectInfoQt &project : projects) {
+        current.insert(project.name);
+        auto it = m_indexed.constFind(project.name);
+        if (it != m_indexed.constEnd() && it->displayName == project.displayName
+            && it->description == project.description && it->tableNames == project.tableNames) {
+            continue;
+        }
+        m_index.addProject(project);
+        m_indexed.insert(project.name, project);
+        ++updated;
+    }
+    const QStringList indexed = m_indexed.keys();
+    for (const QString &name : indexed) {
+        if (!current.contains(name)) {
+            m_index.removeProject(name);
+            m_indexed.remove(name);
+            ++updated;
+        }
+    }
+
+    if (updated > 0) {
+        qDebug() << "DEBUG: Índice de búsqueda actualizado:" << updated << "proyectos reindexados,"
+                 << m_index.size() << "en total";
+        // Los resultados mostrados pueden haber cambiado
+        if (!m_query.isEmpty())
+            search(m_query);
+    }
+}
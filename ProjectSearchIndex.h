@@ -0,0 +1,118 @@
+#ifndef PROJECTSEARCHINDEX_H
+#define PROJECTSEARCHINDEX_H
+
+#include <QObject>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+#include "projectpathsqt.h"
+
+// Índice de búsqueda de proyectos por nombre, tablas y descripción.
+//
+// Cada proyecto se parte en términos (minúsculas, sin tildes, separados por
+// todo lo que no sea letra o número). Hay dos índices sobre esos términos:
+//   - por prefijo: mapa ordenado término → proyectos, para consultas cortas
+//   - por trigramas: trigrama → proyectos, para subcadenas y errores de tipeo
+// Los trigramas de un término incluyen sus bordes (" ve", "as "), así que una
+// letra equivocada todavía deja la mayoría en común.
+//
+// Los candidatos de cada palabra de la consulta se puntúan contra los términos
+// del proyecto (exacto > prefijo > subcadena > parecido por trigramas) con más
+// peso para el nombre que para las tablas y la descripción; un proyecto tiene
+// que coincidir con todas las palabras.
+//
+// Es un valor con contenedores de Qt compartidos implícitamente: copiarlo es
+// barato, y ProjectSearcher consulta una copia en otro hilo mientras la
+// interfaz sigue actualizando el original.
+class ProjectSearchIndex
+{
+public:
+    struct Match {
+        QString name;
+        int score = 0;
+    };
+
+    // Reemplaza lo indexado del proyecto (si ya estaba)
+    void addProject(const ProjectInfoQt &project);
+    void removeProject(const QString &name);
+    bool contains(const QString &name) const { return m_slotByName.contains(name); }
+    int size() const { return m_slotByName.size(); }
+
+    // Proyectos que coinciden, del mejor al peor (a igual puntaje, por nombre)
+    QVector<Match> query(const QString &text) const;
+
+    // Minúsculas y sin tildes ("Módulo" → "modulo")
+    static QString normalize(const QString &text);
+
+private:
+    enum Field : quint8 {
+        NameField,
+        TableField,
+        DescriptionField
+    };
+    struct Term {
+        QString text;
+        Field field = NameField;
+        QVector<quint64> trigrams;   // ordenados, para el parecido
+    };
+    struct Document {
+        QString name;
+        QString normalizedName;
+        QVector<Term> terms;
+        QVector<quint64> trigrams;   // sin repetir
+    };
+
+    static QStringList tokens(const QString &normalized);
+    static void appendTrigrams(const QString &term, QVector<quint64> *out);
+    int scoreToken(const Document &doc, const QString &token, const QVector<quint64> &tokenTrigrams) const;
+
+    QVector<Document> m_docs;                 // por ranura; las libres tienen nombre vacío
+    QVector<int> m_freeSlots;
+    QHash<QString, int> m_slotByName;
+    QMap<QString, QVector<int>> m_terms;      // término → ranuras
+    QHash<quint64, QVector<int>> m_trigrams;  // trigrama → ranuras
+};
+
+// Búsqueda de la barra del lanzador fuera del hilo de la interfaz.
+//
+// Mantiene un ProjectSearchIndex al día con ProjectCatalog (solo reindexa los
+// proyectos que cambiaron) y resuelve cada consulta en su QThreadPool sobre
+// una copia del índice. Si se escribe más rápido de lo que se resuelve, las
+// consultas viejas se descartan sin correr: resultsReady() llega solo para la
+// última.
+class ProjectSearcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Una consulta que tarde más que esto (un cuadro a 60 Hz) se avisa en el log
+    static constexpr int FrameBudgetMs = 16;
+
+    explicit ProjectSearcher(QObject *parent = nullptr);
+    ~ProjectSearcher();
+
+    void search(const QString &text);
+    QString lastQuery() const { return m_query; }
+    const ProjectSearchIndex &index() const { return m_index; }
+
+signals:
+    void resultsReady(const QString &text, const QVector<ProjectSearchIndex::Match> &matches);
+
+private slots:
+    void syncWithCatalog();
+
+private:
+    void deliver(int generation, const QString &text, const QVector<ProjectSearchIndex::Match> &matches);
+
+    ProjectSearchIndex m_index;
+    QHash<QString, ProjectInfoQt> m_indexed;   // lo indexado de cada proyecto
+    QThreadPool m_pool;
+    std::atomic<int> m_generation { 0 };
+    QString m_query;
+};
+
+#endif // PROJECTSEARCHINDEX_H
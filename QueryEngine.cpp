@@ -0,0 +1,636 @@
+#include "QueryEngine.h"
+#include "IndexKey.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Comparaciones que se pueden resolver con un rango de claves del índice
+bool isRangeOperator(QueryCondition::Operator op)
+{
+    switch (op) {
+    case QueryCondition::Equal:
+    case QueryCondition::Less:
+    case QueryCondition::LessOrEqual:
+    case QueryCondition::Greater:
+    case QueryCondition::GreaterOrEqual:
+    case QueryCondition::Between:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Comparaciones cuyo valor hay que interpretar con el tipo del campo
+bool comparesValue(QueryCondition::Operator op)
+{
+    return isRangeOperator(op) || op == QueryCondition::NotEqual;
+}
+
+int compareKeys(qint64 a, qint64 b)
+{
+    return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+// Límites de un rango que se van estrechando con cada condición
+struct KeyRange {
+    std::optional<qint64> low;
+    std::optional<qint64> high;
+    bool lowInclusive = true;
+    bool highInclusive = true;
+
+    void raiseLow(qint64 key, bool inclusive)
+    {
+        if (!low || key > *low || (key == *low && !inclusive)) {
+            low = key;
+            lowInclusive = inclusive;
+        }
+    }
+
+    void lowerHigh(qint64 key, bool inclusive)
+    {
+        if (!high || key < *high || (key == *high && !inclusive)) {
+            high = key;
+            highInclusive = inclusive;
+        }
+    }
+
+    void apply(const QueryCondition &condition, qint64 key, qint64 key2)
+    {
+        switch (condition.op) {
+        case QueryCondition::Equal:          raiseLow(key, true); lowerHigh(key, true); break;
+        case QueryCondition::Less:           lowerHigh(key, false); break;
+        case QueryCondition::LessOrEqual:    lowerHigh(key, true); break;
+        case QueryCondition::Greater:        raiseLow(key, false); break;
+        case QueryCondition::GreaterOrEqual: raiseLow(key, true); break;
+        case QueryCondition::Between:        raiseLow(key, true); lowerHigh(key2, true); break;
+        default: break;
+        }
+    }
+};
+} // namespace
+
+// --- Plan ---
+
+QString QueryPlan::describe() const
+{
+    switch (access) {
+    case RowsScan:
+        return QStringLiteral("filas en memoria");
+    case IndexScan:
+        return QStringLiteral("índice de %1 (%2 registros, costo %3 contra %4 del recorrido completo)%5")
+            .arg(indexField).arg(estimatedRows)
+            .arg(indexScanCost, 0, 'f', 1).arg(fullScanCost, 0, 'f', 1)
+            .arg(sortedByIndex ? QStringLiteral(", en el orden del índice") : QString());
+    case FullScan:
+        break;
+    }
+    if (indexScanCost > 0.0) {
+        return QStringLiteral("recorrido completo (costo %1; el índice de %2 costaría más de %3)")
+            .arg(fullScanCost, 0, 'f', 1).arg(indexField).arg(indexScanCost, 0, 'f', 1);
+    }
+    return QStringLiteral("recorrido completo (costo %1)").arg(fullScanCost, 0, 'f', 1);
+}
+
+// --- Operadores ---
+
+QueryOperator::QueryOperator(std::unique_ptr<QueryOperator> input)
+    : m_input(std::move(input))
+{
+}
+
+QueryOperator::~QueryOperator() = default;
+
+QStringList QueryOperator::fieldNames() const
+{
+    return m_input ? m_input->fieldNames() : QStringList();
+}
+
+QStringList QueryOperator::fieldTypes() const
+{
+    return m_input ? m_input->fieldTypes() : QStringList();
+}
+
+QString QueryOperator::errorString() const
+{
+    if (!m_error.isEmpty())
+        return m_error;
+    return m_input ? m_input->errorString() : QString();
+}
+
+qint64 QueryOperator::rowsRead() const
+{
+    return m_input ? m_input->rowsRead() : 0;
+}
+
+TableScanOperator::TableScanOperator(RecordFile *file)
+    : m_file(file)
+{
+}
+
+bool TableScanOperator::next(RowBatch *batch)
+{
+    batch->clear();
+    QList<QPair<RecordId, QStringList>> records;
+    while (batch->size() < BatchRows && m_nextPage < m_file->pageCount()) {
+        records.clear();
+        if (!m_file->readPageRecords(m_nextPage, &records)) {
+            m_error = QStringLiteral("No se pudo leer la página %1: %2").arg(m_nextPage).arg(m_file->errorString());
+            return false;
+        }
+        ++m_nextPage;
+        for (const auto &record : qAsConst(records))
+            batch->append(record.second);
+        m_rowsRead += records.size();
+    }
+    return !batch->isEmpty();
+}
+
+IndexScanOperator::IndexScanOperator(RecordFile *file, const BPlusTreeIterator &range)
+    : m_file(file), m_range(range)
+{
+}
+
+bool IndexScanOperator::next(RowBatch *batch)
+{
+    batch->clear();
+    while (batch->size() < BatchRows && m_range.next()) {
+        const std::optional<QStringList> values = m_file->read(m_range.recordId());
+        if (!values) {
+            qDebug() << "WARNING: El índice apunta a un registro que no existe:" << m_range.recordId().page
+                     << m_range.recordId().slot;
+            continue;
+        }
+        batch->append(*values);
+        ++m_rowsRead;
+    }
+    return !batch->isEmpty();
+}
+
+RowsScanOperator::RowsScanOperator(const ColumnTable &rows)
+    : m_rows(rows)
+{
+}
+
+bool RowsScanOperator::next(RowBatch *batch)
+{
+    batch->clear();
+    while (batch->size() < BatchRows && m_nextRow < m_rows.rowCount())
+        batch->append(m_rows.rowValues(m_nextRow++));
+    return !batch->isEmpty();
+}
+
+FilterOperator::FilterOperator(std::unique_ptr<QueryOperator> input, const QVector<QueryCondition> &conditions)
+    : QueryOperator(std::move(input))
+{
+    const QStringList names = m_input->fieldNames();
+    const QStringList types = m_input->fieldTypes();
+    for (const QueryCondition &condition : conditions) {
+        Predicate predicate;
+        predicate.column = names.indexOf(condition.field);
+        predicate.op = condition.op;
+        predicate.fieldType = types.value(predicate.column);
+        predicate.typed = IndexKey::isIndexableType(predicate.fieldType);
+        predicate.text = condition.value.trimmed();
+        predicate.text2 = condition.value2.trimmed();
+        if (predicate.column < 0) {
+            predicate.never = true;
+        } else if (predicate.typed && comparesValue(condition.op)) {
+            const std::optional<qint64> key = IndexKey::encode(predicate.fieldType, condition.value);
+            const std::optional<qint64> key2 = condition.op == QueryCondition::Between
+                ? IndexKey::encode(predicate.fieldType, condition.value2) : std::optional<qint64>(0);
+            predicate.never = !key || !key2;
+            predicate.key = key.value_or(0);
+            predicate.key2 = key2.value_or(0);
+        }
+        m_predicates.append(predicate);
+    }
+}
+
+bool FilterOperator::matches(const Predicate &predicate, const QString &cell) const
+{
+    if (predicate.never)
+        return false;
+
+    switch (predicate.op) {
+    case QueryCondition::IsEmpty:
+        return cell.trimmed().isEmpty();
+    case QueryCondition::IsNotEmpty:
+        return !cell.trimmed().isEmpty();
+    case QueryCondition::Contains:
+        return cell.contains(predicate.text, Qt::CaseInsensitive);
+    default:
+        break;
+    }
+
+    int cmp = 0;
+    int cmp2 = 0;
+    if (predicate.typed) {
+        const std::optional<qint64> key = IndexKey::encode(predicate.fieldType, cell);
+        if (!key)
+            return false;
+        cmp = compareKeys(*key, predicate.key);
+        cmp2 = compareKeys(*key, predicate.key2);
+    } else {
+        const QString value = cell.trimmed();
+        if (value.isEmpty())
+            return false;
+        cmp = QString::compare(value, predicate.text, Qt::CaseInsensitive);
+        if (predicate.op == QueryCondition::Between)
+            cmp2 = QString::compare(value, predicate.text2, Qt::CaseInsensitive);
+    }
+
+    switch (predicate.op) {
+    case QueryCondition::Equal:          return cmp == 0;
+    case QueryCondition::NotEqual:       return cmp != 0;
+    case QueryCondition::Less:           return cmp < 0;
+    case QueryCondition::LessOrEqual:    return cmp <= 0;
+    case QueryCondition::Greater:        return cmp > 0;
+    case QueryCondition::GreaterOrEqual: return cmp >= 0;
+    case QueryCondition::Between:        return cmp >= 0 && cmp2 <= 0;
+    default:                             return false;
+    }
+}
+
+bool FilterOperator::next(RowBatch *batch)
+{
+    while (m_input->next(batch)) {
+        // Las filas que pasan se compactan al principio del mismo lote
+        int kept = 0;
+        for (int row = 0; row < batch->size(); row++) {
+            const QStringList &values = batch->at(row);
+            bool keep = true;
+            for (const Predicate &predicate : qAsConst(m_predicates)) {
+                if (!matches(predicate, values.value(predicate.column))) {
+                    keep = false;
+                    break;
+                }
+            }
+            if (!keep)
+                continue;
+            if (kept != row)
+                (*batch)[kept] = std::move((*batch)[row]);
+            ++kept;
+        }
+        batch->resize(kept);
+        if (kept > 0)
+            return true;
+    }
+    return false;
+}
+
+SortOperator::SortOperator(std::unique_ptr<QueryOperator> input, const QVector<QuerySortKey> &keys, int limit)
+    : QueryOperator(std::move(input)), m_limit(limit)
+{
+    const QStringList names = m_input->fieldNames();
+    const QStringList types = m_input->fieldTypes();
+    for (const QuerySortKey &key : keys) {
+        const int column = names.indexOf(key.field);
+        if (column < 0)
+            continue;
+        m_columns.append(column);
+        m_ascending.append(key.ascending);
+        const QString type = types.value(column);
+        m_keyTypes.append(IndexKey::isIndexableType(type) ? type : QString());
+    }
+}
+
+bool SortOperator::sortInput()
+{
+    RowBatch batch;
+    while (m_input->next(&batch))
+        m_rows += batch;
+    if (!m_input->errorString().isEmpty())
+        return false;
+
+    // Las claves por valor se convierten una sola vez por fila
+    const int rowCount = m_rows.size();
+    const int keyCount = m_columns.size();
+    QVector<qint64> keys(rowCount * keyCount);
+    QVector<bool> hasKey(rowCount * keyCount);
+    for (int k = 0; k < keyCount; k++) {
+        if (m_keyTypes.at(k).isEmpty())
+            continue;
+        for (int row = 0; row < rowCount; row++) {
+            const std::optional<qint64> key = IndexKey::encode(m_keyTypes.at(k), m_rows.at(row).value(m_columns.at(k)));
+            hasKey[row * keyCount + k] = key.has_value();
+            keys[row * keyCount + k] = key.value_or(0);
+        }
+    }
+
+    // A igualdad de claves se conserva el orden de llegada
+    auto less = [&](int a, int b) {
+        for (int k = 0; k < keyCount; k++) {
+            int cmp;
+            if (m_keyTypes.at(k).isEmpty()) {
+                cmp = QString::compare(m_rows.at(a).value(m_columns.at(k)), m_rows.at(b).value(m_columns.at(k)),
+                                       Qt::CaseInsensitive);
+            } else {
+                const bool hasA = hasKey.at(a * keyCount + k);
+                const bool hasB = hasKey.at(b * keyCount + k);
+                if (hasA != hasB)
+                    cmp = hasA ? 1 : -1;
+                else
+                    cmp = hasA ? compareKeys(keys.at(a * keyCount + k), keys.at(b * keyCount + k)) : 0;
+            }
+            if (cmp != 0)
+                return m_ascending.at(k) ? cmp < 0 : cmp > 0;
+        }
+        return a < b;
+    };
+
+    QVector<int> order(rowCount);
+    for (int row = 0; row < rowCount; row++)
+        order[row] = row;
+    if (m_limit >= 0 && m_limit < rowCount) {
+        std::partial_sort(order.begin(), order.begin() + m_limit, order.end(), less);
+        order.resize(m_limit);
+    } else {
+        std::sort(order.begin(), order.end(), less);
+    }
+
+    RowBatch sorted;
+    sorted.reserve(order.size());
+    for (int row : qAsConst(order))
+        sorted.append(std::move(m_rows[row]));
+    m_rows = std::move(sorted);
+    return true;
+}
+
+bool SortOperator::next(RowBatch *batch)
+{
+    batch->clear();
+    if (!m_sorted) {
+        m_sorted = true;
+        if (!sortInput())
+            return false;
+    }
+    const int count = qMin(BatchRows, m_rows.size() - m_nextRow);
+    if (count <= 0)
+        return false;
+    *batch = m_rows.mid(m_nextRow, count);
+    m_nextRow += count;
+    return true;
+}
+
+LimitOperator::LimitOperator(std::unique_ptr<QueryOperator> input, int limit)
+    : QueryOperator(std::move(input)), m_remaining(limit)
+{
+}
+
+bool LimitOperator::next(RowBatch *batch)
+{
+    if (m_remaining <= 0 || !m_input->next(batch)) {
+        batch->clear();
+        return false;
+    }
+    if (batch->size() > m_remaining)
+        batch->resize(m_remaining);
+    m_remaining -= batch->size();
+    return true;
+}
+
+ProjectOperator::ProjectOperator(std::unique_ptr<QueryOperator> input, const QStringList &fields)
+    : QueryOperator(std::move(input))
+{
+    const QStringList names = m_input->fieldNames();
+    const QStringList types = m_input->fieldTypes();
+    for (const QString &field : fields) {
+        const int column = names.indexOf(field);
+        if (column < 0)
+            continue;
+        m_columns.append(column);
+        m_names << field;
+        m_types << types.value(column);
+    }
+}
+
+bool ProjectOperator::next(RowBatch *batch)
+{
+    if (!m_input->next(batch))
+        return false;
+    for (QStringList &values : *batch) {
+        QStringList projected;
+        projected.reserve(m_columns.size());
+        for (int column : qAsConst(m_columns))
+            projected << values.value(column);
+        values = std::move(projected);
+    }
+    return true;
+}
+
+// --- Motor ---
+
+QueryEngine::QueryEngine(RecordFile *file, const QMap<QString, BPlusTree*> &indexes)
+    : m_file(file), m_indexes(indexes)
+{
+}
+
+QueryEngine::QueryEngine(const ColumnTable &rows)
+    : m_rows(rows)
+{
+}
+
+QStringList QueryEngine::fieldNames() const
+{
+    return m_rows ? m_rows->fieldNames() : m_file->fieldNames();
+}
+
+QStringList QueryEngine::fieldTypes() const
+{
+    return m_rows ? m_rows->fieldTypes() : m_file->fieldTypes();
+}
+
+bool QueryEngine::validate(const Query &query, QString *error) const
+{
+    const QStringList names = fieldNames();
+    const QStringList types = fieldTypes();
+    auto fail = [error](const QString &message) {
+        if (error)
+            *error = message;
+        return false;
+    };
+
+    for (const QueryCondition &condition : query.conditions) {
+        const int column = names.indexOf(condition.field);
+        if (column < 0)
+            return fail(QStringLiteral("El campo %1 no existe").arg(condition.field));
+        const QString type = types.value(column);
+        if (!IndexKey::isIndexableType(type) || !comparesValue(condition.op))
+            continue;
+        QStringList values { condition.value };
+        if (condition.op == QueryCondition::Between)
+            values << condition.value2;
+        for (const QString &value : values) {
+            if (!IndexKey::encode(type, value)) {
+                return fail(QStringLiteral("El valor \"%1\" no es válido para el campo %2 (%3)")
+                                .arg(value, condition.field, type));
+            }
+        }
+    }
+    for (const QuerySortKey &key : query.orderBy) {
+        if (!names.contains(key.field))
+            return fail(QStringLiteral("El campo %1 no existe").arg(key.field));
+    }
+    for (const QString &field : query.select) {
+        if (!names.contains(field))
+            return fail(QStringLiteral("El campo %1 no existe").arg(field));
+    }
+    return true;
+}
+
+double QueryEngine::indexScanCost(const BPlusTree *index, qint64 rows) const
+{
+    // Bajar por el árbol, recorrer las hojas del rango y leer cada registro
+    // en su página (lectura aleatoria)
+    const double leafPages = double(rows) / IndexFile::maxEntries(true);
+    return index->height() * RandomPageCost + leafPages * SequentialPageCost
+           + rows * (RandomPageCost + RowCost);
+}
+
+QueryPlan QueryEngine::plan(const Query &query)
+{
+    QueryPlan plan;
+    if (m_rows) {
+        plan.access = QueryPlan::RowsScan;
+        plan.estimatedRows = m_rows->rowCount();
+        return plan;
+    }
+
+    plan.fullScanCost = m_file->pageCount() * SequentialPageCost + m_file->recordCount() * RowCost;
+    double bestCost = plan.fullScanCost;
+
+    const QStringList names = fieldNames();
+    const QStringList types = fieldTypes();
+    for (auto it = m_indexes.constBegin(); it != m_indexes.constEnd(); ++it) {
+        BPlusTree *index = it.value();
+        const QString field = it.key();
+        const QString type = types.value(names.indexOf(field));
+        if (!index || !index->isOpen() || !IndexKey::isIndexableType(type))
+            continue;
+
+        KeyRange range;
+        bool hasRange = false;
+        bool residual = false;
+        for (const QueryCondition &condition : query.conditions) {
+            if (condition.field != field || !isRangeOperator(condition.op)) {
+                residual = true;
+                continue;
+            }
+            const std::optional<qint64> key = IndexKey::encode(type, condition.value);
+            const std::optional<qint64> key2 = condition.op == QueryCondition::Between
+                ? IndexKey::encode(type, condition.value2) : std::optional<qint64>(0);
+            if (!key || !key2)
+                continue;   // validate() ya lo rechaza
+            range.apply(condition, *key, *key2);
+            hasRange = true;
+        }
+        if (!hasRange)
+            continue;
+
+        // El índice da las filas ordenadas por su clave (y a igual clave, por
+        // RecordId: el mismo orden que el recorrido completo)
+        const bool sortedByIndex = query.orderBy.size() == 1 && query.orderBy.first().field == field
+                                   && query.orderBy.first().ascending;
+        // Sin más condiciones, con el orden del índice alcanza con las primeras limit filas
+        const bool stopAtLimit = sortedByIndex && !residual && query.limit >= 0;
+
+        // Más registros que maxRows y el recorrido completo es más barato: no
+        // hace falta contar el rango entero
+        const double perRow = RandomPageCost + RowCost + SequentialPageCost / IndexFile::maxEntries(true);
+        const qint64 maxRows = qint64(std::floor((bestCost - index->height() * RandomPageCost) / perRow));
+        if (maxRows < 0)
+            continue;
+        BPlusTreeIterator probe = index->range(range.low, range.high, range.lowInclusive, range.highInclusive);
+        qint64 rows = 0;
+        while (rows <= maxRows && !(stopAtLimit && rows >= query.limit) && probe.next())
+            ++rows;
+
+        const double cost = indexScanCost(index, rows);
+        if (cost < bestCost) {
+            bestCost = cost;
+            plan.access = QueryPlan::IndexScan;
+            plan.indexField = field;
+            plan.low = range.low;
+            plan.high = range.high;
+            plan.lowInclusive = range.lowInclusive;
+            plan.highInclusive = range.highInclusive;
+            plan.sortedByIndex = sortedByIndex;
+            plan.estimatedRows = rows;
+            plan.indexScanCost = cost;
+        } else if (plan.access == QueryPlan::FullScan) {
+            // Para explicar por qué no se usó
+            plan.indexField = field;
+            plan.indexScanCost = cost;
+        }
+    }
+    return plan;
+}
+
+std::unique_ptr<QueryOperator> QueryEngine::build(const Query &query, const QueryPlan &plan)
+{
+    std::unique_ptr<QueryOperator> root;
+    QVector<QueryCondition> residual = query.conditions;
+    switch (plan.access) {
+    case QueryPlan::RowsScan:
+        root.reset(new RowsScanOperator(*m_rows));
+        break;
+    case QueryPlan::IndexScan: {
+        BPlusTree *index = m_indexes.value(plan.indexField);
+        root.reset(new IndexScanOperator(m_file, index->range(plan.low, plan.high,
+                                                              plan.lowInclusive, plan.highInclusive)));
+        // El rango ya resuelve las condiciones de rango sobre el campo del índice
+        residual.erase(std::remove_if(residual.begin(), residual.end(), [&plan](const QueryCondition &c) {
+            return c.field == plan.indexField && isRangeOperator(c.op);
+        }), residual.end());
+        break;
+    }
+    case QueryPlan::FullScan:
+        root.reset(new TableScanOperator(m_file));
+        break;
+    }
+
+    if (!residual.isEmpty())
+        root.reset(new FilterOperator(std::move(root), residual));
+    if (!query.orderBy.isEmpty() && !plan.sortedByIndex)
+        root.reset(new SortOperator(std::move(root), query.orderBy, query.limit));
+    if (query.limit >= 0)
+        root.reset(new LimitOperator(std::move(root), query.limit));
+    if (!query.select.isEmpty())
+        root.reset(new ProjectOperator(std::move(root), query.select));
+    return root;
+}
+
+std::optional<QueryResult> QueryEngine::execute(const Query &query)
+{
+    m_error.clear();
+    if (!m_rows && (!m_file || !m_file->isOpen())) {
+        m_error = QStringLiteral("La tabla no tiene archivo de registros");
+        return std::nullopt;
+    }
+    if (!validate(query, &m_error))
+        return std::nullopt;
+
+    QElapsedTimer clock;
+    clock.start();
+
+    QueryResult result;
+    result.plan = plan(query);
+    std::unique_ptr<QueryOperator> root = build(query, result.plan);
+    result.fieldNames = root->fieldNames();
+
+    RowBatch batch;
+    while (root->next(&batch)) {
+        for (QStringList &values : batch)
+            result.rows.append(std::move(values));
+    }
+    if (!root->errorString().isEmpty()) {
+        m_error = root->errorString();
+        return std::nullopt;
+    }
+    result.scannedRows = root->rowsRead();
+    result.elapsedMs = clock.elapsed();
+    return result;
+}
@@ -0,0 +1,277 @@
+#ifndef QUERYENGINE_H
+#define QUERYENGINE_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+#include <optional>
+#include "RecordFile.h"
+#include "BPlusTree.h"
+#include "ColumnTable.h"
+
+// Condición sobre un campo. Los valores se interpretan según el tipo del
+// campo: "Entero", "Decimales", "moneda" y "fecha" se comparan por valor
+// (ver IndexKey); los demás tipos como texto, sin distinguir mayúsculas.
+// Una celda vacía (o que no es un valor de su tipo) no cumple ninguna
+// comparación; para buscarlas están IsEmpty e IsNotEmpty.
+struct QueryCondition {
+    enum Operator {
+        Equal,
+        NotEqual,
+        Less,
+        LessOrEqual,
+        Greater,
+        GreaterOrEqual,
+        Between,        // value <= campo <= value2
+        Contains,       // el texto contiene value
+        IsEmpty,
+        IsNotEmpty
+    };
+
+    QString field;
+    Operator op = Equal;
+    QString value;
+    QString value2;
+};
+
+struct QuerySortKey {
+    QString field;
+    bool ascending = true;
+};
+
+// SELECT select FROM tabla WHERE conditions (todas) ORDER BY orderBy LIMIT limit
+struct Query {
+    QVector<QueryCondition> conditions;
+    QStringList select;                 // vacío = todos los campos
+    QVector<QuerySortKey> orderBy;      // en orden ascendente las celdas vacías van primero
+    int limit = -1;                     // -1 = sin límite
+};
+
+// Cómo se va a leer la tabla y por qué
+struct QueryPlan {
+    enum Access {
+        FullScan,       // todas las páginas del .mad, en orden
+        IndexScan,      // un rango de un índice B+/B* y cada registro por su RecordId
+        RowsScan        // filas en memoria (tabla sin archivo)
+    };
+
+    Access access = FullScan;
+    QString indexField;
+    std::optional<qint64> low;
+    std::optional<qint64> high;
+    bool lowInclusive = true;
+    bool highInclusive = true;
+    bool sortedByIndex = false;         // el índice ya da el orden pedido: no se ordena
+    qint64 estimatedRows = -1;          // entradas del rango (-1 = no se estimó)
+    double fullScanCost = 0.0;
+    double indexScanCost = 0.0;
+
+    QString describe() const;
+};
+
+struct QueryResult {
+    QStringList fieldNames;
+    QList<QStringList> rows;
+    QueryPlan plan;
+    qint64 scannedRows = 0;             // registros leídos antes de filtrar
+    qint64 elapsedMs = 0;
+};
+
+// Lote de filas que pasa de un operador al siguiente
+using RowBatch = QVector<QStringList>;
+
+// Operador del motor de consultas (modelo de iteradores, de a lotes).
+//
+// Cada operador toma las filas del que tiene debajo llamando a next(), que
+// entrega hasta BatchRows filas por llamada: el costo de pasar de un operador
+// a otro se paga una vez por lote y no por fila. Los que solo miran o recortan
+// filas (Filter, Project, Limit) trabajan sobre el mismo lote; Sort es el único
+// que necesita todas las filas antes de entregar la primera.
+class QueryOperator {
+public:
+    static constexpr int BatchRows = 1024;
+
+    explicit QueryOperator(std::unique_ptr<QueryOperator> input = nullptr);
+    virtual ~QueryOperator();
+    QueryOperator(const QueryOperator&) = delete;
+    QueryOperator& operator=(const QueryOperator&) = delete;
+
+    // Siguiente lote (nunca vacío); false cuando no hay más filas o hubo un error
+    virtual bool next(RowBatch *batch) = 0;
+
+    // Campos de las filas que entrega
+    virtual QStringList fieldNames() const;
+    virtual QStringList fieldTypes() const;
+
+    // Error de este operador o de alguno de los de abajo
+    QString errorString() const;
+    // Registros leídos de la tabla por el recorrido de más abajo
+    virtual qint64 rowsRead() const;
+
+protected:
+    std::unique_ptr<QueryOperator> m_input;
+    QString m_error;
+};
+
+// Todos los registros del .mad, página por página
+class TableScanOperator : public QueryOperator {
+public:
+    explicit TableScanOperator(RecordFile *file);
+    bool next(RowBatch *batch) override;
+    QStringList fieldNames() const override { return m_file->fieldNames(); }
+    QStringList fieldTypes() const override { return m_file->fieldTypes(); }
+    qint64 rowsRead() const override { return m_rowsRead; }
+
+private:
+    RecordFile *m_file;
+    quint32 m_nextPage = 1;
+    qint64 m_rowsRead = 0;
+};
+
+// Los registros de un rango de un índice, en el orden de la clave
+class IndexScanOperator : public QueryOperator {
+public:
+    IndexScanOperator(RecordFile *file, const BPlusTreeIterator &range);
+    bool next(RowBatch *batch) override;
+    QStringList fieldNames() const override { return m_file->fieldNames(); }
+    QStringList fieldTypes() const override { return m_file->fieldTypes(); }
+    qint64 rowsRead() const override { return m_rowsRead; }
+
+private:
+    RecordFile *m_file;
+    BPlusTreeIterator m_range;
+    qint64 m_rowsRead = 0;
+};
+
+// Filas ya cargadas por columnas (tabla sin archivo)
+class RowsScanOperator : public QueryOperator {
+public:
+    explicit RowsScanOperator(const ColumnTable &rows);
+    bool next(RowBatch *batch) override;
+    QStringList fieldNames() const override { return m_rows.fieldNames(); }
+    QStringList fieldTypes() const override { return m_rows.fieldTypes(); }
+    qint64 rowsRead() const override { return m_nextRow; }
+
+private:
+    ColumnTable m_rows;
+    int m_nextRow = 0;
+};
+
+// Deja pasar las filas que cumplen todas las condiciones
+class FilterOperator : public QueryOperator {
+public:
+    FilterOperator(std::unique_ptr<QueryOperator> input, const QVector<QueryCondition> &conditions);
+    bool next(RowBatch *batch) override;
+
+private:
+    // Condición con la columna resuelta y los valores ya convertidos a clave
+    struct Predicate {
+        int column = -1;
+        QueryCondition::Operator op = QueryCondition::Equal;
+        QString fieldType;
+        bool typed = false;             // se compara por valor (IndexKey)
+        bool never = false;             // el valor no es del tipo del campo: ninguna fila cumple
+        qint64 key = 0;
+        qint64 key2 = 0;
+        QString text;
+        QString text2;
+    };
+
+    bool matches(const Predicate &predicate, const QString &cell) const;
+
+    QVector<Predicate> m_predicates;
+};
+
+// Ordena por una o más claves. Con limit >= 0 solo conserva las primeras
+// limit filas (selección parcial en lugar de ordenar todo).
+class SortOperator : public QueryOperator {
+public:
+    SortOperator(std::unique_ptr<QueryOperator> input, const QVector<QuerySortKey> &keys, int limit = -1);
+    bool next(RowBatch *batch) override;
+
+private:
+    bool sortInput();
+
+    QVector<int> m_columns;
+    QVector<bool> m_ascending;
+    QStringList m_keyTypes;             // tipo del campo si se compara por valor, si no vacío
+    int m_limit;
+    bool m_sorted = false;
+    RowBatch m_rows;
+    int m_nextRow = 0;
+};
+
+// Corta después de limit filas (y deja de leer las de abajo)
+class LimitOperator : public QueryOperator {
+public:
+    LimitOperator(std::unique_ptr<QueryOperator> input, int limit);
+    bool next(RowBatch *batch) override;
+
+private:
+    int m_remaining;
+};
+
+// Solo los campos pedidos, en ese orden
+class ProjectOperator : public QueryOperator {
+public:
+    ProjectOperator(std::unique_ptr<QueryOperator> input, const QStringList &fields);
+    bool next(RowBatch *batch) override;
+    QStringList fieldNames() const override { return m_names; }
+    QStringList fieldTypes() const override { return m_types; }
+
+private:
+    QVector<int> m_columns;
+    QStringList m_names;
+    QStringList m_types;
+};
+
+// Planificación y ejecución de consultas sobre una tabla.
+//
+// Sin condiciones sobre campos indexados la tabla se recorre completa. Si hay
+// un índice B+/B* sobre un campo con condiciones de rango (=, <, <=, >, >=,
+// entre), se estima cuántos registros tiene el rango recorriendo las hojas
+// del índice (sin leer registros) y se compara el costo de leer esos
+// registros uno por uno con el de leer todas las páginas en secuencia. El
+// recorrido de las hojas se corta apenas el índice deja de convenir, así que
+// estimar nunca cuesta más que una fracción del recorrido completo.
+//
+//   Scan (completo o por índice) → Filter → Sort → Limit → Project
+//
+// Filter solo evalúa las condiciones que el rango del índice no resuelve, y
+// si el orden pedido es el de la clave del índice no hay Sort.
+class QueryEngine {
+public:
+    // Costos relativos (leer una página en secuencia = 1). Decodificar un
+    // registro pesa: en una página entran cientos, así que el recorrido
+    // completo se va casi todo en eso. Con estos valores el índice conviene
+    // hasta alrededor del 5% de la tabla.
+    static constexpr double SequentialPageCost = 1.0;
+    static constexpr double RandomPageCost = 4.0;
+    static constexpr double RowCost = 0.2;
+
+    QueryEngine(RecordFile *file, const QMap<QString, BPlusTree*> &indexes);
+    explicit QueryEngine(const ColumnTable &rows);
+
+    // Campos existentes y valores que se pueden interpretar con el tipo del campo
+    bool validate(const Query &query, QString *error = nullptr) const;
+    QueryPlan plan(const Query &query);
+    std::unique_ptr<QueryOperator> build(const Query &query, const QueryPlan &plan);
+    std::optional<QueryResult> execute(const Query &query);
+
+    QString errorString() const { return m_error; }
+
+private:
+    QStringList fieldNames() const;
+    QStringList fieldTypes() const;
+    double indexScanCost(const BPlusTree *index, qint64 rows) const;
+
+    RecordFile *m_file = nullptr;
+    QMap<QString, BPlusTree*> m_indexes;
+    std::optional<ColumnTable> m_rows;
+    QString m_error;
+};
+
+#endif // QUERYENGINE_H
@@ -0,0 +1,921 @@
+#include "RecordFile.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <cstring>
+
+namespace {
+// Distribución de la página de encabezado (después del encabezado común)
+constexpr char HeaderMagic[4] = { 'M', 'A', 'D', 'F' };
+constexpr int MagicOffset        = 16;
+constexpr int VersionOffset      = 20;
+constexpr int RecordCountOffset  = 24;
+constexpr int LastDataPageOffset = 28;
+constexpr int AvailHeadOffset    = 32; // quint64: RecordId de la cabeza de la Avail List
+constexpr int AvailCountOffset   = 40; // quint32: ranuras en la lista
+constexpr int AvailPolicyOffset  = 44; // quint8: AvailList::Policy
+constexpr int SchemaOffset       = 64;
+
+// Los registros con versión de esquema marcan este bit en la cantidad de valores
+// (los de la versión 2 del formato no lo tienen y son de la versión 0)
+constexpr quint16 VersionedRecordFlag = 0x8000;
+
+void appendString(QByteArray &out, const QString &value)
+{
+    const QByteArray utf8 = value.toUtf8();
+    char len[2];
+    pageWriteU16(len, 0, quint16(utf8.size()));
+    out.append(len, 2);
+    out.append(utf8);
+}
+
+bool takeString(const char *data, int length, int &pos, QString *value)
+{
+    if (pos + 2 > length)
+        return false;
+    const int len = pageReadU16(data, pos);
+    pos += 2;
+    if (pos + len > length)
+        return false;
+    *value = QString::fromUtf8(data + pos, len);
+    pos += len;
+    return true;
+}
+
+QByteArray encodeSchema(const QString &tableName, const QStringList &names, const QStringList &types)
+{
+    QByteArray out;
+    appendString(out, tableName);
+    char count[2];
+    pageWriteU16(count, 0, quint16(names.size()));
+    out.append(count, 2);
+    for (int i = 0; i < names.size(); ++i) {
+        appendString(out, names.at(i));
+        appendString(out, i < types.size() ? types.at(i) : QString());
+    }
+    return out;
+}
+
+bool decodeSchema(const char *page, QString *tableName, QStringList *names, QStringList *types,
+                  int *endOffset = nullptr)
+{
+    const char *data = page + SchemaOffset;
+    const int length = PagedFile::PageSize - SchemaOffset;
+    int pos = 0;
+
+    QString table;
+    if (!takeString(data, length, pos, &table) || pos + 2 > length)
+        return false;
+    const int fieldCount = pageReadU16(data, pos);
+    pos += 2;
+
+    QStringList n, t;
+    for (int i = 0; i < fieldCount; ++i) {
+        QString name, type;
+        if (!takeString(data, length, pos, &name) || !takeString(data, length, pos, &type))
+            return false;
+        n << name;
+        t << type;
+    }
+
+    if (tableName) *tableName = table;
+    if (names) *names = n;
+    if (types) *types = t;
+    if (endOffset) *endOffset = SchemaOffset + pos;
+    return true;
+}
+
+void appendU16(QByteArray &out, quint16 value)
+{
+    char buf[2];
+    pageWriteU16(buf, 0, value);
+    out.append(buf, 2);
+}
+
+bool takeU16(const char *data, int length, int &pos, quint16 *value)
+{
+    if (pos + 2 > length)
+        return false;
+    *value = pageReadU16(data, pos);
+    pos += 2;
+    return true;
+}
+
+bool isHeaderPage(const char *page)
+{
+    return quint8(page[PagedFile::PageTypeOffset]) == 1
+           && std::memcmp(page + MagicOffset, HeaderMagic, sizeof(HeaderMagic)) == 0;
+}
+} // namespace
+
+RecordFile::~RecordFile()
+{
+    close();
+}
+
+bool RecordFile::open(const QString &path)
+{
+    close();
+    m_error.clear();
+
+    // Un reemplazo interrumpido dejó solo la copia de respaldo: se restaura
+    const QString backup = path + ".bak";
+    if (!QFile::exists(path) && QFile::exists(backup)) {
+        qDebug() << "WARNING: Restaurando" << path << "desde su respaldo";
+        QFile::rename(backup, path);
+    }
+
+    if (!m_file.open(path)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    if (m_file.pageCount() == 0) {
+        // Archivo nuevo: solo la página de encabezado
+        if (m_file.allocatePage() != 0) {
+            m_error = m_file.errorString();
+            m_file.close();
+            return false;
+        }
+        m_tableName.clear();
+        m_fieldNames.clear();
+        m_fieldTypes.clear();
+        resetFieldIds();
+        m_schemaVersion = 0;
+        m_versionUnused = true;
+        m_recordCount = 0;
+        m_lastDataPage = 0;
+        m_avail.clear();
+        m_avail.setPolicy(AvailList::FirstFit);
+        if (!writeHeader()) {
+            m_file.close();
+            return false;
+        }
+        return true;
+    }
+
+    if (!loadHeader()) {
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+void RecordFile::close()
+{
+    if (!m_file.isOpen())
+        return;
+    if (m_headerDirty)
+        writeHeader();
+    m_file.close();
+}
+
+bool RecordFile::loadHeader()
+{
+    QByteArray page(PagedFile::PageSize, '\0');
+    if (!m_file.readPage(0, page.data())) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    if (!isHeaderPage(page.constData())) {
+        m_error = QStringLiteral("%1 no es un archivo de tabla válido").arg(m_file.path());
+        return false;
+    }
+    const quint16 version = pageReadU16(page.constData(), VersionOffset);
+    if (version > FormatVersion) {
+        m_error = QStringLiteral("Versión de archivo no soportada: %1").arg(version);
+        return false;
+    }
+    int schemaEnd = 0;
+    if (!decodeSchema(page.constData(), &m_tableName, &m_fieldNames, &m_fieldTypes, &schemaEnd)) {
+        m_error = QStringLiteral("Esquema dañado en %1").arg(m_file.path());
+        return false;
+    }
+    // Versión 2: sin historial, todos los registros son de la versión 0
+    resetFieldIds();
+    m_schemaVersion = 0;
+    if (version >= 3 && !loadSchemaVersions(page.constData(), schemaEnd)) {
+        m_error = QStringLiteral("Historial de esquemas dañado en %1").arg(m_file.path());
+        return false;
+    }
+    m_versionUnused = false;
+    m_recordCount = pageReadU32(page.constData(), RecordCountOffset);
+    m_lastDataPage = pageReadU32(page.constData(), LastDataPageOffset);
+    if (m_lastDataPage >= m_file.pageCount())
+        m_lastDataPage = 0;
+
+    const quint8 policy = quint8(page.at(AvailPolicyOffset));
+    m_avail.setPolicy(policy <= AvailList::WorstFit ? AvailList::Policy(policy) : AvailList::FirstFit);
+    m_headerDirty = false;
+    loadAvailList(RecordId::fromUInt64(pageReadU64(page.constData(), AvailHeadOffset)),
+                  pageReadU32(page.constData(), AvailCountOffset));
+    return true;
+}
+
+bool RecordFile::loadAvailList(RecordId head, quint32 count)
+{
+    m_avail.clear();
+
+    QByteArray page(PagedFile::PageSize, '\0');
+    quint32 loadedPage = 0;
+    RecordId rid = head;
+
+    // Se recorre la lista enlazada en disco; cualquier enlace inválido la corta
+    // (el espacio perdido se recupera en la compactación)
+    while (rid.isValid() && quint32(m_avail.count()) <= count) {
+        if (rid.page >= m_file.pageCount() || m_avail.contains(rid))
+            break;
+        if (rid.page != loadedPage) {
+            if (!m_file.readPage(rid.page, page.data())
+                || quint8(page.at(PagedFile::PageTypeOffset)) != DataPageType)
+                break;
+            loadedPage = rid.page;
+        }
+        const char *p = page.constData();
+        if (rid.slot >= pageReadU16(p, SlotCountOffset))
+            break;
+        const int slotPos = PagedFile::PageHeaderSize + rid.slot * SlotSize;
+        const quint16 capacity = pageReadU16(p, slotPos + 4);
+        if (pageReadU16(p, slotPos + 2) != FreeSlot || capacity < LinkSize)
+            break;
+
+        m_avail.append(rid, capacity);
+        const int offset = pageReadU16(p, slotPos);
+        rid = RecordId{ pageReadU32(p, offset), pageReadU16(p, offset + 4) };
+    }
+
+    if (quint32(m_avail.count()) != count || rid.isValid()) {
+        qDebug() << "WARNING: Avail List inconsistente en" << m_file.path()
+                 << "- se cargaron" << m_avail.count() << "de" << count << "ranuras";
+        m_headerDirty = true;
+        return false;
+    }
+    return true;
+}
+
+bool RecordFile::writeFreeLink(RecordId rid, RecordId next)
+{
+    QByteArray page;
+    if (!readDataPage(rid.page, page))
+        return false;
+
+    char *p = page.data();
+    const int slotPos = PagedFile::PageHeaderSize + rid.slot * SlotSize;
+    const int offset = pageReadU16(p, slotPos);
+    pageWriteU32(p, offset, next.page);
+    pageWriteU16(p, offset + 4, next.slot);
+    if (!m_file.writePage(rid.page, p)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool RecordFile::setPlacementPolicy(AvailList::Policy policy)
+{
+    m_avail.setPolicy(policy);
+    if (!isOpen())
+        return false;
+    return writeHeader();
+}
+
+bool RecordFile::loadSchemaVersions(const char *page, int offset)
+{
+    const int length = PagedFile::PageSize;
+    int pos = offset;
+    quint16 historyCount = 0;
+    if (!takeU16(page, length, pos, &m_schemaVersion) || !takeU16(page, length, pos, &m_nextFieldId))
+        return false;
+    for (int i = 0; i < m_fieldIds.size(); ++i) {
+        if (!takeU16(page, length, pos, &m_fieldIds[i]))
+            return false;
+    }
+    if (!takeU16(page, length, pos, &historyCount))
+        return false;
+    for (int i = 0; i < historyCount; ++i) {
+        SchemaVersion entry;
+        quint16 count = 0;
+        if (!takeU16(page, length, pos, &entry.version) || !takeU16(page, length, pos, &count))
+            return false;
+        entry.fieldIds.resize(count);
+        for (int f = 0; f < count; ++f) {
+            if (!takeU16(page, length, pos, &entry.fieldIds[f]))
+                return false;
+        }
+        m_schemaHistory.append(entry);
+    }
+    return true;
+}
+
+void RecordFile::resetFieldIds()
+{
+    m_fieldIds.clear();
+    for (int i = 0; i < m_fieldNames.size(); ++i)
+        m_fieldIds.append(quint16(i + 1));
+    m_nextFieldId = quint16(m_fieldNames.size() + 1);
+    m_schemaHistory.clear();
+}
+
+bool RecordFile::writeHeader()
+{
+    QByteArray schema = encodeSchema(m_tableName, m_fieldNames, m_fieldTypes);
+    appendU16(schema, m_schemaVersion);
+    appendU16(schema, m_nextFieldId);
+    for (quint16 id : qAsConst(m_fieldIds))
+        appendU16(schema, id);
+    appendU16(schema, quint16(m_schemaHistory.size()));
+    for (const SchemaVersion &entry : qAsConst(m_schemaHistory)) {
+        appendU16(schema, entry.version);
+        appendU16(schema, quint16(entry.fieldIds.size()));
+        for (quint16 id : entry.fieldIds)
+            appendU16(schema, id);
+    }
+    if (schema.size() > PagedFile::PageSize - SchemaOffset) {
+        m_error = QStringLiteral("El esquema de la tabla es demasiado grande");
+        return false;
+    }
+
+    QByteArray page(PagedFile::PageSize, '\0');
+    page[PagedFile::PageTypeOffset] = char(HeaderPageType);
+    std::memcpy(page.data() + MagicOffset, HeaderMagic, sizeof(HeaderMagic));
+    pageWriteU16(page.data(), VersionOffset, FormatVersion);
+    pageWriteU32(page.data(), RecordCountOffset, m_recordCount);
+    pageWriteU32(page.data(), LastDataPageOffset, m_lastDataPage);
+    pageWriteU64(page.data(), AvailHeadOffset, m_avail.head().toUInt64());
+    pageWriteU32(page.data(), AvailCountOffset, quint32(m_avail.count()));
+    page[AvailPolicyOffset] = char(m_avail.policy());
+    std::memcpy(page.data() + SchemaOffset, schema.constData(), schema.size());
+
+    if (!m_file.writePage(0, page.constData())) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_headerDirty = false;
+    return true;
+}
+
+bool RecordFile::setSchema(const QString &tableName, const QStringList &fieldNames, const QStringList &fieldTypes)
+{
+    if (!isOpen())
+        return false;
+    ++m_modificationCount;
+    m_tableName = tableName;
+    m_fieldNames = fieldNames;
+    m_fieldTypes = fieldTypes;
+    // Esquema nuevo sin historial: los registros existentes deben reescribirse
+    resetFieldIds();
+    ++m_schemaVersion;
+    m_versionUnused = true;
+    return writeHeader();
+}
+
+bool RecordFile::alterSchema(const QString &tableName, const QStringList &fieldNames,
+                             const QStringList &fieldTypes, const QVector<quint16> &fieldIds)
+{
+    if (!isOpen())
+        return false;
+
+    const QStringList oldNames = m_fieldNames;
+    const QStringList oldTypes = m_fieldTypes;
+    const QString oldTable = m_tableName;
+    const QVector<quint16> oldIds = m_fieldIds;
+    const quint16 oldVersion = m_schemaVersion;
+    const quint16 oldNextId = m_nextFieldId;
+    const QVector<SchemaVersion> oldHistory = m_schemaHistory;
+
+    // La versión actual pasa al historial, salvo que ningún registro la use
+    if (m_recordCount == 0) {
+        m_schemaHistory.clear();
+    } else if (!m_versionUnused) {
+        SchemaVersion entry;
+        entry.version = m_schemaVersion;
+        entry.fieldIds = m_fieldIds;
+        m_schemaHistory.append(entry);
+    }
+
+    // Identificadores de los campos nuevos; un campo que ya no existe
+    // (o repetido) recibe uno nuevo
+    QVector<quint16> ids;
+    for (int i = 0; i < fieldNames.size(); ++i) {
+        const quint16 id = fieldIds.value(i);
+        if (id != 0 && oldIds.contains(id) && !ids.contains(id))
+            ids.append(id);
+        else
+            ids.append(m_nextFieldId++);
+    }
+
+    ++m_modificationCount;
+    m_tableName = tableName;
+    m_fieldNames = fieldNames;
+    m_fieldTypes = fieldTypes;
+    m_fieldIds = ids;
+    ++m_schemaVersion;
+    m_versionUnused = true;
+
+    if (m_schemaHistory.size() > MaxSchemaHistory)
+        m_error = QStringLiteral("Demasiadas versiones pendientes del esquema");
+    else if (writeHeader())
+        return true;
+
+    // No cabe: se deja el esquema como estaba
+    m_tableName = oldTable;
+    m_fieldNames = oldNames;
+    m_fieldTypes = oldTypes;
+    m_fieldIds = oldIds;
+    m_schemaVersion = oldVersion;
+    m_nextFieldId = oldNextId;
+    m_schemaHistory = oldHistory;
+    m_versionUnused = false;
+    writeHeader();
+    return false;
+}
+
+bool RecordFile::discardSchemaHistory()
+{
+    if (!isOpen())
+        return false;
+    if (m_schemaHistory.isEmpty())
+        return true;
+    m_schemaHistory.clear();
+    return writeHeader();
+}
+
+bool RecordFile::readSchema(const QString &path, QString *tableName,
+                            QStringList *fieldNames, QStringList *fieldTypes)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray page = file.read(PagedFile::PageSize);
+    if (page.size() != PagedFile::PageSize || !isHeaderPage(page.constData()))
+        return false;
+    return decodeSchema(page.constData(), tableName, fieldNames, fieldTypes);
+}
+
+int RecordFile::maxRecordSize()
+{
+    return PagedFile::PageSize - PagedFile::PageHeaderSize - SlotSize;
+}
+
+std::optional<RecordId> RecordFile::reuseSlot(const QByteArray &record)
+{
+    const std::optional<AvailList::Taken> taken = m_avail.take(quint16(record.size()));
+    if (!taken)
+        return std::nullopt;
+    m_headerDirty = true;
+
+    // Re-enlazar en disco la ranura anterior (si era la cabeza, basta el encabezado)
+    if (taken->prev.isValid() && !writeFreeLink(taken->prev, taken->next)) {
+        qDebug() << "WARNING: No se pudo re-enlazar la Avail List:" << m_error;
+    }
+
+    QByteArray page;
+    if (!readDataPage(taken->rid.page, page))
+        return std::nullopt;
+
+    char *p = page.data();
+    const int slotPos = PagedFile::PageHeaderSize + taken->rid.slot * SlotSize;
+    std::memcpy(p + pageReadU16(p, slotPos), record.constData(), record.size());
+    pageWriteU16(p, slotPos + 2, quint16(record.size()));
+    pageWriteU16(p, LiveCountOffset, quint16(pageReadU16(p, LiveCountOffset) + 1));
+
+    if (!m_file.writePage(taken->rid.page, p)) {
+        m_error = m_file.errorString();
+        return std::nullopt;
+    }
+    return taken->rid;
+}
+
+QByteArray RecordFile::encodeRecord(const QStringList &values, quint16 schemaVersion)
+{
+    QByteArray out;
+    appendU16(out, quint16(values.size()) | VersionedRecordFlag);
+    appendU16(out, schemaVersion);
+    for (const QString &value : values)
+        appendString(out, value);
+    return out;
+}
+
+QStringList RecordFile::decodeRecord(const char *data, int length, quint16 *schemaVersion)
+{
+    QStringList values;
+    if (schemaVersion)
+        *schemaVersion = 0;
+    if (length < 2)
+        return values;
+    int count = pageReadU16(data, 0);
+    int pos = 2;
+    if (count & VersionedRecordFlag) {
+        if (length < 4)
+            return values;
+        count &= ~VersionedRecordFlag;
+        if (schemaVersion)
+            *schemaVersion = pageReadU16(data, 2);
+        pos = 4;
+    }
+    for (int i = 0; i < count; ++i) {
+        QString value;
+        if (!takeString(data, length, pos, &value))
+            break;
+        values << value;
+    }
+    return values;
+}
+
+QStringList RecordFile::decodeCurrent(const char *data, int length, bool *outdated) const
+{
+    quint16 version = 0;
+    const QStringList values = decodeRecord(data, length, &version);
+    if (outdated)
+        *outdated = version != m_schemaVersion;
+    if (version == m_schemaVersion)
+        return values;
+
+    // Registro de una versión anterior: cada campo actual se busca por su identificador
+    for (const SchemaVersion &entry : m_schemaHistory) {
+        if (entry.version != version)
+            continue;
+        QStringList current;
+        for (quint16 id : m_fieldIds)
+            current << values.value(entry.fieldIds.indexOf(id));
+        return current;
+    }
+    return values; // versión desconocida: se interpreta por posición
+}
+
+void RecordFile::initDataPage(QByteArray &page)
+{
+    page.fill('\0', PagedFile::PageSize);
+    page[PagedFile::PageTypeOffset] = char(DataPageType);
+    pageWriteU16(page.data(), SlotCountOffset, 0);
+    pageWriteU16(page.data(), DataStartOffset, quint16(PagedFile::PageSize));
+    pageWriteU16(page.data(), LiveCountOffset, 0);
+}
+
+int RecordFile::pageFreeSpace(const char *page)
+{
+    const int slotCount = pageReadU16(page, SlotCountOffset);
+    const int dataStart = pageReadU16(page, DataStartOffset);
+    return dataStart - (PagedFile::PageHeaderSize + slotCount * SlotSize);
+}
+
+bool RecordFile::readDataPage(quint32 pageNo, QByteArray &page)
+{
+    if (pageNo == 0 || pageNo >= m_file.pageCount()) {
+        m_error = QStringLiteral("Registro fuera de rango (página %1)").arg(pageNo);
+        return false;
+    }
+    page.resize(PagedFile::PageSize);
+    if (!m_file.readPage(pageNo, page.data())) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    if (quint8(page.at(PagedFile::PageTypeOffset)) != DataPageType) {
+        m_error = QStringLiteral("La página %1 no es de datos").arg(pageNo);
+        return false;
+    }
+    return true;
+}
+
+std::optional<RecordId> RecordFile::placeRecord(const QByteArray &record)
+{
+    // Primero se intenta reutilizar una ranura de la Avail List
+    if (auto reused = reuseSlot(record))
+        return reused;
+
+    // Si no, se agrega al final de la última página de datos
+    const int capacity = qMax(int(record.size()), MinSlotCapacity);
+    QByteArray page;
+    quint32 pageNo = m_lastDataPage;
+
+    bool fits = false;
+    if (pageNo != 0 && readDataPage(pageNo, page))
+        fits = pageFreeSpace(page.constData()) >= capacity + SlotSize;
+
+    if (!fits) {
+        pageNo = m_file.allocatePage();
+        if (pageNo == 0xFFFFFFFF) {
+            m_error = m_file.errorString();
+            return std::nullopt;
+        }
+        initDataPage(page);
+        m_lastDataPage = pageNo;
+        m_headerDirty = true;
+    }
+
+    char *p = page.data();
+    const quint16 slot = pageReadU16(p, SlotCountOffset);
+    const quint16 offset = quint16(pageReadU16(p, DataStartOffset) - capacity);
+
+    std::memcpy(p + offset, record.constData(), record.size());
+    const int slotPos = PagedFile::PageHeaderSize + slot * SlotSize;
+    pageWriteU16(p, slotPos, offset);
+    pageWriteU16(p, slotPos + 2, quint16(record.size()));
+    pageWriteU16(p, slotPos + 4, quint16(capacity));
+    pageWriteU16(p, SlotCountOffset, quint16(slot + 1));
+    pageWriteU16(p, DataStartOffset, offset);
+    pageWriteU16(p, LiveCountOffset, quint16(pageReadU16(p, LiveCountOffset) + 1));
+
+    if (!m_file.writePage(pageNo, p)) {
+        m_error = m_file.errorString();
+        return std::nullopt;
+    }
+    return RecordId{ pageNo, slot };
+}
+
+std::optional<RecordId> RecordFile::insert(const QStringList &values)
+{
+    if (!isOpen()) {
+        m_error = QStringLiteral("El archivo de la tabla no está abierto");
+        return std::nullopt;
+    }
+    const QByteArray record = encodeRecord(values, m_schemaVersion);
+    if (record.size() > maxRecordSize()) {
+        m_error = QStringLiteral("El registro excede el tamaño máximo (%1 bytes)").arg(maxRecordSize());
+        return std::nullopt;
+    }
+
+    ++m_modificationCount;
+    m_versionUnused = false;
+    auto rid = placeRecord(record);
+    if (rid.has_value()) {
+        ++m_recordCount;
+        m_headerDirty = true;
+    }
+    return rid;
+}
+
+std::optional<RecordId> RecordFile::update(RecordId rid, const QStringList &values)
+{
+    QByteArray page;
+    if (!readDataPage(rid.page, page))
+        return std::nullopt;
+
+    char *p = page.data();
+    if (rid.slot >= pageReadU16(p, SlotCountOffset)) {
+        m_error = QStringLiteral("Ranura inválida %1").arg(rid.slot);
+        return std::nullopt;
+    }
+    const int slotPos = PagedFile::PageHeaderSize + rid.slot * SlotSize;
+    if (pageReadU16(p, slotPos + 2) == FreeSlot) {
+        m_error = QStringLiteral("El registro ya fue eliminado");
+        return std::nullopt;
+    }
+
+    const QByteArray record = encodeRecord(values, m_schemaVersion);
+    if (record.size() > maxRecordSize()) {
+        m_error = QStringLiteral("El registro excede el tamaño máximo (%1 bytes)").arg(maxRecordSize());
+        return std::nullopt;
+    }
+    ++m_modificationCount;
+    m_versionUnused = false;
+
+    // Cabe en su ranura: se reescribe en el mismo lugar
+    if (record.size() <= pageReadU16(p, slotPos + 4)) {
+        std::memcpy(p + pageReadU16(p, slotPos), record.constData(), record.size());
+        pageWriteU16(p, slotPos + 2, quint16(record.size()));
+        if (!m_file.writePage(rid.page, p)) {
+            m_error = m_file.errorString();
+            return std::nullopt;
+        }
+        return rid;
+    }
+
+    // No cabe: se mueve a otra ranura
+    auto moved = placeRecord(record);
+    if (!moved.has_value())
+        return std::nullopt;
+    if (!remove(rid))
+        return std::nullopt;
+    ++m_recordCount; // remove() lo descontó, pero el registro sigue vivo
+    return moved;
+}
+
+bool RecordFile::remove(RecordId rid)
+{
+    QByteArray page;
+    if (!readDataPage(rid.page, page))
+        return false;
+
+    char *p = page.data();
+    if (rid.slot >= pageReadU16(p, SlotCountOffset)) {
+        m_error = QStringLiteral("Ranura inválida %1").arg(rid.slot);
+        return false;
+    }
+    const int slotPos = PagedFile::PageHeaderSize + rid.slot * SlotSize;
+    if (pageReadU16(p, slotPos + 2) == FreeSlot)
+        return true;
+    ++m_modificationCount;
+
+    // Borrado lógico: la ranura queda marcada como libre y se enlaza al
+    // inicio de la Avail List (el enlace se guarda donde estaba el registro)
+    const quint16 capacity = pageReadU16(p, slotPos + 4);
+    const bool reusable = capacity >= LinkSize;
+    pageWriteU16(p, slotPos + 2, FreeSlot);
+    pageWriteU16(p, LiveCountOffset, quint16(pageReadU16(p, LiveCountOffset) - 1));
+    if (reusable) {
+        const int offset = pageReadU16(p, slotPos);
+        pageWriteU32(p, offset, m_avail.head().page);
+        pageWriteU16(p, offset + 4, m_avail.head().slot);
+    }
+    if (!m_file.writePage(rid.page, p)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    if (reusable)
+        m_avail.push(rid, capacity);
+    if (m_recordCount > 0)
+        --m_recordCount;
+    m_headerDirty = true;
+    return true;
+}
+
+std::optional<QStringList> RecordFile::read(RecordId rid)
+{
+    QByteArray page;
+    if (!readDataPage(rid.page, page))
+        return std::nullopt;
+
+    const char *p = page.constData();
+    if (rid.slot >= pageReadU16(p, SlotCountOffset)) {
+        m_error = QStringLiteral("Ranura inválida %1").arg(rid.slot);
+        return std::nullopt;
+    }
+    const int slotPos = PagedFile::PageHeaderSize + rid.slot * SlotSize;
+    const quint16 length = pageReadU16(p, slotPos + 2);
+    if (length == FreeSlot) {
+        m_error = QStringLiteral("El registro fue eliminado");
+        return std::nullopt;
+    }
+    return decodeCurrent(p + pageReadU16(p, slotPos), length);
+}
+
+bool RecordFile::clear()
+{
+    if (!isOpen())
+        return false;
+    if (!m_file.truncate(1)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    ++m_modificationCount;
+    m_recordCount = 0;
+    m_lastDataPage = 0;
+    m_avail.clear();
+    return writeHeader();
+}
+
+bool RecordFile::readPageRecords(quint32 pageNo, QList<QPair<RecordId, QStringList>> *records,
+                                 QList<RecordId> *outdated)
+{
+    records->clear();
+    if (outdated)
+        outdated->clear();
+    if (pageNo == 0 || pageNo >= m_file.pageCount())
+        return pageNo != 0;
+
+    QByteArray page(PagedFile::PageSize, '\0');
+    if (!m_file.readPage(pageNo, page.data())) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    if (quint8(page.at(PagedFile::PageTypeOffset)) != DataPageType)
+        return true;
+
+    const char *p = page.constData();
+    const int slotCount = pageReadU16(p, SlotCountOffset);
+    for (int slot = 0; slot < slotCount; ++slot) {
+        const int slotPos = PagedFile::PageHeaderSize + slot * SlotSize;
+        const quint16 length = pageReadU16(p, slotPos + 2);
+        if (length == FreeSlot)
+            continue;
+        bool old = false;
+        const RecordId rid{ pageNo, quint16(slot) };
+        records->append(qMakePair(rid, decodeCurrent(p + pageReadU16(p, slotPos), length, &old)));
+        if (old && outdated)
+            outdated->append(rid);
+    }
+    return true;
+}
+
+bool RecordFile::replaceWith(const QString &path)
+{
+    if (!isOpen())
+        return false;
+
+    const QString target = m_file.path();
+    const QString backup = target + ".bak";
+    close();
+
+    // 1) El archivo nuevo completo en disco antes de que ocupe el lugar del actual
+    QFile replacement(path);
+    if (!replacement.open(QIODevice::ReadWrite) || !PagedFile::fsyncFile(replacement)) {
+        m_error = QStringLiteral("No se pudo escribir %1 al disco").arg(path);
+        open(target);
+        return false;
+    }
+    replacement.close();
+
+    // 2) Renombres: el actual pasa a .bak y el nuevo toma su nombre
+    const QString dir = QFileInfo(target).absolutePath();
+    QFile::remove(backup);
+    if (!QFile::rename(target, backup)) {
+        m_error = QStringLiteral("No se pudo respaldar %1").arg(target);
+        open(target);
+        return false;
+    }
+    if (!QFile::rename(path, target)) {
+        m_error = QStringLiteral("No se pudo reemplazar %1").arg(target);
+        QFile::rename(backup, target);
+        open(target);
+        return false;
+    }
+
+    // 3) Los renombres en disco; recién entonces se borra el respaldo. Si no se
+    //    pueden asegurar, se vuelve al archivo anterior
+    if (!PagedFile::fsyncDirectory(dir)) {
+        m_error = QStringLiteral("No se pudo sincronizar la carpeta de %1").arg(target);
+        QFile::remove(target);
+        QFile::rename(backup, target);
+        PagedFile::fsyncDirectory(dir);
+        open(target);
+        return false;
+    }
+    QFile::remove(backup);
+
+    ++m_modificationCount;
+    return open(target);
+}
+
+bool RecordFile::sync()
+{
+    if (!isOpen())
+        return false;
+    if (m_headerDirty && !writeHeader())
+        return false;
+    return m_file.sync();
+}
+
+bool RecordFile::flushToDisk()
+{
+    if (!isOpen())
+        return false;
+    if (m_headerDirty && !writeHeader())
+        return false;
+    if (!m_file.flushToDisk()) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool RecordFile::reloadHeader()
+{
+    if (!isOpen())
+        return false;
+    return loadHeader();
+}
+
+// --- RecordCursor ---
+
+RecordCursor::RecordCursor(RecordFile *file)
+    : m_file(file)
+{
+}
+
+bool RecordCursor::next()
+{
+    if (!m_file || !m_file->isOpen())
+        return false;
+
+    while (true) {
+        if (!m_pageLoaded) {
+            ++m_pageNo;
+            if (m_pageNo >= m_file->pageCount())
+                return false;
+            m_page.resize(PagedFile::PageSize);
+            if (!m_file->m_file.readPage(m_pageNo, m_page.data()))
+                return false;
+            m_slot = 0;
+            m_pageLoaded = true;
+            if (quint8(m_page.at(PagedFile::PageTypeOffset)) != RecordFile::DataPageType) {
+                m_pageLoaded = false;
+                continue;
+            }
+        }
+
+        const char *p = m_page.constData();
+        const int slotCount = pageReadU16(p, RecordFile::SlotCountOffset);
+        while (m_slot < slotCount) {
+            const int slotPos = PagedFile::PageHeaderSize + m_slot * RecordFile::SlotSize;
+            const quint16 length = pageReadU16(p, slotPos + 2);
+            const int slot = m_slot++;
+            if (length == RecordFile::FreeSlot)
+                continue;
+            m_current = RecordId{ m_pageNo, quint16(slot) };
+            m_values = m_file->decodeCurrent(p + pageReadU16(p, slotPos), length);
+            return true;
+        }
+        m_pageLoaded = false;
+    }
+}
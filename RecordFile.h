@@ -0,0 +1,200 @@
+#ifndef RECORDFILE_H
+#define RECORDFILE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QVector>
+#include <optional>
+#include "PagedFile.h"
+#include "RecordId.h"
+#include "AvailList.h"
+
+// Archivo de registros de una tabla (.mad).
+//
+// Página 0: encabezado con el esquema de la tabla (nombre, campos y tipos).
+// Páginas 1..n: páginas de datos con ranuras (slotted pages). El directorio
+// de ranuras crece desde el inicio de la página y los registros desde el final.
+//
+// Cada registro guarda los valores de la fila como texto UTF-8, en el mismo
+// orden que los campos del esquema, junto con la versión del esquema con la
+// que se escribió.
+//
+// Los cambios de diseño (agregar, quitar, renombrar o cambiar el tipo de un
+// campo) no reescriben los registros: alterSchema() crea una nueva versión y
+// guarda en el encabezado los campos de las versiones anteriores. Cada campo
+// tiene un identificador estable, así que un registro viejo se lee con el
+// esquema actual siguiendo esos identificadores. SchemaMigrator reescribe los
+// registros viejos en segundo plano y luego se descarta el historial.
+//
+// Las ranuras de registros eliminados forman la Avail List: quedan enlazadas
+// entre sí (la cabeza está en el encabezado) y se reutilizan en las
+// inserciones según la política elegida (first-fit, best-fit o worst-fit).
+class RecordFile {
+public:
+    static constexpr quint16 FormatVersion = 3;
+    static constexpr int MaxSchemaHistory = 32;
+
+    RecordFile() = default;
+    ~RecordFile();
+
+    RecordFile(const RecordFile&) = delete;
+    RecordFile& operator=(const RecordFile&) = delete;
+
+    // Abre el archivo; si no existe lo crea con un encabezado vacío
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    QString path() const { return m_file.path(); }
+    QString errorString() const { return m_error; }
+
+    // Esquema guardado en la página de encabezado
+    QString tableName() const { return m_tableName; }
+    QStringList fieldNames() const { return m_fieldNames; }
+    QStringList fieldTypes() const { return m_fieldTypes; }
+    bool setSchema(const QString &tableName, const QStringList &fieldNames, const QStringList &fieldTypes);
+
+    // Versionado del esquema. fieldIds indica, para cada campo nuevo, el
+    // identificador del campo actual del que proviene (0 si es un campo nuevo).
+    // Retorna false si el historial ya no cabe en el encabezado; en ese caso
+    // hay que reescribir la tabla con setSchema().
+    quint16 schemaVersion() const { return m_schemaVersion; }
+    QVector<quint16> fieldIds() const { return m_fieldIds; }
+    bool alterSchema(const QString &tableName, const QStringList &fieldNames, const QStringList &fieldTypes,
+                     const QVector<quint16> &fieldIds);
+    bool hasOutdatedRecords() const { return !m_schemaHistory.isEmpty(); }
+    // Todos los registros ya usan la versión actual: se olvidan las anteriores
+    bool discardSchemaHistory();
+
+    // Lee solo el esquema de un .mad sin mantenerlo abierto
+    static bool readSchema(const QString &path, QString *tableName,
+                           QStringList *fieldNames, QStringList *fieldTypes);
+
+    quint32 recordCount() const { return m_recordCount; }
+    quint32 pageCount() const { return m_file.pageCount(); }
+    qint64 fileSize() const { return qint64(m_file.pageCount()) * PagedFile::PageSize; }
+
+    // Cambia con cada modificación; permite detectar escrituras concurrentes
+    // a un recorrido incremental (p. ej. la compactación)
+    quint64 modificationCount() const { return m_modificationCount; }
+
+    // Avail List: política de reutilización de espacio (se guarda en el archivo)
+    AvailList::Policy placementPolicy() const { return m_avail.policy(); }
+    bool setPlacementPolicy(AvailList::Policy policy);
+    int freeSlotCount() const { return m_avail.count(); }
+    quint64 freeBytes() const { return m_avail.freeBytes(); }
+
+    // Operaciones sobre registros. update() puede mover el registro si ya no
+    // cabe en su ranura; por eso retorna el identificador definitivo.
+    std::optional<RecordId> insert(const QStringList &values);
+    std::optional<RecordId> update(RecordId rid, const QStringList &values);
+    bool remove(RecordId rid);
+    std::optional<QStringList> read(RecordId rid);
+
+    // Registros vivos de una página de datos (vacío para otras páginas).
+    // outdated recibe los que se escribieron con una versión anterior del esquema.
+    bool readPageRecords(quint32 pageNo, QList<QPair<RecordId, QStringList>> *records,
+                         QList<RecordId> *outdated = nullptr);
+
+    // Elimina todos los registros (conserva el esquema)
+    bool clear();
+
+    // Reemplaza el contenido por el archivo `path` (ya cerrado) y lo reabre.
+    // El archivo actual se conserva como .bak hasta que el nuevo y el renombre
+    // están en disco; si algo falla se vuelve a él.
+    bool replaceWith(const QString &path);
+
+    // Escribe el encabezado pendiente y vacía los buffers del sistema
+    bool sync();
+    // Como sync(), pero fuerza el fsync del archivo aunque tenga log
+    bool flushToDisk();
+    // Vuelve a leer el encabezado y la lista de huecos de las páginas (tras
+    // deshacer una transacción del log, lo que está en memoria quedó adelantado)
+    bool reloadHeader();
+
+    // Registra las escrituras en el log del proyecto (ver WriteAheadLog)
+    void setWriteAheadLog(WriteAheadLog *log) { m_file.setWriteAheadLog(log); }
+
+    // Tamaño máximo de un registro codificado
+    static int maxRecordSize();
+
+    static QByteArray encodeRecord(const QStringList &values, quint16 schemaVersion = 0);
+    static QStringList decodeRecord(const char *data, int length, quint16 *schemaVersion = nullptr);
+
+private:
+    friend class RecordCursor;
+
+    // Páginas de datos
+    static constexpr quint8 HeaderPageType = 1;
+    static constexpr quint8 DataPageType = 2;
+    static constexpr int SlotCountOffset = 2;   // quint16
+    static constexpr int DataStartOffset = 4;   // quint16: inicio de la zona de registros
+    static constexpr int LiveCountOffset = 6;   // quint16: ranuras ocupadas
+    static constexpr int SlotSize = 6;          // offset, longitud, capacidad (quint16 c/u)
+    static constexpr quint16 FreeSlot = 0xFFFF; // longitud de una ranura borrada
+    static constexpr int LinkSize = 6;          // enlace de la Avail List: página + ranura
+    static constexpr int MinSlotCapacity = 8;   // toda ranura debe poder guardar el enlace
+
+    bool loadHeader();
+    bool loadSchemaVersions(const char *page, int offset);
+    bool writeHeader();
+    bool readDataPage(quint32 pageNo, QByteArray &page);
+    static void initDataPage(QByteArray &page);
+    static int pageFreeSpace(const char *page);
+    std::optional<RecordId> placeRecord(const QByteArray &record);
+    std::optional<RecordId> reuseSlot(const QByteArray &record);
+    bool loadAvailList(RecordId head, quint32 count);
+    bool writeFreeLink(RecordId rid, RecordId next);
+    QStringList decodeCurrent(const char *data, int length, bool *outdated = nullptr) const;
+    void resetFieldIds();
+
+    // Campos de una versión anterior del esquema
+    struct SchemaVersion {
+        quint16 version = 0;
+        QVector<quint16> fieldIds;
+    };
+
+    PagedFile m_file;
+    QString m_tableName;
+    QStringList m_fieldNames;
+    QStringList m_fieldTypes;
+    QVector<quint16> m_fieldIds;
+    quint16 m_schemaVersion = 0;
+    quint16 m_nextFieldId = 1;
+    QVector<SchemaVersion> m_schemaHistory;
+    bool m_versionUnused = false;         // ningún registro se escribió todavía con la versión actual
+    quint32 m_recordCount = 0;
+    quint32 m_lastDataPage = 0;
+    bool m_headerDirty = false;
+    quint64 m_modificationCount = 0;
+    AvailList m_avail;
+    QString m_error;
+};
+
+// Recorrido secuencial de todos los registros vivos de un RecordFile.
+//
+//   RecordCursor cursor(&file);
+//   while (cursor.next()) { cursor.recordId(); cursor.values(); }
+class RecordCursor {
+public:
+    explicit RecordCursor(RecordFile *file);
+
+    bool next();
+    RecordId recordId() const { return m_current; }
+    QStringList values() const { return m_values; }
+
+private:
+    RecordFile *m_file;
+    QByteArray m_page;
+    quint32 m_pageNo = 0;
+    int m_slot = 0;
+    bool m_pageLoaded = false;
+    RecordId m_current;
+    QStringList m_values;
+};
+
+#endif // RECORDFILE_H
@@ -0,0 +1,29 @@
+#ifndef RECORDID_H
+#define RECORDID_H
+
+#include <QtGlobal>
+#include <QHash>
+
+// Identificador físico de un registro: página + ranura dentro de la página.
+// La página 0 es siempre el encabezado, así que page == 0 significa "sin registro".
+struct RecordId {
+    quint32 page = 0;
+    quint16 slot = 0;
+
+    bool isValid() const { return page != 0; }
+    quint64 toUInt64() const { return (quint64(page) << 16) | slot; }
+    static RecordId fromUInt64(quint64 value) {
+        return RecordId{ quint32(value >> 16), quint16(value & 0xFFFF) };
+    }
+
+    bool operator==(const RecordId &other) const { return page == other.page && slot == other.slot; }
+    bool operator!=(const RecordId &other) const { return !(*this == other); }
+    bool operator<(const RecordId &other) const { return toUInt64() < other.toUInt64(); }
+};
+
+inline uint qHash(const RecordId &rid, uint seed = 0)
+{
+    return qHash(rid.toUInt64(), seed);
+}
+
+#endif // RECORDID_H
@@ -1,5 +1,6 @@
 #include "RelationshipsView.h"
 #include "ThemeManager.h"
+#include "SchemaCatalog.h"
 #include <QApplication>
 #include <QDir>
 #include <QJsonDocument>
@@ -511,6 +512,19 @@ void RelationshipsView::updateTheme(bool isDark)
     }
 }
 
+void RelationshipsView::setSchemaCatalog(SchemaCatalog *catalog)
+{
+    if (schemaCatalog)
+        disconnect(schemaCatalog, nullptr, this, nullptr);
+    schemaCatalog = catalog;
+    if (schemaCatalog) {
+        connect(schemaCatalog, &SchemaCatalog::tableChanged, this, &RelationshipsView::loadTables);
+        connect(schemaCatalog, &SchemaCatalog::tableRemoved, this, &RelationshipsView::loadTables);
+        connect(schemaCatalog, &SchemaCatalog::relationshipsChanged, this, &RelationshipsView::loadRelationships);
+    }
+    refreshTableList();
+}
+
 void RelationshipsView::loadTables()
 {
     availableTables.clear();
@@ -519,10 +533,10 @@ void RelationshipsView::loadTables()
     sourceTableCombo->clear();
     targetTableCombo->clear();
     
-    // Crear tablas predeterminadas para demostración
-    QStringList predefinedTables = {"estudiante", "maestro"};
+    // Las tablas del proyecto, con sus campos, vienen del catálogo de esquemas
+    const QStringList tableNames = schemaCatalog ? schemaCatalog->tableNames() : QStringList();
     
-    for (const QString &tableName : predefinedTables) {
+    for (const QString &tableName : tableNames) {
         availableTables.append(tableName);
         
         // Create draggable item for tables list
@@ -534,22 +548,34 @@ void RelationshipsView::loadTables()
         sourceTableCombo->addItem(tableName);
         targetTableCombo->addItem(tableName);
         
-        // Definir campos básicos para cada tabla
-        QStringList fields;
-        if (tableName == "estudiante") {
-            fields << "id" << "nombre" << "apellido" << "email" << "carrera" << "maestro_id";
-        } else if (tableName == "maestro") {
-            fields << "id" << "nombre" << "apellido" << "especialidad" << "telefono";
-        }
-        tableFields[tableName] = fields;
+        if (const std::optional<TableSchema> schema = schemaCatalog->table(tableName))
+            tableFields[tableName] = schema->fieldNames();
+    }
+
+    // Las tablas ya puestas en el diseñador muestran sus campos actuales
+    for (TableGraphicsItem *item : tableItems) {
+        if (tableFields.contains(item->getTableName()))
+            item->setFields(tableFields.value(item->getTableName()));
     }
 }
 
 void RelationshipsView::loadRelationships()
 {
     relationshipsListWidget->clear();
-    // Las relaciones se mostrarán solo cuando se vayan creando
-    // No hay relaciones predeterminadas, todo será dinámico
+    for (RelationshipLine *line : relationshipLines) {
+        designerScene->removeItem(line);
+        delete line;
+    }
+    relationshipLines.clear();
+    if (!schemaCatalog)
+        return;
+
+    // Relaciones guardadas en el catálogo, en el mismo orden que la lista
+    for (const RelationshipSchema &relationship : schemaCatalog->relationships()) {
+        relationshipsListWidget->addItem(QString("%1 → %2 (%3)")
+                                         .arg(relationship.sourceTable, relationship.targetTable, relationship.type));
+        createRelationshipBetweenTables(relationship.sourceTable, relationship.targetTable, relationship.type);
+    }
 }
 
 void RelationshipsView::addTableToDesigner(const QString &tableName, const QPointF &position)
@@ -587,6 +613,9 @@ void RelationshipsView::addTableToDesigner(const QString &tableName, const QPoin
     tableItem->updateTheme(isDarkTheme);
     designerScene->addItem(tableItem);
     tableItems.append(tableItem);
+
+    // Relaciones guardadas con esta tabla que ahora se pueden dibujar
+    loadRelationships();
 }
 
 void RelationshipsView::addTableToDesigner(const QString &tableName, const QPoint &position)
@@ -674,12 +703,21 @@ void RelationshipsView::onCreateRelationship()
         return;
     }
     
-    // Create visual representation
-    createRelationshipBetweenTables(sourceTable, targetTable, shortType);
-    
-    // Add to relationships list
-    QString relationshipDesc = QString("%1 → %2 (%3)").arg(sourceTable, targetTable, shortType);
-    relationshipsListWidget->addItem(relationshipDesc);
+    if (schemaCatalog) {
+        // Se guarda en el catálogo; la lista y el diseñador se actualizan con su aviso
+        RelationshipSchema relationship;
+        relationship.sourceTable = sourceTable;
+        relationship.targetTable = targetTable;
+        relationship.type = shortType;
+        schemaCatalog->addRelationship(relationship);
+    } else {
+        // Create visual representation
+        createRelationshipBetweenTables(sourceTable, targetTable, shortType);
+        
+        // Add to relationships list
+        QString relationshipDesc = QString("%1 → %2 (%3)").arg(sourceTable, targetTable, shortType);
+        relationshipsListWidget->addItem(relationshipDesc);
+    }
     
     QMessageBox::information(this, "Éxito", "Relación creada correctamente");
 }
@@ -688,7 +726,10 @@ void RelationshipsView::onDeleteRelationship()
 {
     int currentRow = relationshipsListWidget->currentRow();
     if (currentRow >= 0) {
-        relationshipsListWidget->takeItem(currentRow);
+        if (schemaCatalog)
+            schemaCatalog->removeRelationship(currentRow);
+        else
+            delete relationshipsListWidget->takeItem(currentRow);
         QMessageBox::information(this, "Relación Eliminada", "La relación ha sido eliminada.");
     } else {
         QMessageBox::warning(this, "Error", "Selecciona una relación para eliminar.");
@@ -37,6 +37,7 @@
 
 class TableGraphicsItem;
 class RelationshipLine;
+class SchemaCatalog;
 
 // Custom QGraphicsView for drag and drop
 class RelationshipDesignerView : public QGraphicsView
@@ -62,6 +63,8 @@ class RelationshipsView : public QWidget
 public:
     explicit RelationshipsView(QWidget *parent = nullptr);
     void updateTheme(bool isDark);
+    // Tablas, campos y relaciones salen del catálogo de esquemas del proyecto
+    void setSchemaCatalog(SchemaCatalog *catalog);
     void refreshTableList();
     void addTableToDesigner(const QString &tableName, const QPointF &position);
 
@@ -160,6 +163,7 @@ private:
     QMap<QString, QStringList> tableFields;
     QList<TableGraphicsItem*> tableItems;
     QList<RelationshipLine*> relationshipLines;
+    SchemaCatalog *schemaCatalog = nullptr;
     
     // Theme
     bool isDarkTheme;
@@ -0,0 +1,433 @@
+#include "SchemaCatalog.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+
+namespace {
+const char *const CatalogFileName = "schema.meta";
+constexpr int HeaderSize = 16;
+
+// Banderas de un campo y de una relación
+constexpr quint8 FieldRequired = 0x01;
+constexpr quint8 RelationshipEnforced = 0x01;
+constexpr quint8 RelationshipCascade = 0x02;
+
+void appendU8(QByteArray &out, quint8 value)
+{
+    out.append(char(value));
+}
+
+void appendU16(QByteArray &out, quint16 value)
+{
+    char bytes[2];
+    qToLittleEndian<quint16>(value, bytes);
+    out.append(bytes, 2);
+}
+
+void appendU32(QByteArray &out, quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian<quint32>(value, bytes);
+    out.append(bytes, 4);
+}
+
+void appendU64(QByteArray &out, quint64 value)
+{
+    char bytes[8];
+    qToLittleEndian<quint64>(value, bytes);
+    out.append(bytes, 8);
+}
+
+void appendText(QByteArray &out, const QString &text)
+{
+    // El largo va en 16 bits: lo que pase de 64 KB (una descripción enorme) se corta
+    const QByteArray utf8 = text.toUtf8().left(0xFFFF);
+    appendU16(out, quint16(utf8.size()));
+    out.append(utf8);
+}
+
+// Lector con control de límites sobre el archivo mapeado
+struct Reader {
+    const char *data;
+    qint64 size;
+    qint64 pos = 0;
+    bool ok = true;
+
+    bool need(qint64 bytes) { ok = ok && pos + bytes <= size; return ok; }
+    quint8 u8() { if (!need(1)) return 0; return quint8(data[pos++]); }
+    quint16 u16() { if (!need(2)) return 0; pos += 2; return qFromLittleEndian<quint16>(data + pos - 2); }
+    quint32 u32() { if (!need(4)) return 0; pos += 4; return qFromLittleEndian<quint32>(data + pos - 4); }
+    quint64 u64() { if (!need(8)) return 0; pos += 8; return qFromLittleEndian<quint64>(data + pos - 8); }
+    QString text()
+    {
+        const quint16 length = u16();
+        if (!need(length)) return QString();
+        pos += length;
+        return QString::fromUtf8(data + pos - length, length);
+    }
+};
+
+bool parseContents(Reader &in, SchemaCatalog::Contents *contents)
+{
+    const quint32 magic = in.u32();
+    const quint16 version = in.u16();
+    in.u16(); // reservado
+    const quint32 tableCount = in.u32();
+    const quint32 relationshipCount = in.u32();
+    if (!in.ok || magic != SchemaCatalog::FormatMagic || version != SchemaCatalog::FormatVersion)
+        return false;
+
+    for (quint32 t = 0; t < tableCount && in.ok; ++t) {
+        TableSchema table;
+        table.name = in.text();
+        table.fileName = in.text();
+        table.fileModified = qint64(in.u64());
+        table.fileSize = qint64(in.u64());
+        const quint16 fieldCount = in.u16();
+        table.fields.reserve(fieldCount);
+        for (quint16 f = 0; f < fieldCount && in.ok; ++f) {
+            FieldSchema field;
+            field.name = in.text();
+            field.type = in.text();
+            field.description = in.text();
+            field.size = int(in.u32());
+            field.format = in.text();
+            field.required = in.u8() & FieldRequired;
+            field.defaultValue = in.text();
+            field.indexKind = in.text();
+            table.fields.append(field);
+        }
+        contents->tables.insert(table.name, table);
+    }
+    for (quint32 r = 0; r < relationshipCount && in.ok; ++r) {
+        RelationshipSchema relationship;
+        relationship.sourceTable = in.text();
+        relationship.sourceField = in.text();
+        relationship.targetTable = in.text();
+        relationship.targetField = in.text();
+        relationship.type = in.text();
+        const quint8 flags = in.u8();
+        relationship.enforceIntegrity = flags & RelationshipEnforced;
+        relationship.cascadeDelete = flags & RelationshipCascade;
+        contents->relationships.append(relationship);
+    }
+    return in.ok;
+}
+} // namespace
+
+// --- Esquemas ---
+
+bool FieldSchema::operator==(const FieldSchema &other) const
+{
+    return name == other.name && type == other.type && description == other.description
+           && size == other.size && format == other.format && required == other.required
+           && defaultValue == other.defaultValue && indexKind == other.indexKind;
+}
+
+QStringList TableSchema::fieldNames() const
+{
+    QStringList names;
+    for (const FieldSchema &field : fields)
+        names << field.name;
+    return names;
+}
+
+QStringList TableSchema::fieldTypes() const
+{
+    QStringList types;
+    for (const FieldSchema &field : fields)
+        types << field.type;
+    return types;
+}
+
+QMap<QString, QString> TableSchema::fieldIndexes() const
+{
+    QMap<QString, QString> indexes;
+    for (const FieldSchema &field : fields) {
+        if (!field.indexKind.isEmpty())
+            indexes.insert(field.name, field.indexKind);
+    }
+    return indexes;
+}
+
+bool TableSchema::matchesFile(const QString &path) const
+{
+    const QFileInfo info(path);
+    return info.exists() && info.size() == fileSize
+           && info.lastModified().toMSecsSinceEpoch() == fileModified;
+}
+
+bool TableSchema::operator==(const TableSchema &other) const
+{
+    return name == other.name && fileName == other.fileName && fields == other.fields
+           && fileModified == other.fileModified && fileSize == other.fileSize;
+}
+
+bool RelationshipSchema::operator==(const RelationshipSchema &other) const
+{
+    return sourceTable == other.sourceTable && sourceField == other.sourceField
+           && targetTable == other.targetTable && targetField == other.targetField
+           && type == other.type && enforceIntegrity == other.enforceIntegrity
+           && cascadeDelete == other.cascadeDelete;
+}
+
+// --- Archivo ---
+
+QString SchemaCatalog::pathFor(const QString &projectRoot)
+{
+    return QDir(projectRoot).filePath(CatalogFileName);
+}
+
+std::optional<SchemaCatalog::Contents> SchemaCatalog::read(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return std::nullopt;
+
+    // Mapeado se lee directo de la caché de páginas; si no se puede, se copia
+    const qint64 size = file.size();
+    QByteArray copy;
+    const char *data = nullptr;
+    if (size > 0) {
+        if (uchar *mapped = file.map(0, size)) {
+            data = reinterpret_cast<const char *>(mapped);
+        } else {
+            copy = file.readAll();
+            data = copy.constData();
+        }
+    }
+
+    Contents contents;
+    Reader in{ data, data ? size : 0 };
+    if (size < HeaderSize || !parseContents(in, &contents)) {
+        qDebug() << "WARNING: Catálogo de esquemas ignorado (formato desconocido o dañado):" << path;
+        return std::nullopt;
+    }
+    return contents;
+}
+
+bool SchemaCatalog::write(const QString &path, const Contents &contents, QString *error)
+{
+    QByteArray out;
+    appendU32(out, FormatMagic);
+    appendU16(out, FormatVersion);
+    appendU16(out, 0);
+    appendU32(out, quint32(contents.tables.size()));
+    appendU32(out, quint32(contents.relationships.size()));
+
+    for (const TableSchema &table : contents.tables) {
+        appendText(out, table.name);
+        appendText(out, table.fileName);
+        appendU64(out, quint64(table.fileModified));
+        appendU64(out, quint64(table.fileSize));
+        appendU16(out, quint16(table.fields.size()));
+        for (const FieldSchema &field : table.fields) {
+            appendText(out, field.name);
+            appendText(out, field.type);
+            appendText(out, field.description);
+            appendU32(out, quint32(qMax(0, field.size)));
+            appendText(out, field.format);
+            appendU8(out, field.required ? FieldRequired : 0);
+            appendText(out, field.defaultValue);
+            appendText(out, field.indexKind);
+        }
+    }
+    for (const RelationshipSchema &relationship : contents.relationships) {
+        appendText(out, relationship.sourceTable);
+        appendText(out, relationship.sourceField);
+        appendText(out, relationship.targetTable);
+        appendText(out, relationship.targetField);
+        appendText(out, relationship.type);
+        appendU8(out, quint8((relationship.enforceIntegrity ? RelationshipEnforced : 0)
+                             | (relationship.cascadeDelete ? RelationshipCascade : 0)));
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size() || !file.commit()) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QVector<FieldSchema> SchemaCatalog::mergeFields(const QVector<FieldSchema> &previous,
+                                                const QStringList &names, const QStringList &types)
+{
+    QVector<FieldSchema> fields;
+    fields.reserve(names.size());
+    for (int i = 0; i < names.size(); ++i) {
+        FieldSchema field;
+        for (const FieldSchema &old : previous) {
+            if (old.name == names.at(i)) {
+                field = old;
+                break;
+            }
+        }
+        const QString type = types.value(i);
+        // Tamaño y formato son del tipo: con otro tipo ya no valen
+        if (!field.type.isEmpty() && field.type != type) {
+            field.size = 0;
+            field.format.clear();
+            field.indexKind.clear();
+        }
+        field.name = names.at(i);
+        field.type = type;
+        fields.append(field);
+    }
+    return fields;
+}
+
+// --- Catálogo compartido ---
+
+SchemaCatalog::SchemaCatalog(QObject *parent)
+    : QObject(parent)
+{
+    // Las ediciones seguidas del diseño se guardan juntas
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(SaveDelayMs);
+    connect(&m_saveTimer, &QTimer::timeout, this, &SchemaCatalog::save);
+}
+
+SchemaCatalog::~SchemaCatalog()
+{
+    save();
+}
+
+void SchemaCatalog::setPath(const QString &path)
+{
+    m_path = path;
+    if (m_dirty)
+        m_saveTimer.start();
+}
+
+void SchemaCatalog::reset(const Contents &contents)
+{
+    m_contents = contents;
+    for (auto it = m_contents.tables.cbegin(); it != m_contents.tables.cend(); ++it)
+        emit tableChanged(it.key());
+    emit relationshipsChanged();
+}
+
+bool SchemaCatalog::save()
+{
+    m_saveTimer.stop();
+    if (!m_dirty || m_path.isEmpty())
+        return true;
+
+    QString error;
+    if (!write(m_path, m_contents, &error)) {
+        qDebug() << "WARNING: No se pudo guardar el catálogo de esquemas:" << error;
+        return false;
+    }
+    m_dirty = false;
+    qDebug() << "DEBUG: Catálogo de esquemas guardado:" << m_contents.tables.size() << "tablas,"
+             << m_contents.relationships.size() << "relaciones";
+    return true;
+}
+
+std::optional<TableSchema> SchemaCatalog::table(const QString &tableName) const
+{
+    auto it = m_contents.tables.constFind(tableName);
+    if (it == m_contents.tables.constEnd())
+        return std::nullopt;
+    return it.value();
+}
+
+void SchemaCatalog::setTable(const TableSchema &table)
+{
+    auto it = m_contents.tables.constFind(table.name);
+    if (it != m_contents.tables.constEnd() && it.value() == table)
+        return;
+    m_contents.tables.insert(table.name, table);
+    markDirty();
+    emit tableChanged(table.name);
+}
+
+void SchemaCatalog::setTableFields(const QString &tableName, const QStringList &fieldNames,
+                                   const QStringList &fieldTypes)
+{
+    TableSchema table = m_contents.tables.value(tableName);
+    table.name = tableName;
+    table.fields = mergeFields(table.fields, fieldNames, fieldTypes);
+    setTable(table);
+}
+
+void SchemaCatalog::setFieldIndexes(const QString &tableName, const QMap<QString, QString> &indexes)
+{
+    auto it = m_contents.tables.constFind(tableName);
+    if (it == m_contents.tables.constEnd())
+        return;
+    TableSchema table = it.value();
+    for (FieldSchema &field : table.fields)
+        field.indexKind = indexes.value(field.name);
+    setTable(table);
+}
+
+void SchemaCatalog::updateFileStamp(const QString &tableName, const QString &filePath)
+{
+    auto it = m_contents.tables.find(tableName);
+    if (it == m_contents.tables.end())
+        return;
+    // No es un cambio de diseño: solo se guarda
+    const QFileInfo info(filePath);
+    const QString fileName = info.completeBaseName();
+    const qint64 modified = info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0;
+    const qint64 size = info.exists() ? info.size() : -1;
+    if (it->fileName == fileName && it->fileModified == modified && it->fileSize == size)
+        return;
+    it->fileName = fileName;
+    it->fileModified = modified;
+    it->fileSize = size;
+    markDirty();
+}
+
+void SchemaCatalog::removeTable(const QString &tableName)
+{
+    if (m_contents.tables.remove(tableName) == 0)
+        return;
+
+    // Las relaciones de la tabla se van con ella
+    bool relationshipsRemoved = false;
+    for (int i = m_contents.relationships.size() - 1; i >= 0; --i) {
+        const RelationshipSchema &relationship = m_contents.relationships.at(i);
+        if (relationship.sourceTable == tableName || relationship.targetTable == tableName) {
+            m_contents.relationships.remove(i);
+            relationshipsRemoved = true;
+        }
+    }
+    markDirty();
+    emit tableRemoved(tableName);
+    if (relationshipsRemoved)
+        emit relationshipsChanged();
+}
+
+void SchemaCatalog::addRelationship(const RelationshipSchema &relationship)
+{
+    if (m_contents.relationships.contains(relationship))
+        return;
+    m_contents.relationships.append(relationship);
+    markDirty();
+    emit relationshipsChanged();
+}
+
+bool SchemaCatalog::removeRelationship(int index)
+{
+    if (index < 0 || index >= m_contents.relationships.size())
+        return false;
+    m_contents.relationships.remove(index);
+    markDirty();
+    emit relationshipsChanged();
+    return true;
+}
+
+void SchemaCatalog::markDirty()
+{
+    m_dirty = true;
+    if (!m_path.isEmpty())
+        m_saveTimer.start();
+}
@@ -0,0 +1,126 @@
+#ifndef SCHEMACATALOG_H
+#define SCHEMACATALOG_H
+
+#include <QObject>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include <optional>
+
+// Un campo de una tabla con sus propiedades de diseño
+struct FieldSchema {
+    QString name;
+    QString type;
+    QString description;
+    int size = 0;              // largo máximo (texto); 0 = el del tipo
+    QString format;            // formato de moneda, fecha o número
+    bool required = false;
+    QString defaultValue;
+    QString indexKind;         // "bplus", "bstar" o vacío (sin índice secundario)
+
+    bool operator==(const FieldSchema &other) const;
+    bool operator!=(const FieldSchema &other) const { return !(*this == other); }
+};
+
+struct TableSchema {
+    QString name;
+    QString fileName;          // nombre del .mad sin extensión
+    QVector<FieldSchema> fields;
+    // Fecha y tamaño del .mad cuando se guardó el esquema: si siguen iguales,
+    // el esquema vale sin abrir el archivo
+    qint64 fileModified = 0;
+    qint64 fileSize = -1;
+
+    QStringList fieldNames() const;
+    QStringList fieldTypes() const;
+    QMap<QString, QString> fieldIndexes() const;
+    bool matchesFile(const QString &path) const;
+
+    bool operator==(const TableSchema &other) const;
+    bool operator!=(const TableSchema &other) const { return !(*this == other); }
+};
+
+struct RelationshipSchema {
+    QString sourceTable;
+    QString sourceField;
+    QString targetTable;
+    QString targetField;
+    QString type;              // "1:1", "1:N" o "N:M"
+    bool enforceIntegrity = false;
+    bool cascadeDelete = false;
+
+    bool operator==(const RelationshipSchema &other) const;
+};
+
+// Catálogo de esquemas de un proyecto (<proyecto>/schema.meta).
+//
+// Guarda el diseño de cada tabla (campos, tipos, tamaños, formatos,
+// requeridos, valores por defecto, índices) y las relaciones entre tablas,
+// para que el proyecto se arme sin abrir cada .mad ni cada índice. Es el
+// mismo objeto para TableEditor, TableData y RelationshipsView: los cambios
+// se avisan con señales y se guardan juntos un momento después.
+//
+// El archivo es binario, con versión en la cabecera, y se lee mapeado en
+// memoria cuando se puede (read() es seguro desde cualquier hilo). Se escribe
+// con QSaveFile: nunca queda a medio escribir.
+class SchemaCatalog : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr quint32 FormatMagic = 0x4353414D;   // "MASC"
+    static constexpr quint16 FormatVersion = 1;
+    static constexpr int SaveDelayMs = 300;
+
+    struct Contents {
+        QMap<QString, TableSchema> tables;    // por nombre de tabla
+        QVector<RelationshipSchema> relationships;
+    };
+
+    static QString pathFor(const QString &projectRoot);
+    static std::optional<Contents> read(const QString &path);
+    static bool write(const QString &path, const Contents &contents, QString *error = nullptr);
+    // Campos nuevos conservando las propiedades de los que ya estaban (por nombre)
+    static QVector<FieldSchema> mergeFields(const QVector<FieldSchema> &previous,
+                                            const QStringList &names, const QStringList &types);
+
+    explicit SchemaCatalog(QObject *parent = nullptr);
+    ~SchemaCatalog() override;
+
+    // Sin ruta el catálogo vive solo en memoria
+    void setPath(const QString &path);
+    QString path() const { return m_path; }
+    // Reemplaza todo (p. ej. con lo que leyó ProjectOpener) sin guardar
+    void reset(const Contents &contents);
+    bool save();
+
+    QStringList tableNames() const { return m_contents.tables.keys(); }
+    bool contains(const QString &tableName) const { return m_contents.tables.contains(tableName); }
+    std::optional<TableSchema> table(const QString &tableName) const;
+    void setTable(const TableSchema &table);
+    void setTableFields(const QString &tableName, const QStringList &fieldNames, const QStringList &fieldTypes);
+    void setFieldIndexes(const QString &tableName, const QMap<QString, QString> &indexes);
+    void updateFileStamp(const QString &tableName, const QString &filePath);
+    void removeTable(const QString &tableName);
+
+    const QVector<RelationshipSchema> &relationships() const { return m_contents.relationships; }
+    void addRelationship(const RelationshipSchema &relationship);
+    bool removeRelationship(int index);
+
+signals:
+    void tableChanged(const QString &tableName);
+    void tableRemoved(const QString &tableName);
+    void relationshipsChanged();
+
+private:
+    void markDirty();
+
+    QString m_path;
+    Contents m_contents;
+    bool m_dirty = false;
+    QTimer m_saveTimer;
+};
+
+#endif // SCHEMACATALOG_H
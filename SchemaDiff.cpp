@@ -0,0 +1,93 @@
+#include "SchemaDiff.h"
+
+#include <QHash>
+
+SchemaDiff SchemaDiff::compute(const QVector<SchemaField> &before, const QVector<SchemaField> &after)
+{
+    SchemaDiff diff;
+
+    QHash<quint16, int> oldColumns;
+    for (int col = 0; col < before.size(); col++) {
+        diff.m_oldNames << before.at(col).name;
+        diff.m_oldTypes << before.at(col).type;
+        oldColumns.insert(before.at(col).id, col);
+    }
+
+    QHash<quint16, int> newColumns;
+    for (int col = 0; col < after.size(); col++) {
+        const SchemaField &field = after.at(col);
+        diff.m_newNames << field.name;
+        diff.m_newTypes << field.type;
+        newColumns.insert(field.id, col);
+
+        const int source = oldColumns.value(field.id, -1);
+        diff.m_sourceColumns << source;
+
+        Op op;
+        op.fieldId = field.id;
+        op.oldColumn = source;
+        op.newColumn = col;
+        op.newName = field.name;
+        op.newType = field.type;
+        if (source < 0) {
+            op.kind = AddField;
+            diff.m_ops << op;
+            continue;
+        }
+        op.oldName = before.at(source).name;
+        op.oldType = before.at(source).type;
+        if (op.oldName != op.newName) {
+            op.kind = RenameField;
+            diff.m_ops << op;
+        }
+        if (op.oldType != op.newType) {
+            op.kind = RetypeField;
+            diff.m_ops << op;
+        }
+    }
+
+    for (int col = 0; col < before.size(); col++) {
+        const SchemaField &field = before.at(col);
+        if (newColumns.contains(field.id)) continue;
+        Op op;
+        op.kind = DropField;
+        op.fieldId = field.id;
+        op.oldColumn = col;
+        op.oldName = field.name;
+        op.oldType = field.type;
+        diff.m_ops << op;
+    }
+    return diff;
+}
+
+bool SchemaDiff::hasOp(OpKind kind) const
+{
+    for (const Op &op : m_ops) {
+        if (op.kind == kind) return true;
+    }
+    return false;
+}
+
+QVector<int> SchemaDiff::identity() const
+{
+    QVector<int> columns;
+    for (int col = 0; col < m_oldNames.size(); col++)
+        columns << col;
+    return columns;
+}
+
+QString SchemaDiff::toString() const
+{
+    QStringList parts;
+    for (const Op &op : m_ops) {
+        switch (op.kind) {
+        case AddField:    parts << QString("+%1 (%2)").arg(op.newName, op.newType); break;
+        case DropField:   parts << QString("-%1").arg(op.oldName); break;
+        case RenameField: parts << QString("%1 → %2").arg(op.oldName, op.newName); break;
+        case RetypeField: parts << QString("%1: %2 → %3").arg(op.newName, op.oldType, op.newType); break;
+        }
+    }
+    if (parts.isEmpty() && !isEmpty())
+        parts << "orden de campos";
+    return parts.join(", ");
+}
@@ -0,0 +1,70 @@
+#ifndef SCHEMADIFF_H
+#define SCHEMADIFF_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Un campo del diseño con su identificador estable dentro de la vista de diseño
+struct SchemaField {
+    quint16 id = 0;
+    QString name;
+    QString type;
+};
+
+// Cambio de diseño entre dos versiones de una tabla, campo por campo.
+//
+// Los campos se emparejan por identificador (no por nombre ni posición), así
+// que un renombrado no se confunde con un campo eliminado más uno nuevo.
+// Un mismo campo puede tener a la vez RenameField y RetypeField.
+class SchemaDiff
+{
+public:
+    enum OpKind {
+        AddField,
+        DropField,
+        RenameField,
+        RetypeField
+    };
+
+    struct Op {
+        OpKind kind;
+        quint16 fieldId = 0;
+        int oldColumn = -1;    // -1 en AddField
+        int newColumn = -1;    // -1 en DropField
+        QString oldName;
+        QString newName;
+        QString oldType;
+        QString newType;
+    };
+
+    SchemaDiff() = default;
+    static SchemaDiff compute(const QVector<SchemaField> &before, const QVector<SchemaField> &after);
+
+    // Sin cambios de campos (el orden tampoco cambió)
+    bool isEmpty() const { return m_ops.isEmpty() && m_sourceColumns == identity(); }
+    const QVector<Op> &ops() const { return m_ops; }
+    bool hasOp(OpKind kind) const;
+
+    QStringList oldFieldNames() const { return m_oldNames; }
+    QStringList oldFieldTypes() const { return m_oldTypes; }
+    QStringList fieldNames() const { return m_newNames; }
+    QStringList fieldTypes() const { return m_newTypes; }
+
+    // Para cada campo nuevo, la columna del diseño anterior de la que proviene (-1 si es nuevo)
+    const QVector<int> &sourceColumns() const { return m_sourceColumns; }
+
+    QString toString() const;
+
+private:
+    QVector<int> identity() const;
+
+    QVector<Op> m_ops;
+    QStringList m_oldNames;
+    QStringList m_oldTypes;
+    QStringList m_newNames;
+    QStringList m_newTypes;
+    QVector<int> m_sourceColumns;
+};
+
+#endif // SCHEMADIFF_H
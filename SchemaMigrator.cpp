@@ -0,0 +1,150 @@
+#include "SchemaMigrator.h"
+#include "WriteAheadLog.h"
+
+#include <QDebug>
+
+namespace {
+// Milisegundos entre ticks: deja correr los eventos de la interfaz
+constexpr int TickIntervalMs = 10;
+}
+
+SchemaMigrator::SchemaMigrator(RecordFile *file, QObject *parent)
+    : QObject(parent), m_file(file)
+{
+    m_timer.setInterval(TickIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &SchemaMigrator::step);
+}
+
+SchemaMigrator::~SchemaMigrator()
+{
+    cancel();
+}
+
+QVector<int> SchemaMigrator::matchFields(const QStringList &oldNames, const QStringList &newNames)
+{
+    QVector<int> sources;
+    for (int col = 0; col < newNames.size(); col++) {
+        int source = oldNames.indexOf(newNames.at(col));
+        // Nombre nuevo donde antes había un campo que ya no aparece: renombrado
+        if (source < 0 && col < oldNames.size() && !newNames.contains(oldNames.at(col))
+            && !sources.contains(col))
+            source = col;
+        sources << source;
+    }
+    return sources;
+}
+
+void SchemaMigrator::start()
+{
+    if (!m_file || !m_file->isOpen() || !m_file->hasOutdatedRecords())
+        return;
+
+    // Si ya estaba corriendo, los registros reescritos pueden haber quedado viejos otra vez
+    m_nextPage = 1;
+    if (isRunning())
+        return;
+
+    m_rewritten = 0;
+    m_clock.start();
+    qDebug() << "DEBUG: Migrando" << m_file->path() << "a la versión" << m_file->schemaVersion()
+             << "del esquema (" << m_file->pageCount() << "páginas)";
+    m_timer.start();
+}
+
+void SchemaMigrator::cancel()
+{
+    if (!isRunning())
+        return;
+    m_timer.stop();
+    qDebug() << "DEBUG: Migración de esquema detenida";
+}
+
+void SchemaMigrator::step()
+{
+    if (!m_file->isOpen()) {
+        m_timer.stop();
+        return;
+    }
+
+    QList<QPair<RecordId, QStringList>> records;
+    QList<RecordId> outdated;
+    QHash<quint64, RecordId> moved;
+    QString error;
+
+    // El encabezado pendiente se escribe antes: si el paso se deshace, lo que
+    // se relee de las páginas tiene que ser lo de antes del paso
+    if (m_log) {
+        m_file->sync();
+        m_log->begin();
+    }
+
+    const quint32 firstPage = m_nextPage;
+    const int rewrittenBefore = m_rewritten;
+    const quint32 pageCount = m_file->pageCount();
+    const quint32 lastPage = qMin(pageCount, m_nextPage + quint32(m_pagesPerTick));
+    for (; m_nextPage < lastPage && error.isEmpty(); ++m_nextPage) {
+        if (!m_file->readPageRecords(m_nextPage, &records, &outdated)) {
+            error = m_file->errorString();
+            break;
+        }
+        for (const auto &record : qAsConst(records)) {
+            if (!outdated.contains(record.first))
+                continue;
+            const std::optional<RecordId> rid = m_file->update(record.first, record.second);
+            if (!rid) {
+                error = m_file->errorString();
+                break;
+            }
+            if (*rid != record.first)
+                moved.insert(record.first.toUInt64(), *rid);
+            m_rewritten++;
+        }
+    }
+
+    // Una página a medio migrar no se confirma: el paso se deshace completo,
+    // sin avisar de los registros movidos, y el archivo relee su encabezado
+    if (!error.isEmpty() && m_log) {
+        if (!m_log->rollback())
+            qDebug() << "ERROR: No se pudo deshacer la migración:" << m_log->errorString();
+        else if (!m_file->reloadHeader())
+            qDebug() << "ERROR: No se pudo releer el encabezado:" << m_file->errorString();
+        m_nextPage = firstPage;
+        m_rewritten = rewrittenBefore;
+        fail(error);
+        return;
+    }
+
+    // Los índices y la vista se actualizan dentro de la misma transacción
+    if (!moved.isEmpty())
+        emit recordsMoved(moved);
+    m_file->sync();
+    if (m_log && !m_log->commit())
+        qDebug() << "ERROR: No se pudo confirmar la migración:" << m_log->errorString();
+
+    // Sin log no hay cómo deshacer: lo movido ya quedó en los índices
+    if (!error.isEmpty()) {
+        fail(error);
+        return;
+    }
+
+    emit progress(m_nextPage, pageCount);
+
+    if (m_nextPage >= pageCount) {
+        m_timer.stop();
+        if (!m_file->discardSchemaHistory()) {
+            fail(m_file->errorString());
+            return;
+        }
+        const qint64 elapsed = m_clock.elapsed();
+        qDebug() << "DEBUG: Migración de esquema terminada:" << m_rewritten << "registros reescritos en"
+                 << elapsed << "ms";
+        emit finished(m_rewritten, elapsed);
+    }
+}
+
+void SchemaMigrator::fail(const QString &error)
+{
+    m_timer.stop();
+    qDebug() << "ERROR: Falló la migración de esquema:" << error;
+    emit failed(error);
+}
@@ -0,0 +1,66 @@
+#ifndef SCHEMAMIGRATOR_H
+#define SCHEMAMIGRATOR_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+#include "RecordFile.h"
+
+class WriteAheadLog;
+
+// Migración en segundo plano después de un cambio de diseño.
+//
+// RecordFile::alterSchema() solo cambia el encabezado: los registros viejos
+// se siguen leyendo a través del historial de versiones. Este migrador los
+// reescribe con la versión actual, pocas páginas por tick del temporizador,
+// y al terminar una pasada completa descarta el historial.
+//
+// Un registro que ya no cabe en su ranura se mueve; los identificadores
+// nuevos se avisan con recordsMoved() antes de confirmar cada tick.
+class SchemaMigrator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SchemaMigrator(RecordFile *file, QObject *parent = nullptr);
+    ~SchemaMigrator() override;
+
+    void setPagesPerTick(int pages) { m_pagesPerTick = qMax(1, pages); }
+    void setWriteAheadLog(WriteAheadLog *log) { m_log = log; }
+    bool isRunning() const { return m_timer.isActive(); }
+
+    // Para cada campo de newNames, la columna de oldNames de la que proviene
+    // (-1 si es nuevo). Los campos se emparejan por nombre; un campo que
+    // cambió de nombre en la misma posición se toma como renombrado.
+    static QVector<int> matchFields(const QStringList &oldNames, const QStringList &newNames);
+
+public slots:
+    // Empieza (o reinicia, si el esquema volvió a cambiar) la pasada
+    void start();
+    void cancel();
+
+signals:
+    void recordsMoved(const QHash<quint64, RecordId> &moved);
+    void progress(quint32 pagesDone, quint32 pageCount);
+    void finished(int rewritten, qint64 elapsedMs);
+    void failed(const QString &error);
+
+private slots:
+    void step();
+
+private:
+    void fail(const QString &error);
+
+    RecordFile *m_file;
+    WriteAheadLog *m_log = nullptr;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    quint32 m_nextPage = 1;
+    int m_pagesPerTick = 8;
+    int m_rewritten = 0;
+};
+
+#endif // SCHEMAMIGRATOR_H
@@ -0,0 +1,150 @@
+#include "TableCompactor.h"
+
+#include <QDebug>
+#include <QFile>
+
+namespace {
+// Reinicios permitidos por escrituras concurrentes antes de abandonar la pasada
+constexpr int MaxRestarts = 3;
+// Milisegundos entre ticks: deja correr los eventos de la interfaz
+constexpr int TickIntervalMs = 10;
+}
+
+TableCompactor::TableCompactor(RecordFile *file, QObject *parent)
+    : QObject(parent), m_source(file)
+{
+    m_timer.setInterval(TickIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &TableCompactor::step);
+}
+
+TableCompactor::~TableCompactor()
+{
+    cancel();
+}
+
+bool TableCompactor::needsCompaction(const RecordFile &file)
+{
+    if (!file.isOpen() || file.pageCount() < 4)
+        return false;
+    return qint64(file.freeBytes()) * 4 >= file.fileSize();
+}
+
+QString TableCompactor::tempPath() const
+{
+    return m_source->path() + ".compact";
+}
+
+void TableCompactor::start()
+{
+    if (isRunning() || !m_source || !m_source->isOpen())
+        return;
+
+    m_restarts = 0;
+    m_clock.start();
+    m_bytesBefore = m_source->fileSize();
+    if (!beginPass())
+        return;
+
+    qDebug() << "DEBUG: Iniciando compactación de" << m_source->path()
+             << "(" << m_source->pageCount() << "páginas," << m_source->freeBytes() << "bytes libres)";
+    m_timer.start();
+}
+
+void TableCompactor::cancel()
+{
+    if (!isRunning())
+        return;
+    m_timer.stop();
+    m_target.close();
+    QFile::remove(tempPath());
+    qDebug() << "DEBUG: Compactación cancelada";
+}
+
+bool TableCompactor::beginPass()
+{
+    m_target.close();
+    QFile::remove(tempPath());
+
+    if (!m_target.open(tempPath())
+        || !m_target.setSchema(m_source->tableName(), m_source->fieldNames(), m_source->fieldTypes())
+        || !m_target.setPlacementPolicy(m_source->placementPolicy())) {
+        fail(m_target.errorString());
+        return false;
+    }
+
+    m_moved.clear();
+    m_nextPage = 1;
+    m_sourceVersion = m_source->modificationCount();
+    return true;
+}
+
+void TableCompactor::step()
+{
+    // La tabla cambió desde el último tick: lo copiado ya no es confiable
+    if (m_source->modificationCount() != m_sourceVersion) {
+        if (++m_restarts > MaxRestarts) {
+            fail(QStringLiteral("La tabla se modificó demasiadas veces durante la compactación"));
+            return;
+        }
+        qDebug() << "DEBUG: La tabla cambió durante la compactación, reiniciando pasada";
+        if (!beginPass())
+            return;
+    }
+
+    QList<QPair<RecordId, QStringList>> records;
+    const quint32 pageCount = m_source->pageCount();
+    const quint32 lastPage = qMin(pageCount, m_nextPage + quint32(m_pagesPerTick));
+
+    for (; m_nextPage < lastPage; ++m_nextPage) {
+        if (!m_source->readPageRecords(m_nextPage, &records)) {
+            fail(m_source->errorString());
+            return;
+        }
+        for (const auto &record : records) {
+            const std::optional<RecordId> rid = m_target.insert(record.second);
+            if (!rid) {
+                fail(m_target.errorString());
+                return;
+            }
+            if (*rid != record.first)
+                m_moved.insert(record.first.toUInt64(), *rid);
+        }
+    }
+
+    emit progress(m_nextPage, pageCount);
+
+    if (m_nextPage >= pageCount)
+        finishPass();
+}
+
+void TableCompactor::finishPass()
+{
+    m_timer.stop();
+
+    // El archivo compactado tiene que estar en disco antes del cambio de nombre
+    if (!m_target.flushToDisk()) {
+        fail(m_target.errorString());
+        return;
+    }
+    m_target.close();
+
+    if (!m_source->replaceWith(tempPath())) {
+        fail(m_source->errorString());
+        return;
+    }
+
+    const qint64 reclaimed = m_bytesBefore - m_source->fileSize();
+    const qint64 elapsed = m_clock.elapsed();
+    qDebug() << "DEBUG: Compactación terminada:" << reclaimed << "bytes recuperados en" << elapsed << "ms,"
+             << m_moved.size() << "registros movidos";
+    emit finished(reclaimed, elapsed);
+}
+
+void TableCompactor::fail(const QString &error)
+{
+    m_timer.stop();
+    m_target.close();
+    QFile::remove(tempPath());
+    qDebug() << "ERROR: Falló la compactación:" << error;
+    emit failed(error);
+}
@@ -0,0 +1,65 @@
+#ifndef TABLECOMPACTOR_H
+#define TABLECOMPACTOR_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include "RecordFile.h"
+
+// Compactación en línea de un archivo .mad.
+//
+// Copia los registros vivos, en orden, a un archivo temporal (<tabla>.mad.compact)
+// procesando pocas páginas por cada tick del temporizador, de modo que el hilo
+// de la interfaz nunca se bloquea. Al terminar reemplaza el archivo original
+// y la Avail List queda reconstruida (vacía, el archivo ya no tiene huecos).
+//
+// Si la tabla se modifica mientras se copia, la pasada se reinicia.
+class TableCompactor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TableCompactor(RecordFile *file, QObject *parent = nullptr);
+    ~TableCompactor();
+
+    void setPagesPerTick(int pages) { m_pagesPerTick = qMax(1, pages); }
+    bool isRunning() const { return m_timer.isActive(); }
+
+    // Vale la pena compactar cuando al menos una cuarta parte del archivo está libre
+    static bool needsCompaction(const RecordFile &file);
+
+    // Identificadores que cambiaron en la última compactación (anterior → nuevo)
+    QHash<quint64, RecordId> movedRecords() const { return m_moved; }
+
+public slots:
+    void start();
+    void cancel();
+
+signals:
+    void progress(quint32 pagesDone, quint32 pageCount);
+    void finished(qint64 reclaimedBytes, qint64 elapsedMs);
+    void failed(const QString &error);
+
+private slots:
+    void step();
+
+private:
+    bool beginPass();
+    void finishPass();
+    void fail(const QString &error);
+    QString tempPath() const;
+
+    RecordFile *m_source;
+    RecordFile m_target;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    QHash<quint64, RecordId> m_moved;
+    quint32 m_nextPage = 1;
+    quint64 m_sourceVersion = 0;
+    qint64 m_bytesBefore = 0;
+    int m_pagesPerTick = 16;
+    int m_restarts = 0;
+};
+
+#endif // TABLECOMPACTOR_H
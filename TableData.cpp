@@ -8,6 +8,18 @@
 #include <QCalendarWidget>
 #include <QTimer>
 #include <QToolTip>
+#include <QDir>
+#include <QFileInfo>
+#include <QFile>
+#include <QApplication>
+#include <QClipboard>
+#include <QShortcut>
+#include <QFileDialog>
+#include <QEvent>
+#include "IndexKey.h"
+#include "TypeValidator.h"
+#include "Currency.h"
+#include "CompactDate.h"
 
 // Implementación del DataFieldDelegate
 QWidget *DataFieldDelegate::createEditor(QWidget *parent,
@@ -167,21 +179,8 @@ void DataFieldDelegate::setEditorData(QWidget *editor, const QModelIndex &index)
 {
     if (auto *dateEdit = qobject_cast<QDateEdit*>(editor)) {
         // Acepta dd-mm-aaaa o dd/mm/aaaa (y año de 2 dígitos)
-        QString txt = index.model()->data(index, Qt::EditRole).toString().trimmed();
-        QDate d;
-        if (!txt.isEmpty()) {
-            const QChar sep = txt.contains('/') ? QChar('/') : (txt.contains('-') ? QChar('-') : QChar());
-            if (sep.isNull()) {
-                d = QDate::currentDate();
-            } else {
-                const QString fmt = (txt.count(sep)==2 && txt.split(sep).last().size()==4)
-                ? QString("dd%1MM%1yyyy").arg(sep)
-                : QString("dd%1MM%1yy").arg(sep);
-                d = QDate::fromString(txt, fmt);
-            }
-        }
-        if (!d.isValid()) d = QDate::currentDate();
-        dateEdit->setDate(d);
+        const std::optional<CompactDate> date = CompactDate::parse(index.model()->data(index, Qt::EditRole).toString());
+        dateEdit->setDate(date ? date->toQDate() : QDate::currentDate());
         return;
     }
 
@@ -207,8 +206,8 @@ void DataFieldDelegate::setModelData(QWidget *editor, QAbstractItemModel *model,
                                      const QModelIndex &index) const
 {
     if (auto *dateEdit = qobject_cast<QDateEdit*>(editor)) {
-        const QDate d = dateEdit->date();
-        model->setData(index, d.toString("dd-MM-yyyy"), Qt::EditRole);
+        const std::optional<CompactDate> date = CompactDate::fromQDate(dateEdit->date());
+        model->setData(index, date ? date->toString() : QString(), Qt::EditRole);
         if (auto *owner = qobject_cast<TableData*>(this->parent()))
             owner->clearCellError(index.row(), index.column());
         return;
@@ -246,20 +245,15 @@ void DataFieldDelegate::setModelData(QWidget *editor, QAbstractItemModel *model,
                 if (owner) owner->clearCellError(index.row(), index.column());
                 return;
             }
-            bool ok=false; newText.toDouble(&ok);
-            if (!ok) return softReject("Moneda inválida. Ingresa un número.");
-            // >>> formateo visual aquí <<<
-            if (owner) newText = owner->formatCurrency(newText);
+            // Lo mismo que acepta el importador: "1,234.56", "Lps 1,234.56", "12,5"...
+            const std::optional<Currency> amount = Currency::parse(newText);
+            if (!amount) return softReject("Moneda inválida. Ingresa un monto (ej. 1,234.56).");
+            newText = amount->toString();
         } else if (type == "fecha") {
             if (!owner->isValueValidForType(type, newText)) {
                 return softReject("Fecha inválida. Usa dd-MM-aaaa o dd/MM/aaaa.");
-            } else {
-                const QChar sep = newText.contains('/') ? QChar('/') : (newText.contains('-') ? QChar('-') : QChar());
-                const QString fmt = (newText.count(sep)==2 && newText.split(sep).last().size()==4)
-                                        ? QString("dd%1MM%1yyyy").arg(sep)
-                                        : QString("dd%1MM%1yy").arg(sep);
-                const QDate d = QDate::fromString(newText, fmt);
-                newText = d.toString("dd-MM-yyyy");
+            } else if (const std::optional<CompactDate> date = CompactDate::parse(newText)) {
+                newText = date->toString();
             }
         }
         // Texto: sin extra
@@ -279,13 +273,34 @@ TableData::TableData(QWidget *parent) : QWidget(parent)
     // Crear delegate para estilo consistente
     dataFieldDelegate = new DataFieldDelegate(this);
     
+    // Compactación incremental del archivo de la tabla
+    storageCompactor = new TableCompactor(&recordFile, this);
+    connect(storageCompactor, &TableCompactor::finished, this, &TableData::onStorageCompacted);
+    
+    // Reescritura en segundo plano de los registros tras un cambio de diseño
+    schemaMigrator = new SchemaMigrator(&recordFile, this);
+    connect(schemaMigrator, &SchemaMigrator::recordsMoved, this, &TableData::onRecordsMigrated);
+    connect(schemaMigrator, &SchemaMigrator::finished, this, &TableData::onSchemaMigrated);
+    
+    // Importación de CSV/TSV: se parsea en otros hilos y se guarda por lotes
+    tableImporter = new TableImporter(this);
+    connect(tableImporter, &TableImporter::rowsReady, this, &TableData::onImportedRows);
+    connect(tableImporter, &TableImporter::progress, this, &TableData::onImportProgress);
+    connect(tableImporter, &TableImporter::finished, this, &TableData::onImportFinished);
+    
+    // Exportación a CSV/JSON Lines directo desde las páginas del archivo
+    tableExporter = new TableExporter(&recordFile, this);
+    connect(tableExporter, &TableExporter::progress, this, &TableData::onExportProgress);
+    connect(tableExporter, &TableExporter::finished, this, &TableData::onExportFinished);
+    connect(tableExporter, &TableExporter::failed, this, &TableData::onExportFailed);
+    
     createUI();
     setupTableForPersonData();
 }
 
 TableData::~TableData()
 {
-    // Destructor
+    closeStorage();
 }
 
 void TableData::createUI()
@@ -303,8 +318,13 @@ void TableData::createUI()
     contentLayout->setContentsMargins(10, 10, 10, 10);
     contentLayout->setSpacing(10);
     
-    // Crear tabla de datos
-    dataTable = new QTableWidget();
+    // Crear tabla de datos: las filas se traen del archivo a medida que se muestran
+    dataModel = new TableDataModel(this);
+    dataTable = new QTableView();
+    dataTable->setModel(dataModel);
+    dataTable->setItemDelegate(dataFieldDelegate);
+    dataFieldDelegate->setRenderModel(dataModel);
+    dataFieldDelegate->setRenderView(dataTable);
     dataTable->setStyleSheet(getTableStyle());
     
     // Configurar comportamiento de la tabla (igual que TableView)
@@ -315,6 +335,7 @@ void TableData::createUI()
     // Configurar altura de filas (igual que TableView)
     dataTable->verticalHeader()->setDefaultSectionSize(50); // Filas más altas para mejor visibilidad del texto
     dataTable->verticalHeader()->setMinimumSectionSize(50);
+    dataTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed); // Sin medir cada fila
     dataTable->verticalHeader()->show(); // Mostrar números de fila para mejor organización
     
     // Mejorar el comportamiento de edición
@@ -323,12 +344,104 @@ void TableData::createUI()
                               QAbstractItemView::AnyKeyPressed);
     
     // Conectar señales
-    connect(dataTable, &QTableWidget::itemChanged, this, &TableData::onPersonDataChanged);
+    connect(dataModel, &TableDataModel::cellEdited, this, &TableData::onPersonDataChanged);
+    
+    // Pegar un bloque de celdas (Ctrl+V) con validación por columnas
+    auto *pasteShortcut = new QShortcut(QKeySequence::Paste, dataTable);
+    pasteShortcut->setContext(Qt::WidgetShortcut);
+    connect(pasteShortcut, &QShortcut::activated, this, &TableData::pasteFromClipboard);
+    
+    // Filtro y orden sobre los registros (motor de consultas)
+    createFilterBar(contentLayout);
     
     contentLayout->addWidget(dataTable);
+    
+    // Resultado del filtro: misma apariencia que la tabla, sin edición
+    queryResultModel = new QueryResultModel(this);
+    queryResultTable = new QTableView();
+    queryResultTable->setModel(queryResultModel);
+    queryResultTable->setStyleSheet(getTableStyle());
+    queryResultTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    queryResultTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    queryResultTable->setAlternatingRowColors(true);
+    queryResultTable->verticalHeader()->setDefaultSectionSize(50);
+    queryResultTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    queryResultTable->hide();
+    contentLayout->addWidget(queryResultTable);
+    
     mainLayout->addWidget(contentWidget);
 }
 
+void TableData::createFilterBar(QVBoxLayout *layout)
+{
+    QWidget *filterBar = new QWidget();
+    QHBoxLayout *filterLayout = new QHBoxLayout(filterBar);
+    filterLayout->setContentsMargins(0, 0, 0, 0);
+    filterLayout->setSpacing(6);
+    
+    filterFieldCombo = new QComboBox();
+    filterFieldCombo->setMinimumWidth(140);
+    
+    // El dato de cada opción es el QueryCondition::Operator; -1 = sin condición
+    filterOperatorCombo = new QComboBox();
+    filterOperatorCombo->addItem("Todos", -1);
+    filterOperatorCombo->addItem("=", QueryCondition::Equal);
+    filterOperatorCombo->addItem("≠", QueryCondition::NotEqual);
+    filterOperatorCombo->addItem("<", QueryCondition::Less);
+    filterOperatorCombo->addItem("≤", QueryCondition::LessOrEqual);
+    filterOperatorCombo->addItem(">", QueryCondition::Greater);
+    filterOperatorCombo->addItem("≥", QueryCondition::GreaterOrEqual);
+    filterOperatorCombo->addItem("Entre", QueryCondition::Between);
+    filterOperatorCombo->addItem("Contiene", QueryCondition::Contains);
+    filterOperatorCombo->addItem("Vacío", QueryCondition::IsEmpty);
+    filterOperatorCombo->addItem("No vacío", QueryCondition::IsNotEmpty);
+    connect(filterOperatorCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &TableData::onFilterOperatorChanged);
+    
+    filterValueEdit = new QLineEdit();
+    filterValueEdit->setPlaceholderText("Valor");
+    filterValue2Edit = new QLineEdit();
+    filterValue2Edit->setPlaceholderText("Hasta");
+    connect(filterValueEdit, &QLineEdit::returnPressed, this, &TableData::onApplyFilterClicked);
+    connect(filterValue2Edit, &QLineEdit::returnPressed, this, &TableData::onApplyFilterClicked);
+    
+    sortFieldCombo = new QComboBox();
+    sortFieldCombo->setMinimumWidth(140);
+    sortOrderCombo = new QComboBox();
+    sortOrderCombo->addItem("Ascendente", true);
+    sortOrderCombo->addItem("Descendente", false);
+    
+    QPushButton *applyFilterBtn = new QPushButton("Filtrar");
+    connect(applyFilterBtn, &QPushButton::clicked, this, &TableData::onApplyFilterClicked);
+    clearFilterBtn = new QPushButton("Quitar filtro");
+    clearFilterBtn->setEnabled(false);
+    connect(clearFilterBtn, &QPushButton::clicked, this, &TableData::onClearFilterClicked);
+    
+    queryPlanLabel = new QLabel();
+    queryPlanLabel->setStyleSheet("QLabel { color: #64748b; }");
+    
+    filterLayout->addWidget(new QLabel("Filtrar:"));
+    filterLayout->addWidget(filterFieldCombo);
+    filterLayout->addWidget(filterOperatorCombo);
+    filterLayout->addWidget(filterValueEdit);
+    filterLayout->addWidget(filterValue2Edit);
+    filterLayout->addSpacing(12);
+    filterLayout->addWidget(new QLabel("Ordenar por:"));
+    filterLayout->addWidget(sortFieldCombo);
+    filterLayout->addWidget(sortOrderCombo);
+    filterLayout->addSpacing(12);
+    filterLayout->addWidget(applyFilterBtn);
+    filterLayout->addWidget(clearFilterBtn);
+    filterLayout->addStretch();
+    
+    layout->addWidget(filterBar);
+    layout->addWidget(queryPlanLabel);
+    queryPlanLabel->hide();
+    
+    refreshFilterFields();
+    onFilterOperatorChanged();
+}
+
 void TableData::createHeader()
 {
     headerWidget = new QWidget();
@@ -351,6 +464,42 @@ void TableData::createHeader()
     headerLayout->addWidget(tableNameLabel);
     headerLayout->addStretch();
     
+    // Progreso de la importación (oculto mientras no haya una en curso)
+    transferProgress = new QProgressBar();
+    transferProgress->setRange(0, 1000);
+    transferProgress->setTextVisible(false);
+    transferProgress->setFixedSize(160, 10);
+    transferProgress->hide();
+    headerLayout->addWidget(transferProgress);
+    
+    // Botón Importar (CSV/TSV); durante la importación la cancela
+    importBtn = new QPushButton("Importar");
+    importBtn->setFixedSize(170, 35);
+    importBtn->setStyleSheet(
+        "QPushButton {"
+        "background: white;"
+        "color: #374151;"
+        "border: 1px solid #cbd5e1;"
+        "border-radius: 6px;"
+        "font-weight: bold;"
+        "font-size: 13px;"
+        "}"
+        "QPushButton:hover {"
+        "background: #f1f5f9;"
+        "}"
+    );
+    connect(importBtn, &QPushButton::clicked, this, &TableData::onImportClicked);
+    headerLayout->addWidget(importBtn);
+    headerLayout->addSpacing(6);
+    
+    // Botón Exportar (CSV/JSON Lines); durante la exportación la cancela
+    exportBtn = new QPushButton("Exportar");
+    exportBtn->setFixedSize(170, 35);
+    exportBtn->setStyleSheet(importBtn->styleSheet());
+    connect(exportBtn, &QPushButton::clicked, this, &TableData::onExportClicked);
+    headerLayout->addWidget(exportBtn);
+    headerLayout->addSpacing(12);
+    
     // Contenedor para los botones
     QWidget *buttonContainer = new QWidget();
     QHBoxLayout *buttonLayout = new QHBoxLayout(buttonContainer);
@@ -416,6 +565,32 @@ void TableData::setupTableForPersonData()
 
 void TableData::setupDataView(const QStringList &fieldNames, const QStringList &fieldTypes)
 {
+    // Sin identificadores de campo: por nombre, o renombrado en la misma posición
+    setupDataView(fieldNames, fieldTypes, SchemaMigrator::matchFields(savedFieldNames, fieldNames));
+}
+
+void TableData::applyDesignChange(const SchemaDiff &diff)
+{
+    qDebug() << "DEBUG: Cambio de diseño en" << currentTableName << ":" << diff.toString();
+    
+    // La diferencia se calculó sobre otro diseño (p. ej. la tabla se cargó después)
+    if (diff.oldFieldNames() != savedFieldNames) {
+        setupDataView(diff.fieldNames(), diff.fieldTypes());
+        return;
+    }
+    setupDataView(diff.fieldNames(), diff.fieldTypes(), diff.sourceColumns());
+}
+
+void TableData::setupDataView(const QStringList &fieldNames, const QStringList &fieldTypes,
+                              const QVector<int> &sourceColumns)
+{
+    // Las filas que faltan importar vienen con el diseño anterior
+    if (isImporting() && (fieldNames != savedFieldNames || fieldTypes != savedFieldTypes)) {
+        qDebug() << "WARNING: El diseño cambió durante la importación, se cancela";
+        tableImporter->cancel();
+        endImport(false);
+    }
+    
     qDebug() << "DEBUG: Configurando vista de datos con campos:" << fieldNames;
     qDebug() << "DEBUG: Tipos de campos recibidos:" << fieldTypes;
     
@@ -436,136 +611,108 @@ void TableData::setupDataView(const QStringList &fieldNames, const QStringList &
         savedFieldTypes = fieldTypes;
     }
     
-    // Guardar datos existentes antes de reconfigurar
-    QList<QStringList> existingData;
     QStringList oldFieldNames = savedFieldNames;
-    int oldRowCount = dataTable->rowCount();
-    int oldColumnCount = dataTable->columnCount();
-    
-    // Solo guardar datos si ya había columnas configuradas
-    if (oldColumnCount > 0 && oldRowCount > 0) {
-        for (int row = 0; row < oldRowCount; row++) {
-            // Verificar si esta fila es de ejemplo y saltarla
-            QTableWidgetItem *firstItem = dataTable->item(row, 0);
-            if (firstItem && firstItem->toolTip().contains("Ejemplo")) {
-                qDebug() << "DEBUG: Skipping example row" << row << "when saving existing data";
-                continue;
-            }
-            
+    savedFieldNames = fieldNames;
+
+    // Columna del archivo de la que proviene cada campo
+    const QVector<int> fileColumns = recordFile.fieldNames() == oldFieldNames
+        ? sourceColumns : SchemaMigrator::matchFields(recordFile.fieldNames(), savedFieldNames);
+
+    // Si el diseño cambió, el archivo pasa a una nueva versión del esquema: los
+    // registros se leen con el historial y se reescriben en segundo plano
+    bool rewritten = false;
+    if (hasStorage() && !recordFile.fieldNames().isEmpty()
+        && (recordFile.fieldNames() != savedFieldNames || recordFile.fieldTypes() != savedFieldTypes)
+        && !alterStorageSchema(fileColumns)) {
+        qDebug() << "DEBUG: El diseño cambió, reescribiendo registros en disco";
+        // Registros del archivo y filas que todavía no se guardaron
+        ColumnTable existingData = storedRows();
+        for (int row = 0; row < dataModel->rowCount(); row++) {
+            if (isExampleRow(row) || recordIdForRow(row).isValid()) continue;
+            const QStringList oldValues = rowValues(row);
             QStringList rowData;
             bool hasData = false;
-            
-            for (int col = 0; col < oldColumnCount; col++) {
-                QTableWidgetItem *item = dataTable->item(row, col);
-                QString cellText = item ? item->text().trimmed() : "";
-                rowData << cellText;
-                
-                if (!cellText.isEmpty()) {
+            for (int source : sourceColumns) {
+                rowData << oldValues.value(source);
+                hasData = hasData || !rowData.last().isEmpty();
+            }
+            if (hasData) existingData.appendRow(rowData);
+        }
+        qDebug() << "DEBUG: Datos existentes guardados:" << existingData.rowCount() << "filas";
+
+        dataModel->setFields(savedFieldNames, savedFieldTypes);
+        rewriteAllRecords(existingData);
+        rewritten = true;
+    }
+
+    if (!rewritten) {
+        // Las filas guardadas se vuelven a leer con el nuevo esquema; las filas
+        // en memoria se reacomodan
+        dataModel->setFields(savedFieldNames, savedFieldTypes, sourceColumns);
+
+        bool hasData = false;
+        for (int row = 0; row < dataModel->rowCount() && !hasData; row++) {
+            if (isExampleRow(row)) continue;
+            if (recordIdForRow(row).isValid()) {
+                hasData = true;
+                break;
+            }
+            for (const QString &value : rowValues(row)) {
+                if (!value.isEmpty()) {
                     hasData = true;
+                    break;
                 }
             }
-            
-            // Solo guardar filas que tengan datos
-            if (hasData) {
-                existingData << rowData;
+        }
+
+        // Agregar fila de ejemplo en gris al principio solo si no hay datos existentes
+        if (!hasData) {
+            updateExampleData();
+        }
+
+        // Solo agregar una fila vacía para empezar a escribir si no hay datos existentes Y no hay fila de ejemplo
+        if (!hasData && dataModel->rowCount() <= 1) {
+            addPersonRow();
+        }
+
+        // Reformatea celdas en memoria de columnas moneda (las guardadas ya tienen formato)
+        for (int col = 0; col < savedFieldTypes.size(); ++col) {
+            if (savedFieldTypes.at(col) != "moneda") continue;
+            dataModel->blockSignals(true);
+            for (int row = 0; row < dataModel->rowCount(); ++row) {
+                // saltar fila de ejemplo y filas guardadas
+                if (isExampleRow(row) || recordIdForRow(row).isValid()) continue;
+
+                const QString t = rowValues(row).value(col);
+                if (!t.isEmpty()) dataModel->setData(dataModel->index(row, col), formatCurrency(t));
             }
+            dataModel->blockSignals(false);
+            dataTable->viewport()->update();
         }
     }
-    
-    qDebug() << "DEBUG: Datos existentes guardados:" << existingData.size() << "filas";
-    
-    savedFieldNames = fieldNames;
-    
-    // Configurar tabla con nuevos campos
-    dataTable->setColumnCount(fieldNames.size());
-    dataTable->setHorizontalHeaderLabels(fieldNames);
-    
-    // Configurar el número inicial de filas - solo si hay datos existentes
-    int initialRows = existingData.isEmpty() ? 0 : existingData.size(); // Sin filas si no hay datos existentes
-    dataTable->setRowCount(initialRows);
-    
-    // Aplicar delegate a todas las columnas para estilo consistente
-    for (int col = 0; col < dataTable->columnCount(); col++) {
-        dataTable->setItemDelegateForColumn(col, dataFieldDelegate);
-    }
-    
+
     // Configurar anchos de columnas
     configureColumnWidths();
-    
+
     // Configurar altura de filas después de configurar todo (igual que TableView)
     dataTable->verticalHeader()->setDefaultSectionSize(50); // Filas más altas para mejor visibilidad
     dataTable->verticalHeader()->setMinimumSectionSize(50);
-    
+
     // Configurar ancho del header vertical (números de fila)
     dataTable->verticalHeader()->setFixedWidth(50);
-    
-    // Restaurar datos existentes y crear celdas solo para las filas que tienen datos
-    for (int row = 0; row < initialRows; row++) {
-        for (int col = 0; col < dataTable->columnCount(); col++) {
-            QTableWidgetItem *item = new QTableWidgetItem("");
-            
-            // Configurar fuente más grande para mejor legibilidad
-            QFont itemFont = item->font();
-            itemFont.setPointSize(16); // Fuente más grande para consistencia con el editor
-            item->setFont(itemFont);
-            
-            // Todas las celdas son editables desde el inicio
-            item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable);
-            item->setBackground(QBrush(QColor(255, 255, 255))); // Fondo blanco para todas las celdas
-            
-            // Restaurar datos si existen
-            if (row < existingData.size() && !oldFieldNames.isEmpty()) {
-                QString newFieldName = fieldNames.at(col);
-                
-                // Buscar si este campo existía antes
-                int oldColIndex = oldFieldNames.indexOf(newFieldName);
-                if (oldColIndex >= 0 && oldColIndex < existingData.at(row).size()) {
-                    // Restaurar el dato existente
-                    item->setText(existingData.at(row).at(oldColIndex));
-                    qDebug() << "DEBUG: Restaurando dato en fila" << row << "columna" << col << ":" << item->text();
-                }
-                // Si es un campo nuevo, el item queda vacío
-            }
-            
-            dataTable->setItem(row, col, item);
-        }
-    }
-    
-    // Agregar fila de ejemplo en gris al principio solo si no hay datos existentes
-    if (existingData.isEmpty()) {
-        updateExampleData();
-    }
-    
-    // Solo agregar una fila vacía para empezar a escribir si no hay datos existentes Y no hay fila de ejemplo
-    if (existingData.isEmpty() && dataTable->rowCount() <= 1) {
-        addPersonRow();
-    }
-    
-    // Reformatea celdas existentes de columnas moneda
-    for (int col = 0; col < savedFieldTypes.size(); ++col) {
-        if (savedFieldTypes.at(col) == "moneda") {
-            dataTable->blockSignals(true);
-            for (int row = 0; row < dataTable->rowCount(); ++row) {
-                QTableWidgetItem *it = dataTable->item(row, col);
-                if (!it) continue;
-                // saltar fila de ejemplo
-                QTableWidgetItem *first = dataTable->item(row, 0);
-                if (first && first->toolTip().contains("Ejemplo")) continue;
 
-                const QString t = it->text().trimmed();
-                if (!t.isEmpty()) it->setText(formatCurrency(t));
-            }
-            dataTable->blockSignals(false);
-        }
-    }
+    // El filtro aplicado era sobre el diseño anterior
+    clearFilter();
+    refreshFilterFields();
 
-    qDebug() << "DEBUG: Vista de datos configurada exitosamente con" << dataTable->rowCount() << "filas y" << dataTable->columnCount() << "columnas";
+    qDebug() << "DEBUG: Vista de datos configurada exitosamente con" << dataModel->rowCount() << "filas y" << dataModel->columnCount() << "columnas";
+    syncSchemaCatalog();
 }
 
 void TableData::configureColumnWidths()
 {
     // Configurar anchos para tabla de datos (no de diseño)
-    for (int col = 0; col < dataTable->columnCount(); col++) {
+    for (int col = 0; col < dataModel->columnCount(); col++) {
         if (col < savedFieldNames.size()) {
             QString fieldName = savedFieldNames.at(col).toLower();
             
@@ -590,24 +737,8 @@ void TableData::configureColumnWidths()
 
 void TableData::addPersonRow(const QStringList &personData)
 {
-    int newRow = dataTable->rowCount();
-    dataTable->setRowCount(newRow + 1);
-    
-    // Crear todas las celdas de la nueva fila - todas editables
-    for (int col = 0; col < dataTable->columnCount(); col++) {
-        QTableWidgetItem *item = new QTableWidgetItem("");
-        
-        // Configurar fuente más grande para mejor legibilidad
-        QFont itemFont = item->font();
-        itemFont.setPointSize(16); // Fuente más grande para consistencia con el editor
-        item->setFont(itemFont);
-        
-        // Todas las celdas son editables
-        item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable);
-        item->setBackground(QBrush(QColor(255, 255, 255))); // Fondo blanco
-        
-        dataTable->setItem(newRow, col, item);
-    }
+    // Todas las celdas de la nueva fila son editables
+    dataModel->appendRow(personData);
 }
 
 void TableData::addNewPersonRow()
@@ -618,90 +749,63 @@ void TableData::addNewPersonRow()
 
 void TableData::removeEmptyRows()
 {
-    // Eliminar filas completamente vacías desde el final
-    for (int row = dataTable->rowCount() - 1; row >= 0; row--) {
+    beginChange();
+    // Eliminar filas completamente vacías desde el final. Una fila guardada
+    // nunca está vacía (persistRow borra su registro), así que solo se revisan
+    // las filas en memoria y no hace falta leer el archivo.
+    for (int row = dataModel->rowCount() - 1; row >= 0; row--) {
+        if (isExampleRow(row) || recordIdForRow(row).isValid()) continue;
+
         bool isEmpty = true;
-        for (int col = 0; col < dataTable->columnCount(); col++) {
-            QTableWidgetItem *item = dataTable->item(row, col);
-            if (item && !item->text().trimmed().isEmpty()) {
+        for (const QString &value : rowValues(row)) {
+            if (!value.isEmpty()) {
                 isEmpty = false;
                 break;
             }
         }
         
-        if (isEmpty && dataTable->rowCount() > 1) {
-            dataTable->removeRow(row);
+        if (isEmpty && dataModel->rowCount() > 1) {
+            dataModel->removeRow(row);
         }
     }
+    
+    commitChange();
+    scheduleCompaction();
 }
 
-void TableData::onPersonDataChanged(QTableWidgetItem *item)
+void TableData::onPersonDataChanged(int row, int col)
 {
-    if (!item) return;
-    
     // Ignorar cambios en la fila de ejemplo
-    if (item->toolTip().contains("Ejemplo")) {
+    if (isExampleRow(row)) {
         qDebug() << "DEBUG: Ignoring changes to example row";
         return;
     }
     
-    int row = item->row();
-    int col = item->column();
-    
     qDebug() << "DEBUG: Datos cambiados en fila:" << row << "columna:" << col;
     
+    const QString text = rowValues(row).value(col);
+    
     // Si el usuario empieza a escribir, eliminar la fila de ejemplo
-    if (!item->text().trimmed().isEmpty()) {
-        // Buscar y eliminar la fila de ejemplo
-        for (int r = 0; r < dataTable->rowCount(); r++) {
-            QTableWidgetItem *firstItem = dataTable->item(r, 0);
-            if (firstItem && firstItem->toolTip().contains("Ejemplo")) {
-                qDebug() << "DEBUG: User started typing, removing example row";
-                dataTable->blockSignals(true);
-                dataTable->removeRow(r);
-                dataTable->blockSignals(false);
-                break;
-            }
-        }
+    if (!text.isEmpty() && dataModel->hasExampleRow()) {
+        qDebug() << "DEBUG: User started typing, removing example row";
+        dataModel->clearExampleRow();
+        row--; // la fila de ejemplo estaba antes (índice 0)
     }
     
+    // Guardar la fila en disco
+    beginChange();
+    persistRow(row);
+    commitChange();
+    
     // Verificar que los índices son válidos antes de acceder a savedFieldTypes
     if (col >= savedFieldTypes.size() || col >= savedFieldNames.size()) {
         qDebug() << "DEBUG: Column index" << col << "out of range. savedFieldTypes size:" << savedFieldTypes.size() << "savedFieldNames size:" << savedFieldNames.size();
         return;
     }
-    
-    // Aplicar formato automático para campos de moneda
-    /*if (col < savedFieldTypes.size() && col < savedFieldNames.size() && savedFieldTypes.at(col) == "moneda") {
-        QString text = item->text().trimmed();
-        if (!text.isEmpty() && !text.startsWith("Lps ") && !text.startsWith("$") && !text.startsWith("€")) {
-            // Bloquear señales para evitar bucle infinito
-            dataTable->blockSignals(true);
-            
-            // Extraer solo los números y puntos decimales
-            QString cleanNumber = "";
-            for (int i = 0; i < text.length(); i++) {
-                QChar c = text.at(i);
-                if (c.isDigit() || c == '.' || c == ',') {
-                    cleanNumber += c;
-                }
-            }
-            
-            if (!cleanNumber.isEmpty()) {
-                item->setText("Lps " + cleanNumber);
-            }
-            
-            dataTable->blockSignals(false);
-        }
-    }
-    */
 
     // Solo agregar nueva fila si estamos escribiendo en la última fila y hay contenido real
-    if (row == dataTable->rowCount() - 1 && !item->text().trimmed().isEmpty()) {
-        // Bloquear señales temporalmente para evitar bucles infinitos
-        dataTable->blockSignals(true);
+    if (row == dataModel->rowCount() - 1 && !text.isEmpty()) {
         addPersonRow();
-        dataTable->blockSignals(false);
     }
 }
 
@@ -719,34 +823,26 @@ void TableData::setTableName(const QString &tableName)
     }
 }
 
-QList<QStringList> TableData::getAllPersonData() const
+ColumnTable TableData::getAllPersonData() const
 {
-    QList<QStringList> allData;
+    // Los registros guardados se leen del archivo (la vista solo tiene los ya mostrados)
+    ColumnTable allData = storedRows();
     
-    for (int row = 0; row < dataTable->rowCount(); row++) {
-        // Ignorar la fila de ejemplo
-        QTableWidgetItem *firstItem = dataTable->item(row, 0);
-        if (firstItem && firstItem->toolTip().contains("Ejemplo")) {
+    for (int row = 0; row < dataModel->rowCount(); row++) {
+        // Ignorar la fila de ejemplo y las filas que ya están en el archivo
+        if (isExampleRow(row) || (hasStorage() && recordIdForRow(row).isValid())) {
             continue;
         }
         
-        QStringList rowData;
-        bool hasData = false;
+        const QStringList rowData = rowValues(row);
         
-        for (int col = 0; col < dataTable->columnCount(); col++) {
-            QTableWidgetItem *item = dataTable->item(row, col);
-            QString cellText = item ? item->text().trimmed() : "";
-            rowData << cellText;
-            
+        // Solo agregar filas que tengan al menos un dato
+        for (const QString &cellText : rowData) {
             if (!cellText.isEmpty()) {
-                hasData = true;
+                allData.appendRow(rowData);
+                break;
             }
         }
-        
-        // Solo agregar filas que tengan al menos un dato
-        if (hasData) {
-            allData << rowData;
-        }
     }
     
     return allData;
@@ -754,8 +850,19 @@ QList<QStringList> TableData::getAllPersonData() const
 
 void TableData::clearAllData()
 {
-    dataTable->clearContents();
-    dataTable->setRowCount(0); // Empezar sin filas
+    if (hasStorage() && !recordFile.clear()) {
+        qDebug() << "ERROR: No se pudieron borrar los registros:" << recordFile.errorString();
+    }
+    if (primaryIndex.isOpen()) {
+        primaryIndex.clear();
+    }
+    for (BPlusTree *index : qAsConst(secondaryIndexes)) {
+        index->clear();
+    }
+    
+    // Empezar sin filas
+    clearFilter();
+    dataModel->setRecordFile(hasStorage() ? &recordFile : nullptr);
     
     // Mostrar fila de ejemplo cuando no hay datos
     updateExampleData();
@@ -766,24 +873,24 @@ void TableData::clearAllData()
 
 QString TableData::getTableStyle()
 {
-    return "QTableWidget {"
+    return "QTableView {"
            "background-color: white;"
            "gridline-color: #e2e8f0;"
            "border: 1px solid #cbd5e1;"
            "selection-background-color: #dbeafe;"
            "font-size: 14px;"
            "}"
-           "QTableWidget::item {"
+           "QTableView::item {"
            "padding: 16px 12px;" // Más padding para mejor visibilidad del texto (igual que el editor)
            "border-bottom: 1px solid #f1f5f9;"
            "min-height: 50px;" // Altura mínima para las celdas
            "font-size: 16px;" // Fuente más grande para mejor legibilidad
            "}"
-           "QTableWidget::item:selected {"
+           "QTableView::item:selected {"
            "background-color: #bfdbfe;" // Mismo color que TableView
            "color: #1e40af;"
            "}"
-           "QTableWidget::item:focus {"
+           "QTableView::item:focus {"
            "background-color: rgba(59, 130, 246, 0.1);" // Fondo muy sutil al hacer foco
            "border: 1px solid #3b82f6;" // Borde sutil para indicar foco
            "outline: none;"
@@ -844,53 +951,15 @@ void TableData::updateExampleData()
         return;
     }
     
-    // Bloquear señales para evitar bucles infinitos
-    dataTable->blockSignals(true);
-    
-    // Eliminar TODAS las filas de ejemplo existentes
-    for (int row = dataTable->rowCount() - 1; row >= 0; row--) {
-        QTableWidgetItem *firstItem = dataTable->item(row, 0);
-        if (firstItem && firstItem->toolTip().contains("Ejemplo")) {
-            qDebug() << "DEBUG: Removing existing example row at index" << row;
-            dataTable->removeRow(row);
-        }
-    }
-    
-    // Crear UNA nueva fila de ejemplo al principio (índice 0)
-    dataTable->insertRow(0);
-    
-    // Crear items para la fila de ejemplo
+    // Generar el ejemplo específico para el tipo de dato de cada campo
+    QStringList exampleValues;
     for (int col = 0; col < savedFieldNames.size(); col++) {
-        QString fieldName = savedFieldNames.at(col);
         QString dataType = (col < savedFieldTypes.size()) ? savedFieldTypes.at(col) : "Texto corto (hasta N caracteres)";
-        
-        QTableWidgetItem *exampleItem = new QTableWidgetItem("");
-        
-        // Configurar estilo para datos de ejemplo
-        QFont exampleFont = exampleItem->font();
-        exampleFont.setPointSize(16);
-        exampleFont.setItalic(true); // Cursiva para indicar que es ejemplo
-        exampleItem->setFont(exampleFont);
-        
-        // Color gris para indicar que es ejemplo
-        exampleItem->setForeground(QBrush(QColor(156, 163, 175))); // Color gris
-        exampleItem->setBackground(QBrush(QColor(249, 250, 251))); // Fondo gris muy claro
-        
-        // NO EDITABLE - solo para mostrar ejemplo
-        exampleItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
-        
-        // Tooltip para identificar que es ejemplo
-        exampleItem->setToolTip("Fila de ejemplo - muestra cómo se verán los datos");
-        
-        // Generar el ejemplo específico para este tipo de dato
-        QString example = generateExampleData(dataType, col);
-        exampleItem->setText(example);
-        
-        dataTable->setItem(0, col, exampleItem);
+        exampleValues << generateExampleData(dataType, col);
     }
     
-    // Desbloquear señales
-    dataTable->blockSignals(false);
+    // UNA sola fila de ejemplo al principio (índice 0): cursiva, gris y no editable
+    dataModel->setExampleRow(exampleValues);
     
     qDebug() << "DEBUG: Created single new example row at index 0";
 }
@@ -903,41 +972,19 @@ QString TableData::fieldTypeForColumn(int col) const {
 }
 
 void TableData::markCellInvalid(int row, int col, const QString& msg) const {
-    if (!dataTable) return;
-    if (auto *it = dataTable->item(row, col)) {
-        it->setBackground(QBrush(QColor("#FEE2E2"))); // rojo suave
-        it->setToolTip(msg);
-    }
+    if (!dataModel) return;
+    dataModel->setCellError(row, col, msg); // rojo suave + tooltip
 }
 
 void TableData::clearCellError(int row, int col) const {
-    if (!dataTable) return;
-    if (auto *it = dataTable->item(row, col)) {
-        it->setBackground(QBrush(QColor(255,255,255)));
-        it->setToolTip({});
-    }
+    if (!dataModel) return;
+    dataModel->clearCellError(row, col);
 }
 
 QString TableData::formatCurrency(const QString& raw) const {
-    // Extrae dígitos, separadores y signo para poder parsear
-    QString cleaned;
-    cleaned.reserve(raw.size());
-    for (QChar c : raw) {
-        if (c.isDigit() || c == '.' || c == ',' || c == '-') cleaned.append(c);
-    }
-    if (cleaned.isEmpty()) return QString();
-
-    // Normaliza decimal a punto para parseo
-    QString normalized = cleaned;
-    normalized.replace(',', '.');
-
-    bool ok = false;
-    const double v = normalized.toDouble(&ok);
-    if (!ok) return raw; // Si no se pudo parsear, deja el texto tal cual
-
-    // Formatea con separadores y 2 decimales
-    QLocale loc(QLocale::Spanish, QLocale::Honduras); // "1,234.56" → en ES-HN se ve "1,234.56" o según configuración
-    return QStringLiteral("Lps %1").arg(loc.toString(v, 'f', 2));
+    // Centavos exactos (sin pasar por double): "Lps 1,234.56"
+    const std::optional<Currency> value = Currency::parse(raw);
+    return value ? value->toString() : raw;
 }
 
 void TableData::showSoftWarning(int row, int col, const QString& msg) const {
@@ -946,95 +993,1410 @@ void TableData::showSoftWarning(int row, int col, const QString& msg) const {
     markCellInvalid(row, col, msg);
 
     // calcular posición de la celda y mostrar tooltip no modal
-    const QModelIndex idx = dataTable->model()->index(row, col);
+    const QModelIndex idx = dataModel->index(row, col);
     QRect vr = dataTable->visualRect(idx);
     QPoint pos = dataTable->viewport()->mapToGlobal(vr.center());
     QToolTip::showText(pos, msg, dataTable);
 }
 
 bool TableData::isValueValidForType(const QString& type, const QString& value) const {
-    const QString v = value.trimmed();
-    if (type == "Entero") {
-        bool ok=false; v.toInt(&ok); return ok || v.isEmpty();
+    return TypeValidator::isValid(type, value);
+}
+
+void TableData::pasteFromClipboard()
+{
+    // Bloque de celdas separadas por tabulador (como lo copia una hoja de cálculo)
+    QString text = QApplication::clipboard()->text();
+    text.remove('\r');
+    if (text.endsWith('\n')) text.chop(1);
+    if (text.isEmpty() || savedFieldNames.isEmpty()) return;
+
+    const QStringList lines = text.split('\n');
+    const QModelIndex current = dataTable->currentIndex();
+    int firstRow = current.isValid() ? current.row() : dataModel->rowCount() - 1;
+    const int firstCol = current.isValid() ? current.column() : 0;
+    int width = 0;
+    for (const QString &line : lines)
+        width = qMax(width, line.count('\t') + 1);
+    const int columnCount = qMin(width, savedFieldNames.size() - firstCol);
+    if (columnCount <= 0) return;
+
+    // Valores por columna, validados de una vez
+    QVector<QStringList> columns(columnCount);
+    for (const QString &line : lines) {
+        const QStringList cells = line.split('\t');
+        for (int c = 0; c < columnCount; c++)
+            columns[c] << cells.value(c).trimmed();
     }
-    if (type == "Decimales" || type == "moneda") {
-        bool ok=false; v.toDouble(&ok); return ok || v.isEmpty();
+    QVector<BitVector> invalid;
+    for (int c = 0; c < columnCount; c++)
+        invalid << TypeValidator::invalidRows(savedFieldTypes.value(firstCol + c), columns.at(c));
+
+    // Pegar sobre la fila de ejemplo la reemplaza
+    if (dataModel->hasExampleRow()) {
+        dataModel->clearExampleRow();
+        firstRow = qMax(0, firstRow - 1);
     }
-    if (type == "fecha") {
-        if (v.isEmpty()) return true;
-        const QChar sep = v.contains('/') ? QChar('/') : (v.contains('-') ? QChar('-') : QChar());
-        if (sep.isNull()) return false;
-        const QString fmt = (v.count(sep)==2 && v.split(sep).last().size()==4)
-                                ? QString("dd%1MM%1yyyy").arg(sep)
-                                : QString("dd%1MM%1yy").arg(sep);
-        return QDate::fromString(v, fmt).isValid();
+    while (dataModel->rowCount() < firstRow + lines.size())
+        addPersonRow();
+
+    // Una sola transacción; cada fila se guarda una vez, no por celda
+    int rejected = 0;
+    dataModel->blockSignals(true);
+    for (int i = 0; i < lines.size(); i++) {
+        const int row = firstRow + i;
+        for (int c = 0; c < columnCount; c++) {
+            const int col = firstCol + c;
+            QString value = columns.at(c).at(i);
+            if (invalid.at(c).at(i)) {
+                rejected++;
+                continue;
+            }
+            if (!value.isEmpty() && savedFieldTypes.value(col) == "moneda") {
+                value = formatCurrency(value);
+            } else if (!value.isEmpty() && savedFieldTypes.value(col) == "fecha") {
+                if (const std::optional<CompactDate> date = CompactDate::parse(value))
+                    value = date->toString();
+            }
+            dataModel->setData(dataModel->index(row, col), value);
+        }
     }
-    return true;
+    dataModel->blockSignals(false);
+
+    beginChange();
+    for (int i = 0; i < lines.size(); i++)
+        persistRow(firstRow + i);
+    commitChange();
+
+    // Las celdas rechazadas se marcan después de guardar (persistRow no las toca)
+    for (int c = 0; c < columnCount; c++) {
+        const QString type = savedFieldTypes.value(firstCol + c);
+        for (int i = 0; i < lines.size(); i++) {
+            if (invalid.at(c).at(i))
+                markCellInvalid(firstRow + i, firstCol + c, QString("Valor incompatible para '%1'").arg(type));
+        }
+    }
+    dataTable->viewport()->update();
+
+    if (!rowValues(dataModel->rowCount() - 1).join(QString()).isEmpty())
+        addPersonRow();
+    qDebug() << "DEBUG: Pegadas" << lines.size() << "filas," << rejected << "celdas rechazadas";
+}
+
+void DataFieldDelegate::setRenderModel(const TableDataModel *model)
+{
+    renderModel = model;
+    renderCache.clear();
+    if (renderModel)
+        renderCache.resize(RenderCacheSize); // una sola vez: pintar no reserva memoria
+}
+
+void DataFieldDelegate::setRenderView(QWidget *view)
+{
+    if (renderView)
+        renderView->removeEventFilter(this);
+    renderView = view;
+    if (renderView)
+        renderView->installEventFilter(this);
+}
+
+bool DataFieldDelegate::eventFilter(QObject *watched, QEvent *event)
+{
+    // La base trata lo vigilado como editor: los eventos de la vista no pasan por ella
+    if (watched != renderView)
+        return QStyledItemDelegate::eventFilter(watched, event);
+
+    // Lo guardado tiene la fuente y la paleta de cuando se pintó
+    switch (event->type()) {
+    case QEvent::FontChange:
+    case QEvent::PaletteChange:
+    case QEvent::StyleChange:
+        clearRenderCache();
+        break;
+    default:
+        break;
+    }
+    return false;
+}
+
+void DataFieldDelegate::clearRenderCache()
+{
+    // Sin soltar la memoria: la versión 0 nunca coincide con una fila
+    for (RenderEntry &entry : renderCache)
+        entry.revision = 0;
 }
 
 void DataFieldDelegate::initStyleOption(QStyleOptionViewItem *option,
                                         const QModelIndex &index) const
+{
+    const quint64 revision = (renderModel && index.model() == renderModel)
+        ? renderModel->renderRevision(index.row()) : 0;
+    if (revision == 0) {
+        initStyleOptionFromModel(option, index);
+        return;
+    }
+
+    RenderEntry &entry = renderCache[(quint32(index.row()) * 31u + quint32(index.column())) & (RenderCacheSize - 1)];
+    if (entry.revision == revision && entry.row == index.row() && entry.column == index.column()) {
+        // Mismos campos que llena QStyledItemDelegate::initStyleOption
+        option->index = index;
+        option->text = entry.text;
+        option->font = entry.font;
+        option->fontMetrics = entry.fontMetrics;
+        option->displayAlignment = entry.displayAlignment;
+        if (entry.hasForeground)
+            option->palette.setBrush(QPalette::Text, entry.foreground);
+        option->backgroundBrush = entry.backgroundBrush;
+        option->features |= entry.features;
+        option->styleObject = nullptr;
+        return;
+    }
+
+    const QStyleOptionViewItem::ViewItemFeatures before = option->features;
+    initStyleOptionFromModel(option, index);
+
+    entry.row = index.row();
+    entry.column = index.column();
+    entry.revision = revision;
+    entry.text = option->text;
+    entry.font = option->font;
+    entry.fontMetrics = option->fontMetrics;
+    entry.displayAlignment = option->displayAlignment;
+    entry.hasForeground = index.data(Qt::ForegroundRole).isValid();
+    entry.foreground = option->palette.brush(QPalette::Text);
+    entry.backgroundBrush = option->backgroundBrush;
+    entry.features = option->features & ~before;
+}
+
+void DataFieldDelegate::initStyleOptionFromModel(QStyleOptionViewItem *option,
+                                                 const QModelIndex &index) const
 {
     QStyledItemDelegate::initStyleOption(option, index);
 
     const TableData *owner = qobject_cast<const TableData*>(this->parent());
-    const QString type = owner ? owner->fieldTypeForColumn(index.column()).trimmed().toLower() : QString();
-    if (type != "moneda")
+    if (!owner || owner->fieldTypeForColumn(index.column()) != QLatin1String("moneda"))
+        return;
+    if (option->text.isEmpty())
         return;
 
-    // Texto crudo que devolvería el modelo para pintar
-    QString raw = index.model()->data(index, Qt::DisplayRole).toString().trimmed();
-    if (raw.isEmpty())
+    // Los valores guardados ya vienen con formato; solo se reformatean los que no
+    const std::optional<Currency> value = Currency::parse(option->text);
+    if (value && !value->isFormatted(option->text))
+        option->text = value->toString();
+}
+
+// --- Almacenamiento en disco (.mad) ---
+
+bool TableData::openStorage(const QString &filePath, const QString &indexDir)
+{
+    indexDirectory = indexDir;
+    if (!recordFile.open(filePath)) {
+        qDebug() << "ERROR: No se pudo abrir el archivo de la tabla:" << recordFile.errorString();
+        return false;
+    }
+    qDebug() << "DEBUG: Tabla enlazada a" << filePath << "con" << recordFile.recordCount() << "registros";
+
+    if (recordFile.fieldNames().isEmpty()) {
+        // Archivo nuevo: guardar el diseño actual y las filas que ya existan
+        ColumnTable existingData(savedFieldNames, savedFieldTypes);
+        for (int row = 0; row < dataModel->rowCount(); row++) {
+            if (isExampleRow(row)) continue;
+            const QStringList values = rowValues(row);
+            for (const QString &value : values) {
+                if (!value.isEmpty()) {
+                    existingData.appendRow(values);
+                    break;
+                }
+            }
+        }
+        rewriteAllRecords(existingData);
+        syncSchemaCatalog();
+        return true;
+    }
+    openPrimaryIndex();
+
+    // El archivo manda: si el diseño en memoria es distinto, se usa el del archivo
+    if (recordFile.fieldNames() != savedFieldNames || recordFile.fieldTypes() != savedFieldTypes) {
+        setupDataView(recordFile.fieldNames(), recordFile.fieldTypes());
+    }
+    loadSecondaryIndexes();
+    loadRowsFromStorage();
+    syncSchemaCatalog();
+    // Una migración que no terminó en la sesión anterior continúa
+    schemaMigrator->start();
+    scheduleCompaction();
+    return true;
+}
+
+void TableData::setWriteAheadLog(WriteAheadLog *log)
+{
+    writeAheadLog = log;
+    recordFile.setWriteAheadLog(log);
+    schemaMigrator->setWriteAheadLog(log);
+    primaryIndex.setWriteAheadLog(log);
+    for (BPlusTree *index : qAsConst(secondaryIndexes))
+        index->setWriteAheadLog(log);
+}
+
+void TableData::closeStorage()
+{
+    if (isImporting()) {
+        tableImporter->cancel();
+        endImport(false);
+    }
+    if (isExporting()) {
+        tableExporter->cancel();
+        endExport();
+    }
+    storageCompactor->cancel();
+    schemaMigrator->cancel();
+    clearFilter();
+    primaryIndex.close();
+    closeSecondaryIndexes();
+    recordFile.close();
+}
+
+bool TableData::isExampleRow(int row) const
+{
+    return dataModel->isExampleRow(row);
+}
+
+QStringList TableData::rowValues(int row) const
+{
+    QStringList values = dataModel->rowValues(row);
+    for (QString &value : values)
+        value = value.trimmed();
+    return values;
+}
+
+RecordId TableData::recordIdForRow(int row) const
+{
+    return dataModel->recordIdForRow(row);
+}
+
+void TableData::setRecordIdForRow(int row, RecordId rid)
+{
+    // No es una edición del usuario: el modelo no emite cellEdited
+    dataModel->setRecordIdForRow(row, rid);
+}
+
+void TableData::persistRow(int row)
+{
+    if (!hasStorage() || row < 0 || row >= dataModel->rowCount() || isExampleRow(row))
         return;
 
-    // Si ya viene con prefijo, no doble formatees
-    if (raw.startsWith("Lps ", Qt::CaseInsensitive)) {
-        option->text = raw;
+    const QStringList values = rowValues(row);
+    bool hasData = false;
+    for (const QString &value : values) {
+        if (!value.isEmpty()) {
+            hasData = true;
+            break;
+        }
+    }
+
+    const RecordId rid = recordIdForRow(row);
+
+    // Fila vaciada: se elimina su registro
+    if (!hasData) {
+        if (rid.isValid()) {
+            removeRecord(rid);
+            setRecordIdForRow(row, RecordId());
+            scheduleCompaction();
+        }
         return;
     }
 
-    // === Formateo rápido aquí (si ya tienes TableData::formatCurrency, úsala) ===
-    auto formatCurrencyInline = [](const QString& src)->QString {
-        // limpiar: dígitos, . , y signo
-        QString cleaned; cleaned.reserve(src.size());
-        bool neg = false;
-        for (QChar c : src) {
-            if (c == '-') { neg = !neg; continue; }
-            if (c.isDigit() || c == '.' || c == ',') cleaned.append(c);
+    // Valores anteriores (del registro en disco) para mantener los índices
+    std::optional<QStringList> oldValues;
+    if (rid.isValid() && (primaryIndex.isOpen() || !secondaryIndexes.isEmpty()))
+        oldValues = recordFile.read(rid);
+
+    // Llave primaria anterior y nueva (de la fila)
+    const std::optional<qint64> oldKey = oldValues ? primaryKeyFromValues(*oldValues) : std::nullopt;
+    const std::optional<qint64> newKey = primaryKeyFromValues(values);
+
+    if (newKey && newKey != oldKey) {
+        // El registro que ya tiene esa llave se muestra en el aviso
+        if (const std::optional<QStringList> existing = findByPrimaryKey(*newKey)) {
+            showSoftWarning(row, primaryKeyColumn(), QString("Ya existe un registro con %1 = %2: %3")
+                                                        .arg(savedFieldNames.value(primaryKeyColumn()))
+                                                        .arg(*newKey)
+                                                        .arg(existing->join(", ")));
+            return;
         }
-        if (cleaned.isEmpty()) return src;
-
-        // el último separador visto es decimal
-        int lastDot = cleaned.lastIndexOf('.');
-        int lastCom = cleaned.lastIndexOf(',');
-        QChar dec = (lastDot > lastCom ? QChar('.') : (lastCom > -1 ? QChar(',') : QChar()));
-        QString norm;
-        for (QChar c : cleaned) {
-            if (c.isDigit()) norm.append(c);
-            else if (!dec.isNull() && c == dec) norm.append('.');
+    }
+
+    const std::optional<RecordId> stored = rid.isValid() ? recordFile.update(rid, values)
+                                                          : recordFile.insert(values);
+    if (!stored) {
+        qDebug() << "ERROR: No se pudo guardar la fila" << row << ":" << recordFile.errorString();
+        return;
+    }
+    // La edición queda guardada (y el registro pudo moverse)
+    setRecordIdForRow(row, *stored);
+
+    // Mantener el índice de la llave primaria
+    if (primaryIndex.isOpen() && (oldKey != newKey || *stored != rid)) {
+        if (oldKey && !primaryIndex.remove(*oldKey, rid))
+            qDebug() << "WARNING: Índice primario desincronizado:" << primaryIndex.errorString();
+        if (newKey && !primaryIndex.insert(*newKey, *stored))
+            qDebug() << "WARNING: Índice primario desincronizado:" << primaryIndex.errorString();
+    }
+    updateSecondaryIndexes(oldValues ? &*oldValues : nullptr, rid, &values, *stored);
+}
+
+void TableData::removeRecord(RecordId rid)
+{
+    if (primaryIndex.isOpen() || !secondaryIndexes.isEmpty()) {
+        if (const auto old = recordFile.read(rid)) {
+            const auto key = primaryKeyFromValues(*old);
+            if (key && primaryIndex.isOpen())
+                primaryIndex.remove(*key, rid);
+            updateSecondaryIndexes(&*old, rid, nullptr, RecordId());
         }
-        bool ok=false;
-        double v = norm.toDouble(&ok);
-        if (!ok) return src;
-        if (neg) v = -v;
-
-        // miles con ',', 2 decimales
-        const bool isNeg = v < 0;
-        v = std::abs(v);
-        qint64 entero = static_cast<qint64>(std::floor(v));
-        int cents = static_cast<int>(qRound64((v - entero)*100.0));
-        QString entStr = QString::number(entero);
-        for (int pos = entStr.size() - 3; pos > 0; pos -= 3) entStr.insert(pos, ',');
-
-        QString decStr = QString("%1").arg(cents, 2, 10, QLatin1Char('0'));
-        QString out = QString("Lps %1.%2").arg(entStr, decStr);
-        if (isNeg) out.prepend('-');
-        return out;
-    };
-
-    // Si tienes TableData::formatCurrency, prefierela:
-    // raw = owner ? owner->formatCurrency(raw) : formatCurrencyInline(raw);
-    raw = formatCurrencyInline(raw);
-
-    option->text = raw;
+    }
+    if (!recordFile.remove(rid))
+        qDebug() << "ERROR: No se pudo eliminar el registro:" << recordFile.errorString();
+}
+
+void TableData::beginChange()
+{
+    if (writeAheadLog)
+        writeAheadLog->begin();
+}
+
+void TableData::commitChange()
+{
+    flushStorage();
+    // Durable cuando el log llega al disco (group commit); la tabla se escribe después
+    if (writeAheadLog && !writeAheadLog->commit())
+        qDebug() << "ERROR: No se pudo confirmar el cambio:" << writeAheadLog->errorString();
+}
+
+bool TableData::rollbackChange()
+{
+    // Sin log no hay cómo deshacer: lo escrito se confirma como está
+    if (!writeAheadLog || !writeAheadLog->inTransaction()) {
+        commitChange();
+        return false;
+    }
+    if (!writeAheadLog->rollback()) {
+        qDebug() << "ERROR: No se pudo deshacer el cambio:" << writeAheadLog->errorString();
+        return false;
+    }
+    // Las páginas volvieron atrás; lo leído de ellas a memoria se relee
+    if (!recordFile.reloadHeader())
+        qDebug() << "ERROR: No se pudo releer el encabezado de la tabla:" << recordFile.errorString();
+    if (primaryIndex.isOpen() && !primaryIndex.reloadHeader())
+        qDebug() << "ERROR: No se pudo releer el índice primario:" << primaryIndex.errorString();
+    for (BPlusTree *index : qAsConst(secondaryIndexes)) {
+        if (!index->reloadHeader())
+            qDebug() << "ERROR: No se pudo releer el índice de" << index->fieldName() << ":" << index->errorString();
+    }
+    return true;
+}
+
+void TableData::flushStorage()
+{
+    // Las páginas modificadas viven en la caché compartida hasta aquí; con
+    // log solo se escriben los encabezados pendientes
+    if (!hasStorage()) return;
+    if (!recordFile.sync())
+        qDebug() << "ERROR: No se pudo escribir la tabla:" << recordFile.errorString();
+    if (primaryIndex.isOpen()) {
+        primaryIndex.setSourceRecords(recordFile.recordCount());
+        primaryIndex.sync();
+    }
+    for (BPlusTree *index : qAsConst(secondaryIndexes))
+        index->sync();
+}
+
+ColumnTable TableData::storedRows() const
+{
+    // Registros del archivo con el diseño actual: los valores se tipan según
+    // savedFieldTypes y se guardan por columnas
+    ColumnTable rows(savedFieldNames, savedFieldTypes);
+    if (!hasStorage()) return rows;
+
+    // Columna de cada campo en el esquema del archivo (-1 si el campo es nuevo)
+    const QVector<int> sourceColumns = SchemaMigrator::matchFields(recordFile.fieldNames(), savedFieldNames);
+
+    RecordCursor cursor(const_cast<RecordFile*>(&recordFile));
+    while (cursor.next()) {
+        const QStringList values = cursor.values();
+        QStringList rowData;
+        for (int source : qAsConst(sourceColumns))
+            rowData << (source >= 0 ? values.value(source).trimmed() : QString());
+        rows.appendRow(rowData);
+    }
+    return rows;
+}
+
+void TableData::rewriteAllRecords(const ColumnTable &rows)
+{
+    if (!hasStorage()) return;
+    schemaMigrator->cancel(); // el archivo completo se reescribe con el esquema nuevo
+
+    if (!recordFile.setSchema(currentTableName, savedFieldNames, savedFieldTypes) || !recordFile.clear()) {
+        qDebug() << "ERROR: No se pudo reescribir la tabla:" << recordFile.errorString();
+        return;
+    }
+
+    beginChange();
+
+    // La llave primaria pudo cambiar: el índice se rehace con las filas
+    openPrimaryIndex();
+    if (primaryIndex.isOpen())
+        primaryIndex.clear();
+    resetSecondaryIndexes();
+
+    for (int row = 0; row < rows.rowCount(); row++) {
+        const QStringList values = rows.rowValues(row);
+        const std::optional<qint64> key = primaryKeyFromValues(values);
+        if (key && primaryIndex.isOpen() && primaryIndex.contains(*key)) {
+            qDebug() << "WARNING: Fila descartada por llave primaria repetida:" << *key;
+            continue;
+        }
+        const std::optional<RecordId> stored = recordFile.insert(values);
+        if (!stored) {
+            qDebug() << "ERROR: No se pudo guardar la fila:" << recordFile.errorString();
+            continue;
+        }
+        if (key && primaryIndex.isOpen() && !primaryIndex.insert(*key, *stored))
+            qDebug() << "WARNING: Índice primario desincronizado:" << primaryIndex.errorString();
+        updateSecondaryIndexes(nullptr, RecordId(), &values, *stored);
+    }
+    commitChange();
+
+    // La vista vuelve a leer los registros desde el archivo
+    loadRowsFromStorage();
+}
+
+void TableData::loadRowsFromStorage()
+{
+    if (!hasStorage() || recordFile.fieldNames().isEmpty()) return;
+
+    // Las filas se traen por lotes a medida que la vista las necesita:
+    // abrir la tabla no depende de la cantidad de registros
+    dataModel->setRecordFile(&recordFile);
+    if (dataModel->canFetchMore(QModelIndex()))
+        dataModel->fetchMore(QModelIndex());
+
+    // Sin registros: mostrar la fila de ejemplo como en una tabla nueva
+    if (recordFile.recordCount() == 0) {
+        updateExampleData();
+    }
+
+    // Fila vacía al final para seguir agregando datos
+    addPersonRow();
+
+    qDebug() << "DEBUG: Tabla" << recordFile.path() << "abierta con" << recordFile.recordCount() << "registros";
+}
+
+bool TableData::alterStorageSchema(const QVector<int> &sourceColumns)
+{
+    const QStringList fileNames = recordFile.fieldNames();
+    const QStringList fileTypes = recordFile.fieldTypes();
+    const QVector<quint16> fileIds = recordFile.fieldIds();
+
+    // Cada campo conserva el identificador del campo del que proviene
+    QVector<quint16> ids;
+    for (int source : sourceColumns)
+        ids << (source >= 0 ? fileIds.value(source) : quint16(0));
+
+    if (!recordFile.alterSchema(currentTableName, savedFieldNames, savedFieldTypes, ids)) {
+        qDebug() << "WARNING: No se pudo versionar el esquema:" << recordFile.errorString();
+        return false;
+    }
+    const QVector<quint16> newIds = recordFile.fieldIds();
+    qDebug() << "DEBUG: Esquema de" << currentTableName << "en la versión" << recordFile.schemaVersion()
+             << "- los registros se migran en segundo plano";
+
+    // El índice primario sigue valiendo si la llave es el mismo campo, con el mismo nombre
+    const int oldKey = primaryKeyColumnFor(fileNames, fileTypes);
+    const int newKey = primaryKeyColumn();
+    const bool sameKey = oldKey >= 0 && newKey >= 0 && fileIds.value(oldKey) == newIds.value(newKey)
+                         && fileNames.at(oldKey) == savedFieldNames.at(newKey);
+    if (!sameKey) {
+        primaryIndex.close();
+        openPrimaryIndex();
+        rebuildPrimaryIndex();
+    }
+
+    // Índices secundarios: se descartan los de campos eliminados o con otro
+    // tipo, se renombran los de campos renombrados; el resto no cambia
+    const QStringList indexed = secondaryIndexes.keys();
+    for (const QString &field : indexed) {
+        const int oldCol = fileNames.indexOf(field);
+        const int newCol = oldCol >= 0 ? newIds.indexOf(fileIds.value(oldCol)) : -1;
+        if (newCol < 0 || savedFieldTypes.value(newCol) != fileTypes.value(oldCol)) {
+            setFieldIndex(field, QString());
+        } else if (savedFieldNames.at(newCol) != field && !renameSecondaryIndex(field, savedFieldNames.at(newCol))) {
+            setFieldIndex(field, QString());
+        }
+    }
+
+    // La compactación se reiniciaría con cada tick de la migración
+    storageCompactor->cancel();
+    schemaMigrator->start();
+    return true;
+}
+
+bool TableData::renameSecondaryIndex(const QString &fieldName, const QString &newFieldName)
+{
+    BPlusTree *index = secondaryIndexes.value(fieldName);
+    if (!index || secondaryIndexes.contains(newFieldName)) return false;
+
+    // Las entradas no cambian: solo el nombre del campo en la cabecera y en el archivo
+    const IndexFile::Kind kind = index->kind();
+    const QString oldPath = index->path();
+    if (!index->setFieldName(newFieldName) || !index->sync()) {
+        qDebug() << "WARNING: No se pudo renombrar el índice de" << fieldName << ":" << index->errorString();
+        return false;
+    }
+    if (tableExporter->usesIndex(index)) {
+        tableExporter->cancel();
+        endExport();
+    }
+    secondaryIndexes.remove(fieldName);
+    index->close();
+    delete index;
+
+    const QString tableBase = QFileInfo(recordFile.path()).completeBaseName();
+    const QString newPath = QDir(indexDirectory).filePath(
+        IndexFile::fileNameFor(tableBase, newFieldName, indexKindName(kind)));
+    if (newPath != oldPath) {
+        QFile::remove(newPath);
+        if (!QFile::rename(oldPath, newPath)) {
+            qDebug() << "WARNING: No se pudo renombrar" << oldPath << "a" << newPath;
+            QFile::remove(oldPath);
+            return false;
+        }
+    }
+    qDebug() << "DEBUG: Índice de" << fieldName << "renombrado a" << newFieldName;
+    return openSecondaryIndex(newFieldName, kind) != nullptr;
+}
+
+void TableData::onRecordsMigrated(const QHash<quint64, RecordId> &moved)
+{
+    // Registros que no cabían en su ranura con el esquema nuevo
+    dataModel->remapRecordIds(moved);
+    for (auto it = moved.cbegin(); it != moved.cend(); ++it) {
+        const RecordId oldRid = RecordId::fromUInt64(it.key());
+        const RecordId newRid = it.value();
+        const std::optional<QStringList> values = recordFile.read(newRid);
+        if (!values) continue;
+        const std::optional<qint64> key = primaryKeyFromValues(*values);
+        if (key && primaryIndex.isOpen()) {
+            primaryIndex.remove(*key, oldRid);
+            primaryIndex.insert(*key, newRid);
+        }
+        updateSecondaryIndexes(&*values, oldRid, &*values, newRid);
+    }
+}
+
+void TableData::onSchemaMigrated(int rewritten, qint64 elapsedMs)
+{
+    qDebug() << "DEBUG: Tabla" << currentTableName << "migrada:" << rewritten << "registros en" << elapsedMs << "ms";
+    // Los registros que se movieron dejaron huecos
+    scheduleCompaction();
+}
+
+void TableData::scheduleCompaction()
+{
+    if (schemaMigrator->isRunning() || isImporting() || isExporting()) return;
+    if (!storageCompactor->isRunning() && TableCompactor::needsCompaction(recordFile)) {
+        storageCompactor->start();
+    }
+}
+
+void TableData::onStorageCompacted(qint64 reclaimedBytes, qint64 elapsedMs)
+{
+    // Los registros se movieron: actualizar el identificador de cada fila
+    dataModel->remapRecordIds(storageCompactor->movedRecords());
+
+    // Los índices apuntan a las posiciones anteriores
+    rebuildPrimaryIndex();
+    for (BPlusTree *index : qAsConst(secondaryIndexes)) {
+        rebuildSecondaryIndex(index);
+    }
+
+    qDebug() << "DEBUG: Tabla" << currentTableName << "compactada:" << reclaimedBytes
+             << "bytes recuperados en" << elapsedMs << "ms";
+    emit storageCompacted(reclaimedBytes, elapsedMs);
+}
+
+int TableData::primaryKeyColumn() const
+{
+    return primaryKeyColumnFor(savedFieldNames, savedFieldTypes);
+}
+
+int TableData::primaryKeyColumnFor(const QStringList &fieldNames, const QStringList &fieldTypes)
+{
+    // La llave primaria es el campo "Id" entero; si no existe, la primera columna entera
+    for (int col = 0; col < fieldNames.size() && col < fieldTypes.size(); col++) {
+        if (fieldNames.at(col).trimmed().compare("id", Qt::CaseInsensitive) == 0
+            && fieldTypes.at(col) == "Entero")
+            return col;
+    }
+    if (!fieldTypes.isEmpty() && fieldTypes.first() == "Entero")
+        return 0;
+    return -1;
+}
+
+std::optional<qint64> TableData::primaryKeyFromValues(const QStringList &values) const
+{
+    const int col = primaryKeyColumn();
+    if (col < 0 || col >= values.size())
+        return std::nullopt;
+    bool ok = false;
+    const qint64 key = values.at(col).trimmed().toLongLong(&ok);
+    if (!ok)
+        return std::nullopt;
+    return key;
+}
+
+void TableData::openPrimaryIndex()
+{
+    const int col = primaryKeyColumn();
+    if (indexDirectory.isEmpty() || col < 0 || !hasStorage()) {
+        primaryIndex.close();
+        return;
+    }
+
+    const QString tableBase = QFileInfo(recordFile.path()).completeBaseName();
+    const QString path = QDir(indexDirectory).filePath(
+        IndexFile::fileNameFor(tableBase, savedFieldNames.at(col), "btree"));
+    if (primaryIndex.isOpen() && primaryIndex.path() == path)
+        return;
+
+    primaryIndex.close();
+    if (!primaryIndex.open(path, currentTableName, savedFieldNames.at(col))) {
+        qDebug() << "ERROR: No se pudo abrir el índice primario:" << primaryIndex.errorString();
+        return;
+    }
+
+    // Índice nuevo o desactualizado respecto a la tabla: se reconstruye. Se
+    // compara con la cantidad de registros guardada en el índice, no con sus
+    // entradas (los registros sin llave no tienen entrada).
+    const bool stale = primaryIndex.sourceRecords() != recordFile.recordCount()
+                       || (recordFile.recordCount() == 0 && primaryIndex.size() > 0);
+    if (stale)
+        rebuildPrimaryIndex();
+}
+
+void TableData::rebuildPrimaryIndex()
+{
+    if (!primaryIndex.isOpen()) return;
+
+    // Construcción de abajo hacia arriba a partir de las claves ordenadas
+    IndexBulkLoader loader(primaryIndex.path());
+    loader.setFillFactor(indexFill);
+    RecordCursor cursor(&recordFile);
+    while (cursor.next()) {
+        if (const auto key = primaryKeyFromValues(cursor.values()))
+            loader.add(*key, cursor.recordId());
+    }
+    if (!primaryIndex.bulkLoad(loader)) {
+        qDebug() << "ERROR: No se pudo reconstruir el índice primario:" << primaryIndex.errorString();
+        return;
+    }
+    primaryIndex.setSourceRecords(recordFile.recordCount());
+    primaryIndex.sync();
+    if (loader.duplicatesSkipped() > 0)
+        qDebug() << "WARNING: Llaves primarias repetidas en disco:" << loader.duplicatesSkipped();
+    qDebug() << "DEBUG: Índice primario reconstruido con" << primaryIndex.size() << "claves";
+}
+
+std::optional<QStringList> TableData::findByPrimaryKey(qint64 key)
+{
+    if (!primaryIndex.isOpen())
+        return std::nullopt;
+    const std::optional<RecordId> rid = primaryIndex.find(key);
+    if (!rid)
+        return std::nullopt;
+    return recordFile.read(*rid);
+}
+
+// --- Índices secundarios (árbol B+ / B*) ---
+
+bool TableData::setFieldIndex(const QString &fieldName, const QString &kind)
+{
+    BPlusTree *current = secondaryIndexes.value(fieldName);
+    if (current && indexKindName(current->kind()) == kind)
+        return true;
+
+    // Quitar el índice actual (también cuando se cambia B+ ↔ B*)
+    if (current) {
+        if (tableExporter->usesIndex(current)) {
+            qDebug() << "WARNING: Se quita el índice que recorre la exportación, se cancela";
+            tableExporter->cancel();
+            endExport();
+        }
+        secondaryIndexes.remove(fieldName);
+        const QString path = current->path();
+        current->close();
+        delete current;
+        QFile::remove(path);
+        qDebug() << "DEBUG: Índice eliminado del campo" << fieldName;
+    }
+    if (kind.isEmpty()) {
+        syncSchemaCatalog();
+        return true;
+    }
+
+    if (kind != "bplus" && kind != "bstar") {
+        qDebug() << "WARNING: Tipo de índice desconocido:" << kind;
+        return false;
+    }
+    const int col = savedFieldNames.indexOf(fieldName);
+    if (col < 0 || !IndexKey::isIndexableType(savedFieldTypes.value(col))) {
+        qDebug() << "WARNING: El campo" << fieldName << "no admite índice";
+        return false;
+    }
+    if (!hasStorage() || indexDirectory.isEmpty()) {
+        qDebug() << "WARNING: La tabla no tiene proyecto; no se puede indexar" << fieldName;
+        return false;
+    }
+
+    BPlusTree *index = openSecondaryIndex(fieldName, kind == "bstar" ? IndexFile::BStarTreeKind
+                                                                      : IndexFile::BPlusTreeKind);
+    if (!index)
+        return false;
+    rebuildSecondaryIndex(index);
+    syncSchemaCatalog();
+    return true;
+}
+
+QMap<QString, QString> TableData::fieldIndexes() const
+{
+    QMap<QString, QString> indexes;
+    for (auto it = secondaryIndexes.cbegin(); it != secondaryIndexes.cend(); ++it) {
+        indexes.insert(it.key(), indexKindName(it.value()->kind()));
+    }
+    return indexes;
+}
+
+QString TableData::indexKindName(IndexFile::Kind kind)
+{
+    // Es también la extensión del archivo del índice
+    return kind == IndexFile::BStarTreeKind ? "bstar" : "bplus";
+}
+
+BPlusTree *TableData::openSecondaryIndex(const QString &fieldName, IndexFile::Kind kind)
+{
+    const QString tableBase = QFileInfo(recordFile.path()).completeBaseName();
+    const QString path = QDir(indexDirectory).filePath(
+        IndexFile::fileNameFor(tableBase, fieldName, indexKindName(kind)));
+
+    BPlusTree *index = new BPlusTree();
+    index->setWriteAheadLog(writeAheadLog);
+    if (!index->open(path, currentTableName, fieldName, kind)) {
+        qDebug() << "ERROR: No se pudo abrir el índice de" << fieldName << ":" << index->errorString();
+        delete index;
+        return nullptr;
+    }
+    secondaryIndexes.insert(fieldName, index);
+    return index;
+}
+
+void TableData::loadSecondaryIndexes()
+{
+    closeSecondaryIndexes();
+    if (indexDirectory.isEmpty() || !hasStorage()) return;
+
+    // Los nombres de archivo están saneados: el nombre real del campo está en la
+    // cabecera, salvo que el catálogo de esquemas ya diga de qué campo es cada archivo
+    const QString tableBase = QFileInfo(recordFile.path()).completeBaseName();
+    QHash<QString, QString> knownFiles; // archivo → campo
+    if (schemaCatalog) {
+        if (const std::optional<TableSchema> schema = schemaCatalog->table(currentTableName)) {
+            for (const FieldSchema &field : schema->fields) {
+                if (!field.indexKind.isEmpty())
+                    knownFiles.insert(IndexFile::fileNameFor(tableBase, field.name, field.indexKind), field.name);
+            }
+        }
+    }
+    const QStringList files = QDir(indexDirectory).entryList({ tableBase + ".*.bplus", tableBase + ".*.bstar" },
+                                                             QDir::Files);
+    for (const QString &file : files) {
+        const IndexFile::Kind kind = file.endsWith(".bstar") ? IndexFile::BStarTreeKind : IndexFile::BPlusTreeKind;
+        const QString path = QDir(indexDirectory).filePath(file);
+        QString fieldName = knownFiles.value(file);
+        if (fieldName.isEmpty()) {
+            BPlusTree probe;
+            if (!probe.open(path, QString(), QString(), kind)) continue;
+            fieldName = probe.fieldName();
+            probe.close();
+        }
+
+        const int col = recordFile.fieldNames().indexOf(fieldName);
+        if (col < 0 || !IndexKey::isIndexableType(recordFile.fieldTypes().value(col))) {
+            QFile::remove(path); // el campo ya no existe o cambió de tipo
+            continue;
+        }
+        if (secondaryIndexes.contains(fieldName)) {
+            QFile::remove(path); // quedó un índice de cada tipo: se conserva uno
+            continue;
+        }
+        BPlusTree *index = openSecondaryIndex(fieldName, kind);
+        if (index && index->size() > recordFile.recordCount())
+            rebuildSecondaryIndex(index);
+    }
+
+    if (!secondaryIndexes.isEmpty())
+        qDebug() << "DEBUG: Índices secundarios abiertos:" << secondaryIndexes.keys();
+}
+
+void TableData::rebuildSecondaryIndex(BPlusTree *index)
+{
+    const int col = savedFieldNames.indexOf(index->fieldName());
+    const QString type = savedFieldTypes.value(col);
+
+    IndexBulkLoader loader(index->path());
+    loader.setFillFactor(indexFill);
+    RecordCursor cursor(&recordFile);
+    while (cursor.next()) {
+        if (const auto key = IndexKey::encode(type, cursor.values().value(col)))
+            loader.add(*key, cursor.recordId());
+    }
+    if (!index->bulkLoad(loader)) {
+        qDebug() << "ERROR: No se pudo reconstruir el índice de" << index->fieldName() << ":" << index->errorString();
+        return;
+    }
+    qDebug() << "DEBUG: Índice de" << index->fieldName() << "reconstruido con" << index->size() << "entradas";
+}
+
+void TableData::resetSecondaryIndexes()
+{
+    // Tras un cambio de diseño: se descartan los índices de campos que ya no
+    // existen o cambiaron a un tipo sin orden; el resto se vacía y se vuelve a llenar
+    const QStringList fields = secondaryIndexes.keys();
+    for (const QString &field : fields) {
+        const int col = savedFieldNames.indexOf(field);
+        if (col < 0 || !IndexKey::isIndexableType(savedFieldTypes.value(col)))
+            setFieldIndex(field, QString());
+        else
+            secondaryIndexes.value(field)->clear();
+    }
+}
+
+void TableData::closeSecondaryIndexes()
+{
+    for (BPlusTree *index : qAsConst(secondaryIndexes)) {
+        if (tableExporter->usesIndex(index)) {
+            tableExporter->cancel();
+            endExport();
+        }
+    }
+    qDeleteAll(secondaryIndexes);
+    secondaryIndexes.clear();
+}
+
+void TableData::syncSchemaCatalog()
+{
+    if (!schemaCatalog || currentTableName.isEmpty())
+        return;
+    schemaCatalog->setTableFields(currentTableName, savedFieldNames, savedFieldTypes);
+    // Sin archivo no hay índices: lo que diga el catálogo se conserva
+    if (hasStorage())
+        schemaCatalog->setFieldIndexes(currentTableName, fieldIndexes());
+}
+
+void TableData::updateSecondaryIndexes(const QStringList *oldValues, RecordId oldRid,
+                                       const QStringList *newValues, RecordId newRid)
+{
+    for (auto it = secondaryIndexes.cbegin(); it != secondaryIndexes.cend(); ++it) {
+        const int col = savedFieldNames.indexOf(it.key());
+        const QString type = savedFieldTypes.value(col);
+        const auto oldKey = oldValues ? IndexKey::encode(type, oldValues->value(col)) : std::nullopt;
+        const auto newKey = newValues ? IndexKey::encode(type, newValues->value(col)) : std::nullopt;
+        if (oldKey == newKey && oldRid == newRid)
+            continue;
+
+        BPlusTree *index = it.value();
+        if (oldKey && !index->remove(*oldKey, oldRid))
+            qDebug() << "WARNING: Índice de" << it.key() << "desincronizado:" << index->errorString();
+        if (newKey && !index->insert(*newKey, newRid))
+            qDebug() << "WARNING: Índice de" << it.key() << "desincronizado:" << index->errorString();
+    }
+}
+
+BPlusTreeIterator TableData::rangeScan(const QString &fieldName, const QString &low, const QString &high,
+                                       bool lowInclusive, bool highInclusive)
+{
+    BPlusTree *index = secondaryIndexes.value(fieldName);
+    std::optional<qint64> lowKey, highKey;
+    if (!index || !rangeKeys(fieldName, low, high, &lowKey, &highKey))
+        return BPlusTreeIterator();
+    return index->range(lowKey, highKey, lowInclusive, highInclusive);
+}
+
+bool TableData::rangeKeys(const QString &fieldName, const QString &low, const QString &high,
+                          std::optional<qint64> *lowKey, std::optional<qint64> *highKey) const
+{
+    const QString type = savedFieldTypes.value(savedFieldNames.indexOf(fieldName));
+    *lowKey = low.trimmed().isEmpty() ? std::nullopt : IndexKey::encode(type, low);
+    *highKey = high.trimmed().isEmpty() ? std::nullopt : IndexKey::encode(type, high);
+    if ((!low.trimmed().isEmpty() && !*lowKey) || (!high.trimmed().isEmpty() && !*highKey)) {
+        qDebug() << "WARNING: Límites de rango inválidos para" << fieldName << ":" << low << high;
+        return false;
+    }
+    return true;
+}
+
+std::optional<QueryResult> TableData::runQuery(const Query &query, QString *error)
+{
+    std::optional<QueryResult> result;
+    QString engineError;
+    if (hasStorage()) {
+        QueryEngine engine(&recordFile, secondaryIndexes);
+        result = engine.execute(query);
+        engineError = engine.errorString();
+    } else {
+        QueryEngine engine(getAllPersonData());
+        result = engine.execute(query);
+        engineError = engine.errorString();
+    }
+    if (!result.has_value()) {
+        qDebug() << "WARNING: No se pudo consultar la tabla" << currentTableName << ":" << engineError;
+        if (error) *error = engineError;
+        return std::nullopt;
+    }
+    qDebug() << "DEBUG: Consulta sobre" << currentTableName << ":" << result->rows.size() << "filas de"
+             << result->scannedRows << "leídas en" << result->elapsedMs << "ms -" << result->plan.describe();
+    return result;
+}
+
+// --- Barra de filtro ---
+
+void TableData::refreshFilterFields()
+{
+    const QString filterField = filterFieldCombo->currentText();
+    const QString sortField = sortFieldCombo->currentData().toString();
+    
+    filterFieldCombo->clear();
+    filterFieldCombo->addItems(savedFieldNames);
+    sortFieldCombo->clear();
+    sortFieldCombo->addItem("(sin orden)", QString());
+    for (const QString &name : qAsConst(savedFieldNames))
+        sortFieldCombo->addItem(name, name);
+    
+    // Conservar la selección si el campo sigue existiendo
+    filterFieldCombo->setCurrentIndex(qMax(0, filterFieldCombo->findText(filterField)));
+    sortFieldCombo->setCurrentIndex(qMax(0, sortFieldCombo->findData(sortField)));
+}
+
+void TableData::onFilterOperatorChanged()
+{
+    const int op = filterOperatorCombo->currentData().toInt();
+    const bool needsValue = op >= 0 && op != QueryCondition::IsEmpty && op != QueryCondition::IsNotEmpty;
+    filterFieldCombo->setEnabled(op >= 0);
+    filterValueEdit->setVisible(needsValue);
+    filterValue2Edit->setVisible(op == QueryCondition::Between);
+}
+
+std::optional<Query> TableData::filterQuery(QString *error) const
+{
+    Query query;
+    const int op = filterOperatorCombo->currentData().toInt();
+    if (op >= 0) {
+        QueryCondition condition;
+        condition.field = filterFieldCombo->currentText();
+        condition.op = QueryCondition::Operator(op);
+        condition.value = filterValueEdit->text().trimmed();
+        condition.value2 = filterValue2Edit->text().trimmed();
+        const bool needsValue = condition.op != QueryCondition::IsEmpty && condition.op != QueryCondition::IsNotEmpty;
+        if (needsValue && (condition.value.isEmpty()
+                           || (condition.op == QueryCondition::Between && condition.value2.isEmpty()))) {
+            *error = "Escribe el valor con el que se compara el campo.";
+            return std::nullopt;
+        }
+        query.conditions << condition;
+    }
+    const QString sortField = sortFieldCombo->currentData().toString();
+    if (!sortField.isEmpty()) {
+        QuerySortKey key;
+        key.field = sortField;
+        key.ascending = sortOrderCombo->currentData().toBool();
+        query.orderBy << key;
+    }
+    return query;
+}
+
+void TableData::onApplyFilterClicked()
+{
+    if (savedFieldNames.isEmpty()) return;
+    
+    QString error;
+    std::optional<Query> query = filterQuery(&error);
+    if (!query.has_value()) {
+        QMessageBox::warning(this, "Filtrar", error);
+        return;
+    }
+    if (query->conditions.isEmpty() && query->orderBy.isEmpty()) {
+        clearFilter();
+        return;
+    }
+    
+    // Una fila más que las que se muestran, para saber si el resultado se cortó
+    Query shown = query.value();
+    shown.limit = FilterRowLimit + 1;
+    const std::optional<QueryResult> result = runQuery(shown, &error);
+    if (!result.has_value()) {
+        QMessageBox::warning(this, "Filtrar", QString("No se pudo aplicar el filtro:\n%1").arg(error));
+        return;
+    }
+    activeQuery = query;
+    showQueryResult(result.value());
+}
+
+void TableData::showQueryResult(const QueryResult &result)
+{
+    const int shownRows = qMin(result.rows.size(), FilterRowLimit);
+    queryResultModel->setResult(result, FilterRowLimit);
+    for (int col = 0; col < result.fieldNames.size(); col++)
+        queryResultTable->setColumnWidth(col, dataTable->columnWidth(col));
+    
+    QString summary = result.rows.size() > FilterRowLimit
+        ? QString("Primeras %1 filas").arg(FilterRowLimit)
+        : QString("%1 filas").arg(shownRows);
+    summary += QString(" · %1 registros leídos en %2 ms · %3")
+        .arg(result.scannedRows).arg(result.elapsedMs).arg(result.plan.describe());
+    queryPlanLabel->setText(summary);
+    queryPlanLabel->show();
+    
+    dataTable->hide();
+    queryResultTable->show();
+    clearFilterBtn->setEnabled(true);
+}
+
+void TableData::onClearFilterClicked()
+{
+    clearFilter();
+}
+
+void TableData::clearFilter()
+{
+    activeQuery.reset();
+    queryResultTable->hide();
+    queryResultModel->clear();
+    queryPlanLabel->hide();
+    clearFilterBtn->setEnabled(false);
+    dataTable->show();
+}
+
+// --- Importación de CSV/TSV ---
+
+bool TableData::importFile(const QString &filePath)
+{
+    if (savedFieldNames.isEmpty() || isImporting() || isExporting())
+        return false;
+
+    if (!tableImporter->start(filePath, savedFieldNames, savedFieldTypes)) {
+        qDebug() << "ERROR: No se pudo importar" << filePath << ":" << tableImporter->errorString();
+        return false;
+    }
+
+    // La compactación y la migración de esquema moverían registros mientras
+    // se agregan: la compactación no se programa y la migración se retoma al terminar
+    storageCompactor->cancel();
+    schemaMigrator->cancel();
+
+    importedRows = 0;
+    importDuplicates = 0;
+    if (!hasStorage()) {
+        // Sin archivo las filas van al modelo: sin ejemplo ni filas vacías en medio
+        dataModel->clearExampleRow();
+        removeEmptyRows();
+    }
+    importBtn->setText("Cancelar importación");
+    exportBtn->setEnabled(false);
+    transferProgress->setValue(0);
+    transferProgress->show();
+    return true;
+}
+
+void TableData::onImportClicked()
+{
+    if (isImporting()) {
+        tableImporter->cancel();
+        endImport(true);
+        return;
+    }
+
+    const QString filePath = QFileDialog::getOpenFileName(this, "Importar datos", QString(),
+                                                          "Texto delimitado (*.csv *.tsv *.tab *.txt);;Todos los archivos (*)");
+    if (!filePath.isEmpty())
+        importFile(filePath);
+}
+
+void TableData::onImportedRows(const QVector<QStringList> &rows)
+{
+    if (!hasStorage()) {
+        for (const QStringList &values : rows)
+            addPersonRow(values);
+        importedRows += rows.size();
+        return;
+    }
+
+    // Un lote, una transacción
+    bool failed = false;
+    QString error;
+    const qint64 importedBefore = importedRows;
+    const qint64 duplicatesBefore = importDuplicates;
+    beginChange();
+    for (const QStringList &values : rows) {
+        const std::optional<qint64> key = primaryKeyFromValues(values);
+        if (key && primaryIndex.isOpen() && primaryIndex.contains(*key)) {
+            importDuplicates++;
+            continue;
+        }
+        const std::optional<RecordId> rid = recordFile.insert(values);
+        if (!rid) {
+            error = recordFile.errorString();
+            qDebug() << "ERROR: No se pudo guardar una fila importada:" << error;
+            failed = true;
+            break;
+        }
+        if (key && primaryIndex.isOpen() && !primaryIndex.insert(*key, *rid))
+            qDebug() << "WARNING: Índice primario desincronizado:" << primaryIndex.errorString();
+        updateSecondaryIndexes(nullptr, RecordId(), &values, *rid);
+        importedRows++;
+    }
+
+    if (!failed) {
+        commitChange();
+        return;
+    }
+
+    // Un lote a medias no se confirma: se deshace completo y la importación se detiene
+    if (rollbackChange()) {
+        importedRows = importedBefore;
+        importDuplicates = duplicatesBefore;
+    }
+    tableImporter->cancel();
+    endImport(true);
+    QMessageBox::warning(this, "Importar", QString("No se pudo guardar una fila importada:\n%1\n\nSe importaron %2 filas.")
+                         .arg(error).arg(importedRows));
+}
+
+void TableData::onImportProgress(qint64 bytesDone, qint64 bytesTotal)
+{
+    transferProgress->setValue(int(bytesDone * 1000 / qMax<qint64>(1, bytesTotal)));
+}
+
+void TableData::onImportFinished(qint64 rows, qint64 rejectedCells, qint64 elapsedMs)
+{
+    endImport(true);
+    qDebug() << "DEBUG: Tabla" << currentTableName << "importada:" << importedRows << "de" << rows << "filas,"
+             << importDuplicates << "con llave repetida," << rejectedCells << "celdas rechazadas en" << elapsedMs << "ms";
+    emit importFinished(importedRows, rejectedCells);
+
+    QString summary = QString("Se importaron %1 filas.").arg(importedRows);
+    if (importDuplicates > 0)
+        summary += QString("\n%1 filas se omitieron por tener una llave primaria repetida.").arg(importDuplicates);
+    if (rejectedCells > 0)
+        summary += QString("\n%1 celdas quedaron vacías por no coincidir con el tipo del campo.").arg(rejectedCells);
+    QMessageBox::information(this, "Importar", summary);
+}
+
+void TableData::endImport(bool showRows)
+{
+    importBtn->setText("Importar");
+    exportBtn->setEnabled(true);
+    transferProgress->hide();
+    if (hasStorage() && recordFile.hasOutdatedRecords())
+        schemaMigrator->start();
+    if (!showRows) return;
+
+    clearFilter();
+
+    // Las filas importadas se leen del archivo como al abrir la tabla
+    if (hasStorage()) {
+        loadRowsFromStorage();
+    } else {
+        addPersonRow();
+    }
+}
+
+// --- Exportación a CSV / JSON Lines ---
+
+bool TableData::exportTable(const QString &filePath)
+{
+    const ExportWriter::Format format = ExportWriter::formatForPath(filePath);
+    if (!hasStorage()) {
+        // Tabla solo en memoria: pocas filas, se escriben de una vez
+        ExportWriter writer;
+        if (!writer.open(filePath, format, savedFieldNames, savedFieldTypes)) {
+            qDebug() << "ERROR: No se pudo exportar a" << filePath << ":" << writer.errorString();
+            return false;
+        }
+        for (int row = 0; row < dataModel->rowCount(); row++) {
+            if (isExampleRow(row)) continue;
+            const QStringList values = rowValues(row);
+            if (!values.join(QString()).isEmpty())
+                writer.writeRecord(values);
+        }
+        if (!writer.close()) {
+            qDebug() << "ERROR: No se pudo exportar a" << filePath << ":" << writer.errorString();
+            return false;
+        }
+        emit exportFinished(writer.rowCount(), writer.bytesWritten());
+        return true;
+    }
+
+    if (!beginExport())
+        return false;
+    if (!tableExporter->start(filePath, format)) {
+        qDebug() << "ERROR: No se pudo exportar a" << filePath << ":" << tableExporter->errorString();
+        endExport();
+        return false;
+    }
+    return true;
+}
+
+bool TableData::exportRange(const QString &filePath, const QString &fieldName, const QString &low,
+                            const QString &high, bool lowInclusive, bool highInclusive)
+{
+    BPlusTree *index = secondaryIndexes.value(fieldName);
+    if (!index) {
+        qDebug() << "WARNING: No se puede exportar el rango: el campo" << fieldName << "no tiene índice";
+        return false;
+    }
+    std::optional<qint64> lowKey, highKey;
+    if (!rangeKeys(fieldName, low, high, &lowKey, &highKey))
+        return false;
+    if (!beginExport())
+        return false;
+    if (!tableExporter->start(filePath, ExportWriter::formatForPath(filePath), index, lowKey, highKey,
+                              lowInclusive, highInclusive)) {
+        qDebug() << "ERROR: No se pudo exportar a" << filePath << ":" << tableExporter->errorString();
+        endExport();
+        return false;
+    }
+    return true;
+}
+
+bool TableData::exportFilterResult(const QString &filePath)
+{
+    const Query query = activeQuery.value();
+
+    // Un rango sobre un campo con índice B+/B* (y el orden es el de la clave):
+    // se exporta en segundo plano recorriendo el índice, sin cargar el resultado
+    if (hasStorage() && query.conditions.size() == 1) {
+        const QueryCondition &condition = query.conditions.first();
+        const bool keyOrder = query.orderBy.isEmpty()
+            || (query.orderBy.size() == 1 && query.orderBy.first().field == condition.field
+                && query.orderBy.first().ascending);
+        if (keyOrder && secondaryIndexes.contains(condition.field)) {
+            switch (condition.op) {
+            case QueryCondition::Equal:
+                return exportRange(filePath, condition.field, condition.value, condition.value);
+            case QueryCondition::Less:
+                return exportRange(filePath, condition.field, QString(), condition.value, true, false);
+            case QueryCondition::LessOrEqual:
+                return exportRange(filePath, condition.field, QString(), condition.value);
+            case QueryCondition::Greater:
+                return exportRange(filePath, condition.field, condition.value, QString(), false, true);
+            case QueryCondition::GreaterOrEqual:
+                return exportRange(filePath, condition.field, condition.value, QString());
+            case QueryCondition::Between:
+                return exportRange(filePath, condition.field, condition.value, condition.value2);
+            default:
+                break;
+            }
+        }
+    }
+
+    // Cualquier otro filtro: el resultado completo de la consulta, de una vez
+    QString error;
+    const std::optional<QueryResult> result = runQuery(query, &error);
+    if (!result.has_value()) {
+        QMessageBox::warning(this, "Exportar", QString("No se pudo aplicar el filtro:\n%1").arg(error));
+        return false;
+    }
+    ExportWriter writer;
+    if (!writer.open(filePath, ExportWriter::formatForPath(filePath), savedFieldNames, savedFieldTypes)) {
+        qDebug() << "ERROR: No se pudo exportar a" << filePath << ":" << writer.errorString();
+        return false;
+    }
+    for (const QStringList &values : result->rows)
+        writer.writeRecord(values);
+    if (!writer.close()) {
+        qDebug() << "ERROR: No se pudo exportar a" << filePath << ":" << writer.errorString();
+        return false;
+    }
+    emit exportFinished(writer.rowCount(), writer.bytesWritten());
+    return true;
+}
+
+bool TableData::beginExport()
+{
+    if (isExporting() || isImporting())
+        return false;
+
+    // Mientras se recorre el archivo nada debe mover registros: la compactación
+    // no se programa y la migración de esquema se retoma al terminar
+    storageCompactor->cancel();
+    schemaMigrator->cancel();
+    exportBtn->setText("Cancelar exportación");
+    importBtn->setEnabled(false);
+    transferProgress->setValue(0);
+    transferProgress->show();
+    return true;
+}
+
+void TableData::endExport()
+{
+    exportBtn->setText("Exportar");
+    importBtn->setEnabled(true);
+    transferProgress->hide();
+    transferProgress->setRange(0, 1000);
+    if (hasStorage() && recordFile.hasOutdatedRecords())
+        schemaMigrator->start();
+}
+
+void TableData::onExportClicked()
+{
+    if (isExporting()) {
+        tableExporter->cancel();
+        endExport();
+        return;
+    }
+
+    // Con un filtro aplicado se exporta lo que muestra el filtro (sin el límite de filas)
+    const QString filePath = QFileDialog::getSaveFileName(this, activeQuery ? "Exportar resultado del filtro" : "Exportar datos",
+                                                          currentTableName + ".csv", "CSV (*.csv);;JSON Lines (*.jsonl)");
+    if (filePath.isEmpty())
+        return;
+    if (activeQuery.has_value())
+        exportFilterResult(filePath);
+    else
+        exportTable(filePath);
+}
+
+void TableData::onExportProgress(qint64 rowsDone, qint64 rowCount)
+{
+    // Sin total (rango): la barra queda indeterminada
+    if (rowCount < 0) {
+        transferProgress->setRange(0, 0);
+        return;
+    }
+    transferProgress->setRange(0, 1000);
+    transferProgress->setValue(int(rowsDone * 1000 / qMax<qint64>(1, rowCount)));
+}
+
+void TableData::onExportFinished(qint64 rows, qint64 bytes, qint64 elapsedMs)
+{
+    endExport();
+    qDebug() << "DEBUG: Tabla" << currentTableName << "exportada:" << rows << "registros," << bytes
+             << "bytes en" << elapsedMs << "ms";
+    emit exportFinished(rows, bytes);
+}
+
+void TableData::onExportFailed(const QString &error)
+{
+    endExport();
+    QMessageBox::warning(this, "Exportar", QString("No se pudo exportar la tabla:\n%1").arg(error));
 }
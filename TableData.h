@@ -4,8 +4,7 @@
 #include <QWidget>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QTableWidget>
-#include <QTableWidgetItem>
+#include <QTableView>
 #include <QPushButton>
 #include <QLabel>
 #include <QHeaderView>
@@ -15,14 +14,43 @@
 #include <QLineEdit>
 #include <QComboBox>
 #include <QRegExp>
+#include <QProgressBar>
+#include "RecordFile.h"
+#include "TableCompactor.h"
+#include "SchemaMigrator.h"
+#include "SchemaDiff.h"
+#include "SchemaCatalog.h"
+#include "TableImporter.h"
+#include "TableExporter.h"
+#include "BTree.h"
+#include "BPlusTree.h"
+#include "WriteAheadLog.h"
+#include "TableDataModel.h"
+#include "ColumnTable.h"
+#include "QueryEngine.h"
+#include <QMap>
 
 // Delegate para campos de datos - estilo consistente con TableView
+//
+// initStyleOption() se llama por cada celda visible en cada repintado. Lo que
+// sale del modelo (texto ya formateado, fuente, colores) se guarda en una
+// caché de tamaño fijo por (fila, columna, versión de la fila); mientras la
+// fila no se edite, repintarla no vuelve a consultar el modelo ni el tipo del campo.
+// La fuente y los colores salen de la vista: si cambian su fuente, paleta o
+// estilo, la caché se vacía (ver setRenderView).
 class DataFieldDelegate : public QStyledItemDelegate
 {
     Q_OBJECT
 public:
+    static constexpr int RenderCacheSize = 4096; // potencia de 2
+
     explicit DataFieldDelegate(QObject *parent = nullptr) : QStyledItemDelegate(parent) {}
     
+    // Modelo que da las versiones de fila (nullptr: sin caché)
+    void setRenderModel(const TableDataModel *model);
+    // Vista que pinta con este delegate: se vigilan sus cambios de apariencia
+    void setRenderView(QWidget *view);
+    
     QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option,
                          const QModelIndex &index) const override;
     void setEditorData(QWidget *editor, const QModelIndex &index) const override;
@@ -30,6 +58,32 @@ public:
                      const QModelIndex &index) const override;
     void updateEditorGeometry(QWidget*, const QStyleOptionViewItem&, const QModelIndex&) const override;
     void initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const override;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    // Lo que initStyleOption() de la base y el formato de moneda dejan en la opción
+    struct RenderEntry {
+        int row = -1;
+        int column = -1;
+        quint64 revision = 0;
+        QString text;
+        QFont font;
+        QFontMetrics fontMetrics = QFontMetrics(QFont());
+        Qt::Alignment displayAlignment;
+        QBrush foreground;
+        bool hasForeground = false;
+        QBrush backgroundBrush;
+        QStyleOptionViewItem::ViewItemFeatures features; // solo las que agrega el modelo
+    };
+
+    void initStyleOptionFromModel(QStyleOptionViewItem *option, const QModelIndex &index) const;
+    void clearRenderCache();
+
+    const TableDataModel *renderModel = nullptr;
+    QWidget *renderView = nullptr;
+    mutable QVector<RenderEntry> renderCache;
 };
 
 class TableData : public QWidget
@@ -43,11 +97,15 @@ public:
     // Configurar la vista de datos basada en campos de diseño
     void setupDataView(const QStringList &fieldNames, const QStringList &fieldTypes);
     
+    // Aplicar un cambio de diseño de la vista de diseño: los campos se
+    // emparejan por identificador y solo se toca lo que cambió
+    void applyDesignChange(const SchemaDiff &diff);
+    
     // Configurar nombre de tabla
     void setTableName(const QString &tableName);
     
-    // Obtener datos ingresados
-    QList<QStringList> getAllPersonData() const;
+    // Obtener datos ingresados, por columnas según el tipo de cada campo
+    ColumnTable getAllPersonData() const;
     
     // Limpiar todos los datos
     void clearAllData();
@@ -58,22 +116,91 @@ public:
     void showSoftWarning(int row, int col, const QString& msg) const;
     QString formatCurrency(const QString& raw) const;
 
+    // Almacenamiento en disco: cada fila se guarda como registro del archivo .mad
+    bool openStorage(const QString &filePath, const QString &indexDir = QString());
+    void closeStorage();
+    bool hasStorage() const { return recordFile.isOpen(); }
+    
+    // Log del proyecto: cada edición se confirma como una transacción
+    // (llamar antes de openStorage)
+    void setWriteAheadLog(WriteAheadLog *log);
+
+    // Catálogo de esquemas del proyecto: la tabla le avisa su diseño y sus
+    // índices, y lo usa para abrir los índices sin leer cada archivo
+    void setSchemaCatalog(SchemaCatalog *catalog) { schemaCatalog = catalog; }
+    
+    // Búsqueda exacta por llave primaria usando el índice B (indexes/<tabla>.<campo>.btree)
+    int primaryKeyColumn() const;
+    std::optional<QStringList> findByPrimaryKey(qint64 key);
+    
+    // Índices secundarios con claves repetidas: kind "bplus" (indexes/<tabla>.<campo>.bplus)
+    // o "bstar" (árbol B*, .bstar). kind vacío elimina el índice del campo.
+    bool setFieldIndex(const QString &fieldName, const QString &kind);
+    QMap<QString, QString> fieldIndexes() const;
+    
+    // Búsqueda por rango sobre un campo indexado; un límite vacío queda abierto.
+    // Los valores se interpretan según el tipo del campo (número, moneda o fecha).
+    BPlusTreeIterator rangeScan(const QString &fieldName, const QString &low, const QString &high,
+                                bool lowInclusive = true, bool highInclusive = true);
+    
+    // Consulta con filtros, orden, campos y límite sobre los registros guardados
+    // (o sobre las filas de la vista si la tabla no tiene archivo). El plan
+    // elige entre recorrer el archivo completo o un rango de un índice B+/B*.
+    // La barra de filtro de la vista de datos la arma desde sus controles.
+    std::optional<QueryResult> runQuery(const Query &query, QString *error = nullptr);
+    
+    // Llenado de los nodos al (re)construir un índice completo (0.5 – 1.0)
+    void setIndexFillFactor(double fillFactor) { indexFill = fillFactor; }
+    double indexFillFactor() const { return indexFill; }
+    
+    // Importar un archivo CSV/TSV en segundo plano; las filas se agregan por
+    // lotes, cada lote en una transacción (ver TableImporter)
+    bool importFile(const QString &filePath);
+    bool isImporting() const { return tableImporter->isRunning(); }
+    
+    // Exportar a CSV o JSON Lines (según la extensión) sin cargar la tabla en
+    // memoria: toda la tabla, o los registros de un rango de un campo indexado
+    // (el botón Exportar lo usa cuando el filtro aplicado es un rango así)
+    bool exportTable(const QString &filePath);
+    bool exportRange(const QString &filePath, const QString &fieldName, const QString &low, const QString &high,
+                     bool lowInclusive = true, bool highInclusive = true);
+    bool isExporting() const { return tableExporter->isRunning(); }
 
 public slots:
-    void onPersonDataChanged(QTableWidgetItem *item);
+    void onPersonDataChanged(int row, int col);
+    void pasteFromClipboard();
 
 private slots:
     void addNewPersonRow();
     void removeEmptyRows();
     void onDesignViewClicked();
+    void onStorageCompacted(qint64 reclaimedBytes, qint64 elapsedMs);
+    void onRecordsMigrated(const QHash<quint64, RecordId> &moved);
+    void onSchemaMigrated(int rewritten, qint64 elapsedMs);
+    void onImportClicked();
+    void onImportedRows(const QVector<QStringList> &rows);
+    void onImportProgress(qint64 bytesDone, qint64 bytesTotal);
+    void onImportFinished(qint64 rows, qint64 rejectedCells, qint64 elapsedMs);
+    void onExportClicked();
+    void onExportProgress(qint64 rowsDone, qint64 rowCount);
+    void onExportFinished(qint64 rows, qint64 bytes, qint64 elapsedMs);
+    void onExportFailed(const QString &error);
+    void onFilterOperatorChanged();
+    void onApplyFilterClicked();
+    void onClearFilterClicked();
 
 signals:
     void switchToDesignView();
     void personDataChanged();
-    void dataUpdated(const QList<QStringList> &allData);
+    void dataUpdated(const ColumnTable &allData);
+    void storageCompacted(qint64 reclaimedBytes, qint64 elapsedMs);
+    void importFinished(qint64 rows, qint64 rejectedCells);
+    void exportFinished(qint64 rows, qint64 bytes);
 
 private:
     void createUI();
+    void setupDataView(const QStringList &fieldNames, const QStringList &fieldTypes,
+                       const QVector<int> &sourceColumns);
     void createHeader();
     void setupTableForPersonData();
     void configureColumnWidths();
@@ -82,12 +209,74 @@ private:
     void updateExampleData();
     QString generateExampleData(const QString &dataType, int column);
     
+    // Persistencia de filas
+    bool isExampleRow(int row) const;
+    QStringList rowValues(int row) const;
+    RecordId recordIdForRow(int row) const;
+    void setRecordIdForRow(int row, RecordId rid);
+    void persistRow(int row);
+    ColumnTable storedRows() const;
+    void rewriteAllRecords(const ColumnTable &rows);
+    void loadRowsFromStorage();
+    bool alterStorageSchema(const QVector<int> &sourceColumns);
+    void scheduleCompaction();
+    void removeRecord(RecordId rid);
+    void flushStorage();
+    void beginChange();
+    void commitChange();
+    // Deshace la transacción en curso; false si no había log con qué hacerlo
+    bool rollbackChange();
+    static int primaryKeyColumnFor(const QStringList &fieldNames, const QStringList &fieldTypes);
+    std::optional<qint64> primaryKeyFromValues(const QStringList &values) const;
+    bool rangeKeys(const QString &fieldName, const QString &low, const QString &high,
+                   std::optional<qint64> *lowKey, std::optional<qint64> *highKey) const;
+    void openPrimaryIndex();
+    void rebuildPrimaryIndex();
+    static QString indexKindName(IndexFile::Kind kind);
+    BPlusTree *openSecondaryIndex(const QString &fieldName, IndexFile::Kind kind);
+    void loadSecondaryIndexes();
+    void rebuildSecondaryIndex(BPlusTree *index);
+    void resetSecondaryIndexes();
+    bool renameSecondaryIndex(const QString &fieldName, const QString &newFieldName);
+    void closeSecondaryIndexes();
+    void syncSchemaCatalog();
+    void updateSecondaryIndexes(const QStringList *oldValues, RecordId oldRid,
+                                const QStringList *newValues, RecordId newRid);
+    void createFilterBar(QVBoxLayout *layout);
+    void refreshFilterFields();
+    std::optional<Query> filterQuery(QString *error) const;
+    void showQueryResult(const QueryResult &result);
+    void clearFilter();
+    void endImport(bool showRows);
+    bool exportFilterResult(const QString &filePath);
+    bool beginExport();
+    void endExport();
+    
     // UI Components
     QVBoxLayout *mainLayout;
     QWidget *headerWidget;
     QLabel *tableNameLabel;
     QPushButton *designViewBtn;
-    QTableWidget *dataTable;
+    QPushButton *importBtn;
+    QPushButton *exportBtn;
+    QProgressBar *transferProgress;
+    QTableView *dataTable;
+    TableDataModel *dataModel;
+    
+    // Barra de filtro y orden: mientras hay un filtro aplicado, el resultado
+    // (solo lectura) reemplaza a la tabla editable
+    QComboBox *filterFieldCombo;
+    QComboBox *filterOperatorCombo;
+    QLineEdit *filterValueEdit;
+    QLineEdit *filterValue2Edit;
+    QComboBox *sortFieldCombo;
+    QComboBox *sortOrderCombo;
+    QPushButton *clearFilterBtn;
+    QLabel *queryPlanLabel;
+    QTableView *queryResultTable;
+    QueryResultModel *queryResultModel;
+    std::optional<Query> activeQuery;
+    static constexpr int FilterRowLimit = 5000; // filas que se muestran del resultado
     
     // Data storage
     QStringList savedFieldNames;
@@ -97,6 +286,21 @@ private:
     
     // Delegates para estilo consistente con TableView
     DataFieldDelegate *dataFieldDelegate;
+    
+    // Archivo de registros de la tabla (vacío si la tabla no tiene proyecto)
+    RecordFile recordFile;
+    TableCompactor *storageCompactor;
+    SchemaMigrator *schemaMigrator;
+    TableImporter *tableImporter;
+    qint64 importedRows = 0;
+    qint64 importDuplicates = 0;     // filas con llave primaria repetida
+    TableExporter *tableExporter;
+    BTree primaryIndex;
+    QMap<QString, BPlusTree*> secondaryIndexes; // campo → índice
+    QString indexDirectory;
+    WriteAheadLog *writeAheadLog = nullptr;
+    SchemaCatalog *schemaCatalog = nullptr;
+    double indexFill = IndexBulkLoader::DefaultFillFactor;
 };
 
 #endif // TABLEDATA_H
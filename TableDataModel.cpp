@@ -0,0 +1,433 @@
+#include "TableDataModel.h"
+#include <QColor>
+#include <QDebug>
+
+TableDataModel::TableDataModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_valueCache(RowCacheSize)
+{
+    // Fuente más grande para consistencia con el editor
+    m_cellFont.setPointSize(16);
+    m_exampleFont = m_cellFont;
+    m_exampleFont.setItalic(true); // Cursiva para indicar que es ejemplo
+}
+
+void TableDataModel::setFields(const QStringList &names, const QStringList &types,
+                               const QVector<int> &sourceColumns)
+{
+    beginResetModel();
+    m_fieldNames = names;
+    m_fieldTypes = types;
+
+    // Solo se reacomodan los valores en memoria; los del archivo se leen con
+    // el esquema que tenga el archivo
+    if (!sourceColumns.isEmpty()) {
+        for (Row &row : m_rows) {
+            if (row.values.isEmpty()) continue;
+            QStringList values;
+            for (int col = 0; col < names.size(); col++) {
+                const int source = sourceColumns.value(col, -1);
+                values << (source >= 0 ? row.values.value(source) : QString());
+            }
+            row.values = values;
+        }
+    }
+    // Con otros campos cambia lo que se pinta en todas las filas
+    for (Row &row : m_rows)
+        row.revision = m_nextRevision++;
+    m_example.clear();
+    m_valueCache.clear();
+    m_cellErrors.clear();
+    endResetModel();
+}
+
+void TableDataModel::setRecordFile(RecordFile *file)
+{
+    beginResetModel();
+    m_file = file;
+    m_rows.clear();
+    m_fetchedRows = 0;
+    m_knownRecords.clear();
+    m_valueCache.clear();
+    m_cellErrors.clear();
+    m_example.clear();
+    if (m_file && m_file->isOpen())
+        m_cursor.emplace(m_file);
+    else
+        m_cursor.reset();
+    endResetModel();
+}
+
+void TableDataModel::setExampleRow(const QStringList &values)
+{
+    clearExampleRow();
+    if (values.isEmpty()) return;
+
+    clearCellErrors();
+    beginInsertRows(QModelIndex(), 0, 0);
+    m_example = values;
+    m_exampleRevision = m_nextRevision++;
+    endInsertRows();
+}
+
+void TableDataModel::clearExampleRow()
+{
+    if (!hasExampleRow()) return;
+
+    clearCellErrors();
+    beginRemoveRows(QModelIndex(), 0, 0);
+    m_example.clear();
+    endRemoveRows();
+}
+
+void TableDataModel::appendRow(const QStringList &values)
+{
+    const int row = rowCount();
+    beginInsertRows(QModelIndex(), row, row);
+    Row newRow;
+    newRow.values = values;
+    newRow.revision = m_nextRevision++;
+    m_rows.append(newRow);
+    endInsertRows();
+}
+
+QStringList TableDataModel::padded(QStringList values) const
+{
+    while (values.size() < m_fieldNames.size())
+        values << QString();
+    return values;
+}
+
+QStringList TableDataModel::storedValues(RecordId rid) const
+{
+    if (const QStringList *cached = m_valueCache.object(rid.toUInt64()))
+        return *cached;
+    if (!m_file)
+        return padded(QStringList());
+
+    const std::optional<QStringList> values = m_file->read(rid);
+    if (!values) {
+        qDebug() << "WARNING: No se pudo leer el registro" << rid.page << rid.slot << ":" << m_file->errorString();
+        return padded(QStringList());
+    }
+    m_valueCache.insert(rid.toUInt64(), new QStringList(*values));
+    return *values;
+}
+
+QStringList TableDataModel::rowValues(int row) const
+{
+    if (isExampleRow(row))
+        return padded(m_example);
+
+    const int i = row - firstDataRow();
+    if (i < 0 || i >= m_rows.size())
+        return QStringList();
+
+    const Row &r = m_rows.at(i);
+    if (!r.values.isEmpty() || !r.rid.isValid())
+        return padded(r.values);
+    return padded(storedValues(r.rid));
+}
+
+RecordId TableDataModel::recordIdForRow(int row) const
+{
+    const int i = row - firstDataRow();
+    if (isExampleRow(row) || i < 0 || i >= m_rows.size())
+        return RecordId();
+    return m_rows.at(i).rid;
+}
+
+void TableDataModel::setRecordIdForRow(int row, RecordId rid)
+{
+    const int i = row - firstDataRow();
+    if (isExampleRow(row) || i < 0 || i >= m_rows.size())
+        return;
+
+    Row &r = m_rows[i];
+    if (r.rid.isValid()) {
+        // Sin registro la fila conserva sus valores en memoria
+        if (!rid.isValid() && r.values.isEmpty())
+            r.values = storedValues(r.rid);
+        m_knownRecords.remove(r.rid.toUInt64());
+        m_valueCache.remove(r.rid.toUInt64());
+    }
+    if (rid.isValid()) {
+        // Lo que había en memoria es ahora el contenido del registro
+        if (!r.values.isEmpty())
+            m_valueCache.insert(rid.toUInt64(), new QStringList(padded(r.values)));
+        r.values.clear();
+        m_knownRecords.insert(rid.toUInt64());
+    }
+    r.rid = rid;
+}
+
+void TableDataModel::remapRecordIds(const QHash<quint64, RecordId> &moved)
+{
+    if (moved.isEmpty()) return;
+
+    m_knownRecords.clear();
+    for (Row &row : m_rows) {
+        if (!row.rid.isValid()) continue;
+        row.rid = moved.value(row.rid.toUInt64(), row.rid);
+        m_knownRecords.insert(row.rid.toUInt64());
+    }
+    m_valueCache.clear();
+
+    // El archivo se reescribió: el recorrido pendiente vuelve a empezar y
+    // salta los registros que ya tienen fila
+    if (m_cursor)
+        m_cursor.emplace(m_file);
+}
+
+void TableDataModel::setCellError(int row, int column, const QString &message)
+{
+    if (row < 0 || row >= rowCount() || column < 0 || column >= columnCount())
+        return;
+    m_cellErrors.insert(cellKey(row, column), message);
+    touchRow(row);
+    const QModelIndex idx = index(row, column);
+    emit dataChanged(idx, idx, { Qt::BackgroundRole, Qt::ToolTipRole });
+}
+
+void TableDataModel::clearCellError(int row, int column)
+{
+    if (!m_cellErrors.remove(cellKey(row, column)))
+        return;
+    touchRow(row);
+    const QModelIndex idx = index(row, column);
+    emit dataChanged(idx, idx, { Qt::BackgroundRole, Qt::ToolTipRole });
+}
+
+quint64 TableDataModel::renderRevision(int row) const
+{
+    if (isExampleRow(row))
+        return m_exampleRevision;
+    const int i = row - firstDataRow();
+    if (i < 0 || i >= m_rows.size())
+        return 0;
+    return m_rows.at(i).revision;
+}
+
+void TableDataModel::touchRow(int row)
+{
+    if (isExampleRow(row)) {
+        m_exampleRevision = m_nextRevision++;
+        return;
+    }
+    const int i = row - firstDataRow();
+    if (i >= 0 && i < m_rows.size())
+        m_rows[i].revision = m_nextRevision++;
+}
+
+void TableDataModel::clearCellErrors()
+{
+    // Las filas marcadas se vuelven a pintar sin la marca
+    for (auto it = m_cellErrors.constBegin(); it != m_cellErrors.constEnd(); ++it)
+        touchRow(int(it.key() >> 32));
+    m_cellErrors.clear();
+}
+
+int TableDataModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    return firstDataRow() + m_rows.size();
+}
+
+int TableDataModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    return m_fieldNames.size();
+}
+
+QVariant TableDataModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount() || index.column() >= columnCount())
+        return QVariant();
+
+    const int row = index.row();
+    const int col = index.column();
+
+    if (isExampleRow(row)) {
+        switch (role) {
+        case Qt::DisplayRole:
+        case Qt::EditRole:
+            return m_example.value(col);
+        case Qt::FontRole:
+            return m_exampleFont;
+        case Qt::ForegroundRole:
+            return QColor(156, 163, 175); // Color gris
+        case Qt::BackgroundRole:
+            return QColor(249, 250, 251); // Fondo gris muy claro
+        case Qt::ToolTipRole:
+            return QStringLiteral("Fila de ejemplo - muestra cómo se verán los datos");
+        default:
+            return QVariant();
+        }
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return rowValues(row).value(col);
+    case Qt::FontRole:
+        return m_cellFont;
+    case Qt::BackgroundRole:
+        return m_cellErrors.contains(cellKey(row, col)) ? QColor("#FEE2E2") // rojo suave
+                                                        : QColor(255, 255, 255);
+    case Qt::ToolTipRole: {
+        const auto it = m_cellErrors.constFind(cellKey(row, col));
+        return it != m_cellErrors.constEnd() ? QVariant(*it) : QVariant();
+    }
+    default:
+        return QVariant();
+    }
+}
+
+bool TableDataModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (role != Qt::EditRole || !index.isValid() || isExampleRow(index.row()))
+        return false;
+
+    const int i = index.row() - firstDataRow();
+    if (i < 0 || i >= m_rows.size() || index.column() >= columnCount())
+        return false;
+
+    QStringList values = rowValues(index.row());
+    const QString text = value.toString();
+    if (values.at(index.column()) == text)
+        return true;
+
+    // La edición queda en memoria hasta que la fila se guarde
+    values[index.column()] = text;
+    m_rows[i].values = values;
+    m_rows[i].revision = m_nextRevision++;
+
+    emit dataChanged(index, index, { Qt::DisplayRole, Qt::EditRole });
+    emit cellEdited(index.row(), index.column());
+    return true;
+}
+
+Qt::ItemFlags TableDataModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+    // NO EDITABLE - la fila de ejemplo solo muestra cómo se verán los datos
+    if (isExampleRow(index.row()))
+        return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable;
+}
+
+QVariant TableDataModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
+        return m_fieldNames.value(section);
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+bool TableDataModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    const int first = row - firstDataRow();
+    if (parent.isValid() || count <= 0 || first < 0 || first + count > m_rows.size())
+        return false;
+
+    clearCellErrors();
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    for (int i = first; i < first + count; i++) {
+        if (m_rows.at(i).rid.isValid())
+            m_knownRecords.remove(m_rows.at(i).rid.toUInt64());
+    }
+    m_rows.remove(first, count);
+    m_fetchedRows -= qBound(0, m_fetchedRows - first, count);
+    endRemoveRows();
+    return true;
+}
+
+bool TableDataModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_cursor.has_value();
+}
+
+void TableDataModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid() || !m_cursor) return;
+
+    QVector<Row> batch;
+    batch.reserve(FetchBatchSize);
+    while (batch.size() < FetchBatchSize) {
+        if (!m_cursor->next()) {
+            m_cursor.reset();
+            break;
+        }
+        // Registros que ya tienen fila: agregados desde la vista o movidos por una edición
+        const quint64 key = m_cursor->recordId().toUInt64();
+        if (m_knownRecords.contains(key))
+            continue;
+        m_knownRecords.insert(key);
+        m_valueCache.insert(key, new QStringList(m_cursor->values()));
+
+        Row row;
+        row.rid = m_cursor->recordId();
+        row.revision = m_nextRevision++;
+        batch.append(row);
+    }
+    if (batch.isEmpty()) return;
+
+    // Las filas del archivo van antes de las filas nuevas de la vista
+    const int first = firstDataRow() + m_fetchedRows;
+    clearCellErrors(); // las marcas de las filas nuevas cambiarían de índice
+    beginInsertRows(QModelIndex(), first, first + batch.size() - 1);
+    m_rows.insert(m_fetchedRows, batch.size(), Row());
+    for (int i = 0; i < batch.size(); i++)
+        m_rows[m_fetchedRows + i] = batch.at(i);
+    m_fetchedRows += batch.size();
+    endInsertRows();
+}
+
+// --- QueryResultModel ---
+
+QueryResultModel::QueryResultModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void QueryResultModel::setResult(const QueryResult &result, int rowLimit)
+{
+    beginResetModel();
+    m_fieldNames = result.fieldNames;
+    m_rows = result.rows.mid(0, rowLimit);
+    endResetModel();
+}
+
+void QueryResultModel::clear()
+{
+    beginResetModel();
+    m_fieldNames.clear();
+    m_rows.clear();
+    endResetModel();
+}
+
+int QueryResultModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+int QueryResultModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_fieldNames.size();
+}
+
+QVariant QueryResultModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole || index.row() >= m_rows.size())
+        return QVariant();
+    return m_rows.at(index.row()).value(index.column());
+}
+
+QVariant QueryResultModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    if (orientation == Qt::Horizontal)
+        return m_fieldNames.value(section);
+    return section + 1;
+}
@@ -0,0 +1,147 @@
+#ifndef TABLEDATAMODEL_H
+#define TABLEDATAMODEL_H
+
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QFont>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+#include <optional>
+#include "RecordFile.h"
+#include "QueryEngine.h"
+
+// Modelo de la Vista Datos sobre el archivo .mad de la tabla.
+//
+// Las filas se traen del archivo por lotes (canFetchMore/fetchMore) a medida
+// que la vista se desplaza, así que abrir una tabla no depende de cuántos
+// registros tenga. De cada fila solo se guarda su RecordId; los valores se
+// leen del archivo al pintarla y quedan en una caché acotada (RowCacheSize).
+//
+// Límite: las filas traídas no se sueltan. Cada una deja un Row (24 bytes) en
+// m_rows y su RecordId en m_knownRecords hasta el próximo setRecordFile(), así
+// que la memoria crece con lo que el usuario se desplazó (unos 60 bytes por
+// registro: ~60 MB tras recorrer un millón) y no con la parte visible.
+//
+// Solo viven en memoria las filas sin registro (tablas sin proyecto, la fila
+// vacía para seguir escribiendo) y las ediciones que todavía no se guardaron.
+// La fila de ejemplo, si existe, es siempre la fila 0.
+class TableDataModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int FetchBatchSize = 256;
+    static constexpr int RowCacheSize = 4096;
+
+    explicit TableDataModel(QObject *parent = nullptr);
+
+    // Campos de la tabla. sourceColumns indica, para cada campo nuevo, su
+    // columna anterior (-1 si es nuevo) y reacomoda las filas en memoria.
+    void setFields(const QStringList &names, const QStringList &types,
+                   const QVector<int> &sourceColumns = QVector<int>());
+    QStringList fieldNames() const { return m_fieldNames; }
+
+    // Descarta las filas y vuelve a recorrer el archivo desde el principio
+    // (nullptr: tabla solo en memoria)
+    void setRecordFile(RecordFile *file);
+    bool isFullyFetched() const { return !m_cursor; }
+
+    // Fila de ejemplo (fila 0, no editable)
+    void setExampleRow(const QStringList &values);
+    void clearExampleRow();
+    bool hasExampleRow() const { return !m_example.isEmpty(); }
+    bool isExampleRow(int row) const { return hasExampleRow() && row == 0; }
+
+    // Filas de datos
+    void appendRow(const QStringList &values = QStringList());
+    QStringList rowValues(int row) const;
+    RecordId recordIdForRow(int row) const;
+    // Con un registro válido la edición pendiente se da por guardada
+    void setRecordIdForRow(int row, RecordId rid);
+    // Tras compactar: nuevo identificador de los registros que se movieron
+    void remapRecordIds(const QHash<quint64, RecordId> &moved);
+
+    // Marca de celda inválida (fondo rojo suave + tooltip)
+    void setCellError(int row, int column, const QString &message);
+    void clearCellError(int row, int column);
+
+    // Versión de lo que se pinta en la fila: cambia con cada edición, marca de
+    // error o cambio de campos, y nunca se repite entre filas distintas, así
+    // que (fila, columna, versión) identifica el contenido de una celda
+    // aunque las filas se corran al traer o borrar. 0 si la fila no existe.
+    quint64 renderRevision(int row) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+signals:
+    // El usuario cambió el valor de una celda (no se emite al cargar filas)
+    void cellEdited(int row, int column);
+
+private:
+    struct Row {
+        RecordId rid;
+        QStringList values;     // vacío: los valores están en el archivo
+        quint64 revision = 0;   // ver renderRevision()
+    };
+
+    int firstDataRow() const { return hasExampleRow() ? 1 : 0; }
+    QStringList storedValues(RecordId rid) const;
+    QStringList padded(QStringList values) const;
+    static quint64 cellKey(int row, int column) { return (quint64(quint32(row)) << 32) | quint32(column); }
+    void touchRow(int row);
+    void clearCellErrors();
+
+    QStringList m_fieldNames;
+    QStringList m_fieldTypes;
+    QStringList m_example;
+
+    RecordFile *m_file = nullptr;
+    std::optional<RecordCursor> m_cursor;     // sin valor: ya se trajeron todos los registros
+    QVector<Row> m_rows;
+    int m_fetchedRows = 0;                     // filas traídas del archivo (al inicio de m_rows)
+    QSet<quint64> m_knownRecords;              // registros que ya tienen fila (crece como m_rows)
+    mutable QCache<quint64, QStringList> m_valueCache;
+
+    QHash<quint64, QString> m_cellErrors;
+    quint64 m_nextRevision = 1;
+    quint64 m_exampleRevision = 0;
+    QFont m_cellFont;
+    QFont m_exampleFont;
+};
+
+// Resultado de un filtro de la Vista Datos (solo lectura).
+//
+// Guarda las filas que devolvió la consulta, hasta rowLimit, y las entrega
+// tal cual a la vista: no hay un QTableWidgetItem por celda y la vista solo
+// pide las celdas visibles.
+class QueryResultModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit QueryResultModel(QObject *parent = nullptr);
+
+    void setResult(const QueryResult &result, int rowLimit);
+    void clear();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    QStringList m_fieldNames;
+    QList<QStringList> m_rows;
+};
+
+#endif // TABLEDATAMODEL_H
@@ -3,14 +3,35 @@
 #include <QDebug>
 #include <QTimer>
 #include <QMessageBox>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
 
 TableEditor::TableEditor(QWidget *parent)
     : QWidget(parent), isDarkTheme(false)
 {
+    // Sin proyecto el catálogo vive solo en memoria
+    projectSchemas = new SchemaCatalog(this);
     setupUI();
     styleComponents();
 }
 
+TableEditor::~TableEditor()
+{
+    // Las tablas se cierran antes que el log: el último checkpoint deja todo en disco
+    for (TableData *data : qAsConst(tableDatas))
+        data->closeStorage();
+    if (projectLog)
+        projectLog->close();
+
+    // Con la fecha de cada .mad ya cerrado, la próxima apertura no los vuelve a leer
+    if (projectPaths) {
+        for (auto it = tableDatas.cbegin(); it != tableDatas.cend(); ++it)
+            projectSchemas->updateFileStamp(it.key(), tableFilePath(it.key()));
+    }
+    projectSchemas->save();
+}
+
 void TableEditor::setupUI()
 {
     // Main layout
@@ -551,6 +572,18 @@ void TableEditor::onSaveClicked()
 
     QString tableName = tableNameInput->text().trimmed();
 
+    // Dos nombres distintos no pueden compartir el mismo .mad ("a b" y "a_b")
+    const QString fileName = tableFileName(tableName);
+    for (int i = 0; i < tableTree->topLevelItemCount(); ++i) {
+        const QString existing = tableTree->topLevelItem(i)->text(0);
+        if (existing != tableName && tableFileName(existing) == fileName) {
+            QMessageBox::warning(this, "Error",
+                                 QString("El nombre \"%1\" se guardaría en el mismo archivo que la tabla \"%2\". "
+                                         "Elige otro nombre.").arg(tableName, existing));
+            return;
+        }
+    }
+
     hideCreateTablePanel();
 
     // Si no existe ya en el sidebar, agregarlo
@@ -619,6 +652,9 @@ void TableEditor::hideCreateTablePanel()
 
 void TableEditor::showTableView(const QString &tableName)
 {
+    // Cambios de diseño que todavía esperaban en la tabla anterior
+    if (TableView *previous = tableViews.value(currentTableName))
+        previous->flushDesignChange();
     currentTableName = tableName;
 
     // 1) Crear o recuperar el TableView de cache
@@ -631,21 +667,37 @@ void TableEditor::showTableView(const QString &tableName)
         view->updateTheme(isDarkTheme);
         view->setProperty("tableName", tableName);
 
+        // Si la tabla ya tiene diseño (p. ej. cargado del proyecto), mostrarlo
+        if (const std::optional<TableSchema> schema = projectSchemas->table(tableName))
+            view->setFields(schema->fieldNames(), schema->fieldTypes());
+
         // Conexiones SOLO al crearlo (UniqueConnection por seguridad)
         connect(view, &TableView::switchToDataView, this, [this]() {
             switchToDataView();
         }, Qt::UniqueConnection);
 
         connect(view, &TableView::tableDesignChanged, this,
-                [this, tableName](const QStringList &fieldNames, const QStringList &fieldTypes) {
-                    // Guardar diseño en "arreglos" por tabla
-                    TableDesignData &d = tableDesigns[tableName];
-                    d.fieldNames = fieldNames;
-                    d.fieldTypes = fieldTypes;
-                    // Si existe su TableData, sincronizar
+                [this, tableName](const SchemaDiff &diff) {
+                    // Guardar diseño en el catálogo del proyecto
+                    projectSchemas->setTableFields(tableName, diff.fieldNames(), diff.fieldTypes());
+                    // Si existe su TableData, aplicarle solo lo que cambió
                     if (tableDatas.contains(tableName) && tableDatas.value(tableName)) {
-                        tableDatas.value(tableName)->setupDataView(fieldNames, fieldTypes);
+                        tableDatas.value(tableName)->applyDesignChange(diff);
+                    }
+                }, Qt::UniqueConnection);
+
+        // Índice secundario elegido en la cuadrícula de diseño
+        connect(view, &TableView::fieldIndexChanged, this,
+                [this, tableName, view](const QString &fieldName, const QString &indexKind) {
+                    TableData *data = tableDatas.value(tableName);
+                    if (!data) return;
+                    if (!data->setFieldIndex(fieldName, indexKind)) {
+                        QMessageBox::warning(this, "Índice",
+                                             QString("No se pudo indexar el campo \"%1\".\n"
+                                                     "Solo se indexan campos Entero, Decimales, moneda y fecha "
+                                                     "de tablas guardadas en un proyecto.").arg(fieldName));
                     }
+                    view->setFieldIndexes(data->fieldIndexes());
                 }, Qt::UniqueConnection);
 
         tableViews.insert(tableName, view);
@@ -665,12 +717,12 @@ void TableEditor::showTableView(const QString &tableName)
         }, Qt::UniqueConnection);
 
         // Si ya hay diseño guardado, aplicarlo
-        if (tableDesigns.contains(tableName)) {
-            const auto &d = tableDesigns.value(tableName);
-            data->setupDataView(d.fieldNames, d.fieldTypes);
-        }
+        if (const std::optional<TableSchema> schema = projectSchemas->table(tableName))
+            data->setupDataView(schema->fieldNames(), schema->fieldTypes());
+        attachTableStorage(tableName, data);
         tableDatas.insert(tableName, data);
     }
+    view->setFieldIndexes(data->fieldIndexes());
 
     // 3) Mostrar SOLO el view (diseño) ahora
     //    Limpia layout principal y añade el que corresponde (sin borrar caches)
@@ -686,24 +738,32 @@ void TableEditor::showTableView(const QString &tableName)
 }
 
 
-void TableEditor::addTableToSidebar(const QString &tableName)
+QTreeWidgetItem *TableEditor::addTableToSidebar(const QString &tableName)
 {
-    // Create new tree widget item for the table
+    // Los clics llegan a onSidebarItemClicked (conectado en createLeftPanel)
     auto *tableItem = new QTreeWidgetItem(tableTree);
     tableItem->setText(0, tableName);
     tableItem->setIcon(0, QIcon("🗄️")); // You can use a proper icon here
-    
-    // Connect item click to show the table
-    connect(tableTree, &QTreeWidget::itemClicked, this, [this](QTreeWidgetItem *item) {
-        if (item) {
-            QString selectedTableName = item->text(0);
-            showTableView(selectedTableName);
-        }
-    });
+    return tableItem;
+}
+
+void TableEditor::setSidebarItemPending(QTreeWidgetItem *item, bool pending)
+{
+    // Una tabla del catálogo cuyo esquema todavía no se leyó no se puede abrir
+    if (pending) {
+        item->setFlags(item->flags() & ~Qt::ItemIsEnabled);
+        item->setToolTip(0, "Cargando…");
+    } else {
+        item->setFlags(item->flags() | Qt::ItemIsEnabled);
+        item->setToolTip(0, QString());
+        item->setData(0, Qt::UserRole, QVariant());
+    }
 }
 
 void TableEditor::showTableDataView(const QString &tableName)
 {
+    if (TableView *previous = tableViews.value(currentTableName))
+        previous->flushDesignChange();
     currentTableName = tableName;
 
     // Asegura que existen en cache
@@ -711,6 +771,8 @@ void TableEditor::showTableDataView(const QString &tableName)
         tableViews.insert(tableName, new TableView(this));
         tableViews[tableName]->setTableName(tableName);
         tableViews[tableName]->updateTheme(isDarkTheme);
+        if (const std::optional<TableSchema> schema = projectSchemas->table(tableName))
+            tableViews[tableName]->setFields(schema->fieldNames(), schema->fieldTypes());
         connect(tableViews[tableName], &TableView::switchToDataView, this, [this]() {
             switchToDataView();
         }, Qt::UniqueConnection);
@@ -722,10 +784,9 @@ void TableEditor::showTableDataView(const QString &tableName)
             switchToDesignView();
         }, Qt::UniqueConnection);
 
-        if (tableDesigns.contains(tableName)) {
-            const auto &d = tableDesigns.value(tableName);
-            tableDatas[tableName]->setupDataView(d.fieldNames, d.fieldTypes);
-        }
+        if (const std::optional<TableSchema> schema = projectSchemas->table(tableName))
+            tableDatas[tableName]->setupDataView(schema->fieldNames(), schema->fieldTypes());
+        attachTableStorage(tableName, tableDatas[tableName]);
     }
 
     // Mostrar solo Data
@@ -801,7 +862,122 @@ void TableEditor::switchToDesignView()
 
 void TableEditor::onSidebarItemClicked(QTreeWidgetItem *item, int /*column*/)
 {
-    if (!item) return;
+    if (!item || !(item->flags() & Qt::ItemIsEnabled)) return;
     const QString selectedTableName = item->text(0);
     showTableView(selectedTableName);   // o showTableDataView si quieres abrir en datos
 }
+
+void TableEditor::setProjectName(const QString &name)
+{
+    projectName = name;
+
+    // Hasta tener las tablas del proyecto no se crean tablas nuevas
+    newTableBtn->setEnabled(false);
+    delete projectOpener;
+    projectOpener = new ProjectOpener(name, this);
+    connect(projectOpener, &ProjectOpener::catalogLoaded, this, &TableEditor::onProjectCatalogLoaded);
+    connect(projectOpener, &ProjectOpener::storageReady, this, &TableEditor::onProjectStorageReady);
+    connect(projectOpener, &ProjectOpener::schemaCatalogRead, projectSchemas, &SchemaCatalog::reset);
+    connect(projectOpener, &ProjectOpener::tableSchemaLoaded, this, &TableEditor::onTableSchemaLoaded);
+    connect(projectOpener, &ProjectOpener::finished, this, &TableEditor::onProjectOpenFinished);
+    projectOpener->start();
+}
+
+void TableEditor::onProjectCatalogLoaded(const ProjectInfoQt &info)
+{
+    // Las tablas que conoce el catálogo se muestran ya, sin poder abrirse
+    // hasta que llegue su esquema
+    for (const QString &baseName : info.tableNames) {
+        if (!tableTree->findItems(baseName, Qt::MatchExactly).isEmpty())
+            continue;
+        QTreeWidgetItem *item = addTableToSidebar(baseName);
+        item->setData(0, Qt::UserRole, baseName);
+        setSidebarItemPending(item, true);
+    }
+}
+
+void TableEditor::onProjectStorageReady(const ProjectPathsQt &paths)
+{
+    projectPaths = paths;
+    projectSchemas->setPath(SchemaCatalog::pathFor(paths.root));
+
+    // El log ya se recuperó en segundo plano: abrirlo aquí no rehace nada
+    delete projectLog;
+    projectLog = new WriteAheadLog(this);
+    if (!projectLog->open(projectPaths->root, projectPaths->logs)) {
+        qDebug() << "ERROR: No se pudo abrir el log del proyecto:" << projectLog->errorString();
+        delete projectLog;
+        projectLog = nullptr;
+    }
+}
+
+void TableEditor::onTableSchemaLoaded(const TableSchema &schema)
+{
+    // Igual a lo que ya tenía el catálogo (el .mad no cambió): no se guarda nada
+    projectSchemas->setTable(schema);
+
+    // El lugar que reservó el catálogo de proyectos, si lo hay
+    for (int i = 0; i < tableTree->topLevelItemCount(); ++i) {
+        QTreeWidgetItem *item = tableTree->topLevelItem(i);
+        if (item->data(0, Qt::UserRole).toString() == schema.fileName) {
+            item->setText(0, schema.name);
+            setSidebarItemPending(item, false);
+            return;
+        }
+    }
+    if (tableTree->findItems(schema.name, Qt::MatchExactly).isEmpty())
+        addTableToSidebar(schema.name);
+}
+
+void TableEditor::onProjectOpenFinished()
+{
+    // Lo que el catálogo tenía y ya no está en disco
+    for (int i = tableTree->topLevelItemCount() - 1; i >= 0; --i) {
+        QTreeWidgetItem *item = tableTree->topLevelItem(i);
+        if (!(item->flags() & Qt::ItemIsEnabled))
+            delete tableTree->takeTopLevelItem(i);
+    }
+    // Tablas del catálogo de esquemas cuyo .mad ya no existe
+    if (projectPaths) {
+        const QStringList loaded = projectOpener->loadedTables();
+        for (const QString &tableName : projectSchemas->tableNames()) {
+            if (!loaded.contains(tableName))
+                projectSchemas->removeTable(tableName);
+        }
+        projectSchemas->save();
+    }
+    newTableBtn->setEnabled(true);
+    qDebug() << "DEBUG: Tablas cargadas del proyecto:" << projectOpener->telemetry().tables;
+}
+
+QString TableEditor::tableFileName(const QString &tableName)
+{
+    // Nombre de archivo seguro: solo letras, dígitos, '_' y '-'. No es
+    // reversible, por eso onSaveClicked() rechaza los nombres que chocan.
+    QString fileName;
+    for (const QChar c : tableName) {
+        fileName.append((c.isLetterOrNumber() || c == '_' || c == '-') ? c : QChar('_'));
+    }
+    return fileName;
+}
+
+QString TableEditor::tableFilePath(const QString &tableName) const
+{
+    if (!projectPaths) return QString();
+    return QDir(projectPaths->tables).filePath(tableFileName(tableName) + ".mad");
+}
+
+void TableEditor::attachTableStorage(const QString &tableName, TableData *data)
+{
+    if (!data) return;
+    data->setSchemaCatalog(projectSchemas);
+    if (!projectPaths) return;
+    data->setWriteAheadLog(projectLog);
+
+    // El archivo de registros y los índices se abren recién al usar la tabla
+    QElapsedTimer clock;
+    clock.start();
+    data->openStorage(tableFilePath(tableName), projectPaths->indexes);
+    qDebug() << "DEBUG: Tabla" << tableName << "abierta al primer uso en" << clock.elapsed() << "ms"
+             << "(" << (projectOpener ? projectOpener->elapsedMs() : 0) << "ms desde que se abrió el proyecto)";
+}
@@ -21,15 +21,12 @@
 #include <QPropertyAnimation>
 #include <QParallelAnimationGroup>
 #include <QMap>
+#include <optional>
 #include "TableView.h"
 #include "TableData.h"
-
-// Structure to store table design data
-struct TableDesignData {
-    QStringList fieldNames;
-    QStringList fieldTypes;
-    QStringList fieldDescriptions;
-};
+#include "projectpathsqt.h"
+#include "ProjectOpener.h"
+#include "SchemaCatalog.h"
 
 // Clickable widget class
 class ClickableWidget : public QWidget
@@ -56,7 +53,15 @@ class TableEditor : public QWidget
 
 public:
     explicit TableEditor(QWidget *parent = nullptr);
+    ~TableEditor() override;
     void updateTheme(bool isDark);
+    
+    // Enlaza el editor con la carpeta del proyecto. La apertura sigue en segundo
+    // plano: las tablas aparecen en la barra lateral a medida que se leen
+    void setProjectName(const QString &name);
+
+    // Diseño de las tablas del proyecto, compartido con TableData y RelationshipsView
+    SchemaCatalog *schemaCatalog() const { return projectSchemas; }
 
 private slots:
     void onCreateTableClicked();
@@ -67,6 +72,10 @@ private slots:
     void onSaveClicked();
     void onDeleteColumnClicked();
     void onSidebarItemClicked(QTreeWidgetItem *item, int column);
+    void onProjectCatalogLoaded(const ProjectInfoQt &info);
+    void onProjectStorageReady(const ProjectPathsQt &paths);
+    void onTableSchemaLoaded(const TableSchema &schema);
+    void onProjectOpenFinished();
 
 private:
     void setupUI();
@@ -74,7 +83,8 @@ private:
     void createRightPanel();
     void createTableCreationPanel();
     void styleComponents();
-    void addTableToSidebar(const QString &tableName);
+    QTreeWidgetItem *addTableToSidebar(const QString &tableName);
+    void setSidebarItemPending(QTreeWidgetItem *item, bool pending);
     void updateTableList();
     void createMainTableArea();
     void showWelcomeContent();
@@ -93,6 +103,9 @@ private:
     void updateSearchComponentsTheme(bool isDark);
     void updateTreeWidgetTheme(bool isDark);
     void updateEmptyStateTheme(bool isDark);
+    static QString tableFileName(const QString &tableName);
+    QString tableFilePath(const QString &tableName) const;
+    void attachTableStorage(const QString &tableName, TableData *data);
     
     // UI Components
     QHBoxLayout *mainLayout;
@@ -137,10 +150,16 @@ private:
     // Table instances and data
     TableView *currentTableView;
     TableData *currentTableData;
-    QMap<QString, TableDesignData> tableDesigns;
+    SchemaCatalog *projectSchemas;          // schema.meta del proyecto
     QMap<QString, TableView*> tableViews;
     QMap<QString, TableData*> tableDatas;
     QString currentTableName;
+    
+    // Proyecto abierto (sin valor si el editor no tiene proyecto)
+    QString projectName;
+    std::optional<ProjectPathsQt> projectPaths;
+    WriteAheadLog *projectLog = nullptr;   // logs/miniaccess.wal
+    ProjectOpener *projectOpener = nullptr; // apertura en curso (o la última)
 };
 
 #endif // TABLEEDITOR_H
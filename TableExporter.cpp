@@ -0,0 +1,394 @@
+#include "TableExporter.h"
+
+#include <QDebug>
+#include <QFileInfo>
+
+namespace {
+// Reinicios permitidos por escrituras concurrentes antes de abandonar la exportación
+constexpr int MaxRestarts = 3;
+// 0 ms: entre ticks corren los eventos de la interfaz
+constexpr int TickIntervalMs = 0;
+
+// Código de un carácter (o de un par sustituto) en UTF-8
+inline int appendUtf8(QByteArray &out, const QChar *chars, int i, int length)
+{
+    uint code = chars[i].unicode();
+    int used = 1;
+    if (QChar::isHighSurrogate(code) && i + 1 < length && chars[i + 1].isLowSurrogate()) {
+        code = QChar::surrogateToUcs4(chars[i], chars[i + 1]);
+        used = 2;
+    }
+    if (code < 0x80) {
+        out.append(char(code));
+    } else if (code < 0x800) {
+        out.append(char(0xC0 | (code >> 6)));
+        out.append(char(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        out.append(char(0xE0 | (code >> 12)));
+        out.append(char(0x80 | ((code >> 6) & 0x3F)));
+        out.append(char(0x80 | (code & 0x3F)));
+    } else {
+        out.append(char(0xF0 | (code >> 18)));
+        out.append(char(0x80 | ((code >> 12) & 0x3F)));
+        out.append(char(0x80 | ((code >> 6) & 0x3F)));
+        out.append(char(0x80 | (code & 0x3F)));
+    }
+    return used;
+}
+
+void appendCsvField(QByteArray &out, const QString &value)
+{
+    const QChar *chars = value.constData();
+    const int length = value.size();
+    bool quote = false;
+    for (int i = 0; i < length && !quote; i++) {
+        const ushort c = chars[i].unicode();
+        quote = c == ',' || c == '"' || c == '\n' || c == '\r';
+    }
+
+    if (quote) out.append('"');
+    for (int i = 0; i < length;) {
+        if (chars[i] == QLatin1Char('"'))
+            out.append('"');
+        i += appendUtf8(out, chars, i, length);
+    }
+    if (quote) out.append('"');
+}
+
+void appendJsonString(QByteArray &out, const QString &value)
+{
+    static const char hex[] = "0123456789abcdef";
+    const QChar *chars = value.constData();
+    const int length = value.size();
+    out.append('"');
+    for (int i = 0; i < length;) {
+        const ushort c = chars[i].unicode();
+        if (c == '"' || c == '\\') {
+            out.append('\\');
+            out.append(char(c));
+        } else if (c == '\n') {
+            out.append("\\n", 2);
+        } else if (c == '\r') {
+            out.append("\\r", 2);
+        } else if (c == '\t') {
+            out.append("\\t", 2);
+        } else if (c < 0x20) {
+            out.append("\\u00", 4);
+            out.append(hex[c >> 4]);
+            out.append(hex[c & 0xF]);
+        } else {
+            i += appendUtf8(out, chars, i, length);
+            continue;
+        }
+        i++;
+    }
+    out.append('"');
+}
+
+// Número con la sintaxis de JSON: -?(0|[1-9]d*)(.d+)?
+bool isJsonNumber(const QString &value)
+{
+    const ushort *chars = value.utf16();
+    const int length = value.size();
+    auto digitsFrom = [&](int i) {
+        while (i < length && chars[i] >= '0' && chars[i] <= '9') i++;
+        return i;
+    };
+    int i = (length > 0 && chars[0] == '-') ? 1 : 0;
+    const int intStart = i;
+    i = digitsFrom(i);
+    if (i == intStart || (i - intStart > 1 && chars[intStart] == '0'))
+        return false;
+    if (i < length && chars[i] == '.') {
+        const int fracStart = i + 1;
+        i = digitsFrom(fracStart);
+        if (i == fracStart) return false;
+    }
+    return i == length;
+}
+} // namespace
+
+// --- ExportWriter ---
+
+ExportWriter::Format ExportWriter::formatForPath(const QString &path)
+{
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    if (suffix == "jsonl" || suffix == "ndjson" || suffix == "json")
+        return JsonLinesFormat;
+    return CsvFormat;
+}
+
+bool ExportWriter::open(const QString &path, Format format, const QStringList &fieldNames,
+                        const QStringList &fieldTypes)
+{
+    if (isOpen())
+        discard();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_format = format;
+    m_rows = 0;
+    m_bytes = 0;
+    m_error.clear();
+    m_buffer.clear();
+    m_buffer.reserve(BufferBytes + BufferBytes / 4);
+
+    m_jsonKeys.clear();
+    m_numeric.clear();
+    for (int i = 0; i < fieldNames.size(); i++) {
+        const QString type = fieldTypes.value(i);
+        m_numeric << (type == "Entero" || type == "Decimales");
+        if (format == JsonLinesFormat) {
+            QByteArray key;
+            appendJsonString(key, fieldNames.at(i));
+            key.append(':');
+            m_jsonKeys << key;
+        }
+    }
+
+    // Encabezado de CSV: los nombres de los campos
+    if (format == CsvFormat) {
+        for (int i = 0; i < fieldNames.size(); i++) {
+            if (i > 0) m_buffer.append(',');
+            appendCsvField(m_buffer, fieldNames.at(i));
+        }
+        m_buffer.append('\n');
+    }
+    return true;
+}
+
+bool ExportWriter::writeRecord(const QStringList &values)
+{
+    if (!isOpen())
+        return false;
+
+    const int fieldCount = m_numeric.size();
+    if (m_format == CsvFormat) {
+        for (int i = 0; i < fieldCount; i++) {
+            if (i > 0) m_buffer.append(',');
+            if (i < values.size())
+                appendCsvField(m_buffer, values.at(i));
+        }
+    } else {
+        m_buffer.append('{');
+        for (int i = 0; i < fieldCount; i++) {
+            if (i > 0) m_buffer.append(',');
+            m_buffer.append(m_jsonKeys.at(i));
+            const QString value = values.value(i);
+            if (value.isEmpty())
+                m_buffer.append("null", 4);
+            else if (m_numeric.at(i) && isJsonNumber(value))
+                m_buffer.append(value.toLatin1());
+            else
+                appendJsonString(m_buffer, value);
+        }
+        m_buffer.append('}');
+    }
+    m_buffer.append('\n');
+    m_rows++;
+
+    if (m_buffer.size() >= BufferBytes)
+        return flushBuffer();
+    return true;
+}
+
+bool ExportWriter::flushBuffer()
+{
+    if (m_buffer.isEmpty())
+        return true;
+    const qint64 written = m_file.write(m_buffer.constData(), m_buffer.size());
+    if (written != m_buffer.size()) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_bytes += written;
+    m_buffer.resize(0); // conserva la capacidad reservada
+    return true;
+}
+
+bool ExportWriter::close()
+{
+    if (!isOpen())
+        return false;
+    if (!flushBuffer()) {
+        discard();
+        return false;
+    }
+    if (!m_file.commit()) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void ExportWriter::discard()
+{
+    if (!isOpen())
+        return;
+    m_file.cancelWriting();
+    m_file.commit(); // no reemplaza nada: solo borra el temporal
+    m_buffer.clear();
+}
+
+// --- TableExporter ---
+
+TableExporter::TableExporter(RecordFile *file, QObject *parent)
+    : QObject(parent), m_file(file)
+{
+    m_timer.setInterval(TickIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &TableExporter::step);
+}
+
+TableExporter::~TableExporter()
+{
+    cancel();
+}
+
+bool TableExporter::start(const QString &path, ExportWriter::Format format)
+{
+    if (isRunning() || !m_file || !m_file->isOpen()) {
+        m_error = QStringLiteral("La tabla no está abierta o ya se está exportando");
+        return false;
+    }
+    m_path = path;
+    m_format = format;
+    m_index = nullptr;
+    m_restarts = 0;
+    m_clock.start();
+    if (!beginPass())
+        return false;
+
+    qDebug() << "DEBUG: Exportando" << m_file->path() << "a" << path << "(" << m_file->recordCount() << "registros)";
+    m_timer.start();
+    return true;
+}
+
+bool TableExporter::start(const QString &path, ExportWriter::Format format, BPlusTree *index,
+                          std::optional<qint64> low, std::optional<qint64> high,
+                          bool lowInclusive, bool highInclusive)
+{
+    if (isRunning() || !m_file || !m_file->isOpen() || !index || !index->isOpen()) {
+        m_error = QStringLiteral("La tabla no está abierta, el índice no es válido o ya se está exportando");
+        return false;
+    }
+    m_path = path;
+    m_format = format;
+    m_index = index;
+    m_low = low;
+    m_high = high;
+    m_lowInclusive = lowInclusive;
+    m_highInclusive = highInclusive;
+    m_restarts = 0;
+    m_clock.start();
+    if (!beginPass())
+        return false;
+
+    qDebug() << "DEBUG: Exportando un rango de" << m_file->path() << "a" << path;
+    m_timer.start();
+    return true;
+}
+
+void TableExporter::cancel()
+{
+    if (!isRunning())
+        return;
+    m_timer.stop();
+    m_writer.discard();
+    qDebug() << "DEBUG: Exportación cancelada";
+}
+
+bool TableExporter::beginPass()
+{
+    if (!m_writer.open(m_path, m_format, m_file->fieldNames(), m_file->fieldTypes())) {
+        fail(m_writer.errorString());
+        return false;
+    }
+    m_nextPage = 1;
+    if (m_index) {
+        m_range = m_index->range(m_low, m_high, m_lowInclusive, m_highInclusive);
+        m_indexVersion = m_index->modificationCount();
+    }
+    m_fileVersion = m_file->modificationCount();
+    return true;
+}
+
+void TableExporter::step()
+{
+    // La tabla cambió desde el último tick: lo escrito ya no es una foto consistente
+    if (m_file->modificationCount() != m_fileVersion
+        || (m_index && m_index->modificationCount() != m_indexVersion)) {
+        if (++m_restarts > MaxRestarts) {
+            fail(QStringLiteral("La tabla se modificó demasiadas veces durante la exportación"));
+            return;
+        }
+        qDebug() << "DEBUG: La tabla cambió durante la exportación, reiniciando pasada";
+        if (!beginPass())
+            return;
+    }
+
+    bool done = false;
+    if (m_index) {
+        for (int i = 0; i < RecordsPerTick; i++) {
+            if (!m_range.next()) {
+                done = true;
+                break;
+            }
+            // Con el árbol sin cambios cada entrada apunta a un registro vivo:
+            // si no se puede leer, el índice y la tabla no coinciden
+            const std::optional<QStringList> values = m_file->read(m_range.recordId());
+            if (!values) {
+                fail(QStringLiteral("El índice apunta a un registro que no se puede leer (%1): %2")
+                     .arg(m_range.recordId().toUInt64()).arg(m_file->errorString()));
+                return;
+            }
+            if (!m_writer.writeRecord(*values)) {
+                fail(m_writer.errorString());
+                return;
+            }
+        }
+        emit progress(m_writer.rowCount(), -1);
+    } else {
+        QList<QPair<RecordId, QStringList>> records;
+        const quint32 pageCount = m_file->pageCount();
+        const quint32 lastPage = qMin(pageCount, m_nextPage + quint32(PagesPerTick));
+        for (; m_nextPage < lastPage; ++m_nextPage) {
+            if (!m_file->readPageRecords(m_nextPage, &records)) {
+                fail(m_file->errorString());
+                return;
+            }
+            for (const auto &record : qAsConst(records)) {
+                if (!m_writer.writeRecord(record.second)) {
+                    fail(m_writer.errorString());
+                    return;
+                }
+            }
+        }
+        emit progress(m_writer.rowCount(), m_file->recordCount());
+        done = m_nextPage >= pageCount;
+    }
+    if (!done)
+        return;
+
+    m_timer.stop();
+    const qint64 rows = m_writer.rowCount();
+    if (!m_writer.close()) {
+        fail(m_writer.errorString());
+        return;
+    }
+    const qint64 bytes = m_writer.bytesWritten();
+    const qint64 elapsed = m_clock.elapsed();
+    qDebug() << "DEBUG: Exportación terminada:" << rows << "registros," << bytes << "bytes en" << elapsed << "ms";
+    emit finished(rows, bytes, elapsed);
+}
+
+void TableExporter::fail(const QString &error)
+{
+    m_timer.stop();
+    m_writer.discard();
+    m_error = error;
+    qDebug() << "ERROR: Falló la exportación:" << error;
+    emit failed(error);
+}
@@ -0,0 +1,133 @@
+#ifndef TABLEEXPORTER_H
+#define TABLEEXPORTER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <QSaveFile>
+#include <QStringList>
+#include <QVector>
+#include <optional>
+#include "RecordFile.h"
+#include "BPlusTree.h"
+
+// Escritura de registros en CSV o JSON Lines a través de un búfer propio.
+//
+// Cada registro se codifica (UTF-8, comillas de CSV o escapes de JSON)
+// directamente en el búfer, que se vuelca al archivo cada BufferBytes: la
+// memoria no depende de cuántos registros se escriban. El archivo se escribe
+// con QSaveFile, así que solo aparece completo al cerrar.
+//
+//   CSV         → encabezado con los nombres de los campos y una línea por
+//                 registro; comillas solo si el valor las necesita
+//   JSON Lines  → un objeto por línea; los campos "Entero" y "Decimales" van
+//                 como número si lo son, las celdas vacías como null
+class ExportWriter
+{
+public:
+    enum Format {
+        CsvFormat,
+        JsonLinesFormat
+    };
+
+    static constexpr int BufferBytes = 1 << 20;
+
+    // .jsonl, .ndjson o .json → JSON Lines; cualquier otra → CSV
+    static Format formatForPath(const QString &path);
+
+    bool open(const QString &path, Format format, const QStringList &fieldNames, const QStringList &fieldTypes);
+    bool writeRecord(const QStringList &values);
+    // Vuelca el búfer y reemplaza el archivo; false si alguna escritura falló
+    bool close();
+    // Descarta lo escrito; el archivo anterior (si había) queda igual
+    void discard();
+
+    bool isOpen() const { return m_file.isOpen(); }
+    qint64 rowCount() const { return m_rows; }
+    qint64 bytesWritten() const { return m_bytes; }
+    QString errorString() const { return m_error; }
+
+private:
+    bool flushBuffer();
+
+    QSaveFile m_file;
+    Format m_format = CsvFormat;
+    QByteArray m_buffer;
+    QVector<QByteArray> m_jsonKeys;     // "\"campo\":" ya codificado
+    QVector<bool> m_numeric;
+    qint64 m_rows = 0;
+    qint64 m_bytes = 0;
+    QString m_error;
+};
+
+// Exportación de una tabla (o del resultado de un rango de un índice) sin
+// bloquear la interfaz.
+//
+// Recorre el archivo .mad de a PagesPerTick páginas por tick del temporizador
+// (o RecordsPerTick registros de las hojas del árbol B+, para un rango) y los
+// escribe con ExportWriter; nunca arma la tabla completa en memoria.
+//
+// Si la tabla (o el índice del rango) se modifica mientras se exporta, la
+// pasada se reinicia (igual que TableCompactor); el archivo solo se reemplaza
+// al terminar una pasada limpia. Un registro del índice que no se puede leer
+// hace fallar la exportación.
+class TableExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int PagesPerTick = 64;
+    static constexpr int RecordsPerTick = 5000;
+
+    explicit TableExporter(RecordFile *file, QObject *parent = nullptr);
+    ~TableExporter();
+
+    // Todos los registros de la tabla, en el orden del archivo
+    bool start(const QString &path, ExportWriter::Format format);
+    // Los registros del rango [low, high] de index, en el orden de la clave.
+    // El rango se vuelve a abrir en cada pasada: un iterador no sobrevive a
+    // un cambio del árbol
+    bool start(const QString &path, ExportWriter::Format format, BPlusTree *index,
+               std::optional<qint64> low, std::optional<qint64> high,
+               bool lowInclusive = true, bool highInclusive = true);
+    void cancel();
+
+    bool isRunning() const { return m_timer.isActive(); }
+    // El índice no se puede cerrar mientras una exportación lo recorre
+    bool usesIndex(const BPlusTree *index) const { return isRunning() && m_index == index; }
+    QString errorString() const { return m_error; }
+
+signals:
+    // rowCount es -1 cuando no se conoce (rangos)
+    void progress(qint64 rowsDone, qint64 rowCount);
+    void finished(qint64 rows, qint64 bytes, qint64 elapsedMs);
+    void failed(const QString &error);
+
+private slots:
+    void step();
+
+private:
+    bool beginPass();
+    void fail(const QString &error);
+
+    RecordFile *m_file;
+    ExportWriter m_writer;
+    QString m_path;
+    ExportWriter::Format m_format = ExportWriter::CsvFormat;
+    quint32 m_nextPage = 1;
+    BPlusTree *m_index = nullptr;       // nullptr: todo el archivo
+    std::optional<qint64> m_low;
+    std::optional<qint64> m_high;
+    bool m_lowInclusive = true;
+    bool m_highInclusive = true;
+    BPlusTreeIterator m_range;
+    quint64 m_indexVersion = 0;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    quint64 m_fileVersion = 0;
+    int m_restarts = 0;
+    QString m_error;
+};
+
+#endif // TABLEEXPORTER_H
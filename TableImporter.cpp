@@ -0,0 +1,354 @@
+#include "TableImporter.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include "TypeValidator.h"
+#include "Currency.h"
+#include "CompactDate.h"
+
+namespace {
+// 0 ms mientras hay lotes: cada tick entrega uno y entre ticks corren los
+// eventos de la interfaz. Si el siguiente trozo todavía se está parseando, el
+// timer espera IdleIntervalMs entre consultas en lugar de girar en vacío.
+constexpr int TickIntervalMs = 0;
+constexpr int IdleIntervalMs = 5;
+
+class ChunkTask : public QRunnable
+{
+public:
+    explicit ChunkTask(std::function<void()> work) : m_work(std::move(work)) {}
+    void run() override { m_work(); }
+
+private:
+    std::function<void()> m_work;
+};
+
+// Fin de un campo sin comillas: separador, fin de línea o fin de datos
+qint64 fieldEnd(const char *data, qint64 pos, qint64 size, char delimiter)
+{
+    while (pos < size && data[pos] != delimiter && data[pos] != '\n')
+        pos++;
+    return pos;
+}
+
+// Sin el '\r' de un fin de línea \r\n
+qint64 withoutCarriageReturn(const char *data, qint64 start, qint64 end)
+{
+    return (end > start && data[end - 1] == '\r') ? end - 1 : end;
+}
+} // namespace
+
+TableImporter::TableImporter(QObject *parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+    m_timer.setInterval(TickIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &TableImporter::step);
+}
+
+TableImporter::~TableImporter()
+{
+    cancel();
+}
+
+bool TableImporter::start(const QString &path, const QStringList &fieldNames, const QStringList &fieldTypes)
+{
+    if (isRunning()) {
+        m_error = QStringLiteral("Ya hay una importación en curso");
+        return false;
+    }
+    m_error.clear();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    m_data = nullptr;
+    if (m_size > 0) {
+        uchar *mapped = m_file.map(0, m_size);
+        if (!mapped) {
+            m_error = m_file.errorString();
+            m_file.close();
+            return false;
+        }
+        m_data = reinterpret_cast<const char *>(mapped);
+    }
+
+    // BOM de UTF-8 que agregan algunas hojas de cálculo
+    qint64 begin = 0;
+    if (m_size >= 3 && std::memcmp(m_data, "\xEF\xBB\xBF", 3) == 0)
+        begin = 3;
+    const qint64 firstEnd = recordEnd(begin, false);
+
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    const auto tabs = std::count(m_data + begin, m_data + firstEnd, '\t');
+    const auto commas = std::count(m_data + begin, m_data + firstEnd, ',');
+    m_delimiter = (suffix == "tsv" || suffix == "tab" || tabs > commas) ? '\t' : ',';
+
+    // Encabezado: columnas por nombre; sin encabezado, por posición
+    const QStringList header = parseRecords(m_data + begin, firstEnd - begin, m_delimiter).value(0);
+    m_mapping = QVector<int>(fieldNames.size(), -1);
+    bool hasHeader = false;
+    for (int field = 0; field < fieldNames.size(); field++) {
+        for (int column = 0; column < header.size(); column++) {
+            if (header.at(column).trimmed().compare(fieldNames.at(field), Qt::CaseInsensitive) == 0) {
+                m_mapping[field] = column;
+                hasHeader = true;
+                break;
+            }
+        }
+    }
+    if (!hasHeader) {
+        for (int field = 0; field < fieldNames.size(); field++)
+            m_mapping[field] = field;
+    }
+    m_fieldTypes = fieldTypes;
+
+    m_scanPos = hasHeader ? firstEnd : begin;
+    m_chunkEnds.clear();
+    m_nextDeliver = 0;
+    m_deliveredRows = 0;
+    m_ready.clear();
+    m_rows = 0;
+    m_rejectedCells = 0;
+    m_cancelled = false;
+    m_clock.start();
+
+    qDebug() << "DEBUG: Importando" << path << "(" << m_size << "bytes, separador"
+             << (m_delimiter == '\t' ? "tabulador" : "coma") << ", encabezado:" << hasHeader
+             << ") columnas por campo:" << m_mapping;
+    submitChunks();
+    m_timer.start(TickIntervalMs);
+    return true;
+}
+
+void TableImporter::cancel()
+{
+    if (!isRunning())
+        return;
+    stop();
+    qDebug() << "DEBUG: Importación cancelada tras" << m_rows << "filas";
+}
+
+void TableImporter::stop()
+{
+    m_cancelled = true;
+    m_timer.stop();
+    // Los bloques en curso leen el mapeo: hay que esperarlos antes de cerrarlo
+    m_pool.waitForDone();
+    m_ready.clear();
+    m_file.close();
+    m_data = nullptr;
+}
+
+qint64 TableImporter::recordEnd(qint64 from, bool inQuotes) const
+{
+    for (qint64 pos = from; pos < m_size; pos++) {
+        const char c = m_data[pos];
+        if (c == '"')
+            inQuotes = !inQuotes;
+        else if (c == '\n' && !inQuotes)
+            return pos + 1;
+    }
+    return m_size;
+}
+
+bool TableImporter::nextChunk(Chunk *chunk)
+{
+    if (m_scanPos >= m_size)
+        return false;
+
+    // Estado de las comillas en el punto de corte: cada '"' lo invierte ("" lo deja igual)
+    const qint64 target = qMin(m_scanPos + ChunkBytes, m_size);
+    bool inQuotes = false;
+    const char *end = m_data + target;
+    for (const char *p = m_data + m_scanPos;
+         (p = static_cast<const char *>(std::memchr(p, '"', size_t(end - p)))); ++p)
+        inQuotes = !inQuotes;
+
+    chunk->begin = m_scanPos;
+    chunk->end = recordEnd(target, inQuotes);
+    m_scanPos = chunk->end;
+    return true;
+}
+
+void TableImporter::submitChunks()
+{
+    Chunk chunk;
+    while (m_chunkEnds.size() - m_nextDeliver < MaxPendingChunks && nextChunk(&chunk)) {
+        const int index = m_chunkEnds.size();
+        m_chunkEnds.append(chunk.end);
+        m_pool.start(new ChunkTask([this, index, chunk] { parseChunk(index, chunk); }));
+    }
+}
+
+void TableImporter::parseChunk(int index, Chunk chunk)
+{
+    if (m_cancelled)
+        return;
+
+    const QVector<QStringList> records = parseRecords(m_data + chunk.begin, chunk.end - chunk.begin, m_delimiter);
+
+    // Por columnas, para validar cada una de una vez
+    const int fieldCount = m_mapping.size();
+    QVector<QStringList> columns(fieldCount);
+    for (int field = 0; field < fieldCount; field++) {
+        const int column = m_mapping.at(field);
+        QStringList &values = columns[field];
+        values.reserve(records.size());
+        for (const QStringList &record : records)
+            values << (column >= 0 ? record.value(column).trimmed() : QString());
+    }
+
+    ParsedChunk parsed;
+    for (int field = 0; field < fieldCount; field++) {
+        const QString &type = m_fieldTypes.at(field);
+        QStringList &values = columns[field];
+        const BitVector invalid = TypeValidator::invalidRows(type, values);
+        for (int i = 0; i < values.size(); i++) {
+            QString &value = values[i];
+            if (value.isEmpty()) continue;
+
+            if (!invalid.at(i)) {
+                // Montos y fechas válidos quedan en el formato con que se guardan
+                if (type == "moneda") {
+                    if (const std::optional<Currency> amount = Currency::parse(value))
+                        value = amount->toString();
+                } else if (type == "fecha") {
+                    if (const std::optional<CompactDate> date = CompactDate::parse(value))
+                        value = date->toString();
+                }
+                continue;
+            }
+            // Celda incompatible: queda vacía, como al pegar
+            value.clear();
+            parsed.rejectedCells++;
+        }
+    }
+
+    parsed.rows.reserve(records.size());
+    for (int i = 0; i < records.size(); i++) {
+        QStringList row;
+        row.reserve(fieldCount);
+        bool hasData = false;
+        for (int field = 0; field < fieldCount; field++) {
+            row << columns.at(field).at(i);
+            hasData = hasData || !row.last().isEmpty();
+        }
+        if (hasData)
+            parsed.rows.append(row);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_ready.insert(index, parsed);
+}
+
+void TableImporter::step()
+{
+    QVector<QStringList> batch;
+    bool chunkDone = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_ready.find(m_nextDeliver);
+        if (it == m_ready.end()) {
+            locker.unlock();
+            m_timer.setInterval(IdleIntervalMs);
+            // Todo entregado y nada más que cortar
+            if (m_nextDeliver >= m_chunkEnds.size() && m_scanPos >= m_size) {
+                stop();
+                const qint64 elapsed = m_clock.elapsed();
+                qDebug() << "DEBUG: Importación terminada:" << m_rows << "filas,"
+                         << m_rejectedCells << "celdas rechazadas en" << elapsed << "ms";
+                emit finished(m_rows, m_rejectedCells, elapsed);
+            }
+            return;
+        }
+        m_timer.setInterval(TickIntervalMs);
+        batch = it->rows.mid(m_deliveredRows, BatchRows);
+        m_deliveredRows += batch.size();
+        if (m_deliveredRows >= it->rows.size()) {
+            m_rejectedCells += it->rejectedCells;
+            m_ready.erase(it);
+            chunkDone = true;
+        }
+    }
+
+    if (!batch.isEmpty()) {
+        m_rows += batch.size();
+        emit rowsReady(batch);
+    }
+    if (chunkDone && isRunning()) {
+        emit progress(m_chunkEnds.at(m_nextDeliver), m_size);
+        m_nextDeliver++;
+        m_deliveredRows = 0;
+        submitChunks();
+    }
+}
+
+QVector<QStringList> TableImporter::parseRecords(const char *data, qint64 size, char delimiter)
+{
+    QVector<QStringList> records;
+    QByteArray quoted;      // solo los campos entre comillas necesitan copiarse
+    qint64 pos = 0;
+    while (pos < size) {
+        // Líneas vacías
+        if (data[pos] == '\n') {
+            pos++;
+            continue;
+        }
+        if (data[pos] == '\r' && pos + 1 < size && data[pos + 1] == '\n') {
+            pos += 2;
+            continue;
+        }
+
+        QStringList record;
+        for (;;) {
+            if (pos < size && data[pos] == '"') {
+                quoted.clear();
+                pos++;
+                while (pos < size) {
+                    if (data[pos] == '"') {
+                        if (pos + 1 < size && data[pos + 1] == '"') {
+                            quoted.append('"');
+                            pos += 2;
+                            continue;
+                        }
+                        pos++;
+                        break;
+                    }
+                    // Hasta la próxima comilla de una vez
+                    const char *next = static_cast<const char *>(std::memchr(data + pos, '"', size_t(size - pos)));
+                    const qint64 stop = next ? next - data : size;
+                    quoted.append(data + pos, int(stop - pos));
+                    pos = stop;
+                }
+                // Lo que quede antes del separador se conserva tal cual
+                const qint64 start = pos;
+                pos = fieldEnd(data, pos, size, delimiter);
+                quoted.append(data + start, int(withoutCarriageReturn(data, start, pos) - start));
+                record << QString::fromUtf8(quoted);
+            } else {
+                const qint64 start = pos;
+                pos = fieldEnd(data, pos, size, delimiter);
+                record << QString::fromUtf8(data + start, int(withoutCarriageReturn(data, start, pos) - start));
+            }
+
+            if (pos < size && data[pos] == delimiter) {
+                pos++;
+                continue;
+            }
+            break;
+        }
+        if (pos < size) pos++; // '\n'
+        records.append(record);
+    }
+    return records;
+}
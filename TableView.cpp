@@ -1,4 +1,7 @@
 #include "TableView.h"
+#include "IndexKey.h"
+#include "Currency.h"
+#include "CompactDate.h"
 #include <QDebug>
 
 // DataTypeDelegate Implementation
@@ -205,6 +208,12 @@ TableView::TableView(QWidget *parent) : QWidget(parent)
     isDarkTheme = false;
     currentTableName = "Nueva Tabla";
     
+    // Las ediciones de diseño se emiten juntas cuando el usuario deja de escribir
+    designChangeTimer = new QTimer(this);
+    designChangeTimer->setSingleShot(true);
+    designChangeTimer->setInterval(DesignChangeDelayMs);
+    connect(designChangeTimer, &QTimer::timeout, this, &TableView::emitDesignChange);
+    
     // Crear la interfaz
     createInterface();
 }
@@ -481,6 +490,19 @@ void TableView::createPropertiesArea()
     );
     centerColumn->addWidget(requiredCheck);
     
+    // Índice secundario (árbol B+ o B*) para búsquedas por rango
+    QLabel *indexedLabel = new QLabel("Indexado:");
+    indexedLabel->setStyleSheet("QLabel { color: #475569; font-weight: bold; }");
+    centerColumn->addWidget(indexedLabel);
+    
+    indexedCombo = new QComboBox();
+    indexedCombo->addItem("No", QString());
+    indexedCombo->addItem("Sí (con duplicados)", QString("bplus"));
+    indexedCombo->addItem("Sí, árbol B* (nodos más llenos)", QString("bstar"));
+    indexedCombo->setStyleSheet(getComboStyle());
+    indexedCombo->setToolTip("Disponible para campos Entero, Decimales, moneda y fecha");
+    centerColumn->addWidget(indexedCombo);
+    
     // Columna derecha
     QVBoxLayout *rightColumn = new QVBoxLayout();
     rightColumn->setSpacing(10);
@@ -516,6 +538,7 @@ void TableView::createPropertiesArea()
     connect(dataTypeCombo, &QComboBox::currentTextChanged, this, &TableView::onDataTypeChanged);
     connect(defaultValueEdit, &QLineEdit::textChanged, this, &TableView::onDefaultValueChanged);
     connect(requiredCheck, &QCheckBox::toggled, this, &TableView::onRequiredChanged);
+    connect(indexedCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &TableView::onIndexedChanged);
     connect(descriptionEdit, &QTextEdit::textChanged, this, &TableView::onDescriptionChanged);
 }
 
@@ -588,6 +611,7 @@ void TableView::updatePropertiesForRow(int row)
     descriptionEdit->blockSignals(true);
     defaultValueEdit->blockSignals(true);
     requiredCheck->blockSignals(true);
+    indexedCombo->blockSignals(true);
     
     // Obtener datos de la fila
     QTableWidgetItem *nameItem = tableWidget->item(row, 0);
@@ -610,6 +634,11 @@ void TableView::updatePropertiesForRow(int row)
     QString fieldName = nameItem ? nameItem->text().toLower() : "";
     requiredCheck->setChecked(fieldName == "id");
     
+    // Índice del campo (solo tipos con orden: números, moneda y fecha)
+    const QString indexKind = nameItem ? nameItem->data(IndexKindRole).toString() : QString();
+    indexedCombo->setCurrentIndex(qMax(0, indexedCombo->findData(indexKind)));
+    indexedCombo->setEnabled(IndexKey::isIndexableType(dataType) && fieldName != "id");
+    
     // Actualizar propiedades específicas según el tipo de dato
     updateSpecificProperties(dataType);
     
@@ -619,6 +648,7 @@ void TableView::updatePropertiesForRow(int row)
     descriptionEdit->blockSignals(false);
     defaultValueEdit->blockSignals(false);
     requiredCheck->blockSignals(false);
+    indexedCombo->blockSignals(false);
     
     // Actualizar propiedades específicas según el tipo de dato seleccionado
     updateSpecificProperties(dataType);
@@ -646,9 +676,10 @@ void TableView::onDataTypeChanged(const QString &dataType)
     
     // Actualizar propiedades específicas según el tipo seleccionado
     updateSpecificProperties(dataType);
+    indexedCombo->setEnabled(IndexKey::isIndexableType(dataType));
     
     // Emitir señal para actualizar vista de datos (no actualizar ejemplos en vista diseño)
-    emit tableDesignChanged(getCurrentFieldNames(), getCurrentFieldTypes());
+    scheduleDesignChange();
 }
 
 void TableView::onDescriptionChanged()
@@ -673,9 +704,25 @@ void TableView::onRequiredChanged(bool required)
     // Por ahora no mostramos si es requerido en la tabla
 }
 
+void TableView::onIndexedChanged(int index)
+{
+    if (currentSelectedRow < 0) return;
+    QTableWidgetItem *nameItem = tableWidget->item(currentSelectedRow, 0);
+    if (!nameItem || nameItem->text().trimmed().isEmpty()) return;
+    
+    const QString indexKind = indexedCombo->itemData(index).toString();
+    tableWidget->blockSignals(true);
+    nameItem->setData(IndexKindRole, indexKind);
+    tableWidget->blockSignals(false);
+    
+    qDebug() << "DEBUG: Índice del campo" << nameItem->text() << "cambiado a:" << (indexKind.isEmpty() ? "ninguno" : indexKind);
+    emit fieldIndexChanged(nameItem->text().trimmed(), indexKind);
+}
+
 void TableView::onDataViewClicked()
 {
     qDebug() << "DEBUG: Cambiando a Vista Datos";
+    flushDesignChange();
     emit switchToDataView();
 }
 
@@ -732,7 +779,7 @@ void TableView::onFieldItemChanged(QTableWidgetItem *item)
     }
     
     // Emitir señal de cambio de diseño de tabla
-    emit tableDesignChanged(getCurrentFieldNames(), getCurrentFieldTypes());
+    scheduleDesignChange();
 }
 
 void TableView::addNewRow()
@@ -761,6 +808,127 @@ void TableView::addNewRow()
     }
 }
 
+void TableView::setFields(const QStringList &fieldNames, const QStringList &fieldTypes)
+{
+    if (!tableWidget || fieldNames.isEmpty()) return;
+    
+    tableWidget->blockSignals(true);
+    tableWidget->setRowCount(0);
+    
+    for (int i = 0; i < fieldNames.size(); ++i) {
+        addNewRow();
+        const int row = tableWidget->rowCount() - 1;
+        
+        // Habilitar todas las celdas de la fila como si el usuario la hubiera llenado
+        for (int col = 0; col < tableWidget->columnCount(); ++col) {
+            QTableWidgetItem *item = tableWidget->item(row, col);
+            if (!item) continue;
+            item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable);
+            item->setBackground(QBrush(QColor(255, 255, 255)));
+        }
+        tableWidget->item(row, 0)->setText(fieldNames.at(i));
+        tableWidget->item(row, 0)->setData(FieldIdRole, i + 1);
+        tableWidget->item(row, 1)->setText(i < fieldTypes.size() ? fieldTypes.at(i) : "Texto largo / Párrafo");
+    }
+    
+    // Fila vacía al final para seguir agregando campos
+    addNewRow();
+    tableWidget->blockSignals(false);
+    
+    // El diseño cargado es el punto de partida de los cambios siguientes
+    designChangeTimer->stop();
+    nextFieldId = quint16(fieldNames.size() + 1);
+    emittedFields = designFields();
+    
+    qDebug() << "DEBUG: Diseño cargado con" << fieldNames.size() << "campos";
+}
+
+void TableView::setFieldIndexes(const QMap<QString, QString> &indexes)
+{
+    tableWidget->blockSignals(true);
+    for (int row = 0; row < tableWidget->rowCount(); ++row) {
+        QTableWidgetItem *nameItem = tableWidget->item(row, 0);
+        if (!nameItem) continue;
+        const QString kind = indexes.value(nameItem->text().trimmed());
+        nameItem->setData(IndexKindRole, kind.isEmpty() ? QVariant() : QVariant(kind));
+    }
+    tableWidget->blockSignals(false);
+    
+    if (currentSelectedRow >= 0 && currentSelectedRow < tableWidget->rowCount()) {
+        updatePropertiesForRow(currentSelectedRow);
+    }
+}
+
+void TableView::scheduleDesignChange()
+{
+    // Cada edición reinicia la espera
+    designChangeTimer->start();
+}
+
+void TableView::flushDesignChange()
+{
+    if (!designChangeTimer->isActive()) return;
+    designChangeTimer->stop();
+    emitDesignChange();
+}
+
+QVector<SchemaField> TableView::designFields()
+{
+    QVector<SchemaField> fields;
+    for (int row = 0; row < tableWidget->rowCount(); ++row) {
+        QTableWidgetItem *nameItem = tableWidget->item(row, 0);
+        if (!nameItem) continue;
+        const QString name = nameItem->text().trimmed();
+        if (name.isEmpty()) {
+            // Un campo borrado no se revive si luego se escribe otro nombre en la fila
+            if (nameItem->data(FieldIdRole).isValid()) {
+                tableWidget->blockSignals(true);
+                nameItem->setData(FieldIdRole, QVariant());
+                tableWidget->blockSignals(false);
+            }
+            continue;
+        }
+        if (!nameItem->data(FieldIdRole).isValid()) {
+            tableWidget->blockSignals(true);
+            nameItem->setData(FieldIdRole, nextFieldId++);
+            tableWidget->blockSignals(false);
+        }
+        
+        SchemaField field;
+        field.id = quint16(nameItem->data(FieldIdRole).toUInt());
+        field.name = name;
+        QTableWidgetItem *typeItem = tableWidget->item(row, 1);
+        field.type = typeItem && !typeItem->text().trimmed().isEmpty()
+                     ? typeItem->text().trimmed() : QString("Texto largo / Párrafo");
+        fields << field;
+    }
+    return fields;
+}
+
+void TableView::emitDesignChange()
+{
+    const QVector<SchemaField> fields = designFields();
+    const SchemaDiff diff = SchemaDiff::compute(emittedFields, fields);
+    if (diff.isEmpty()) return;
+    
+    emittedFields = fields;
+    qDebug() << "DEBUG: Diseño de" << currentTableName << "cambiado:" << diff.toString();
+    emit tableDesignChanged(diff);
+}
+
+QMap<QString, QString> TableView::fieldIndexes() const
+{
+    QMap<QString, QString> indexes;
+    for (int row = 0; row < tableWidget->rowCount(); ++row) {
+        QTableWidgetItem *nameItem = tableWidget->item(row, 0);
+        if (!nameItem || nameItem->text().trimmed().isEmpty()) continue;
+        const QString kind = nameItem->data(IndexKindRole).toString();
+        if (!kind.isEmpty())
+            indexes.insert(nameItem->text().trimmed(), kind);
+    }
+    return indexes;
+}
+
 void TableView::ensureEmptyRowExists()
 {
     // Verificar si necesitamos más filas vacías
@@ -1207,7 +1375,7 @@ void TableView::onTextSizeChanged(const QString &text)
     }
     
     // Emitir señal para actualizar vista de datos
-    emit tableDesignChanged(getCurrentFieldNames(), getCurrentFieldTypes());
+    scheduleDesignChange();
 }
 
 void TableView::onNumberTypeChanged(const QString &text)
@@ -1238,21 +1406,21 @@ void TableView::onNumberTypeChanged(const QString &text)
     }
     
     // Emitir señal para actualizar vista de datos
-    emit tableDesignChanged(getCurrentFieldNames(), getCurrentFieldTypes());
+    scheduleDesignChange();
 }
 
 void TableView::onCurrencyFormatChanged(const QString &text)
 {
     qDebug() << "DEBUG: Formato de moneda cambiado a:" << text;
     // Emitir señal para actualizar vista de datos
-    emit tableDesignChanged(getCurrentFieldNames(), getCurrentFieldTypes());
+    scheduleDesignChange();
 }
 
 void TableView::onDateFormatChanged(const QString &text)
 {
     qDebug() << "DEBUG: Formato de fecha cambiado a:" << text;
     // Emitir señal para actualizar vista de datos
-    emit tableDesignChanged(getCurrentFieldNames(), getCurrentFieldTypes());
+    scheduleDesignChange();
 }
 
 QString TableView::generateExampleData(const QString &dataType, int column)
@@ -1298,29 +1466,14 @@ QString TableView::generateExampleData(const QString &dataType, int column)
     } else if (dataType == "Texto largo / Párrafo") {
         return "Este es un ejemplo de texto largo que puede contener múltiples líneas...";
     } else if (dataType == "moneda") {
-        QString format = currencyFormatCombo ? currencyFormatCombo->currentText() : "Lempiras (Lps)";
-        if (format.contains("Lempiras")) {
-            return "Lps 1,500.00";
-        } else if (format.contains("Dollar")) {
-            return "$1,500.00";
-        } else if (format.contains("Euros")) {
-            return "€1,500.00";
-        } else if (format.contains("Millares")) {
-            return "1,500";
-        } else {
-            return "Lps 1,500.00";
-        }
+        const QString format = currencyFormatCombo ? currencyFormatCombo->currentText() : "Lempiras (Lps)";
+        return Currency(150000).toString(Currency::formatFromName(format));
     } else if (dataType == "fecha") {
-        QString format = dateFormatCombo ? dateFormatCombo->currentText() : "DD-MM-YY";
-        if (format == "DD-MM-YY") {
-            return "15-08-24";
-        } else if (format == "DD/MM/YY") {
-            return "15/08/24";
-        } else if (format == "DD/MESTEXTO/YYYY") {
-            return "15/Agosto/2024";
-        } else {
-            return "15-08-24";
-        }
+        const QString format = dateFormatCombo ? dateFormatCombo->currentText() : "DD-MM-YY";
+        CompactDate::Format dateFormat = CompactDate::formatFromName(format);
+        if (dateFormat == CompactDate::StorageFormat)
+            dateFormat = CompactDate::DashShortFormat;
+        return CompactDate::fromYmd(2024, 8, 15)->toString(dateFormat);
     }
     
     return "Ejemplo";
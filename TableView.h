@@ -21,6 +21,7 @@
 #include <QTimer>
 #include <QStyledItemDelegate>
 #include <QPainter>
+#include "SchemaDiff.h"
 
 // Custom delegate for data type column
 class DataTypeDelegate : public QStyledItemDelegate
@@ -85,10 +86,23 @@ public:
     // Obtener campos actuales del diseño
     QStringList getCurrentFieldNames() const;
     QStringList getCurrentFieldTypes() const;
+    
+    // Cargar un diseño existente (p. ej. leído del archivo .mad) sin emitir cambios
+    void setFields(const QStringList &fieldNames, const QStringList &fieldTypes);
+    
+    // Índices secundarios por campo (campo → tipo de índice: "bplus" o "bstar")
+    void setFieldIndexes(const QMap<QString, QString> &indexes);
+    QMap<QString, QString> fieldIndexes() const;
+    
+    // Emite ya el cambio de diseño pendiente (si lo hay) sin esperar al temporizador
+    void flushDesignChange();
 
 signals:
     void switchToDataView();
-    void tableDesignChanged(const QStringList &fieldNames, const QStringList &fieldTypes);
+    // Las ediciones seguidas se agrupan: se emite una vez, con lo que cambió
+    // desde el último diseño emitido
+    void tableDesignChanged(const SchemaDiff &diff);
+    void fieldIndexChanged(const QString &fieldName, const QString &indexKind);
 
 private slots:
     void onCellChanged(int row, int column);
@@ -98,6 +112,7 @@ private slots:
     void onDescriptionChanged();
     void onRequiredChanged(bool checked);
     void onDefaultValueChanged(const QString &text);
+    void onIndexedChanged(int index);
     void onDataViewClicked();
     void onDesignViewClicked();
     void onFieldItemChanged(QTableWidgetItem *item);
@@ -113,6 +128,9 @@ private slots:
     
     // Función helper para generar ejemplo según tipo de dato
     QString generateExampleData(const QString &dataType, int column);
+    
+    // Compara el diseño actual con el último emitido y emite la diferencia
+    void emitDesignChange();
 
 private:
     void createInterface();
@@ -126,6 +144,8 @@ private:
     void createSpecificPropertiesWidgets();
     void ensureEmptyRowExists();
     void addNewRow();
+    void scheduleDesignChange();
+    QVector<SchemaField> designFields();
     QString getTableStyle();
     QString getInputStyle();
     QString getComboStyle();
@@ -152,6 +172,7 @@ private:
     QTextEdit *descriptionEdit;
     QCheckBox *requiredCheck;
     QLineEdit *defaultValueEdit;
+    QComboBox *indexedCombo; // No / Sí (con duplicados) / Sí, árbol B*
     
     // Propiedades específicas por tipo de dato
     QWidget *specificPropertiesWidget;
@@ -178,6 +199,17 @@ private:
     QString currentTableName;
     bool isDarkTheme;
     int currentSelectedRow;
+    
+    // Cambios de diseño agrupados
+    QTimer *designChangeTimer;
+    QVector<SchemaField> emittedFields;   // diseño que ya conocen los demás
+    quint16 nextFieldId = 1;
+    static constexpr int DesignChangeDelayMs = 300;
+    
+    // Tipo de índice del campo, guardado en la celda del nombre
+    static constexpr int IndexKindRole = Qt::UserRole + 1;
+    // Identificador estable del campo, guardado en la celda del nombre
+    static constexpr int FieldIdRole = Qt::UserRole + 2;
 };
 
 #endif // TABLEVIEW_H
@@ -0,0 +1,171 @@
+#include "TypeValidator.h"
+
+#include <QtAlgorithms>
+#include "CompactDate.h"
+#include "Currency.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+inline bool isAsciiDigit(ushort c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Cantidad de dígitos ASCII seguidos desde el inicio
+int digitPrefix(const ushort *chars, int length)
+{
+    int pos = 0;
+#if defined(__SSE2__)
+    // 8 caracteres UTF-16 por vuelta; los mayores a 0x7FFF quedan negativos y no son dígitos
+    const __m128i belowZero = _mm_set1_epi16('0' - 1);
+    const __m128i aboveNine = _mm_set1_epi16('9' + 1);
+    for (; pos + 8 <= length; pos += 8) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(chars + pos));
+        const __m128i digits = _mm_and_si128(_mm_cmpgt_epi16(chunk, belowZero),
+                                             _mm_cmplt_epi16(chunk, aboveNine));
+        const uint mask = uint(_mm_movemask_epi8(digits));
+        if (mask != 0xFFFF)
+            return pos + int(qCountTrailingZeroBits(~mask)) / 2;
+    }
+#endif
+    while (pos < length && isAsciiDigit(chars[pos]))
+        pos++;
+    return pos;
+}
+
+// Dígitos sin contar los ceros a la izquierda
+int significantDigits(const ushort *chars, int length)
+{
+    int pos = 0;
+    while (pos < length && chars[pos] == '0')
+        pos++;
+    return length - pos;
+}
+
+int twoDigits(const ushort *chars)
+{
+    return (chars[0] - '0') * 10 + (chars[1] - '0');
+}
+
+int daysInMonth(int year, int month)
+{
+    static const int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (month == 2 && ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0))
+        return 29;
+    return days[month - 1];
+}
+
+} // namespace
+
+TypeValidator::Kind TypeValidator::kindForType(const QString &fieldType)
+{
+    if (fieldType == "Entero") return IntegerKind;
+    if (fieldType == "Decimales") return DecimalKind;
+    if (fieldType == "moneda") return CurrencyKind;
+    if (fieldType == "fecha") return DateKind;
+    return UncheckedKind;
+}
+
+bool TypeValidator::isValid(const QString &fieldType, const QString &value)
+{
+    const Kind kind = kindForType(fieldType);
+    const Result result = quickCheck(kind, value);
+    return result == Unknown ? fullCheck(kind, value) : result == Valid;
+}
+
+BitVector TypeValidator::invalidRows(const QString &fieldType, const QStringList &values)
+{
+    BitVector invalid;
+    const Kind kind = kindForType(fieldType);
+    for (const QString &value : values) {
+        const Result result = kind == UncheckedKind ? Valid : quickCheck(kind, value);
+        invalid.append(result == Unknown ? !fullCheck(kind, value) : result == Invalid);
+    }
+    return invalid;
+}
+
+TypeValidator::Result TypeValidator::quickCheck(Kind kind, const QString &value)
+{
+    if (kind == UncheckedKind)
+        return Valid;
+
+    // Recorte sin copiar la cadena
+    const ushort *chars = value.utf16();
+    int begin = 0;
+    int end = value.size();
+    while (begin < end && QChar(chars[begin]).isSpace()) begin++;
+    while (end > begin && QChar(chars[end - 1]).isSpace()) end--;
+    chars += begin;
+    const int length = end - begin;
+    if (length == 0)
+        return Valid;
+
+    switch (kind) {
+    case IntegerKind: {
+        // [signo] dígitos; hasta 9 dígitos significativos siempre caben en 32 bits
+        const int sign = (chars[0] == '+' || chars[0] == '-') ? 1 : 0;
+        const int digits = length - sign;
+        if (digits > 0 && digitPrefix(chars + sign, digits) == digits
+            && significantDigits(chars + sign, digits) <= 9)
+            return Valid;
+        return Unknown;
+    }
+    case DecimalKind: {
+        // [signo] dígitos [. dígitos]; hasta 15 dígitos enteros no pierden nada en un double
+        const int sign = (chars[0] == '+' || chars[0] == '-') ? 1 : 0;
+        const int whole = digitPrefix(chars + sign, length - sign);
+        int pos = sign + whole;
+        int fraction = 0;
+        if (pos < length && chars[pos] == '.') {
+            fraction = digitPrefix(chars + pos + 1, length - pos - 1);
+            pos += 1 + fraction;
+        }
+        const bool dotWithoutDigits = pos > sign + whole && fraction == 0;
+        if (pos == length && whole > 0 && !dotWithoutDigits && significantDigits(chars + sign, whole) <= 15)
+            return Valid;
+        return Unknown;
+    }
+    case DateKind: {
+        // dd-MM-aaaa o dd/MM/aaaa: posiciones fijas, se resuelve sin QDate
+        if (length != 10 || (chars[2] != '-' && chars[2] != '/') || chars[5] != chars[2])
+            return Unknown;
+        if (digitPrefix(chars, 2) != 2 || digitPrefix(chars + 3, 2) != 2 || digitPrefix(chars + 6, 4) != 4)
+            return Unknown;
+        const int day = twoDigits(chars);
+        const int month = twoDigits(chars + 3);
+        const int year = twoDigits(chars + 6) * 100 + twoDigits(chars + 8);
+        if (year == 0)
+            return Unknown;
+        return (month >= 1 && month <= 12 && day >= 1 && day <= daysInMonth(year, month)) ? Valid : Invalid;
+    }
+    case CurrencyKind:
+        // Currency::parse no reserva memoria: es su propio camino rápido
+        return Currency::parse(value) ? Valid : Invalid;
+    case UncheckedKind:
+        break;
+    }
+    return Valid;
+}
+
+bool TypeValidator::fullCheck(Kind kind, const QString &value)
+{
+    const QString v = value.trimmed();
+    if (kind == IntegerKind) {
+        bool ok=false; v.toInt(&ok); return ok || v.isEmpty();
+    }
+    if (kind == DecimalKind) {
+        bool ok=false; v.toDouble(&ok); return ok || v.isEmpty();
+    }
+    if (kind == CurrencyKind) {
+        return v.isEmpty() || Currency::parse(v).has_value();
+    }
+    if (kind == DateKind) {
+        // Misma gramática que usan la vista, el pegado y la importación
+        return v.isEmpty() || CompactDate::parse(v).has_value();
+    }
+    return true;
+}
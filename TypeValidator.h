@@ -0,0 +1,49 @@
+#ifndef TYPEVALIDATOR_H
+#define TYPEVALIDATOR_H
+
+#include <QString>
+#include <QStringList>
+#include "ColumnTable.h"
+
+// Validación de valores según el tipo del campo, de a uno o por columnas completas.
+//
+//   "Entero"             → entero de 32 bits
+//   "Decimales"          → número (punto decimal)
+//   "moneda"             → monto según Currency::parse ("Lps 1,234.56", "1,234.56", "$12")
+//   "fecha"              → según CompactDate::parse: dd-MM-aaaa, dd/MM/aaaa, año de 2
+//                          dígitos o mes en texto ("15/Agosto/2024")
+//   otros tipos          → siempre válidos
+//
+// Los valores se recortan y una celda vacía siempre es válida. El recorrido
+// por columnas resuelve la mayoría de las filas con un camino rápido (dígitos
+// de 8 en 8 con SSE2, fechas de largo fijo con aritmética) y solo pasa por
+// las conversiones de Qt las filas que ese camino no puede confirmar, así
+// que ambos dan exactamente el mismo resultado.
+class TypeValidator
+{
+public:
+    static bool isValid(const QString &fieldType, const QString &value);
+
+    // Un bit por fila, en 1 si el valor no es válido para el tipo
+    static BitVector invalidRows(const QString &fieldType, const QStringList &values);
+
+private:
+    enum Kind {
+        IntegerKind,
+        DecimalKind,
+        CurrencyKind,
+        DateKind,
+        UncheckedKind
+    };
+    enum Result {
+        Valid,
+        Invalid,
+        Unknown     // lo decide la conversión de Qt
+    };
+
+    static Kind kindForType(const QString &fieldType);
+    static Result quickCheck(Kind kind, const QString &value);
+    static bool fullCheck(Kind kind, const QString &value);
+};
+
+#endif // TYPEVALIDATOR_H
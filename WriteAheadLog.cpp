@@ -0,0 +1,738 @@
+#include "WriteAheadLog.h"
+#include "PagedFile.h"
+#include "BufferPool.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QMap>
+#include <QThread>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Encabezado del archivo de log
+constexpr char LogMagic[8] = { 'M', 'A', 'D', 'W', 'A', 'L', '0', '1' };
+constexpr int LogVersionOffset = 8;   // quint32
+constexpr int LogBaseLsnOffset = 16;  // quint64: LSN del primer registro
+constexpr int LogHeaderSize    = 32;
+constexpr quint32 LogVersion   = 1;
+
+// Encabezado de cada registro
+//   [0]  quint32 longitud total
+//   [4]  quint32 CRC-32 de los bytes [8, longitud)
+//   [8]  quint8  tipo
+//   [12] quint64 transacción (0 = fuera de una transacción, solo redo)
+//   [20] quint64 LSN anterior de la misma transacción
+constexpr int RecordLengthOffset = 0;
+constexpr int RecordCrcOffset    = 4;
+constexpr int RecordTypeOffset   = 8;
+constexpr int RecordTxOffset     = 12;
+constexpr int RecordPrevOffset   = 20;
+constexpr int RecordHeaderSize   = 28;
+
+// Los tramos que cambian separados por menos de esto se guardan como uno solo
+constexpr int MergeGap = 8;
+constexpr int WriteBufferLimit = 1024 * 1024;
+
+struct Crc32Table {
+    quint32 entries[256];
+    Crc32Table()
+    {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            entries[i] = c;
+        }
+    }
+};
+
+quint32 crc32(const char *data, int size)
+{
+    // La inicialización de un static local es segura entre hilos
+    static const Crc32Table crcTable;
+    const quint32 *table = crcTable.entries;
+    quint32 crc = 0xFFFFFFFFu;
+    for (int i = 0; i < size; ++i)
+        crc = table[(crc ^ quint8(data[i])) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void appendU16(QByteArray &out, quint16 value)
+{
+    char bytes[2];
+    qToLittleEndian<quint16>(value, bytes);
+    out.append(bytes, 2);
+}
+
+void appendU32(QByteArray &out, quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian<quint32>(value, bytes);
+    out.append(bytes, 4);
+}
+
+void appendU64(QByteArray &out, quint64 value)
+{
+    char bytes[8];
+    qToLittleEndian<quint64>(value, bytes);
+    out.append(bytes, 8);
+}
+
+void appendName(QByteArray &out, const QString &name)
+{
+    const QByteArray utf8 = name.toUtf8();
+    appendU16(out, quint16(utf8.size()));
+    out.append(utf8);
+}
+
+// Lector con control de límites para decodificar un registro
+struct Reader {
+    const char *data;
+    int size;
+    int pos = 0;
+    bool ok = true;
+
+    bool need(int bytes) { ok = ok && pos + bytes <= size; return ok; }
+    quint16 u16() { if (!need(2)) return 0; pos += 2; return pageReadU16(data, pos - 2); }
+    quint32 u32() { if (!need(4)) return 0; pos += 4; return pageReadU32(data, pos - 4); }
+    quint64 u64() { if (!need(8)) return 0; pos += 8; return pageReadU64(data, pos - 8); }
+    QByteArray bytes(int length) { if (!need(length)) return QByteArray(); pos += length; return QByteArray(data + pos - length, length); }
+    QString name() { const quint16 length = u16(); return QString::fromUtf8(bytes(length)); }
+};
+
+} // namespace
+
+WriteAheadLog::WriteAheadLog(QObject *parent)
+    : QObject(parent)
+{
+    m_groupCommitTimer.setSingleShot(true);
+    m_groupCommitTimer.setInterval(GroupCommitDelayMs);
+    connect(&m_groupCommitTimer, &QTimer::timeout, this, &WriteAheadLog::onGroupCommitTimeout);
+}
+
+WriteAheadLog::~WriteAheadLog()
+{
+    close();
+}
+
+bool WriteAheadLog::open(const QString &projectRoot, const QString &logDir)
+{
+    close();
+    m_error.clear();
+    m_recovery = RecoveryStats();
+    m_projectRoot = QDir(projectRoot).absolutePath();
+
+    QDir().mkpath(logDir);
+    m_file.setFileName(QDir(logDir).filePath("miniaccess.wal"));
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Unbuffered))
+        return fail(QStringLiteral("No se pudo abrir el log %1: %2").arg(m_file.fileName(), m_file.errorString()));
+
+    QByteArray header(LogHeaderSize, '\0');
+    const bool hasHeader = m_file.size() >= LogHeaderSize && m_file.seek(0)
+                           && m_file.read(header.data(), LogHeaderSize) == LogHeaderSize;
+    if (!hasHeader || std::memcmp(header.constData(), LogMagic, sizeof(LogMagic)) != 0
+        || pageReadU32(header.constData(), LogVersionOffset) != LogVersion) {
+        if (m_file.size() > 0)
+            qDebug() << "WARNING: Log con encabezado inválido, se crea uno nuevo:" << m_file.fileName();
+        // Log nuevo: el LSN inicial sale del reloj para quedar por encima de
+        // cualquier LSN que haya quedado en las páginas de un log anterior
+        const quint64 base = quint64(QDateTime::currentMSecsSinceEpoch()) << 20;
+        if (!resetLog(base)) {
+            m_file.close();
+            return false;
+        }
+        return true;
+    }
+
+    m_baseLsn = pageReadU64(header.constData(), LogBaseLsnOffset);
+    m_fileEnd = LogHeaderSize;
+    if (!recover()) {
+        qDebug() << "ERROR: Falló la recuperación del proyecto:" << m_error;
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+void WriteAheadLog::close()
+{
+    if (!m_file.isOpen())
+        return;
+    if (m_depth > 0) {
+        qDebug() << "WARNING: Se cierra el log con una transacción sin confirmar";
+        endTransaction();
+    }
+    if (!checkpoint())
+        qDebug() << "ERROR: No se pudo hacer el checkpoint final:" << m_error;
+
+    // Los archivos que sigan abiertos quedan sin log
+    for (auto it = m_files.cbegin(); it != m_files.cend(); ++it)
+        it.key()->m_log = nullptr;
+    m_files.clear();
+
+    qDebug() << "DEBUG: Log cerrado:" << m_commits << "transacciones confirmadas con" << m_syncs << "fsync";
+    m_groupCommitTimer.stop();
+    m_file.close();
+}
+
+quint64 WriteAheadLog::begin()
+{
+    if (m_depth++ == 0) {
+        m_activeTx = m_nextTxId++;
+        m_txLastLsn = 0;   // el registro de inicio se escribe con el primer cambio
+        m_txUndo.clear();
+    }
+    return m_activeTx;
+}
+
+bool WriteAheadLog::rollback()
+{
+    if (m_depth == 0) {
+        qDebug() << "WARNING: rollback() sin begin()";
+        return false;
+    }
+    const quint64 txId = m_activeTx;
+    if (m_txLastLsn == 0) {
+        endTransaction();
+        return true;
+    }
+
+    // Mismo orden que el undo de la recuperación: el registro de compensación
+    // va al log antes de tocar la página, y la página toma su LSN
+    BufferPool &pool = BufferPool::instance();
+    bool ok = true;
+    for (int i = m_txUndo.size() - 1; i >= 0; --i) {
+        const UndoEntry &entry = m_txUndo.at(i);
+        const QByteArray payload = compensationPayload(entry.prevLsn, m_files.value(entry.file),
+                                                       entry.pageNo, entry.ranges);
+        m_txLastLsn = append(CompensationRecord, txId, m_txLastLsn, payload);
+
+        char *page = pool.pin(entry.file, entry.pageNo);
+        if (!page) {
+            ok = fail(QStringLiteral("No se pudo cargar la página %1 para deshacerla").arg(entry.pageNo));
+            break;
+        }
+        for (const Range &range : entry.ranges)
+            std::memcpy(page + range.offset, range.before.constData(), size_t(range.before.size()));
+        pageWriteU64(page, PagedFile::PageLsnOffset, m_txLastLsn);
+        pool.unpin(entry.file, entry.pageNo, true);
+    }
+
+    // Si algo falló, la transacción queda perdedora y la recuperación termina de deshacerla
+    if (ok)
+        append(EndRecord, txId, m_txLastLsn, QByteArray());
+    qDebug() << "DEBUG: Transacción" << txId << "deshecha:" << m_txUndo.size() << "escrituras de página";
+    endTransaction();
+    return ok;
+}
+
+void WriteAheadLog::endTransaction()
+{
+    m_depth = 0;
+    m_activeTx = 0;
+    m_txLastLsn = 0;
+    m_txUndo.clear();
+}
+
+bool WriteAheadLog::commit(bool waitForDisk)
+{
+    if (m_depth == 0) {
+        qDebug() << "WARNING: commit() sin begin()";
+        return false;
+    }
+    if (--m_depth > 0)
+        return true;
+
+    const bool changed = m_txLastLsn != 0;
+    if (changed) {
+        append(CommitRecord, m_activeTx, m_txLastLsn, QByteArray());
+        m_commits++;
+    }
+    endTransaction();
+    if (!changed)
+        return true;
+
+    if (waitForDisk) {
+        if (!flush())
+            return false;
+    } else if (!m_groupCommitTimer.isActive()) {
+        m_groupCommitTimer.start();
+    }
+
+    if (endLsn() - m_baseLsn > quint64(CheckpointBytes))
+        return checkpoint();
+    return true;
+}
+
+void WriteAheadLog::onGroupCommitTimeout()
+{
+    if (!flush())
+        qDebug() << "ERROR: No se pudo escribir el log:" << m_error;
+}
+
+quint64 WriteAheadLog::endLsn() const
+{
+    return m_baseLsn + quint64(m_fileEnd - LogHeaderSize) + quint64(m_buffer.size());
+}
+
+bool WriteAheadLog::flush()
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+    if (!isOpen())
+        return false;
+    m_groupCommitTimer.stop();
+    if (m_durableLsn == endLsn())
+        return true;
+    if (!writeBuffer())
+        return false;
+    if (!PagedFile::fsyncFile(m_file))
+        return fail(QStringLiteral("No se pudo sincronizar el log: %1").arg(m_file.errorString()));
+    m_durableLsn = endLsn();
+    m_syncs++;
+    return true;
+}
+
+bool WriteAheadLog::flushTo(quint64 lsn)
+{
+    if (!isOpen() || lsn < m_durableLsn)
+        return true;
+    return flush();
+}
+
+bool WriteAheadLog::checkpoint()
+{
+    if (!flush())
+        return false;
+    for (auto it = m_files.cbegin(); it != m_files.cend(); ++it) {
+        if (!it.key()->flushToDisk())
+            return fail(QStringLiteral("Checkpoint: no se pudo escribir %1: %2").arg(it.value(), it.key()->errorString()));
+    }
+    // Con una transacción abierta el log todavía hace falta para deshacerla
+    if (m_depth > 0)
+        return true;
+    return resetLog(endLsn());
+}
+
+bool WriteAheadLog::resetLog(quint64 baseLsn)
+{
+    QByteArray header(LogHeaderSize, '\0');
+    std::memcpy(header.data(), LogMagic, sizeof(LogMagic));
+    pageWriteU32(header.data(), LogVersionOffset, LogVersion);
+    pageWriteU64(header.data(), LogBaseLsnOffset, baseLsn);
+
+    if (!m_file.resize(0) || !m_file.seek(0)
+        || m_file.write(header.constData(), LogHeaderSize) != LogHeaderSize
+        || !PagedFile::fsyncFile(m_file)) {
+        return fail(QStringLiteral("No se pudo reiniciar el log: %1").arg(m_file.errorString()));
+    }
+    m_baseLsn = baseLsn;
+    m_fileEnd = LogHeaderSize;
+    m_buffer.clear();
+    m_durableLsn = baseLsn;
+    m_loggedFiles.clear();
+    return true;
+}
+
+quint64 WriteAheadLog::append(RecordType type, quint64 txId, quint64 prevLsn, const QByteArray &payload)
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+    const quint64 lsn = endLsn();
+    const int start = m_buffer.size();
+    m_buffer.resize(start + RecordHeaderSize);
+    m_buffer.append(payload);
+
+    char *record = m_buffer.data() + start;
+    const int length = RecordHeaderSize + payload.size();
+    std::memset(record + RecordTypeOffset, 0, RecordTxOffset - RecordTypeOffset);
+    record[RecordTypeOffset] = char(type);
+    pageWriteU64(record, RecordTxOffset, txId);
+    pageWriteU64(record, RecordPrevOffset, prevLsn);
+    pageWriteU32(record, RecordLengthOffset, quint32(length));
+    pageWriteU32(record, RecordCrcOffset, crc32(record + RecordTypeOffset, length - RecordTypeOffset));
+
+    if (m_buffer.size() > WriteBufferLimit && !writeBuffer())
+        qDebug() << "ERROR: No se pudo escribir el log:" << m_error;
+    return lsn;
+}
+
+QByteArray WriteAheadLog::compensationPayload(quint64 undoNextLsn, const QString &fileName, quint32 pageNo,
+                                              const QVector<Range> &ranges)
+{
+    // Como una actualización, pero con una sola imagen (la anterior) y el LSN
+    // desde el que sigue el undo
+    QByteArray payload;
+    appendU64(payload, undoNextLsn);
+    appendName(payload, fileName);
+    appendU32(payload, pageNo);
+    appendU16(payload, quint16(ranges.size()));
+    for (const Range &range : ranges) {
+        appendU16(payload, range.offset);
+        appendU16(payload, quint16(range.before.size()));
+        payload.append(range.before);
+    }
+    return payload;
+}
+
+bool WriteAheadLog::writeBuffer()
+{
+    if (m_buffer.isEmpty())
+        return true;
+    if (!m_file.seek(m_fileEnd) || m_file.write(m_buffer) != m_buffer.size())
+        return fail(QStringLiteral("Error escribiendo el log: %1").arg(m_file.errorString()));
+    m_fileEnd += m_buffer.size();
+    m_buffer.clear();
+    return true;
+}
+
+void WriteAheadLog::attach(PagedFile *file)
+{
+    m_files.insert(file, fileNameFor(file->path()));
+}
+
+void WriteAheadLog::detach(PagedFile *file)
+{
+    const auto it = m_files.constFind(file);
+    if (it == m_files.constEnd())
+        return;
+    const QString name = it.value();
+    // Lo que la transacción en curso escribió en el archivo ya no se puede deshacer
+    const int pending = m_txUndo.size();
+    m_txUndo.erase(std::remove_if(m_txUndo.begin(), m_txUndo.end(),
+                                  [file](const UndoEntry &entry) { return entry.file == file; }),
+                   m_txUndo.end());
+    if (m_txUndo.size() != pending)
+        qDebug() << "WARNING:" << name << "se cierra con cambios de una transacción sin confirmar";
+    if (!file->flushToDisk())
+        qDebug() << "ERROR: No se pudo escribir" << name << ":" << file->errorString();
+    m_files.remove(file);
+
+    // El archivo puede reemplazarse o borrarse después de cerrarlo: sus
+    // registros no deben volver a aplicarse sobre otro contenido
+    if (isOpen() && m_loggedFiles.contains(name) && !checkpoint())
+        qDebug() << "ERROR: Checkpoint fallido al cerrar" << name << ":" << m_error;
+}
+
+QString WriteAheadLog::fileNameFor(const QString &path) const
+{
+    return QDir(m_projectRoot).relativeFilePath(QFileInfo(path).absoluteFilePath());
+}
+
+bool WriteAheadLog::logPageWrite(PagedFile *file, quint32 pageNo, const char *before, const char *after, quint64 *lsn)
+{
+    *lsn = 0;
+    const auto differs = [&](int i) {
+        // El LSN de la página no forma parte del cambio
+        if (i >= PagedFile::PageLsnOffset && i < PagedFile::PageLsnOffset + 8)
+            return false;
+        return before[i] != after[i];
+    };
+
+    QByteArray ranges;
+    quint16 rangeCount = 0;
+    UndoEntry undo;
+    int i = 0;
+    while (i < PagedFile::PageSize) {
+        if (!differs(i)) {
+            ++i;
+            continue;
+        }
+        const int start = i;
+        int end = i + 1;
+        for (int j = i + 1; j < PagedFile::PageSize && j - end < MergeGap; ++j) {
+            if (differs(j))
+                end = j + 1;
+        }
+        appendU16(ranges, quint16(start));
+        appendU16(ranges, quint16(end - start));
+        ranges.append(before + start, end - start);
+        ranges.append(after + start, end - start);
+        rangeCount++;
+        if (m_activeTx != 0) {
+            Range range;
+            range.offset = quint16(start);
+            range.before = QByteArray(before + start, end - start);
+            undo.ranges.append(range);
+        }
+        i = end;
+    }
+    if (rangeCount == 0)
+        return true;
+
+    const QString name = m_files.value(file);
+    QByteArray payload;
+    appendName(payload, name);
+    appendU32(payload, pageNo);
+    appendU16(payload, rangeCount);
+    payload.append(ranges);
+
+    quint64 prevLsn = 0;
+    if (m_activeTx != 0) {
+        if (m_txLastLsn == 0)
+            m_txLastLsn = append(BeginRecord, m_activeTx, 0, QByteArray());
+        prevLsn = m_txLastLsn;
+    }
+    *lsn = append(UpdateRecord, m_activeTx, prevLsn, payload);
+    if (m_activeTx != 0) {
+        m_txLastLsn = *lsn;
+        undo.file = file;
+        undo.pageNo = pageNo;
+        undo.prevLsn = prevLsn;
+        m_txUndo.append(undo);
+    }
+    m_loggedFiles.insert(name);
+    return true;
+}
+
+bool WriteAheadLog::logTruncate(PagedFile *file, quint32 pageCount)
+{
+    // Truncar no se puede deshacer: queda en el log (y en disco) antes de hacerlo
+    const QString name = m_files.value(file);
+    QByteArray payload;
+    appendName(payload, name);
+    appendU32(payload, pageCount);
+    append(TruncateRecord, 0, 0, payload);
+    m_loggedFiles.insert(name);
+    return flush();
+}
+
+bool WriteAheadLog::recover()
+{
+    QByteArray data;
+    if (m_file.size() > LogHeaderSize) {
+        m_file.seek(LogHeaderSize);
+        data = m_file.readAll();
+    }
+
+    QVector<LogRecord> records;
+    if (!parseLog(data, &records))
+        return false;
+    if (m_recovery.tornTail) {
+        qDebug() << "WARNING: Log con un registro incompleto al final, se descarta";
+        m_file.resize(m_fileEnd);
+    }
+    m_durableLsn = endLsn();
+    if (records.isEmpty())
+        return true;
+
+    qDebug() << "DEBUG: Recuperando el proyecto desde" << m_file.fileName() << ":" << records.size() << "registros";
+
+    // 1) Análisis: última entrada de cada transacción sin terminar
+    QHash<quint64, quint64> lastLsnOf;
+    QHash<quint64, int> indexOf;
+    for (int i = 0; i < records.size(); ++i) {
+        const LogRecord &record = records[i];
+        indexOf.insert(record.lsn, i);
+        if (record.txId == 0)
+            continue;
+        m_nextTxId = qMax(m_nextTxId, record.txId + 1);
+        switch (record.type) {
+        case BeginRecord:
+        case UpdateRecord:
+        case CompensationRecord:
+            lastLsnOf.insert(record.txId, record.lsn);
+            break;
+        case CommitRecord:
+            m_recovery.committed++;
+            lastLsnOf.remove(record.txId);
+            break;
+        case EndRecord:
+            lastLsnOf.remove(record.txId);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // 2) Redo: se repite toda la historia, también la de las perdedoras
+    for (const LogRecord &record : qAsConst(records)) {
+        if (record.type == UpdateRecord || record.type == CompensationRecord) {
+            bool applied = false;
+            if (!applyRanges(record, true, record.lsn, true, &applied))
+                return false;
+            if (applied)
+                m_recovery.redone++;
+        } else if (record.type == TruncateRecord) {
+            PagedFile *file = recoveryFile(record.fileName);
+            if (file && file->pageCount() > record.pageNo && !file->truncate(record.pageNo))
+                return fail(file->errorString());
+        }
+    }
+
+    // 3) Undo: de la entrada más reciente hacia atrás, con registros de compensación
+    QMap<quint64, quint64> toUndo; // LSN → transacción
+    for (auto it = lastLsnOf.cbegin(); it != lastLsnOf.cend(); ++it)
+        toUndo.insert(it.value(), it.key());
+
+    while (!toUndo.isEmpty()) {
+        const quint64 lsn = toUndo.lastKey();
+        const quint64 txId = toUndo.take(lsn);
+
+        const LogRecord &record = records[indexOf.value(lsn)];
+        quint64 next = 0;
+        if (record.type == UpdateRecord) {
+            const QByteArray payload = compensationPayload(record.prevLsn, record.fileName,
+                                                           record.pageNo, record.ranges);
+            const quint64 clrLsn = append(CompensationRecord, txId, lastLsnOf.value(txId), payload);
+            lastLsnOf.insert(txId, clrLsn);
+            if (!applyRanges(record, false, clrLsn, false, nullptr))
+                return false;
+            next = record.prevLsn;
+        } else if (record.type == CompensationRecord) {
+            next = record.undoNextLsn;
+        }
+
+        if (next != 0 && indexOf.contains(next)) {
+            toUndo.insert(next, txId);
+        } else {
+            append(EndRecord, txId, lastLsnOf.value(txId), QByteArray());
+            m_recovery.undone++;
+        }
+    }
+
+    // Todo queda en disco y el log se vacía
+    bool ok = flush();
+    for (auto it = m_recoveryFiles.begin(); it != m_recoveryFiles.end(); ++it) {
+        if (PagedFile *file = it.value()) {
+            if (!file->flushToDisk()) {
+                ok = fail(QStringLiteral("No se pudo escribir %1: %2").arg(it.key(), file->errorString()));
+            }
+            delete file;
+        }
+    }
+    m_recoveryFiles.clear();
+    if (!ok)
+        return false;
+
+    qDebug() << "DEBUG: Recuperación terminada:" << m_recovery.redone << "páginas rehechas,"
+             << m_recovery.committed << "transacciones confirmadas," << m_recovery.undone << "deshechas";
+    return resetLog(endLsn());
+}
+
+bool WriteAheadLog::parseLog(const QByteArray &data, QVector<LogRecord> *records)
+{
+    int offset = 0;
+    while (offset + RecordHeaderSize <= data.size()) {
+        const char *raw = data.constData() + offset;
+        const quint32 length = pageReadU32(raw, RecordLengthOffset);
+        if (length < quint32(RecordHeaderSize) || length > quint32(data.size() - offset)
+            || crc32(raw + RecordTypeOffset, int(length) - RecordTypeOffset) != pageReadU32(raw, RecordCrcOffset)) {
+            break;
+        }
+
+        LogRecord record;
+        record.lsn = m_baseLsn + quint64(offset);
+        record.type = RecordType(quint8(raw[RecordTypeOffset]));
+        record.txId = pageReadU64(raw, RecordTxOffset);
+        record.prevLsn = pageReadU64(raw, RecordPrevOffset);
+
+        Reader reader{ raw + RecordHeaderSize, int(length) - RecordHeaderSize };
+        switch (record.type) {
+        case UpdateRecord:
+        case CompensationRecord: {
+            if (record.type == CompensationRecord)
+                record.undoNextLsn = reader.u64();
+            record.fileName = reader.name();
+            record.pageNo = reader.u32();
+            const quint16 count = reader.u16();
+            for (int r = 0; r < count && reader.ok; ++r) {
+                Range range;
+                range.offset = reader.u16();
+                const quint16 size = reader.u16();
+                if (int(range.offset) + size > PagedFile::PageSize)
+                    reader.ok = false;
+                if (record.type == UpdateRecord)
+                    range.before = reader.bytes(size);
+                range.after = reader.bytes(size);
+                record.ranges.append(range);
+            }
+            break;
+        }
+        case TruncateRecord:
+            record.fileName = reader.name();
+            record.pageNo = reader.u32();
+            break;
+        case BeginRecord:
+        case CommitRecord:
+        case EndRecord:
+            break;
+        default:
+            reader.ok = false;
+            break;
+        }
+        if (!reader.ok)
+            break;
+
+        records->append(record);
+        offset += int(length);
+    }
+
+    m_recovery.records = records->size();
+    m_recovery.tornTail = offset < data.size();
+    m_fileEnd = LogHeaderSize + offset;
+    return true;
+}
+
+PagedFile *WriteAheadLog::recoveryFile(const QString &fileName)
+{
+    const auto found = m_recoveryFiles.constFind(fileName);
+    if (found != m_recoveryFiles.constEnd())
+        return found.value();
+
+    const QString path = QDir(m_projectRoot).filePath(fileName);
+    PagedFile *file = nullptr;
+    if (!QFile::exists(path)) {
+        qDebug() << "WARNING: El log menciona un archivo que ya no existe, se omite:" << fileName;
+    } else {
+        file = new PagedFile;
+        if (!file->open(path)) {
+            qDebug() << "ERROR: No se pudo abrir" << fileName << "para recuperarlo:" << file->errorString();
+            delete file;
+            file = nullptr;
+        }
+    }
+    m_recoveryFiles.insert(fileName, file);
+    return file;
+}
+
+bool WriteAheadLog::applyRanges(const LogRecord &record, bool useAfter, quint64 pageLsn, bool onlyIfNewer, bool *applied)
+{
+    if (applied)
+        *applied = false;
+    PagedFile *file = recoveryFile(record.fileName);
+    if (!file)
+        return true;
+
+    // Páginas que se agregaron después de la última escritura al disco
+    while (file->pageCount() <= record.pageNo) {
+        if (file->allocatePage() == 0xFFFFFFFF)
+            return fail(file->errorString());
+    }
+
+    QByteArray page(PagedFile::PageSize, '\0');
+    if (!file->readPage(record.pageNo, page.data()))
+        return fail(file->errorString());
+    if (onlyIfNewer && pageReadU64(page.constData(), PagedFile::PageLsnOffset) >= pageLsn)
+        return true;
+
+    for (const Range &range : record.ranges) {
+        const QByteArray &bytes = useAfter ? range.after : range.before;
+        std::memcpy(page.data() + range.offset, bytes.constData(), size_t(bytes.size()));
+    }
+    pageWriteU64(page.data(), PagedFile::PageLsnOffset, pageLsn);
+    if (!file->writePage(record.pageNo, page.constData()))
+        return fail(file->errorString());
+    if (applied)
+        *applied = true;
+    return true;
+}
+
+bool WriteAheadLog::fail(const QString &error)
+{
+    m_error = error;
+    qDebug() << "ERROR:" << error;
+    return false;
+}
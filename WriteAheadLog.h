@@ -0,0 +1,172 @@
+#ifndef WRITEAHEADLOG_H
+#define WRITEAHEADLOG_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+class PagedFile;
+
+// Resultado de la recuperación al abrir el log
+struct RecoveryStats {
+    int records = 0;          // registros válidos leídos del log
+    int redone = 0;           // cambios de página aplicados de nuevo
+    int committed = 0;        // transacciones confirmadas encontradas
+    int undone = 0;           // transacciones sin confirmar que se deshicieron
+    bool tornTail = false;    // el final del log estaba incompleto (escritura interrumpida)
+};
+
+// Bitácora de escritura anticipada (write-ahead log) de un proyecto,
+// guardada en logs/miniaccess.wal.
+//
+// Cada PagedFile enlazado al log registra sus escrituras de página antes de
+// modificar la caché: solo los rangos de bytes que cambiaron, con la imagen
+// anterior (undo) y la nueva (redo). El LSN del registro queda en el
+// encabezado de la página, y BufferPool no escribe una página al disco hasta
+// que el log esté en disco hasta ese LSN.
+//
+// Una transacción es durable cuando su registro de confirmación llega al
+// disco; los archivos .mad y de índices se escriben después, al desalojar
+// páginas o en un checkpoint. Las confirmaciones que llegan dentro de
+// GroupCommitDelayMs comparten un único fsync del log (group commit).
+//
+// open() recupera el proyecto al estilo ARIES: análisis (qué transacciones
+// quedaron sin confirmar), redo (repite toda la historia según el LSN de
+// cada página) y undo (deshace las perdedoras escribiendo registros de
+// compensación). Al final se hace un checkpoint y el log queda vacío.
+//
+// Hilos: el log no tiene bloqueos. Él, BufferPool y los archivos paginados
+// se usan solo desde el hilo de la interfaz (el que crea el log), así que
+// también los desalojos que llegan a flushTo() corren en ese hilo; append()
+// y flush() lo verifican con Q_ASSERT.
+class WriteAheadLog : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int GroupCommitDelayMs = 10;
+    static constexpr qint64 CheckpointBytes = 8 * 1024 * 1024;
+
+    explicit WriteAheadLog(QObject *parent = nullptr);
+    ~WriteAheadLog() override;
+
+    // Abre (o crea) el log en logDir y recupera los archivos bajo projectRoot
+    bool open(const QString &projectRoot, const QString &logDir);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    QString path() const { return m_file.fileName(); }
+    QString errorString() const { return m_error; }
+    RecoveryStats lastRecovery() const { return m_recovery; }
+
+    // Transacciones: begin() puede anidarse, solo el commit() externo confirma.
+    // Las escrituras fuera de una transacción se registran solo para redo.
+    quint64 begin();
+    bool commit(bool waitForDisk = false);
+    bool inTransaction() const { return m_depth > 0; }
+    // Deshace la transacción en curso completa (aunque esté anidada): cada
+    // página vuelve a su imagen anterior, de la más reciente a la más vieja,
+    // con registros de compensación como en la recuperación. Lo que se haya
+    // leído de esas páginas a memoria (encabezados, listas) hay que releerlo.
+    bool rollback();
+
+    // Escribe y sincroniza todo lo pendiente del log
+    bool flush();
+    // Escribe las páginas de los archivos enlazados y vacía el log
+    bool checkpoint();
+
+    quint64 endLsn() const;
+    quint64 durableLsn() const { return m_durableLsn; }
+
+private slots:
+    void onGroupCommitTimeout();
+
+private:
+    friend class PagedFile;
+
+    enum RecordType : quint8 {
+        BeginRecord    = 1,
+        UpdateRecord   = 2,
+        CommitRecord   = 3,
+        EndRecord      = 4,
+        CompensationRecord = 5,
+        TruncateRecord = 6
+    };
+
+    struct Range {
+        quint16 offset = 0;
+        QByteArray before;
+        QByteArray after;
+    };
+
+    // Imagen anterior de una escritura de la transacción en curso (para rollback)
+    struct UndoEntry {
+        PagedFile *file = nullptr;
+        quint32 pageNo = 0;
+        quint64 prevLsn = 0;
+        QVector<Range> ranges;      // solo before
+    };
+
+    struct LogRecord {
+        quint64 lsn = 0;
+        RecordType type = BeginRecord;
+        quint64 txId = 0;
+        quint64 prevLsn = 0;
+        quint64 undoNextLsn = 0;    // solo compensación
+        QString fileName;
+        quint32 pageNo = 0;         // página, o cantidad de páginas al truncar
+        QVector<Range> ranges;
+    };
+
+    // Usadas por PagedFile
+    void attach(PagedFile *file);
+    void detach(PagedFile *file);
+    QString fileNameFor(const QString &path) const;
+    bool logPageWrite(PagedFile *file, quint32 pageNo, const char *before, const char *after, quint64 *lsn);
+    bool logTruncate(PagedFile *file, quint32 pageCount);
+    bool flushTo(quint64 lsn);
+
+    quint64 append(RecordType type, quint64 txId, quint64 prevLsn, const QByteArray &payload);
+    static QByteArray compensationPayload(quint64 undoNextLsn, const QString &fileName, quint32 pageNo,
+                                          const QVector<Range> &ranges);
+    void endTransaction();
+    bool writeBuffer();
+    bool resetLog(quint64 baseLsn);
+
+    bool recover();
+    bool parseLog(const QByteArray &data, QVector<LogRecord> *records);
+    PagedFile *recoveryFile(const QString &fileName);
+    bool applyRanges(const LogRecord &record, bool useAfter, quint64 pageLsn, bool onlyIfNewer, bool *applied);
+
+    bool fail(const QString &error);
+
+    QFile m_file;
+    QString m_projectRoot;
+    QString m_error;
+
+    quint64 m_baseLsn = 0;          // LSN del primer byte después del encabezado
+    qint64 m_fileEnd = 0;           // bytes ya escritos al archivo
+    QByteArray m_buffer;            // registros todavía en memoria
+    quint64 m_durableLsn = 0;       // todo lo anterior está en disco
+    QTimer m_groupCommitTimer;
+
+    quint64 m_nextTxId = 1;
+    quint64 m_activeTx = 0;
+    quint64 m_txLastLsn = 0;
+    int m_depth = 0;
+    QVector<UndoEntry> m_txUndo;    // escrituras de la transacción en curso
+
+    QHash<PagedFile*, QString> m_files;   // archivos enlazados → nombre en el log
+    QSet<QString> m_loggedFiles;          // con registros desde el último checkpoint
+    QHash<QString, PagedFile*> m_recoveryFiles;
+    RecoveryStats m_recovery;
+    quint64 m_commits = 0;
+    quint64 m_syncs = 0;
+};
+
+#endif // WRITEAHEADLOG_H
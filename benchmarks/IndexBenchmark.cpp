@@ -0,0 +1,127 @@
+// Compara el árbol B (llave primaria) con los árboles B+ y B* (índices
+// secundarios) insertando N claves en orden secuencial y aleatorio.
+//
+// Uso: index_benchmark [cantidad de claves] [directorio temporal]
+//      (por defecto 1.000.000 claves en el directorio temporal del sistema)
+//
+// Por cada combinación informa tiempo, inserciones por segundo, altura,
+// llenado promedio de hojas y nodos internos, y tamaño del archivo.
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QVector>
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+#include "BPlusTree.h"
+#include "BTree.h"
+
+namespace {
+
+struct Result {
+    double seconds = 0.0;
+    quint32 height = 0;
+    IndexStats stats;
+    qint64 fileSize = 0;
+    bool ok = true;
+};
+
+RecordId recordIdFor(qint64 key)
+{
+    // Un registro ficticio por clave, ~100 por página del .mad
+    return RecordId{ quint32(key / 100 + 1), quint16(key % 100) };
+}
+
+template <typename Tree>
+Result run(Tree &tree, const QVector<qint64> &keys)
+{
+    Result result;
+    QElapsedTimer timer;
+    timer.start();
+    for (const qint64 key : keys) {
+        if (!tree.insert(key, recordIdFor(key))) {
+            std::fprintf(stderr, "ERROR: inserción fallida (%lld): %s\n", static_cast<long long>(key),
+                         tree.errorString().toLocal8Bit().constData());
+            result.ok = false;
+            break;
+        }
+    }
+    tree.sync();
+    result.seconds = timer.nsecsElapsed() / 1e9;
+    result.height = tree.height();
+    result.stats = tree.statistics();
+    result.fileSize = QFileInfo(tree.path()).size();
+    return result;
+}
+
+void printRow(const char *structure, const char *order, int count, const Result &r)
+{
+    std::printf("%-6s %-10s %9d %9.2f %12.0f %6u %9.1f%% %9.1f%% %10.1f MB%s\n",
+                structure, order, count, r.seconds, r.seconds > 0 ? count / r.seconds : 0.0,
+                r.height, r.stats.leafFill * 100.0, r.stats.internalFill * 100.0,
+                r.fileSize / (1024.0 * 1024.0), r.ok ? "" : "  (incompleto)");
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const int count = argc > 1 ? QString(argv[1]).toInt() : 1000000;
+    const QString dir = argc > 2 ? QString(argv[2]) : QDir::tempPath();
+    if (count <= 0) {
+        std::fprintf(stderr, "Uso: %s [cantidad de claves] [directorio]\n", argv[0]);
+        return 1;
+    }
+
+    QVector<qint64> sequential(count);
+    for (int i = 0; i < count; ++i)
+        sequential[i] = i;
+    QVector<qint64> random = sequential;
+    std::mt19937_64 rng(20240601);
+    std::shuffle(random.begin(), random.end(), rng);
+
+    std::printf("%-6s %-10s %9s %9s %12s %6s %10s %10s %13s\n",
+                "tipo", "orden", "claves", "segundos", "inserc./s", "altura", "hojas", "internos", "archivo");
+
+    const struct { const char *name; const QVector<qint64> *keys; } orders[] = {
+        { "secuencial", &sequential },
+        { "aleatorio", &random },
+    };
+
+    for (const auto &order : orders) {
+        const QString base = QDir(dir).filePath(QString("miniaccess_bench_%1").arg(order.name));
+
+        {
+            QFile::remove(base + ".btree");
+            BTree tree;
+            if (!tree.open(base + ".btree", "bench", "clave")) {
+                std::fprintf(stderr, "ERROR: %s\n", tree.errorString().toLocal8Bit().constData());
+                return 1;
+            }
+            printRow("B", order.name, count, run(tree, *order.keys));
+            tree.close();
+            QFile::remove(base + ".btree");
+        }
+
+        const struct { const char *name; IndexFile::Kind kind; const char *ext; } variants[] = {
+            { "B+", IndexFile::BPlusTreeKind, ".bplus" },
+            { "B*", IndexFile::BStarTreeKind, ".bstar" },
+        };
+        for (const auto &variant : variants) {
+            const QString path = base + variant.ext;
+            QFile::remove(path);
+            BPlusTree tree;
+            if (!tree.open(path, "bench", "clave", variant.kind)) {
+                std::fprintf(stderr, "ERROR: %s\n", tree.errorString().toLocal8Bit().constData());
+                return 1;
+            }
+            printRow(variant.name, order.name, count, run(tree, *order.keys));
+            tree.close();
+            QFile::remove(path);
+        }
+    }
+    return 0;
+}
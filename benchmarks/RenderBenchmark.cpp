@@ -0,0 +1,163 @@
+// Tiempo por cuadro al desplazar la Vista Datos de una tabla grande, con y
+// sin la caché de pintado de DataFieldDelegate.
+//
+// Uso: render_benchmark [cantidad de filas] [cuadros] [directorio temporal]
+//      (por defecto 100.000 filas y 600 cuadros en el directorio temporal del sistema)
+//
+// Sin pantalla se puede correr con QT_QPA_PLATFORM=offscreen. Cada cuadro
+// mueve la barra de desplazamiento y repinta la tabla de forma síncrona; se
+// miden tres recorridos: de a una fila (casi todas las celdas ya se pintaron),
+// de a una página (ninguna) y repintar sin moverse (selección, tooltips).
+
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QScrollBar>
+#include <QTableView>
+#include <QVector>
+#include <algorithm>
+#include <cstdio>
+
+#include "RecordFile.h"
+#include "TableData.h"
+
+namespace {
+
+const QStringList FieldNames = { "Id", "Nombre", "Monto", "Fecha", "Notas" };
+const QStringList FieldTypes = { "Entero", "Texto corto (hasta N caracteres)", "moneda", "fecha",
+                                 "Texto corto (hasta N caracteres)" };
+
+struct Result {
+    double meanMs = 0.0;
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+bool writeTable(const QString &path, int rows)
+{
+    QFile::remove(path);
+    RecordFile file;
+    if (!file.open(path) || !file.setSchema("benchmark", FieldNames, FieldTypes)) {
+        std::fprintf(stderr, "ERROR: no se pudo crear %s: %s\n", qPrintable(path),
+                     qPrintable(file.errorString()));
+        return false;
+    }
+    for (int i = 0; i < rows; i++) {
+        const QStringList values = {
+            QString::number(i + 1),
+            QStringLiteral("Registro %1").arg(i + 1),
+            QString::number((i * 7919) % 1000000) + QStringLiteral(".50"), // sin formato: se formatea al pintar
+            QStringLiteral("%1-%2-%3").arg(i % 28 + 1, 2, 10, QLatin1Char('0'))
+                                      .arg(i % 12 + 1, 2, 10, QLatin1Char('0'))
+                                      .arg(1990 + i % 35),
+            QStringLiteral("Notas de la fila %1").arg(i + 1)
+        };
+        if (!file.insert(values)) {
+            std::fprintf(stderr, "ERROR: inserción fallida (%d): %s\n", i, qPrintable(file.errorString()));
+            return false;
+        }
+    }
+    file.close();
+    return true;
+}
+
+// Cada cuadro mueve la barra step unidades (0: no se mueve) y repinta
+Result scroll(QTableView *view, int frames, int step)
+{
+    QScrollBar *bar = view->verticalScrollBar();
+    bar->setValue(0);
+    view->viewport()->repaint();
+
+    QVector<double> times;
+    times.reserve(frames);
+    int value = 0;
+    int direction = 1;
+    QElapsedTimer timer;
+    for (int frame = 0; frame < frames; frame++) {
+        // Al llegar al final se vuelve hacia arriba
+        if (value + direction * step > bar->maximum() || value + direction * step < 0)
+            direction = -direction;
+        value += direction * step;
+
+        timer.start();
+        bar->setValue(value);
+        view->viewport()->repaint();
+        times.append(timer.nsecsElapsed() / 1e6);
+    }
+
+    Result result;
+    if (times.isEmpty()) return result;
+    for (double t : times) result.meanMs += t;
+    result.meanMs /= times.size();
+    std::sort(times.begin(), times.end());
+    result.p50Ms = times.at(times.size() / 2);
+    result.p95Ms = times.at(qMin(times.size() - 1, times.size() * 95 / 100));
+    result.maxMs = times.last();
+    return result;
+}
+
+void printRow(const char *walk, const char *cache, const Result &r)
+{
+    std::printf("%-14s %-6s %10.3f %10.3f %10.3f %10.3f\n", walk, cache, r.meanMs, r.p50Ms, r.p95Ms, r.maxMs);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    const int rows = argc > 1 ? QString(argv[1]).toInt() : 100000;
+    const int frames = argc > 2 ? QString(argv[2]).toInt() : 600;
+    const QString dir = argc > 3 ? QString(argv[3]) : QDir::tempPath();
+    if (rows <= 0 || frames <= 0) {
+        std::fprintf(stderr, "Uso: render_benchmark [cantidad de filas] [cuadros] [directorio temporal]\n");
+        return 1;
+    }
+
+    const QString path = QDir(dir).filePath("render_benchmark.mad");
+    const QString indexDir = QDir(dir).filePath("render_benchmark_indexes");
+    QDir().mkpath(indexDir);
+    if (!writeTable(path, rows))
+        return 1;
+
+    TableData table;
+    table.resize(1280, 900);
+    table.setupDataView(FieldNames, FieldTypes);
+    if (!table.openStorage(path, indexDir))
+        return 1;
+    table.show();
+
+    QTableView *view = table.findChild<QTableView*>();
+    DataFieldDelegate *delegate = view ? qobject_cast<DataFieldDelegate*>(view->itemDelegate()) : nullptr;
+    if (!delegate) {
+        std::fprintf(stderr, "ERROR: la vista de datos no usa DataFieldDelegate\n");
+        return 1;
+    }
+
+    // Todas las filas en la vista para poder recorrerla completa
+    QAbstractItemModel *model = view->model();
+    while (model->canFetchMore(QModelIndex()))
+        model->fetchMore(QModelIndex());
+    const int pageStep = view->verticalScrollBar()->pageStep();
+
+    std::printf("Filas: %d, cuadros por recorrido: %d, filas por página: %d\n",
+                model->rowCount(), frames, pageStep);
+    std::printf("%-14s %-6s %10s %10s %10s %10s\n", "recorrido", "cache", "media ms", "p50 ms", "p95 ms", "max ms");
+
+    struct Walk { const char *name; int step; };
+    const Walk walks[] = { { "una fila", 1 }, { "una pagina", qMax(1, pageStep) }, { "sin mover", 0 } };
+    for (const Walk &walk : walks) {
+        delegate->setRenderModel(nullptr);
+        printRow(walk.name, "no", scroll(view, frames, walk.step));
+        delegate->setRenderModel(qobject_cast<const TableDataModel*>(model));
+        printRow(walk.name, "si", scroll(view, frames, walk.step));
+    }
+
+    table.closeStorage();
+    QFile::remove(path);
+    QDir(indexDir).removeRecursively();
+    return 0;
+}
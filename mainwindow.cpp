@@ -286,8 +286,9 @@ void MainWindow::createMainContent()
     // Create table editor view
     tableEditorView = new TableEditor();
     
-    // Create relationships view
+    // Create relationships view (mismo catálogo de esquemas que el editor de tablas)
     relationshipsView = new RelationshipsView();
+    relationshipsView->setSchemaCatalog(tableEditorView->schemaCatalog());
     
     // Add views to stacked widget
     stackedWidget->addWidget(homeView);     // Index 0
@@ -517,6 +518,11 @@ void MainWindow::setProjectName(const QString &projectName)
     currentProjectName = projectName;
     setWindowTitle("MiniAccess - " + projectName);
     projectNameLabel->setText(projectName);
+    
+    // Las tablas viven en la carpeta del proyecto
+    if (tableEditorView) {
+        tableEditorView->setProjectName(projectName);
+    }
 }
 
 bool MainWindow::eventFilter(QObject *obj, QEvent *event)
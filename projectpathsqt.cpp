@@ -7,9 +7,6 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
-#include <algorithm>
-#include <QJsonArray>
-#include <algorithm>
 
 QStringList ProjectStorageQt::s_markers{
     ".miniaccess_root",
@@ -17,11 +14,14 @@ QStringList ProjectStorageQt::s_markers{
     ".git"
 };
 
+QString ProjectStorageQt::s_repoRoot;
+
 ProjectStorageQt::ProjectStorageQt(const QString& projectName)
     : m_projectName(projectName) {}
 
 void ProjectStorageQt::setRootMarkers(const QStringList& markers) {
     s_markers = markers;
+    s_repoRoot.clear(); // con otros marcadores la raíz puede ser otra
 }
 
 std::optional<ProjectPathsQt> ProjectStorageQt::create() {
@@ -63,6 +63,10 @@ std::optional<ProjectPathsQt> ProjectStorageQt::create() {
 }
 
 std::optional<QString> ProjectStorageQt::findRepoRoot() {
+    // Subir por el árbol de carpetas en cada llamada es caro: la raíz no cambia
+    if (!s_repoRoot.isEmpty())
+        return s_repoRoot;
+
     const QString appDir  = QDir::cleanPath(QCoreApplication::applicationDirPath());
     QStringList starts;
     starts << QDir::currentPath();                // donde se ejecuta (IDE/terminal)
@@ -70,12 +74,22 @@ std::optional<QString> ProjectStorageQt::findRepoRoot() {
     starts << QDir(appDir).absoluteFilePath(".."); // por si el binario está en ./build/<cfg>
 
     for (const QString& st : starts) {
-        if (auto p = climbForMarker(st); p.has_value())
+        if (auto p = climbForMarker(st); p.has_value()) {
+            s_repoRoot = p.value();
             return p;
+        }
     }
     return std::nullopt;
 }
 
+std::optional<QString> ProjectStorageQt::projectsRoot() {
+    auto repoOpt = findRepoRoot();
+    if (!repoOpt.has_value()) {
+        return std::nullopt;
+    }
+    return QDir(repoOpt.value()).filePath("proyectos");
+}
+
 std::optional<QString> ProjectStorageQt::climbForMarker(QString start) {
     QDir cur(start);
 
@@ -97,52 +111,18 @@ std::optional<QString> ProjectStorageQt::climbForMarker(QString start) {
     return std::nullopt;
 }
 
-// Implementación de métodos para listar proyectos existentes
-QList<ProjectInfoQt> ProjectStorageQt::listExistingProjects()
+std::optional<ProjectInfoQt> ProjectStorageQt::getProjectInfo(const QString& projectName)
 {
-    QList<ProjectInfoQt> projects;
-    
-    auto repoOpt = findRepoRoot();
-    if (!repoOpt.has_value()) {
-        return projects; // Lista vacía si no se encuentra la raíz
-    }
-    
-    const QString repo = repoOpt.value();
-    const QString proyectosDir = QDir(repo).filePath("proyectos");
-    
-    QDir dir(proyectosDir);
-    if (!dir.exists()) {
-        return projects; // No existe la carpeta proyectos
-    }
-    
-    // Obtener todas las subcarpetas en proyectos/
-    QStringList projectDirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-    
-    for (const QString& projectName : projectDirs) {
-        auto projectInfo = getProjectInfo(projectName);
-        if (projectInfo.has_value()) {
-            projects.append(projectInfo.value());
-        }
+    auto rootOpt = projectsRoot();
+    if (!rootOpt.has_value()) {
+        return std::nullopt;
     }
-    
-    // Ordenar por fecha de modificación (más reciente primero)
-    std::sort(projects.begin(), projects.end(), 
-              [](const ProjectInfoQt& a, const ProjectInfoQt& b) {
-                  return a.modified > b.modified;
-              });
-    
-    return projects;
+    return readProjectInfo(QDir(rootOpt.value()).filePath(projectName));
 }
 
-std::optional<ProjectInfoQt> ProjectStorageQt::getProjectInfo(const QString& projectName)
+std::optional<ProjectInfoQt> ProjectStorageQt::readProjectInfo(const QString& projectPath)
 {
-    auto repoOpt = findRepoRoot();
-    if (!repoOpt.has_value()) {
-        return std::nullopt;
-    }
-    
-    const QString repo = repoOpt.value();
-    const QString projectPath = QDir(repo).filePath(QStringLiteral("proyectos/%1").arg(projectName));
+    const QString projectName = QFileInfo(projectPath).fileName();
     const QString metaPath = QDir(projectPath).filePath("project.meta.json");
     
     QDir projectDir(projectPath);
@@ -207,12 +187,15 @@ std::optional<ProjectInfoQt> ProjectStorageQt::getProjectInfo(const QString& pro
         info.created = info.modified;
     }
     
-    // Contar archivos .mad en la carpeta tables si no se obtuvo del JSON
-    if (info.tableCount == 0) {
-        QString tablesPath = QDir(projectPath).filePath("tables");
-        QDir tablesDir(tablesPath);
-        if (tablesDir.exists()) {
-            QStringList madFiles = tablesDir.entryList(QStringList() << "*.mad", QDir::Files);
+    // Tablas de la carpeta tables; cuentan si no se obtuvo el número del JSON
+    QString tablesPath = QDir(projectPath).filePath("tables");
+    QDir tablesDir(tablesPath);
+    if (tablesDir.exists()) {
+        const QStringList madFiles = tablesDir.entryList(QStringList() << "*.mad", QDir::Files);
+        for (const QString& file : madFiles) {
+            info.tableNames << QFileInfo(file).completeBaseName();
+        }
+        if (info.tableCount == 0) {
             info.tableCount = madFiles.size();
         }
     }
@@ -27,6 +27,7 @@ struct ProjectInfoQt {
     int version;           // Versión del proyecto
     bool isValid;          // Si el proyecto tiene estructura válida
     int tableCount;        // Número de tablas (si está disponible)
+    QStringList tableNames; // Tablas (.mad) de la carpeta tables, sin extensión
 };
 
 class ProjectStorageQt {
@@ -37,9 +38,12 @@ public:
     // Retorna rutas listas para usar. std::nullopt si no se encontró la raíz del repo.
     std::optional<ProjectPathsQt> create();
 
-    // Métodos para listar proyectos existentes
-    static QList<ProjectInfoQt> listExistingProjects();
+    // Carpeta proyectos/ de la raíz del repo (exista o no todavía).
+    // Para listar proyectos usar ProjectCatalog, que no vuelve a recorrer el disco.
+    static std::optional<QString> projectsRoot();
     static std::optional<ProjectInfoQt> getProjectInfo(const QString& projectName);
+    // Lee project.meta.json y la carpeta tables de un proyecto
+    static std::optional<ProjectInfoQt> readProjectInfo(const QString& projectPath);
     static bool isValidProject(const QString& projectPath);
 
     // (Opcional) Cambiar los marcadores que identifican la raíz del repo
@@ -52,6 +56,7 @@ private:
 private:
     QString m_projectName;
     static QStringList s_markers; // orden de preferencia
+    static QString s_repoRoot;    // raíz ya encontrada (vacía: hay que buscarla)
 };
 
 #endif // PROJECTSTORAGEQT_H